@@ -0,0 +1,75 @@
+/******************************************************************************
+ *
+ * Memory Arena (see arena.h)
+ *
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include "arena.h"
+
+#define ARENA_ALIGNMENT 16
+
+struct arenablock_s {
+	arenablock_t* next;
+	size_t size;			// Usable bytes after the header.
+	size_t used;
+};
+
+// Keeps the first allocation in each block aligned.
+#define ARENA_HEADER_SIZE ((sizeof(arenablock_t) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+void arenaInit(arena_t* arena, size_t blockSize)
+{
+	arena->blocks = NULL;
+	arena->blockSize = blockSize;
+	arena->bytesUsed = 0;
+	arena->bytesReserved = 0;
+}
+
+void* arenaAlloc(arena_t* arena, size_t size)
+{
+	size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+
+	arenablock_t* block = arena->blocks;
+	if (block == NULL || block->size - block->used < size) {
+		size_t blockSize = size > arena->blockSize ? size : arena->blockSize;
+
+		block = calloc(1, ARENA_HEADER_SIZE + blockSize);
+		if (block == NULL) {
+			return NULL;
+		}
+		block->size = blockSize;
+
+		// An oversized request gets its own block behind the current one, so the
+		// space left in the current block isn't abandoned.
+		if (arena->blocks != NULL && blockSize > arena->blockSize) {
+			block->next = arena->blocks->next;
+			arena->blocks->next = block;
+		}
+		else {
+			block->next = arena->blocks;
+			arena->blocks = block;
+		}
+		arena->bytesReserved += blockSize;
+	}
+
+	void* memory = (unsigned char*)block + ARENA_HEADER_SIZE + block->used;
+	block->used += size;
+	arena->bytesUsed += size;
+	return memory;
+}
+
+void arenaReset(arena_t* arena)
+{
+	arenablock_t* block = arena->blocks;
+
+	while (block != NULL) {
+		arenablock_t* next = block->next;
+		free(block);
+		block = next;
+	}
+
+	arena->blocks = NULL;
+	arena->bytesUsed = 0;
+	arena->bytesReserved = 0;
+}
@@ -0,0 +1,34 @@
+/******************************************************************************
+ *
+ * Memory Arena
+ *
+ * A bump allocator for memory that lives and dies together, such as the
+ * scene's assets. Allocations are carved out of large blocks and are never
+ * freed individually; arenaReset() releases everything at once.
+ *
+ ******************************************************************************/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+typedef struct arenablock_s arenablock_t;
+
+typedef struct {
+	arenablock_t* blocks;	// Most recent block first.
+	size_t blockSize;		// Size of each new block (larger requests get a block of their own).
+	size_t bytesUsed;		// Total handed out since the last reset.
+	size_t bytesReserved;	// Total held in blocks.
+} arena_t;
+
+// Set up an empty arena. No memory is allocated until the first arenaAlloc().
+void arenaInit(arena_t* arena, size_t blockSize);
+
+// Allocate size bytes, 16-byte aligned and zeroed. Returns NULL if out of memory.
+void* arenaAlloc(arena_t* arena, size_t size);
+
+// Free every allocation made from the arena. The arena can be used again afterwards.
+void arenaReset(arena_t* arena);
+
+#endif
@@ -0,0 +1,293 @@
+/******************************************************************************
+ *
+ * Binary Asset Cache (see assetcache.h)
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "assetcache.h"
+#include "platform.h"
+#include "ppm.h"
+
+#define ASSET_CACHE_MAGIC 0x43415047u	// "GPAC"
+#define ASSET_CACHE_VERSION 1u
+
+// Planes start on this boundary within the file, so they can be used in place.
+#define ASSET_PLANE_ALIGNMENT 64
+
+// Layout of the start of every cache file. The planes follow at their offsets.
+typedef struct {
+	unsigned int magic;
+	unsigned int version;
+	unsigned long long sourceSize;		// Stamp of the PPM the cache was built from...
+	long long sourceModified;
+	unsigned long long sourceHash;		// ...and a hash of its contents.
+	int width;
+	int height;
+	unsigned int planes;				// ASSET_PLANE_ flags
+	unsigned int reserved;
+	unsigned long long rgbOffset;
+	unsigned long long heightOffset;
+	unsigned long long totalSize;
+} assetcacheheader_t;
+
+static int cacheEnabled = 1;
+
+void assetCacheEnable(int enabled)
+{
+	cacheEnabled = enabled;
+}
+
+// 64-bit FNV-1a, folded a word at a time.
+static unsigned long long hashBytes(const unsigned char* data, size_t size)
+{
+	unsigned long long hash = 14695981039346656037ull;
+	size_t i = 0;
+
+	for (; i + 8 <= size; i += 8) {
+		unsigned long long word;
+		memcpy(&word, data + i, sizeof(word));
+		hash = (hash ^ word) * 1099511628211ull;
+		hash ^= hash >> 29;
+	}
+	for (; i < size; i++) {
+		hash = (hash ^ data[i]) * 1099511628211ull;
+	}
+	return hash;
+}
+
+static unsigned long long alignOffset(unsigned long long offset)
+{
+	return (offset + ASSET_PLANE_ALIGNMENT - 1) & ~(unsigned long long)(ASSET_PLANE_ALIGNMENT - 1);
+}
+
+// Whether a plane of planeSize bytes at offset lies within a blob of size bytes.
+static int planeFits(unsigned long long offset, unsigned long long planeSize, size_t size)
+{
+	return offset >= sizeof(assetcacheheader_t) && offset <= size && planeSize <= size - offset;
+}
+
+// Check a mapped cache file is complete and carries the planes we need, each
+// of them inside the file.
+static int validateBlob(const void* data, size_t size, int planes)
+{
+	const assetcacheheader_t* header = data;
+
+	if (size < sizeof(assetcacheheader_t) || header->magic != ASSET_CACHE_MAGIC ||
+		header->version != ASSET_CACHE_VERSION || header->totalSize != size ||
+		(header->planes & planes) != (unsigned int)planes ||
+		header->width <= 0 || header->height <= 0) {
+		return 0;
+	}
+
+	unsigned long long numPixels = (unsigned long long)header->width * (unsigned long long)header->height;
+	if ((header->planes & ASSET_PLANE_RGB) && !planeFits(header->rgbOffset, numPixels * 3, size)) {
+		return 0;
+	}
+	if ((header->planes & ASSET_PLANE_HEIGHT) && !planeFits(header->heightOffset, numPixels * sizeof(float), size)) {
+		return 0;
+	}
+	return 1;
+}
+
+// Point an asset's planes into a blob laid out as a cache file.
+static void usePlanes(assetimage_t* asset, const unsigned char* blob, int planes)
+{
+	const assetcacheheader_t* header = (const assetcacheheader_t*)blob;
+
+	asset->width = header->width;
+	asset->height = header->height;
+	asset->rgb = (planes & ASSET_PLANE_RGB) ? blob + header->rgbOffset : NULL;
+	asset->heights = (planes & ASSET_PLANE_HEIGHT) ? (const float*)(blob + header->heightOffset) : NULL;
+}
+
+// Decode a PPM into a cache blob held in memory. Returns NULL on failure.
+static unsigned char* buildBlob(const unsigned char* source, size_t sourceSize, int planes,
+	unsigned long long stampSize, long long stampModified)
+{
+	ppmimage_t image;
+
+	if (!ppmParse(source, sourceSize, &image)) {
+		return NULL;
+	}
+
+	size_t numPixels = (size_t)image.width * image.height;
+	assetcacheheader_t header;
+	memset(&header, 0, sizeof(header));
+	header.magic = ASSET_CACHE_MAGIC;
+	header.version = ASSET_CACHE_VERSION;
+	header.sourceSize = stampSize;
+	header.sourceModified = stampModified;
+	header.sourceHash = hashBytes(source, sourceSize);
+	header.width = image.width;
+	header.height = image.height;
+	header.planes = (unsigned int)planes;
+
+	unsigned long long offset = alignOffset(sizeof(header));
+	if (planes & ASSET_PLANE_RGB) {
+		header.rgbOffset = offset;
+		offset = alignOffset(offset + numPixels * 3);
+	}
+	if (planes & ASSET_PLANE_HEIGHT) {
+		header.heightOffset = offset;
+		offset = alignOffset(offset + numPixels * sizeof(float));
+	}
+	header.totalSize = offset;
+
+	unsigned char* blob = calloc(1, (size_t)header.totalSize);
+	if (blob == NULL) {
+		printf("Out of memory caching a %dx%d image!\n", image.width, image.height);
+		ppmFree(&image);
+		return NULL;
+	}
+	memcpy(blob, &header, sizeof(header));
+
+	if (planes & ASSET_PLANE_RGB) {
+		memcpy(blob + header.rgbOffset, image.pixels, numPixels * 3);
+	}
+	if (planes & ASSET_PLANE_HEIGHT) {
+		float* heights = (float*)(blob + header.heightOffset);
+		for (size_t i = 0; i < numPixels; i++) {
+			const unsigned char* rgb = &image.pixels[i * 3];
+			heights[i] = (float)(0.2126 * rgb[0] + 0.7152 * rgb[1] + 0.0722 * rgb[2]);
+		}
+	}
+
+	ppmFree(&image);
+	return blob;
+}
+
+static void writeBlob(const char* cachePath, const unsigned char* blob)
+{
+	const assetcacheheader_t* header = (const assetcacheheader_t*)blob;
+	char tempPath[512];
+
+	// Write under a temporary name first so a crash never leaves a half-written cache.
+	FILE* file = snprintf(tempPath, sizeof(tempPath), "%s.tmp", cachePath) < (int)sizeof(tempPath) ?
+		platformOpenFile(tempPath, "wb") : NULL;
+	if (file == NULL) {
+		return;
+	}
+
+	size_t written = fwrite(blob, 1, (size_t)header->totalSize, file);
+	fclose(file);
+	if (written != header->totalSize) {
+		remove(tempPath);
+		return;
+	}
+
+	remove(cachePath);
+	if (rename(tempPath, cachePath) != 0) {
+		remove(tempPath);
+	}
+}
+
+// Refresh the source stamp in an existing cache file whose contents are still
+// current. Best effort: if the file can't be written (it's read-only, say) the
+// contents are checked against the source again next time.
+static void updateStamp(const char* cachePath, unsigned long long stampSize, long long stampModified)
+{
+	FILE* file = platformOpenFile(cachePath, "r+b");
+	if (file == NULL) {
+		return;
+	}
+
+	assetcacheheader_t header;
+	if (fread(&header, sizeof(header), 1, file) == 1) {
+		header.sourceSize = stampSize;
+		header.sourceModified = stampModified;
+		fseek(file, 0, SEEK_SET);
+		fwrite(&header, sizeof(header), 1, file);
+	}
+	fclose(file);
+}
+
+int assetLoadImage(const char* path, int planes, assetimage_t* asset)
+{
+	char cachePath[512];
+	unsigned long long stampSize = 0;
+	long long stampModified = 0;
+	const void* mapping = NULL;
+	size_t mappingSize = 0;
+
+	memset(asset, 0, sizeof(assetimage_t));
+
+	// A path too long for the cache's name goes without a cache.
+	int useCache = cacheEnabled && snprintf(cachePath, sizeof(cachePath), "%s.cache", path) < (int)sizeof(cachePath);
+
+	int haveSource = platformFileStamp(path, &stampSize, &stampModified);
+
+	if (useCache) {
+		mapping = platformMapFile(cachePath, &mappingSize);
+		if (mapping != NULL && !validateBlob(mapping, mappingSize, planes)) {
+			// Cache built for other planes or by another version: rebuild it with
+			// everything it had plus what's wanted now.
+			if (mappingSize >= sizeof(assetcacheheader_t) &&
+				((const assetcacheheader_t*)mapping)->magic == ASSET_CACHE_MAGIC &&
+				((const assetcacheheader_t*)mapping)->version == ASSET_CACHE_VERSION) {
+				planes |= ((const assetcacheheader_t*)mapping)->planes & (ASSET_PLANE_RGB | ASSET_PLANE_HEIGHT);
+			}
+			platformUnmapFile(mapping, mappingSize);
+			mapping = NULL;
+		}
+
+		// A matching source stamp (or a shipped cache without its source) is trusted as is.
+		if (mapping != NULL) {
+			const assetcacheheader_t* header = mapping;
+			if (!haveSource || (header->sourceSize == stampSize && header->sourceModified == stampModified)) {
+				asset->mapping = mapping;
+				asset->mappingSize = mappingSize;
+				asset->fromCache = 1;
+				usePlanes(asset, mapping, planes);
+				return 1;
+			}
+		}
+	}
+
+	size_t sourceSize;
+	unsigned char* source = platformReadFile(path, &sourceSize);
+	if (source == NULL) {
+		printf("Could not open %s\n", path);
+		platformUnmapFile(mapping, mappingSize);
+		return 0;
+	}
+
+	// The stamp changed but the contents may not have (e.g. a fresh checkout):
+	// keep using the mapping that's already been validated.
+	if (mapping != NULL) {
+		const assetcacheheader_t* header = mapping;
+		if (header->sourceHash == hashBytes(source, sourceSize)) {
+			free(source);
+			updateStamp(cachePath, stampSize, stampModified);
+			asset->mapping = mapping;
+			asset->mappingSize = mappingSize;
+			asset->fromCache = 1;
+			usePlanes(asset, mapping, planes);
+			return 1;
+		}
+		platformUnmapFile(mapping, mappingSize);
+	}
+
+	unsigned char* blob = buildBlob(source, sourceSize, planes, stampSize, stampModified);
+	free(source);
+	if (blob == NULL) {
+		return 0;
+	}
+
+	if (useCache) {
+		writeBlob(cachePath, blob);
+	}
+
+	asset->ownedMemory = blob;
+	usePlanes(asset, blob, planes);
+	return 1;
+}
+
+void assetRelease(assetimage_t* asset)
+{
+	platformUnmapFile(asset->mapping, asset->mappingSize);
+	free(asset->ownedMemory);
+	memset(asset, 0, sizeof(assetimage_t));
+}
@@ -0,0 +1,48 @@
+/******************************************************************************
+ *
+ * Binary Asset Cache
+ *
+ * The first time a PPM is loaded it's decoded once and written next to the
+ * source as "<file>.cache": a small header (including a hash of the source
+ * file) followed by ready-to-upload planes. Later runs map the cache file
+ * straight into memory and hand out pointers into it, so nothing is parsed
+ * or copied. A cache whose source has changed is rebuilt automatically.
+ *
+ ******************************************************************************/
+
+#ifndef ASSETCACHE_H
+#define ASSETCACHE_H
+
+#include <stddef.h>
+
+// Planes a cached image can carry.
+#define ASSET_PLANE_RGB		0x1		// width * height RGB triples (unsigned bytes, top row first)
+#define ASSET_PLANE_HEIGHT	0x2		// width * height luminance values (floats, 0-255)
+
+// A loaded image. The plane pointers point into the mapped cache file (or into
+// memory owned by the asset if the cache couldn't be used), and stay valid
+// until assetRelease().
+typedef struct {
+	int width;
+	int height;
+	const unsigned char* rgb;		// NULL unless ASSET_PLANE_RGB was requested
+	const float* heights;			// NULL unless ASSET_PLANE_HEIGHT was requested
+	int fromCache;					// 1 if the planes came from an existing cache file
+
+	// Private: how the planes are held.
+	const void* mapping;
+	size_t mappingSize;
+	void* ownedMemory;
+} assetimage_t;
+
+// Load a PPM (with the given ASSET_PLANE_ flags) through the cache.
+// Returns 0, with a message on stdout, if the image can't be loaded at all.
+int assetLoadImage(const char* path, int planes, assetimage_t* asset);
+
+// Unmap or free an asset's planes.
+void assetRelease(assetimage_t* asset);
+
+// Turn the cache off (or back on); when off, assets are decoded from the PPM every time.
+void assetCacheEnable(int enabled);
+
+#endif
@@ -0,0 +1,313 @@
+/******************************************************************************
+ *
+ * Benchmark Timings (see bench.h)
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "glstats.h"
+#include "platform.h"
+
+// Names reported for each section, in benchsection_t order.
+static const char* sectionNames[BENCH_SECTION_COUNT] = {
+	"drawSkyCylinder",
+	"drawTerrain",
+	"drawAtom",
+	"drawChopper",
+	"drawHelipad",
+	"drawSpotlight",
+	"drawWindmill",
+	"think"
+};
+
+// GL call counters reported alongside the timings (see glstats.h).
+static const struct {
+	const char* name;
+	size_t offset;
+} counterFields[] = {
+	{ "glVertex", offsetof(glstats_t, vertexCalls) },
+	{ "glNormal", offsetof(glstats_t, normalCalls) },
+	{ "glTexCoord", offsetof(glstats_t, texCoordCalls) },
+	{ "glColor", offsetof(glstats_t, colorCalls) },
+	{ "batches", offsetof(glstats_t, primitiveBatches) },
+	{ "arrayElements", offsetof(glstats_t, arrayElements) },
+	{ "glMaterial", offsetof(glstats_t, materialCalls) },
+	{ "glLight", offsetof(glstats_t, lightCalls) },
+	{ "glEnable", offsetof(glstats_t, enableCalls) },
+	{ "glDisable", offsetof(glstats_t, disableCalls) },
+	{ "glBindTexture", offsetof(glstats_t, bindTextureCalls) },
+	{ "savedCalls", offsetof(glstats_t, savedCalls) },
+	{ "glGenTextures", offsetof(glstats_t, genTextureCalls) },
+	{ "glTexImage2D", offsetof(glstats_t, texImageCalls) },
+	{ "shapes", offsetof(glstats_t, quadricCalls) },
+	{ "shapeTriangles", offsetof(glstats_t, quadricTriangles) },
+	{ "objectsDrawn", offsetof(glstats_t, objectsSubmitted) },
+	{ "objectsCulled", offsetof(glstats_t, objectsCulled) },
+	{ "objectsHidden", offsetof(glstats_t, objectsOccluded) },
+	{ "chunksDrawn", offsetof(glstats_t, chunksSubmitted) },
+	{ "chunksCulled", offsetof(glstats_t, chunksCulled) },
+	{ "chunksHidden", offsetof(glstats_t, chunksOccluded) }
+};
+
+#define NUM_COUNTER_FIELDS ((int)(sizeof(counterFields) / sizeof(counterFields[0])))
+
+// Timings for a single frame (all in seconds), plus its GL call counts.
+typedef struct {
+	double wall;
+	double cpu;
+	double sectionWall[BENCH_SECTION_COUNT];
+	double sectionCpu[BENCH_SECTION_COUNT];
+	glstats_t gl;
+} benchframe_t;
+
+static unsigned long getCounter(const glstats_t* stats, int field)
+{
+	return *(const unsigned long*)((const char*)stats + counterFields[field].offset);
+}
+
+static benchframe_t* frames = NULL;
+static int frameCapacity = 0;
+static int frameCount = 0;
+static int active = 0;
+static int syncBeforeTiming = 0;
+
+// Start times of the frame and of each open section.
+static double frameWallStart, frameCpuStart;
+static double sectionWallStart[BENCH_SECTION_COUNT];
+static double sectionCpuStart[BENCH_SECTION_COUNT];
+
+int benchStart(int maxFrames, int syncGL)
+{
+	benchStop();
+
+	frames = calloc((size_t)maxFrames, sizeof(benchframe_t));
+	if (frames == NULL) {
+		return 0;
+	}
+
+	frameCapacity = maxFrames;
+	frameCount = 0;
+	syncBeforeTiming = syncGL;
+	active = 1;
+	return 1;
+}
+
+int benchIsActive(void)
+{
+	return active;
+}
+
+void benchBeginFrame(void)
+{
+	if (!active || frameCount >= frameCapacity) {
+		return;
+	}
+
+	memset(&frames[frameCount], 0, sizeof(benchframe_t));
+	frameWallStart = platformTimeSeconds();
+	frameCpuStart = platformCpuTimeSeconds();
+}
+
+void benchEndFrame(void)
+{
+	if (!active || frameCount >= frameCapacity) {
+		return;
+	}
+
+	frames[frameCount].wall = platformTimeSeconds() - frameWallStart;
+	frames[frameCount].cpu = platformCpuTimeSeconds() - frameCpuStart;
+	frames[frameCount].gl = *glStatsLastFrame();
+	frameCount++;
+}
+
+void benchBeginSection(benchsection_t section)
+{
+	if (!active || frameCount >= frameCapacity) {
+		return;
+	}
+
+	// Don't charge work queued by the previous section to this one.
+	if (syncBeforeTiming) {
+		glFinish();
+	}
+
+	sectionWallStart[section] = platformTimeSeconds();
+	sectionCpuStart[section] = platformCpuTimeSeconds();
+}
+
+void benchEndSection(benchsection_t section)
+{
+	if (!active || frameCount >= frameCapacity) {
+		return;
+	}
+
+	if (syncBeforeTiming) {
+		glFinish();
+	}
+
+	frames[frameCount].sectionWall[section] += platformTimeSeconds() - sectionWallStart[section];
+	frames[frameCount].sectionCpu[section] += platformCpuTimeSeconds() - sectionCpuStart[section];
+}
+
+/******************************************************************************
+ * Reporting
+ ******************************************************************************/
+
+static int compareDoubles(const void* a, const void* b)
+{
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+// Pull one column out of the recorded frames (section < 0 selects the frame total).
+static void gatherColumn(int section, int cpu, double* out)
+{
+	for (int i = 0; i < frameCount; i++) {
+		if (section < 0) {
+			out[i] = cpu ? frames[i].cpu : frames[i].wall;
+		}
+		else {
+			out[i] = cpu ? frames[i].sectionCpu[section] : frames[i].sectionWall[section];
+		}
+	}
+}
+
+static void printSummaryRow(const char* name, int section, double* scratch)
+{
+	double sum = 0.0, cpuSum = 0.0;
+
+	gatherColumn(section, 1, scratch);
+	for (int i = 0; i < frameCount; i++) {
+		cpuSum += scratch[i];
+	}
+
+	gatherColumn(section, 0, scratch);
+	for (int i = 0; i < frameCount; i++) {
+		sum += scratch[i];
+	}
+	qsort(scratch, frameCount, sizeof(double), compareDoubles);
+
+	printf("%-16s %10.3f %10.3f %10.3f %10.3f %10.3f\n", name,
+		sum / frameCount * 1000.0,
+		scratch[frameCount / 2] * 1000.0,
+		scratch[(frameCount * 95) / 100] * 1000.0,
+		scratch[frameCount - 1] * 1000.0,
+		cpuSum / frameCount * 1000.0);
+}
+
+void benchPrintSummary(void)
+{
+	if (frameCount == 0) {
+		printf("No benchmark frames recorded.\n");
+		return;
+	}
+
+	double* scratch = malloc(sizeof(double) * frameCount);
+	if (scratch == NULL) {
+		return;
+	}
+
+	printf("\n%d frames (times in ms)\n", frameCount);
+	printf("%-16s %10s %10s %10s %10s %10s\n", "section", "mean", "median", "p95", "max", "cpu mean");
+	for (int s = 0; s < BENCH_SECTION_COUNT; s++) {
+		printSummaryRow(sectionNames[s], s, scratch);
+	}
+	printSummaryRow("frame", -1, scratch);
+
+#ifdef GL_STATS
+	double bytes = 0.0;
+	printf("\nGL calls per frame (mean)\n");
+	for (int c = 0; c < NUM_COUNTER_FIELDS; c++) {
+		double sum = 0.0;
+		for (int i = 0; i < frameCount; i++) {
+			sum += getCounter(&frames[i].gl, c);
+		}
+		printf("%-16s %12.1f\n", counterFields[c].name, sum / frameCount);
+	}
+	for (int i = 0; i < frameCount; i++) {
+		bytes += (double)frames[i].gl.bytesUploaded;
+	}
+	printf("%-16s %12.1f\n", "bytesUploaded", bytes / frameCount);
+#endif
+
+	free(scratch);
+}
+
+static void writeCsv(FILE* file)
+{
+	fprintf(file, "frame,wall_ms,cpu_ms");
+	for (int s = 0; s < BENCH_SECTION_COUNT; s++) {
+		fprintf(file, ",%s_wall_ms,%s_cpu_ms", sectionNames[s], sectionNames[s]);
+	}
+	for (int c = 0; c < NUM_COUNTER_FIELDS; c++) {
+		fprintf(file, ",%s", counterFields[c].name);
+	}
+	fprintf(file, ",bytesUploaded\n");
+
+	for (int i = 0; i < frameCount; i++) {
+		fprintf(file, "%d,%.4f,%.4f", i, frames[i].wall * 1000.0, frames[i].cpu * 1000.0);
+		for (int s = 0; s < BENCH_SECTION_COUNT; s++) {
+			fprintf(file, ",%.4f,%.4f", frames[i].sectionWall[s] * 1000.0, frames[i].sectionCpu[s] * 1000.0);
+		}
+		for (int c = 0; c < NUM_COUNTER_FIELDS; c++) {
+			fprintf(file, ",%lu", getCounter(&frames[i].gl, c));
+		}
+		fprintf(file, ",%llu\n", frames[i].gl.bytesUploaded);
+	}
+}
+
+static void writeJson(FILE* file)
+{
+	fprintf(file, "{\n  \"frameCount\": %d,\n  \"units\": \"ms\",\n  \"sections\": [", frameCount);
+	for (int s = 0; s < BENCH_SECTION_COUNT; s++) {
+		fprintf(file, "%s\"%s\"", s > 0 ? ", " : "", sectionNames[s]);
+	}
+	fprintf(file, "],\n  \"frames\": [\n");
+
+	for (int i = 0; i < frameCount; i++) {
+		fprintf(file, "    { \"frame\": %d, \"wall\": %.4f, \"cpu\": %.4f", i, frames[i].wall * 1000.0, frames[i].cpu * 1000.0);
+		for (int s = 0; s < BENCH_SECTION_COUNT; s++) {
+			fprintf(file, ", \"%s\": { \"wall\": %.4f, \"cpu\": %.4f }", sectionNames[s],
+				frames[i].sectionWall[s] * 1000.0, frames[i].sectionCpu[s] * 1000.0);
+		}
+		fprintf(file, ", \"gl\": {");
+		for (int c = 0; c < NUM_COUNTER_FIELDS; c++) {
+			fprintf(file, " \"%s\": %lu,", counterFields[c].name, getCounter(&frames[i].gl, c));
+		}
+		fprintf(file, " \"bytesUploaded\": %llu }", frames[i].gl.bytesUploaded);
+		fprintf(file, " }%s\n", i + 1 < frameCount ? "," : "");
+	}
+	fprintf(file, "  ]\n}\n");
+}
+
+int benchWriteResults(const char* path)
+{
+	FILE* file = platformOpenFile(path, "w");
+	if (file == NULL) {
+		return 0;
+	}
+
+	size_t length = strlen(path);
+	if (length >= 5 && strcmp(path + length - 5, ".json") == 0) {
+		writeJson(file);
+	}
+	else {
+		writeCsv(file);
+	}
+
+	fclose(file);
+	return 1;
+}
+
+void benchStop(void)
+{
+	free(frames);
+	frames = NULL;
+	frameCapacity = 0;
+	frameCount = 0;
+	active = 0;
+}
@@ -0,0 +1,57 @@
+/******************************************************************************
+ *
+ * Benchmark Timings
+ *
+ * Collects wall clock and CPU time per frame, broken down into named sections
+ * (one per draw function plus think()), and writes them out as CSV or JSON for
+ * the --bench mode along with each frame's GL call counts (see glstats.h).
+ * When no benchmark is running the section markers return immediately, so
+ * they can stay in the render loop permanently.
+ *
+ ******************************************************************************/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+// Sections timed within each frame (add new sections before BENCH_SECTION_COUNT
+// and give them a name in bench.c).
+typedef enum {
+	BENCH_SKY_CYLINDER = 0,
+	BENCH_TERRAIN,
+	BENCH_ATOM,
+	BENCH_CHOPPER,
+	BENCH_HELIPAD,
+	BENCH_SPOTLIGHT,
+	BENCH_WINDMILL,
+	BENCH_THINK,
+	BENCH_SECTION_COUNT
+} benchsection_t;
+
+// Start recording up to maxFrames frames. When syncGL is set, each section waits
+// for OpenGL to finish (glFinish) before it's timed, so that rendering work is
+// charged to the section that issued it rather than to whichever call stalls later.
+int benchStart(int maxFrames, int syncGL);
+
+// Non-zero while a benchmark is recording.
+int benchIsActive(void);
+
+// Mark the start and end of a frame (everything between is the frame's total time).
+void benchBeginFrame(void);
+void benchEndFrame(void);
+
+// Mark the start and end of a section within the current frame. A section may be
+// entered several times per frame (e.g. once per windmill); the times add up.
+void benchBeginSection(benchsection_t section);
+void benchEndSection(benchsection_t section);
+
+// Print a per-section summary (mean, median, 95th percentile, max) to stdout.
+void benchPrintSummary(void);
+
+// Write every recorded frame to a file. The format is picked from the file
+// extension: ".json" writes JSON, anything else writes CSV. Returns 0 on failure.
+int benchWriteResults(const char* path);
+
+// Release everything recorded.
+void benchStop(void);
+
+#endif
@@ -0,0 +1,261 @@
+/******************************************************************************
+ *
+ * View Frustum Culling (see culling.h)
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "culling.h"
+
+// SSE2 is always there on x64 (and on x86 when MSVC is told to use it).
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CULLING_SSE
+#include <emmintrin.h>
+#endif
+
+#define BOUNDS(bounds, stride, i) ((const bounds_t*)((const char*)(bounds) + (size_t)(i) * (stride)))
+
+/******************************************************************************
+ * Frustum
+ ******************************************************************************/
+
+// Gribb and Hartmann's extraction: each plane is the clip matrix's last row
+// plus or minus one of the others.
+void frustumExtract(frustum_t* frustum, const GLfloat* projection, const GLfloat* modelview)
+{
+	static const int rows[6] = { 0, 0, 1, 1, 2, 2 };
+	static const GLfloat signs[6] = { 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f };
+	GLfloat clip[16];
+
+	for (int j = 0; j < 4; j++) {
+		for (int i = 0; i < 4; i++) {
+			clip[i + 4 * j] = projection[i] * modelview[4 * j] + projection[i + 4] * modelview[4 * j + 1]
+				+ projection[i + 8] * modelview[4 * j + 2] + projection[i + 12] * modelview[4 * j + 3];
+		}
+	}
+
+	for (int p = 0; p < 6; p++) {
+		int r = rows[p];
+		frustum->a[p] = clip[3] + signs[p] * clip[r];
+		frustum->b[p] = clip[7] + signs[p] * clip[r + 4];
+		frustum->c[p] = clip[11] + signs[p] * clip[r + 8];
+		frustum->d[p] = clip[15] + signs[p] * clip[r + 12];
+	}
+	for (int p = 6; p < 8; p++) {
+		frustum->a[p] = frustum->b[p] = frustum->c[p] = 0.0f;
+		frustum->d[p] = 1.0f;
+	}
+}
+
+// A box is outside a plane when its corner furthest along the plane's normal
+// is, and inside when its nearest corner is: from its centre, the distance
+// plus or minus the box's extent projected onto the normal.
+int frustumClassify(const frustum_t* frustum, const bounds_t* bounds)
+{
+	GLfloat cx = (bounds->min[0] + bounds->max[0]) * 0.5f, ex = (bounds->max[0] - bounds->min[0]) * 0.5f;
+	GLfloat cy = (bounds->min[1] + bounds->max[1]) * 0.5f, ey = (bounds->max[1] - bounds->min[1]) * 0.5f;
+	GLfloat cz = (bounds->min[2] + bounds->max[2]) * 0.5f, ez = (bounds->max[2] - bounds->min[2]) * 0.5f;
+
+#ifdef CULLING_SSE
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	__m128 outside = _mm_setzero_ps(), partly = _mm_setzero_ps();
+
+	for (int p = 0; p < 8; p += 4) {
+		__m128 a = _mm_loadu_ps(frustum->a + p), b = _mm_loadu_ps(frustum->b + p), c = _mm_loadu_ps(frustum->c + p);
+		__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, _mm_set1_ps(cx)), _mm_mul_ps(b, _mm_set1_ps(cy))),
+			_mm_add_ps(_mm_mul_ps(c, _mm_set1_ps(cz)), _mm_loadu_ps(frustum->d + p)));
+		__m128 extent = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_and_ps(a, absMask), _mm_set1_ps(ex)),
+			_mm_mul_ps(_mm_and_ps(b, absMask), _mm_set1_ps(ey))), _mm_mul_ps(_mm_and_ps(c, absMask), _mm_set1_ps(ez)));
+		outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, extent), _mm_setzero_ps()));
+		partly = _mm_or_ps(partly, _mm_cmplt_ps(_mm_sub_ps(distance, extent), _mm_setzero_ps()));
+	}
+	if (_mm_movemask_ps(outside)) {
+		return CULL_OUTSIDE;
+	}
+	return _mm_movemask_ps(partly) ? CULL_PARTLY : CULL_INSIDE;
+#else
+	int result = CULL_INSIDE;
+
+	for (int p = 0; p < 6; p++) {
+		GLfloat distance = frustum->a[p] * cx + frustum->b[p] * cy + frustum->c[p] * cz + frustum->d[p];
+		GLfloat extent = fabsf(frustum->a[p]) * ex + fabsf(frustum->b[p]) * ey + fabsf(frustum->c[p]) * ez;
+		if (distance + extent < 0.0f) {
+			return CULL_OUTSIDE;
+		}
+		if (distance - extent < 0.0f) {
+			result = CULL_PARTLY;
+		}
+	}
+	return result;
+#endif
+}
+
+/******************************************************************************
+ * Bounding Volume Hierarchy
+ ******************************************************************************/
+
+static GLfloat centre(const bounds_t* bounds, size_t stride, int item, int axis)
+{
+	const bounds_t* box = BOUNDS(bounds, stride, item);
+	return box->min[axis] + box->max[axis];
+}
+
+// Partially sort items[first, last) along the axis so the median is at mid,
+// with nothing after it that should be before it and vice versa.
+static void selectMedian(int* items, int first, int last, int mid, const bounds_t* bounds, size_t stride, int axis)
+{
+	while (last - first > 1) {
+		GLfloat pivot = centre(bounds, stride, items[(first + last) / 2], axis);
+		int i = first, j = last - 1;
+
+		while (i <= j) {
+			while (centre(bounds, stride, items[i], axis) < pivot) {
+				i++;
+			}
+			while (centre(bounds, stride, items[j], axis) > pivot) {
+				j--;
+			}
+			if (i <= j) {
+				int swap = items[i];
+				items[i++] = items[j];
+				items[j--] = swap;
+			}
+		}
+		if (mid <= j) {
+			last = j + 1;
+		}
+		else if (mid >= i) {
+			first = i;
+		}
+		else {
+			return;
+		}
+	}
+}
+
+static void buildNode(bvh_t* bvh, int node, const bounds_t* bounds, size_t stride)
+{
+	bvhnode_t* n = &bvh->nodes[node];
+	GLfloat low[3], high[3];
+
+	n->bounds = *BOUNDS(bounds, stride, bvh->items[n->first]);
+	for (int axis = 0; axis < 3; axis++) {
+		low[axis] = high[axis] = centre(bounds, stride, bvh->items[n->first], axis);
+	}
+	for (int i = n->first + 1; i < n->first + n->count; i++) {
+		const bounds_t* box = BOUNDS(bounds, stride, bvh->items[i]);
+		for (int axis = 0; axis < 3; axis++) {
+			GLfloat c = box->min[axis] + box->max[axis];
+			n->bounds.min[axis] = box->min[axis] < n->bounds.min[axis] ? box->min[axis] : n->bounds.min[axis];
+			n->bounds.max[axis] = box->max[axis] > n->bounds.max[axis] ? box->max[axis] : n->bounds.max[axis];
+			low[axis] = c < low[axis] ? c : low[axis];
+			high[axis] = c > high[axis] ? c : high[axis];
+		}
+	}
+
+	n->children = 0;
+	if (n->count <= BVH_LEAF_ITEMS) {
+		return;
+	}
+
+	// Split at the median of the axis the centres spread furthest along.
+	int axis = 0;
+	for (int i = 1; i < 3; i++) {
+		if (high[i] - low[i] > high[axis] - low[axis]) {
+			axis = i;
+		}
+	}
+	int first = n->first, count = n->count, half = count / 2;
+	selectMedian(bvh->items, first, first + count, first + half, bounds, stride, axis);
+
+	int children = bvh->nodeCount;
+	bvh->nodeCount += 2;
+	bvh->nodes[node].children = children;
+	bvh->nodes[children].first = first;
+	bvh->nodes[children].count = half;
+	bvh->nodes[children + 1].first = first + half;
+	bvh->nodes[children + 1].count = count - half;
+	buildNode(bvh, children, bounds, stride);
+	buildNode(bvh, children + 1, bounds, stride);
+}
+
+int bvhBuild(bvh_t* bvh, const bounds_t* bounds, size_t stride, int count)
+{
+	bvh->itemCount = 0;
+	bvh->nodeCount = 0;
+	if (count > bvh->capacity) {
+		int* items = realloc(bvh->items, sizeof(int) * count);
+		if (items == NULL) {
+			return 0;
+		}
+		bvh->items = items;
+		bvhnode_t* nodes = realloc(bvh->nodes, sizeof(bvhnode_t) * 2 * count);
+		if (nodes == NULL) {
+			return 0;
+		}
+		bvh->nodes = nodes;
+		bvh->capacity = count;
+	}
+
+	bvh->itemCount = count;
+	if (count == 0) {
+		return 1;
+	}
+	for (int i = 0; i < count; i++) {
+		bvh->items[i] = i;
+	}
+	bvh->nodeCount = 1;
+	bvh->nodes[0].first = 0;
+	bvh->nodes[0].count = count;
+	buildNode(bvh, 0, bounds, stride);
+	return 1;
+}
+
+int bvhCull(const bvh_t* bvh, const bounds_t* bounds, size_t stride, const frustum_t* frustum,
+	unsigned char* visible)
+{
+	int stack[64], depth = 0, count = 0;
+
+	if (bvh->nodeCount == 0) {
+		return 0;
+	}
+	memset(visible, 0, bvh->itemCount);
+	stack[depth++] = 0;
+	while (depth > 0) {
+		const bvhnode_t* node = &bvh->nodes[stack[--depth]];
+		int where = frustumClassify(frustum, &node->bounds);
+
+		if (where == CULL_OUTSIDE) {
+			continue;
+		}
+		if (where == CULL_INSIDE) {
+			for (int i = node->first; i < node->first + node->count; i++) {
+				visible[bvh->items[i]] = 1;
+			}
+			count += node->count;
+		}
+		else if (node->children != 0) {
+			stack[depth++] = node->children;
+			stack[depth++] = node->children + 1;
+		}
+		else {
+			for (int i = node->first; i < node->first + node->count; i++) {
+				int item = bvh->items[i];
+				if (frustumClassify(frustum, BOUNDS(bounds, stride, item)) != CULL_OUTSIDE) {
+					visible[item] = 1;
+					count++;
+				}
+			}
+		}
+	}
+	return count;
+}
+
+void bvhFree(bvh_t* bvh)
+{
+	free(bvh->nodes);
+	free(bvh->items);
+	memset(bvh, 0, sizeof(*bvh));
+}
@@ -0,0 +1,76 @@
+/******************************************************************************
+ *
+ * View Frustum Culling
+ *
+ * Axis-aligned bounding boxes, the view frustum of a projection and
+ * modelview pair, and a bounding volume hierarchy to cull many boxes against
+ * it a subtree at a time: a subtree wholly outside the frustum is skipped,
+ * and one wholly inside is accepted without testing anything under it. Each
+ * box is tested against four of the frustum's planes at once with SSE where
+ * the compiler targets it.
+ *
+ * Items are only ever culled when they're certainly outside, so anything
+ * straddling the frustum's edge is kept.
+ *
+ ******************************************************************************/
+
+#ifndef CULLING_H
+#define CULLING_H
+
+#include <freeglut.h>
+#include <stddef.h>
+
+// Most items in a leaf of a bounding volume hierarchy.
+#define BVH_LEAF_ITEMS 4
+
+// Where a box is relative to the frustum.
+#define CULL_OUTSIDE	0
+#define CULL_PARTLY		1
+#define CULL_INSIDE		2
+
+typedef struct {
+	GLfloat min[3];
+	GLfloat max[3];
+} bounds_t;
+
+// The frustum's six planes (inside where ax + by + cz + d >= 0), as columns
+// of coefficients padded to eight with planes everything is inside of.
+typedef struct {
+	GLfloat a[8], b[8], c[8], d[8];
+} frustum_t;
+
+typedef struct {
+	bounds_t bounds;		// Of everything under the node
+	int first, count;		// The items under the node, in bvh_t.items
+	int children;			// First of the node's two children (the second follows it); 0 for leaves
+} bvhnode_t;
+
+typedef struct {
+	bvhnode_t* nodes;		// The root first
+	int nodeCount;
+	int* items;				// Item numbers, each subtree's together
+	int itemCount;
+	int capacity;			// Items there's room for (and twice as many nodes)
+} bvh_t;
+
+// Extract the frustum of the projection and modelview matrices (column-major),
+// in the modelview's object space.
+void frustumExtract(frustum_t* frustum, const GLfloat* projection, const GLfloat* modelview);
+
+// CULL_ value for a box.
+int frustumClassify(const frustum_t* frustum, const bounds_t* bounds);
+
+// Build a hierarchy over count boxes, stride bytes apart (so they can be a
+// field of an array of larger structures). Reuses the hierarchy's memory;
+// returns 0 if it runs out.
+int bvhBuild(bvh_t* bvh, const bounds_t* bounds, size_t stride, int count);
+
+// Set visible[i] to 1 for each of the boxes the hierarchy was built from
+// that may be in the frustum, and 0 for the rest; returns how many are
+// visible.
+int bvhCull(const bvh_t* bvh, const bounds_t* bounds, size_t stride, const frustum_t* frustum,
+	unsigned char* visible);
+
+void bvhFree(bvh_t* bvh);
+
+#endif
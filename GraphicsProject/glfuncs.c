@@ -0,0 +1,100 @@
+/******************************************************************************
+ *
+ * OpenGL Entry Points (see glfuncs.h)
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "glfuncs.h"
+#include "platform.h"
+
+glfuncs_t glFuncs;
+
+// Look up each named function into the consecutive pointers starting at first.
+// Returns 1 if every one of them was found.
+static int loadGroup(void* first, const char* const* names, int count)
+{
+	void** pointers = first;
+	int found = 1;
+
+	for (int i = 0; i < count; i++) {
+		pointers[i] = platformGetProcAddress(names[i]);
+		if (pointers[i] == NULL) {
+			found = 0;
+		}
+	}
+	return found;
+}
+
+// Whether the context is version major.minor or later, going by GL_VERSION
+// ("major.minor" first, whatever follows).
+static int hasVersion(int major, int minor)
+{
+	const char* version = (const char*)glGetString(GL_VERSION);
+	int contextMajor = 0, contextMinor = 0;
+
+	if (version == NULL || sscanf(version, "%d.%d", &contextMajor, &contextMinor) != 2) {
+		return 0;
+	}
+	return contextMajor > major || (contextMajor == major && contextMinor >= minor);
+}
+
+// Whether GL_EXTENSIONS lists name as a whole word. Only asked of contexts
+// older than 3.1, which all still answer it.
+static int hasExtension(const char* name)
+{
+	const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+	size_t length = strlen(name);
+
+	for (const char* found = extensions; found != NULL && (found = strstr(found, name)) != NULL; found += length) {
+		if ((found == extensions || found[-1] == ' ') && (found[length] == ' ' || found[length] == '\0')) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+void glFuncsLoad(void)
+{
+	static const char* const bufferNames[] = {
+		"glGenBuffers", "glDeleteBuffers", "glBindBuffer", "glBufferData", "glBufferSubData"
+	};
+
+	static const char* const shaderNames[] = {
+		"glCreateShader", "glShaderSource", "glCompileShader", "glGetShaderiv", "glGetShaderInfoLog",
+		"glDeleteShader", "glCreateProgram", "glAttachShader", "glBindAttribLocation", "glLinkProgram",
+		"glGetProgramiv", "glGetProgramInfoLog", "glDeleteProgram", "glUseProgram", "glGetUniformLocation",
+		"glUniform1i", "glUniform1iv", "glUniform1f", "glUniform3fv", "glUniform4fv", "glUniformMatrix4fv",
+		"glVertexAttribPointer", "glEnableVertexAttribArray", "glDisableVertexAttribArray"
+	};
+	static const char* const instancingNames[] = {
+		"glVertexAttribDivisor", "glDrawElementsInstanced"
+	};
+	static const char* const uniformBufferNames[] = {
+		"glGenVertexArrays", "glDeleteVertexArrays", "glBindVertexArray", "glGetUniformBlockIndex",
+		"glUniformBlockBinding", "glBindBufferBase", "glVertexAttrib4fv"
+	};
+
+	// Some platforms hand out a pointer for any name at all, so finding the
+	// functions isn't enough: the context has to claim the version (or, for
+	// uniform buffers, the extensions, which use the same names) too.
+	memset(&glFuncs, 0, sizeof(glFuncs));
+	glFuncs.hasBuffers = loadGroup(&glFuncs.GenBuffers, bufferNames, sizeof(bufferNames) / sizeof(bufferNames[0])) &&
+		hasVersion(1, 5);
+	glFuncs.hasShaders = loadGroup(&glFuncs.CreateShader, shaderNames, sizeof(shaderNames) / sizeof(shaderNames[0])) &&
+		hasVersion(2, 0);
+	glFuncs.hasInstancing = glFuncs.hasShaders &&
+		loadGroup(&glFuncs.VertexAttribDivisor, instancingNames, sizeof(instancingNames) / sizeof(instancingNames[0])) &&
+		hasVersion(3, 3);
+	glFuncs.hasUniformBuffers = glFuncs.hasShaders &&
+		loadGroup(&glFuncs.GenVertexArrays, uniformBufferNames, sizeof(uniformBufferNames) / sizeof(uniformBufferNames[0])) &&
+		(hasVersion(3, 1) ||
+			(hasExtension("GL_ARB_vertex_array_object") && hasExtension("GL_ARB_uniform_buffer_object")));
+
+	// Only 3.2 and later know the query; older contexts just flag an error, which is cleared.
+	GLint profile = 0;
+	glGetIntegerv(GL_CONTEXT_PROFILE_MASK, &profile);
+	glGetError();
+	glFuncs.coreProfile = (profile & GL_CONTEXT_CORE_PROFILE_BIT) != 0;
+}
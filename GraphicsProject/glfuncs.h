@@ -0,0 +1,167 @@
+/******************************************************************************
+ *
+ * OpenGL Entry Points
+ *
+ * Everything past OpenGL 1.1 has to be looked up at runtime on Windows (and
+ * may be missing on old drivers anywhere), so those functions are called
+ * through the pointers in glFuncs, loaded by glFuncsLoad() once a context
+ * exists. The usual GL names are defined as macros for them, so calling code
+ * looks like plain OpenGL. The constants and types used with them are defined
+ * here too in case the system's GL headers stop at 1.1.
+ *
+ ******************************************************************************/
+
+#ifndef GLFUNCS_H
+#define GLFUNCS_H
+
+#include <stddef.h>
+#include <freeglut.h>
+
+#ifdef _WIN32
+#define GLFUNCS_APIENTRY __stdcall
+#else
+#define GLFUNCS_APIENTRY
+#endif
+
+#ifndef GL_VERSION_1_5
+typedef ptrdiff_t GLsizeiptr;
+typedef ptrdiff_t GLintptr;
+#endif
+
+#ifndef GL_VERSION_2_0
+typedef char GLchar;
+#endif
+
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER					0x8892
+#define GL_ELEMENT_ARRAY_BUFFER			0x8893
+#define GL_STATIC_DRAW					0x88E4
+#define GL_DYNAMIC_DRAW					0x88E8
+#define GL_STREAM_DRAW					0x88E0
+#endif
+
+#ifndef GL_VERTEX_SHADER
+#define GL_FRAGMENT_SHADER				0x8B30
+#define GL_VERTEX_SHADER				0x8B31
+#define GL_COMPILE_STATUS				0x8B81
+#define GL_LINK_STATUS					0x8B82
+#define GL_INFO_LOG_LENGTH				0x8B84
+#endif
+
+#ifndef GL_UNIFORM_BUFFER
+#define GL_UNIFORM_BUFFER				0x8A11
+#define GL_INVALID_INDEX				0xFFFFFFFFu
+#endif
+
+#ifndef GL_CONTEXT_PROFILE_MASK
+#define GL_CONTEXT_PROFILE_MASK			0x9126
+#define GL_CONTEXT_CORE_PROFILE_BIT		0x00000001
+#endif
+
+typedef struct {
+	// Buffer objects (OpenGL 1.5)
+	int hasBuffers;
+	void (GLFUNCS_APIENTRY* GenBuffers)(GLsizei n, GLuint* buffers);
+	void (GLFUNCS_APIENTRY* DeleteBuffers)(GLsizei n, const GLuint* buffers);
+	void (GLFUNCS_APIENTRY* BindBuffer)(GLenum target, GLuint buffer);
+	void (GLFUNCS_APIENTRY* BufferData)(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+	void (GLFUNCS_APIENTRY* BufferSubData)(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+
+	// Shaders and generic vertex attributes (OpenGL 2.0)
+	int hasShaders;
+	GLuint (GLFUNCS_APIENTRY* CreateShader)(GLenum type);
+	void (GLFUNCS_APIENTRY* ShaderSource)(GLuint shader, GLsizei count, const GLchar* const* strings, const GLint* lengths);
+	void (GLFUNCS_APIENTRY* CompileShader)(GLuint shader);
+	void (GLFUNCS_APIENTRY* GetShaderiv)(GLuint shader, GLenum name, GLint* value);
+	void (GLFUNCS_APIENTRY* GetShaderInfoLog)(GLuint shader, GLsizei size, GLsizei* length, GLchar* log);
+	void (GLFUNCS_APIENTRY* DeleteShader)(GLuint shader);
+	GLuint (GLFUNCS_APIENTRY* CreateProgram)(void);
+	void (GLFUNCS_APIENTRY* AttachShader)(GLuint program, GLuint shader);
+	void (GLFUNCS_APIENTRY* BindAttribLocation)(GLuint program, GLuint index, const GLchar* name);
+	void (GLFUNCS_APIENTRY* LinkProgram)(GLuint program);
+	void (GLFUNCS_APIENTRY* GetProgramiv)(GLuint program, GLenum name, GLint* value);
+	void (GLFUNCS_APIENTRY* GetProgramInfoLog)(GLuint program, GLsizei size, GLsizei* length, GLchar* log);
+	void (GLFUNCS_APIENTRY* DeleteProgram)(GLuint program);
+	void (GLFUNCS_APIENTRY* UseProgram)(GLuint program);
+	GLint (GLFUNCS_APIENTRY* GetUniformLocation)(GLuint program, const GLchar* name);
+	void (GLFUNCS_APIENTRY* Uniform1i)(GLint location, GLint value);
+	void (GLFUNCS_APIENTRY* Uniform1iv)(GLint location, GLsizei count, const GLint* values);
+	void (GLFUNCS_APIENTRY* Uniform1f)(GLint location, GLfloat value);
+	void (GLFUNCS_APIENTRY* Uniform3fv)(GLint location, GLsizei count, const GLfloat* values);
+	void (GLFUNCS_APIENTRY* Uniform4fv)(GLint location, GLsizei count, const GLfloat* values);
+	void (GLFUNCS_APIENTRY* UniformMatrix4fv)(GLint location, GLsizei count, GLboolean transpose, const GLfloat* values);
+	void (GLFUNCS_APIENTRY* VertexAttribPointer)(GLuint index, GLint size, GLenum type, GLboolean normalized,
+		GLsizei stride, const void* pointer);
+	void (GLFUNCS_APIENTRY* EnableVertexAttribArray)(GLuint index);
+	void (GLFUNCS_APIENTRY* DisableVertexAttribArray)(GLuint index);
+
+	// Instanced drawing (OpenGL 3.3)
+	int hasInstancing;
+	void (GLFUNCS_APIENTRY* VertexAttribDivisor)(GLuint index, GLuint divisor);
+	void (GLFUNCS_APIENTRY* DrawElementsInstanced)(GLenum mode, GLsizei count, GLenum type, const void* indices,
+		GLsizei instances);
+
+	// Vertex array objects and uniform buffers (OpenGL 3.0 and 3.1)
+	int hasUniformBuffers;
+	void (GLFUNCS_APIENTRY* GenVertexArrays)(GLsizei n, GLuint* arrays);
+	void (GLFUNCS_APIENTRY* DeleteVertexArrays)(GLsizei n, const GLuint* arrays);
+	void (GLFUNCS_APIENTRY* BindVertexArray)(GLuint array);
+	GLuint (GLFUNCS_APIENTRY* GetUniformBlockIndex)(GLuint program, const GLchar* name);
+	void (GLFUNCS_APIENTRY* UniformBlockBinding)(GLuint program, GLuint block, GLuint binding);
+	void (GLFUNCS_APIENTRY* BindBufferBase)(GLenum target, GLuint index, GLuint buffer);
+	void (GLFUNCS_APIENTRY* VertexAttrib4fv)(GLuint index, const GLfloat* values);
+
+	// 1 if the context is a core profile one: no fixed-function pipeline at all.
+	int coreProfile;
+} glfuncs_t;
+
+extern glfuncs_t glFuncs;
+
+// Look up every entry point in the current context and set the has* flags for
+// the groups that are complete and that the context's version (or extensions)
+// says it supports. Call again after creating a new context.
+void glFuncsLoad(void);
+
+#define glGenBuffers glFuncs.GenBuffers
+#define glDeleteBuffers glFuncs.DeleteBuffers
+#define glBindBuffer glFuncs.BindBuffer
+#define glBufferData glFuncs.BufferData
+#define glBufferSubData glFuncs.BufferSubData
+
+#define glCreateShader glFuncs.CreateShader
+#define glShaderSource glFuncs.ShaderSource
+#define glCompileShader glFuncs.CompileShader
+#define glGetShaderiv glFuncs.GetShaderiv
+#define glGetShaderInfoLog glFuncs.GetShaderInfoLog
+#define glDeleteShader glFuncs.DeleteShader
+#define glCreateProgram glFuncs.CreateProgram
+#define glAttachShader glFuncs.AttachShader
+#define glBindAttribLocation glFuncs.BindAttribLocation
+#define glLinkProgram glFuncs.LinkProgram
+#define glGetProgramiv glFuncs.GetProgramiv
+#define glGetProgramInfoLog glFuncs.GetProgramInfoLog
+#define glDeleteProgram glFuncs.DeleteProgram
+#define glUseProgram glFuncs.UseProgram
+#define glGetUniformLocation glFuncs.GetUniformLocation
+#define glUniform1i glFuncs.Uniform1i
+#define glUniform1iv glFuncs.Uniform1iv
+#define glUniform1f glFuncs.Uniform1f
+#define glUniform3fv glFuncs.Uniform3fv
+#define glUniform4fv glFuncs.Uniform4fv
+#define glUniformMatrix4fv glFuncs.UniformMatrix4fv
+#define glVertexAttribPointer glFuncs.VertexAttribPointer
+#define glEnableVertexAttribArray glFuncs.EnableVertexAttribArray
+#define glDisableVertexAttribArray glFuncs.DisableVertexAttribArray
+
+#define glVertexAttribDivisor glFuncs.VertexAttribDivisor
+#define glDrawElementsInstanced glFuncs.DrawElementsInstanced
+
+#define glGenVertexArrays glFuncs.GenVertexArrays
+#define glDeleteVertexArrays glFuncs.DeleteVertexArrays
+#define glBindVertexArray glFuncs.BindVertexArray
+#define glGetUniformBlockIndex glFuncs.GetUniformBlockIndex
+#define glUniformBlockBinding glFuncs.UniformBlockBinding
+#define glBindBufferBase glFuncs.BindBufferBase
+#define glVertexAttrib4fv glFuncs.VertexAttrib4fv
+
+#endif
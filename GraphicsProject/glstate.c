@@ -0,0 +1,492 @@
+/******************************************************************************
+ *
+ * OpenGL State Cache (see glstate.h)
+ *
+ ******************************************************************************/
+
+#define GLSTATE_IMPLEMENTATION
+
+#include <string.h>
+#include "glstats.h"
+#include "glstate.h"
+#include "matrixstack.h"
+
+// Most capabilities tracked at once; others go straight through.
+#define MAX_CAPABILITIES 64
+
+
+typedef struct {
+	GLenum capability;
+	int on;					// 1, 0, or -1 if unknown
+} capabilitystate_t;
+
+static int cacheEnabled = 1;
+
+static capabilitystate_t capabilities[MAX_CAPABILITIES];
+static int capabilityCount = 0;
+
+static GLuint boundTexture;
+static int boundTextureKnown = 0;
+
+static int materialKnown[2][GLSTATE_MATERIAL_COUNT];
+
+static GLenum blendSource, blendDestination;
+static int blendKnown = 0;
+
+static GLenum polygonMode[2];
+static int polygonModeKnown[2];
+
+// Everything recorded for glStateFixedFunction(), including the materials
+// the cache compares against.
+static glfixedstate_t fixed;
+static int fixedInitialised = 0;
+
+// OpenGL's initial state.
+static glfixedstate_t* fixedState(void)
+{
+	static const GLfloat black[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	static const GLfloat white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+	if (fixedInitialised) {
+		return &fixed;
+	}
+	fixedInitialised = 1;
+
+	for (int i = 0; i < GLSTATE_MAX_LIGHTS; i++) {
+		gllight_t* light = &fixed.lights[i];
+		memcpy(light->ambient, black, sizeof(black));
+		memcpy(light->diffuse, i == 0 ? white : black, sizeof(black));
+		memcpy(light->specular, i == 0 ? white : black, sizeof(black));
+		light->position[2] = 1.0f;
+		light->spotDirection[2] = -1.0f;
+		light->spotCutoff = 180.0f;
+		light->attenuation[0] = 1.0f;
+	}
+	for (int face = 0; face < 2; face++) {
+		GLfloat ambient[4] = { 0.2f, 0.2f, 0.2f, 1.0f };
+		GLfloat diffuse[4] = { 0.8f, 0.8f, 0.8f, 1.0f };
+		memcpy(fixed.material[face][GLSTATE_MATERIAL_AMBIENT], ambient, sizeof(ambient));
+		memcpy(fixed.material[face][GLSTATE_MATERIAL_DIFFUSE], diffuse, sizeof(diffuse));
+		memcpy(fixed.material[face][GLSTATE_MATERIAL_SPECULAR], black, sizeof(black));
+		memcpy(fixed.material[face][GLSTATE_MATERIAL_EMISSION], black, sizeof(black));
+	}
+	fixed.lightModelAmbient[0] = fixed.lightModelAmbient[1] = fixed.lightModelAmbient[2] = 0.2f;
+	fixed.lightModelAmbient[3] = 1.0f;
+	fixed.fogMode = GL_EXP;
+	fixed.fogDensity = 1.0f;
+	fixed.fogEnd = 1.0f;
+	memcpy(fixed.color, white, sizeof(white));
+	return &fixed;
+}
+
+const glfixedstate_t* glStateFixedFunction(void)
+{
+	return fixedState();
+}
+
+// State a core profile context doesn't have, so calls for it can't be sent.
+static int fixedFunctionOnly(GLenum capability)
+{
+	switch (capability) {
+	case GL_LIGHTING:
+	case GL_FOG:
+	case GL_TEXTURE_2D:
+	case GL_COLOR_MATERIAL:
+	case GL_NORMALIZE:
+	case GL_ALPHA_TEST:
+		return 1;
+	}
+	return capability >= GL_LIGHT0 && capability < GL_LIGHT0 + GLSTATE_MAX_LIGHTS;
+}
+
+// Record a capability in the fixed-function state, if it's one of those.
+static void recordCapability(GLenum capability, int on)
+{
+	glfixedstate_t* state = fixedState();
+
+	switch (capability) {
+	case GL_LIGHTING:
+		state->lighting = on;
+		break;
+	case GL_FOG:
+		state->fog = on;
+		break;
+	case GL_TEXTURE_2D:
+		state->texturing = on;
+		break;
+	case GL_COLOR_MATERIAL:
+		state->colorMaterial = on;
+		break;
+	default:
+		if (capability >= GL_LIGHT0 && capability < GL_LIGHT0 + GLSTATE_MAX_LIGHTS) {
+			state->lights[capability - GL_LIGHT0].enabled = on;
+		}
+		break;
+	}
+}
+
+void glStateInvalidate(void)
+{
+	capabilityCount = 0;
+	boundTextureKnown = 0;
+	memset(materialKnown, 0, sizeof(materialKnown));
+	blendKnown = 0;
+	memset(polygonModeKnown, 0, sizeof(polygonModeKnown));
+}
+
+void glStateCacheEnable(int enabled)
+{
+	cacheEnabled = enabled;
+	glStateInvalidate();
+}
+
+/******************************************************************************
+ * Capabilities
+ ******************************************************************************/
+
+static capabilitystate_t* findCapability(GLenum capability)
+{
+	for (int i = 0; i < capabilityCount; i++) {
+		if (capabilities[i].capability == capability) {
+			return &capabilities[i];
+		}
+	}
+	if (capabilityCount == MAX_CAPABILITIES) {
+		return NULL;
+	}
+	capabilities[capabilityCount].capability = capability;
+	capabilities[capabilityCount].on = -1;
+	return &capabilities[capabilityCount++];
+}
+
+// glColor changes the ambient and diffuse materials while GL_COLOR_MATERIAL is on.
+static int colorMaterialOff(void)
+{
+	for (int i = 0; i < capabilityCount; i++) {
+		if (capabilities[i].capability == GL_COLOR_MATERIAL) {
+			return capabilities[i].on == 0;
+		}
+	}
+	return 0;
+}
+
+static void forgetColorMaterial(void)
+{
+	for (int face = 0; face < 2; face++) {
+		materialKnown[face][GLSTATE_MATERIAL_AMBIENT] = 0;
+		materialKnown[face][GLSTATE_MATERIAL_DIFFUSE] = 0;
+	}
+}
+
+static void setCapability(GLenum capability, int on)
+{
+	capabilitystate_t* state = cacheEnabled ? findCapability(capability) : NULL;
+
+	recordCapability(capability, on);
+	if (glFuncs.coreProfile && fixedFunctionOnly(capability)) {
+		return;
+	}
+
+	if (state != NULL && state->on == on) {
+		glStats.savedCalls++;
+		return;
+	}
+
+	if (on) {
+		glEnable(capability);
+	}
+	else {
+		glDisable(capability);
+	}
+	if (state != NULL) {
+		state->on = on;
+	}
+	if (capability == GL_COLOR_MATERIAL) {
+		forgetColorMaterial();
+	}
+}
+
+void glStateEnable(GLenum capability)
+{
+	setCapability(capability, 1);
+}
+
+void glStateDisable(GLenum capability)
+{
+	setCapability(capability, 0);
+}
+
+/******************************************************************************
+ * Textures, Materials, Blending and Polygon Mode
+ ******************************************************************************/
+
+void glStateBindTexture(GLenum target, GLuint texture)
+{
+	if (cacheEnabled && target == GL_TEXTURE_2D && boundTextureKnown && boundTexture == texture) {
+		glStats.savedCalls++;
+		return;
+	}
+
+	glBindTexture(target, texture);
+	if (target == GL_TEXTURE_2D) {
+		boundTexture = texture;
+		boundTextureKnown = 1;
+	}
+}
+
+// Update the cached copy of a material parameter for the faces given. Returns 1
+// if every one of them already had that value (so the call can be dropped).
+static int updateMaterial(GLenum face, int parameter, const GLfloat* values, int count)
+{
+	int first = face == GL_BACK ? 1 : 0;
+	int last = face == GL_FRONT ? 0 : 1;
+	int unchanged = 1;
+	int cacheable = parameter > GLSTATE_MATERIAL_DIFFUSE || colorMaterialOff();
+
+	fixedState();
+	for (int i = first; i <= last; i++) {
+		if (!materialKnown[i][parameter] || memcmp(fixed.material[i][parameter], values, count * sizeof(GLfloat)) != 0) {
+			unchanged = 0;
+		}
+		memcpy(fixed.material[i][parameter], values, count * sizeof(GLfloat));
+		materialKnown[i][parameter] = cacheable;
+	}
+	return unchanged && cacheable;
+}
+
+void glStateMaterialfv(GLenum face, GLenum name, const GLfloat* params)
+{
+	int unchanged;
+
+	switch (name) {
+	case GL_AMBIENT:
+		unchanged = updateMaterial(face, GLSTATE_MATERIAL_AMBIENT, params, 4);
+		break;
+	case GL_DIFFUSE:
+		unchanged = updateMaterial(face, GLSTATE_MATERIAL_DIFFUSE, params, 4);
+		break;
+	case GL_AMBIENT_AND_DIFFUSE:
+		unchanged = updateMaterial(face, GLSTATE_MATERIAL_AMBIENT, params, 4);
+		unchanged = updateMaterial(face, GLSTATE_MATERIAL_DIFFUSE, params, 4) && unchanged;
+		break;
+	case GL_SPECULAR:
+		unchanged = updateMaterial(face, GLSTATE_MATERIAL_SPECULAR, params, 4);
+		break;
+	case GL_EMISSION:
+		unchanged = updateMaterial(face, GLSTATE_MATERIAL_EMISSION, params, 4);
+		break;
+	case GL_SHININESS:
+		unchanged = updateMaterial(face, GLSTATE_MATERIAL_SHININESS, params, 1);
+		break;
+	default:
+		unchanged = 0;
+		break;
+	}
+
+	if (glFuncs.coreProfile) {
+		return;
+	}
+	if (cacheEnabled && unchanged) {
+		glStats.savedCalls++;
+		return;
+	}
+	glMaterialfv(face, name, params);
+}
+
+void glStateMaterialf(GLenum face, GLenum name, GLfloat param)
+{
+	int unchanged = name == GL_SHININESS && updateMaterial(face, GLSTATE_MATERIAL_SHININESS, &param, 1);
+
+	if (glFuncs.coreProfile) {
+		return;
+	}
+	if (cacheEnabled && unchanged) {
+		glStats.savedCalls++;
+		return;
+	}
+	glMaterialf(face, name, param);
+}
+
+void glStateBlendFunc(GLenum source, GLenum destination)
+{
+	if (cacheEnabled && blendKnown && blendSource == source && blendDestination == destination) {
+		glStats.savedCalls++;
+		return;
+	}
+
+	glBlendFunc(source, destination);
+	blendSource = source;
+	blendDestination = destination;
+	blendKnown = 1;
+}
+
+void glStatePolygonMode(GLenum face, GLenum mode)
+{
+	int first = face == GL_BACK ? 1 : 0;
+	int last = face == GL_FRONT ? 0 : 1;
+	int unchanged = 1;
+
+	for (int i = first; i <= last; i++) {
+		if (!polygonModeKnown[i] || polygonMode[i] != mode) {
+			unchanged = 0;
+		}
+		polygonMode[i] = mode;
+		polygonModeKnown[i] = 1;
+	}
+
+	if (cacheEnabled && unchanged) {
+		glStats.savedCalls++;
+		return;
+	}
+	glPolygonMode(face, mode);
+}
+
+/******************************************************************************
+ * Lights, Fog and Colour (recorded, never cached)
+ ******************************************************************************/
+
+// Record one of a light's single valued parameters; other names are ignored.
+static void recordLightScalar(gllight_t* state, GLenum name, GLfloat param)
+{
+	switch (name) {
+	case GL_SPOT_EXPONENT:
+		state->spotExponent = param;
+		break;
+	case GL_SPOT_CUTOFF:
+		state->spotCutoff = param;
+		break;
+	case GL_CONSTANT_ATTENUATION:
+		state->attenuation[0] = param;
+		break;
+	case GL_LINEAR_ATTENUATION:
+		state->attenuation[1] = param;
+		break;
+	case GL_QUADRATIC_ATTENUATION:
+		state->attenuation[2] = param;
+		break;
+	}
+}
+
+void glStateLightfv(GLenum light, GLenum name, const GLfloat* params)
+{
+	if (light >= GL_LIGHT0 && light < GL_LIGHT0 + GLSTATE_MAX_LIGHTS) {
+		gllight_t* state = &fixedState()->lights[light - GL_LIGHT0];
+		const GLfloat* m = matrixStackTop(GL_MODELVIEW);
+
+		switch (name) {
+		case GL_AMBIENT:
+			memcpy(state->ambient, params, sizeof(state->ambient));
+			break;
+		case GL_DIFFUSE:
+			memcpy(state->diffuse, params, sizeof(state->diffuse));
+			break;
+		case GL_SPECULAR:
+			memcpy(state->specular, params, sizeof(state->specular));
+			break;
+		case GL_POSITION:
+			for (int row = 0; row < 4; row++) {
+				state->position[row] = m[row] * params[0] + m[4 + row] * params[1] + m[8 + row] * params[2] + m[12 + row] * params[3];
+			}
+			break;
+		case GL_SPOT_DIRECTION:
+			for (int row = 0; row < 3; row++) {
+				state->spotDirection[row] = m[row] * params[0] + m[4 + row] * params[1] + m[8 + row] * params[2];
+			}
+			break;
+		default:
+			recordLightScalar(state, name, params[0]);
+			break;
+		}
+	}
+
+	if (!glFuncs.coreProfile) {
+		glLightfv(light, name, params);
+	}
+}
+
+// GL rejects the vector parameters from glLightf(), so only the single valued ones are recorded.
+void glStateLightf(GLenum light, GLenum name, GLfloat param)
+{
+	if (light >= GL_LIGHT0 && light < GL_LIGHT0 + GLSTATE_MAX_LIGHTS) {
+		recordLightScalar(&fixedState()->lights[light - GL_LIGHT0], name, param);
+	}
+	if (!glFuncs.coreProfile) {
+		glLightf(light, name, param);
+	}
+}
+
+void glStateLightModelfv(GLenum name, const GLfloat* params)
+{
+	if (name == GL_LIGHT_MODEL_AMBIENT) {
+		memcpy(fixedState()->lightModelAmbient, params, 4 * sizeof(GLfloat));
+	}
+	if (!glFuncs.coreProfile) {
+		glLightModelfv(name, params);
+	}
+}
+
+// Record one of the fog's single valued parameters; other names are ignored.
+static void recordFogScalar(glfixedstate_t* state, GLenum name, GLfloat param)
+{
+	switch (name) {
+	case GL_FOG_MODE:
+		state->fogMode = (GLenum)param;
+		break;
+	case GL_FOG_DENSITY:
+		state->fogDensity = param;
+		break;
+	case GL_FOG_START:
+		state->fogStart = param;
+		break;
+	case GL_FOG_END:
+		state->fogEnd = param;
+		break;
+	}
+}
+
+void glStateFogfv(GLenum name, const GLfloat* params)
+{
+	glfixedstate_t* state = fixedState();
+
+	if (name == GL_FOG_COLOR) {
+		memcpy(state->fogColor, params, sizeof(state->fogColor));
+	}
+	else {
+		recordFogScalar(state, name, params[0]);
+	}
+	if (!glFuncs.coreProfile) {
+		glFogfv(name, params);
+	}
+}
+
+// GL rejects GL_FOG_COLOR from glFogf(), so only the single valued parameters are recorded.
+void glStateFogf(GLenum name, GLfloat param)
+{
+	recordFogScalar(fixedState(), name, param);
+	if (!glFuncs.coreProfile) {
+		glFogf(name, param);
+	}
+}
+
+void glStateColor4fv(const GLfloat* v)
+{
+	glfixedstate_t* state = fixedState();
+
+	// Under GL_COLOR_MATERIAL the colour becomes the ambient and diffuse material too.
+	memcpy(state->color, v, sizeof(state->color));
+	if (state->colorMaterial) {
+		for (int face = 0; face < 2; face++) {
+			memcpy(state->material[face][GLSTATE_MATERIAL_AMBIENT], v, sizeof(state->color));
+			memcpy(state->material[face][GLSTATE_MATERIAL_DIFFUSE], v, sizeof(state->color));
+		}
+	}
+	if (!glFuncs.coreProfile) {
+		glColor4fv(v);
+	}
+}
+
+void glStateColor3f(GLfloat r, GLfloat g, GLfloat b)
+{
+	GLfloat color[4] = { r, g, b, 1.0f };
+	glStateColor4fv(color);
+}
@@ -0,0 +1,123 @@
+/******************************************************************************
+ *
+ * OpenGL State Cache
+ *
+ * A CPU-side copy of the state the scene changes most - capabilities
+ * (glEnable/glDisable), the bound 2D texture, the material, the blend
+ * function and the polygon mode - that drops calls which would set a value
+ * already in place. Including this header after glstats.h redirects those
+ * calls through the cache, so glstats only counts the calls that reach
+ * OpenGL; the dropped ones are counted in glStats.savedCalls.
+ *
+ * The cache is only as good as what it has seen: anything else that changes
+ * this state (another library, glPushAttrib, a shader) must be followed by
+ * glStateInvalidate(). It's invalidated at the start of every frame anyway,
+ * and while GL_COLOR_MATERIAL is on the ambient and diffuse materials (which
+ * glColor changes behind its back) are never cached.
+ *
+ * Separately from the cache, the lighting, fog, material and colour state set
+ * through here is always recorded, lights already in eye space, and can be
+ * read with glStateFixedFunction(): it's what a shader needs to draw the way
+ * the fixed pipeline would (see renderbackend.h). In a core profile context,
+ * which has no fixed pipeline, that state is only recorded, never sent.
+ *
+ ******************************************************************************/
+
+#ifndef GLSTATE_H
+#define GLSTATE_H
+
+#include <freeglut.h>
+
+// Lights recorded (GL_LIGHT0 + i). The fixed pipeline itself has 8.
+#define GLSTATE_MAX_LIGHTS 32
+
+// Material parameters, per face.
+#define GLSTATE_MATERIAL_AMBIENT	0
+#define GLSTATE_MATERIAL_DIFFUSE	1
+#define GLSTATE_MATERIAL_SPECULAR	2
+#define GLSTATE_MATERIAL_EMISSION	3
+#define GLSTATE_MATERIAL_SHININESS	4
+#define GLSTATE_MATERIAL_COUNT		5
+
+typedef struct {
+	int enabled;
+	GLfloat ambient[4];
+	GLfloat diffuse[4];
+	GLfloat specular[4];
+	GLfloat position[4];		// Eye space: transformed by the modelview matrix when set, as OpenGL does
+	GLfloat spotDirection[3];	// Eye space too
+	GLfloat spotExponent;
+	GLfloat spotCutoff;			// Degrees; 180 for a light that isn't a spotlight
+	GLfloat attenuation[3];		// Constant, linear and quadratic
+} gllight_t;
+
+// The fixed-function state as last set through this header (OpenGL's defaults until then).
+typedef struct {
+	int lighting;				// GL_LIGHTING
+	int fog;					// GL_FOG
+	int texturing;				// GL_TEXTURE_2D
+	int colorMaterial;			// GL_COLOR_MATERIAL (ambient and diffuse, both faces)
+	gllight_t lights[GLSTATE_MAX_LIGHTS];
+	GLfloat lightModelAmbient[4];
+	GLfloat material[2][GLSTATE_MATERIAL_COUNT][4];	// [front, back][parameter]; shininess is [4][0]
+	GLenum fogMode;
+	GLfloat fogDensity;
+	GLfloat fogStart;
+	GLfloat fogEnd;
+	GLfloat fogColor[4];
+	GLfloat color[4];			// Current colour (glColor)
+} glfixedstate_t;
+
+const glfixedstate_t* glStateFixedFunction(void);
+
+// Forget everything, so the next call for each piece of state goes through.
+void glStateInvalidate(void);
+
+// Turn the cache off (or back on); when off every call goes straight through.
+void glStateCacheEnable(int enabled);
+
+void glStateEnable(GLenum capability);
+void glStateDisable(GLenum capability);
+void glStateBindTexture(GLenum target, GLuint texture);
+void glStateMaterialf(GLenum face, GLenum name, GLfloat param);
+void glStateMaterialfv(GLenum face, GLenum name, const GLfloat* params);
+void glStateBlendFunc(GLenum source, GLenum destination);
+void glStatePolygonMode(GLenum face, GLenum mode);
+void glStateLightf(GLenum light, GLenum name, GLfloat param);
+void glStateLightfv(GLenum light, GLenum name, const GLfloat* params);
+void glStateLightModelfv(GLenum name, const GLfloat* params);
+void glStateFogf(GLenum name, GLfloat param);
+void glStateFogfv(GLenum name, const GLfloat* params);
+void glStateColor3f(GLfloat r, GLfloat g, GLfloat b);
+void glStateColor4fv(const GLfloat* v);
+
+#if !defined(GLSTATE_IMPLEMENTATION) && !defined(GLSTATS_IMPLEMENTATION)
+
+// These replace glstats.h's macros for the same names (glstate.c calls those).
+#undef glEnable
+#undef glDisable
+#undef glBindTexture
+#undef glMaterialf
+#undef glMaterialfv
+#undef glLightf
+#undef glLightfv
+#undef glColor3f
+#undef glColor4fv
+#define glEnable(capability) glStateEnable(capability)
+#define glDisable(capability) glStateDisable(capability)
+#define glBindTexture(target, texture) glStateBindTexture(target, texture)
+#define glMaterialf(face, name, param) glStateMaterialf(face, name, param)
+#define glMaterialfv(face, name, params) glStateMaterialfv(face, name, params)
+#define glBlendFunc(source, destination) glStateBlendFunc(source, destination)
+#define glPolygonMode(face, mode) glStatePolygonMode(face, mode)
+#define glLightf(light, name, param) glStateLightf(light, name, param)
+#define glLightfv(light, name, params) glStateLightfv(light, name, params)
+#define glLightModelfv(name, params) glStateLightModelfv(name, params)
+#define glFogf(name, param) glStateFogf(name, param)
+#define glFogfv(name, params) glStateFogfv(name, params)
+#define glColor3f(r, g, b) glStateColor3f(r, g, b)
+#define glColor4fv(v) glStateColor4fv(v)
+
+#endif
+
+#endif
@@ -0,0 +1,277 @@
+/******************************************************************************
+ *
+ * OpenGL Call Statistics (see glstats.h)
+ *
+ ******************************************************************************/
+
+// The wrappers below need to reach the real functions, not the redirecting macros.
+#define GLSTATS_IMPLEMENTATION
+
+#include <string.h>
+#include "glstats.h"
+#include "platform.h"
+
+glstats_t glStats;
+
+static glstats_t lastFrame;
+
+void glStatsEndFrame(void)
+{
+	lastFrame = glStats;
+	memset(&glStats, 0, sizeof(glStats));
+}
+
+const glstats_t* glStatsLastFrame(void)
+{
+	return &lastFrame;
+}
+
+void glStatsPrint(const glstats_t* stats)
+{
+	printf("GL calls: %lu vertex, %lu normal, %lu texcoord, %lu color, %lu batches, %lu array elements\n",
+		stats->vertexCalls, stats->normalCalls, stats->texCoordCalls, stats->colorCalls, stats->primitiveBatches,
+		stats->arrayElements);
+	printf("State:    %lu material, %lu light, %lu enable, %lu disable, %lu bind texture (%lu more saved by the cache)\n",
+		stats->materialCalls, stats->lightCalls, stats->enableCalls, stats->disableCalls, stats->bindTextureCalls,
+		stats->savedCalls);
+	printf("Uploads:  %lu gen textures, %lu tex images, %llu bytes\n",
+		stats->genTextureCalls, stats->texImageCalls, stats->bytesUploaded);
+	printf("Shapes:   %lu quadric/solid draws, ~%lu triangles\n",
+		stats->quadricCalls, stats->quadricTriangles);
+	printf("Culling:  %lu objects drawn, %lu culled, %lu hidden; %lu terrain chunks drawn, %lu culled, %lu hidden\n",
+		stats->objectsSubmitted, stats->objectsCulled, stats->objectsOccluded, stats->chunksSubmitted,
+		stats->chunksCulled, stats->chunksOccluded);
+}
+
+unsigned long glStatsCylinderTriangles(GLint slices, GLint stacks)
+{
+	// One quad strip of "slices" quads per stack.
+	return 2ul * (unsigned long)slices * (unsigned long)stacks;
+}
+
+unsigned long glStatsSphereTriangles(GLint slices, GLint stacks)
+{
+	// Triangle fans at the two poles, quad strips in between.
+	if (stacks < 2) {
+		return 0;
+	}
+	return 2ul * (unsigned long)slices * (unsigned long)(stacks - 1);
+}
+
+unsigned long long glStatsImageBytes(GLsizei width, GLsizei height, GLenum format, GLenum type)
+{
+	unsigned long long components, componentSize;
+
+	switch (format) {
+	case GL_RGBA:
+	case GL_BGRA_EXT:
+		components = 4;
+		break;
+	case GL_RGB:
+	case GL_BGR_EXT:
+		components = 3;
+		break;
+	case GL_LUMINANCE_ALPHA:
+		components = 2;
+		break;
+	default:
+		components = 1;
+		break;
+	}
+
+	switch (type) {
+	case GL_UNSIGNED_SHORT:
+	case GL_SHORT:
+		componentSize = 2;
+		break;
+	case GL_UNSIGNED_INT:
+	case GL_INT:
+	case GL_FLOAT:
+		componentSize = 4;
+		break;
+	default:
+		componentSize = 1;
+		break;
+	}
+
+	return (unsigned long long)width * (unsigned long long)height * components * componentSize;
+}
+
+/******************************************************************************
+ * Wrappers
+ ******************************************************************************/
+
+void glStatsVertex3f(GLfloat x, GLfloat y, GLfloat z)
+{
+	glStats.vertexCalls++;
+	glVertex3f(x, y, z);
+}
+
+void glStatsVertex3fv(const GLfloat* v)
+{
+	glStats.vertexCalls++;
+	glVertex3fv(v);
+}
+
+void glStatsVertex3d(GLdouble x, GLdouble y, GLdouble z)
+{
+	glStats.vertexCalls++;
+	glVertex3d(x, y, z);
+}
+
+void glStatsNormal3f(GLfloat x, GLfloat y, GLfloat z)
+{
+	glStats.normalCalls++;
+	glNormal3f(x, y, z);
+}
+
+void glStatsNormal3fv(const GLfloat* v)
+{
+	glStats.normalCalls++;
+	glNormal3fv(v);
+}
+
+void glStatsTexCoord2f(GLfloat s, GLfloat t)
+{
+	glStats.texCoordCalls++;
+	glTexCoord2f(s, t);
+}
+
+void glStatsColor3f(GLfloat r, GLfloat g, GLfloat b)
+{
+	glStats.colorCalls++;
+	glColor3f(r, g, b);
+}
+
+void glStatsColor4fv(const GLfloat* v)
+{
+	glStats.colorCalls++;
+	glColor4fv(v);
+}
+
+void glStatsBegin(GLenum mode)
+{
+	glStats.primitiveBatches++;
+	glBegin(mode);
+}
+
+void glStatsMaterialf(GLenum face, GLenum name, GLfloat param)
+{
+	glStats.materialCalls++;
+	glMaterialf(face, name, param);
+}
+
+void glStatsMaterialfv(GLenum face, GLenum name, const GLfloat* params)
+{
+	glStats.materialCalls++;
+	glMaterialfv(face, name, params);
+}
+
+void glStatsLightf(GLenum light, GLenum name, GLfloat param)
+{
+	glStats.lightCalls++;
+	glLightf(light, name, param);
+}
+
+void glStatsLightfv(GLenum light, GLenum name, const GLfloat* params)
+{
+	glStats.lightCalls++;
+	glLightfv(light, name, params);
+}
+
+void glStatsEnable(GLenum capability)
+{
+	glStats.enableCalls++;
+	glEnable(capability);
+}
+
+void glStatsDisable(GLenum capability)
+{
+	glStats.disableCalls++;
+	glDisable(capability);
+}
+
+void glStatsBindTexture(GLenum target, GLuint texture)
+{
+	glStats.bindTextureCalls++;
+	glBindTexture(target, texture);
+}
+
+void glStatsGenTextures(GLsizei n, GLuint* textures)
+{
+	glStats.genTextureCalls += (unsigned long)n;
+	glGenTextures(n, textures);
+}
+
+void glStatsTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+	GLint border, GLenum format, GLenum type, const void* pixels)
+{
+	glStats.texImageCalls++;
+	if (pixels != NULL) {
+		glStats.bytesUploaded += glStatsImageBytes(width, height, format, type);
+	}
+	glTexImage2D(target, level, internalFormat, width, height, border, format, type, pixels);
+}
+
+void glStatsDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+	glStats.primitiveBatches++;
+	glStats.arrayElements += (unsigned long)count;
+	glDrawArrays(mode, first, count);
+}
+
+void glStatsDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+	glStats.primitiveBatches++;
+	glStats.arrayElements += (unsigned long)count;
+	glDrawElements(mode, count, type, indices);
+}
+
+void glStatsDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instances)
+{
+	glStats.primitiveBatches++;
+	glStats.arrayElements += (unsigned long)count * (unsigned long)instances;
+	glDrawElementsInstanced(mode, count, type, indices, instances);
+}
+
+void glStatsBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+	if (data != NULL) {
+		glStats.bytesUploaded += (unsigned long long)size;
+	}
+	glBufferData(target, size, data, usage);
+}
+
+void glStatsBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+	glStats.bytesUploaded += (unsigned long long)size;
+	glBufferSubData(target, offset, size, data);
+}
+
+void glStatsCylinder(GLUquadric* quad, GLdouble base, GLdouble top, GLdouble height, GLint slices, GLint stacks)
+{
+	glStats.quadricCalls++;
+	glStats.quadricTriangles += glStatsCylinderTriangles(slices, stacks);
+	gluCylinder(quad, base, top, height, slices, stacks);
+}
+
+void glStatsSphere(GLUquadric* quad, GLdouble radius, GLint slices, GLint stacks)
+{
+	glStats.quadricCalls++;
+	glStats.quadricTriangles += glStatsSphereTriangles(slices, stacks);
+	gluSphere(quad, radius, slices, stacks);
+}
+
+void glStatsSolidCube(GLdouble size)
+{
+	glStats.quadricCalls++;
+	glStats.quadricTriangles += 12;
+	platformSolidCube(size);
+}
+
+void glStatsSolidSphere(GLdouble radius, GLint slices, GLint stacks)
+{
+	glStats.quadricCalls++;
+	glStats.quadricTriangles += glStatsSphereTriangles(slices, stacks);
+	platformSolidSphere(radius, slices, stacks);
+}
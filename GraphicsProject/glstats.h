@@ -0,0 +1,137 @@
+/******************************************************************************
+ *
+ * OpenGL Call Statistics
+ *
+ * An optional wrapper layer over the GL/GLU entry points the project uses.
+ * When GL_STATS is defined (the CMake build's GRAPHICS_GL_STATS option) this
+ * header redirects those calls through counting wrappers, so every source file
+ * that includes it after the GL headers is counted. Without GL_STATS the calls
+ * go straight to OpenGL and the counters stay at zero.
+ *
+ * GLU and GLUT (and the platform layer's stand-ins for them) draw their shapes
+ * with internal GL calls, which can't be seen from here; the wrappers estimate
+ * the triangles they produce instead.
+ *
+ ******************************************************************************/
+
+#ifndef GLSTATS_H
+#define GLSTATS_H
+
+#include <freeglut.h>
+#include "glfuncs.h"
+
+// Counts for one frame (or for everything before the first frame).
+typedef struct {
+	unsigned long vertexCalls;		// glVertex*
+	unsigned long normalCalls;		// glNormal*
+	unsigned long texCoordCalls;	// glTexCoord*
+	unsigned long colorCalls;		// glColor*
+	unsigned long primitiveBatches;	// glBegin/glEnd pairs and array draws
+	unsigned long arrayElements;	// Vertices (or indices) submitted by array draws
+	unsigned long materialCalls;	// glMaterial*
+	unsigned long lightCalls;		// glLight*
+	unsigned long enableCalls;		// glEnable
+	unsigned long disableCalls;		// glDisable
+	unsigned long bindTextureCalls;	// glBindTexture
+	unsigned long savedCalls;		// State calls dropped by the state cache (see glstate.h)
+	unsigned long genTextureCalls;	// glGenTextures
+	unsigned long texImageCalls;	// glTexImage2D
+	unsigned long quadricCalls;		// gluCylinder, gluSphere and the solid shape helpers
+	unsigned long quadricTriangles;	// Estimated triangles tessellated by those calls
+	unsigned long long bytesUploaded;	// Texture (and buffer) data sent to the driver
+	unsigned long objectsSubmitted;	// Scene objects drawn...
+	unsigned long objectsCulled;	// ...skipped as outside the view frustum (see culling.h)...
+	unsigned long objectsOccluded;	// ...or as hidden behind the terrain (see occlusion.h)
+	unsigned long chunksSubmitted;	// Likewise for terrain chunks
+	unsigned long chunksCulled;
+	unsigned long chunksOccluded;
+} glstats_t;
+
+// Counters for the frame in progress.
+extern glstats_t glStats;
+
+// Close the current frame: its counts become glStatsLastFrame() and counting restarts.
+void glStatsEndFrame(void);
+
+// Counts for the most recently completed frame.
+const glstats_t* glStatsLastFrame(void);
+
+// Print a one-frame summary to stdout.
+void glStatsPrint(const glstats_t* stats);
+
+// Estimated triangles produced by the GLU/GLUT shape functions.
+unsigned long glStatsCylinderTriangles(GLint slices, GLint stacks);
+unsigned long glStatsSphereTriangles(GLint slices, GLint stacks);
+
+// Size in bytes of a width x height image of the given pixel format and type.
+unsigned long long glStatsImageBytes(GLsizei width, GLsizei height, GLenum format, GLenum type);
+
+#if defined(GL_STATS) && !defined(GLSTATS_IMPLEMENTATION)
+
+void glStatsVertex3f(GLfloat x, GLfloat y, GLfloat z);
+void glStatsVertex3fv(const GLfloat* v);
+void glStatsVertex3d(GLdouble x, GLdouble y, GLdouble z);
+void glStatsNormal3f(GLfloat x, GLfloat y, GLfloat z);
+void glStatsNormal3fv(const GLfloat* v);
+void glStatsTexCoord2f(GLfloat s, GLfloat t);
+void glStatsColor3f(GLfloat r, GLfloat g, GLfloat b);
+void glStatsColor4fv(const GLfloat* v);
+void glStatsBegin(GLenum mode);
+void glStatsMaterialf(GLenum face, GLenum name, GLfloat param);
+void glStatsMaterialfv(GLenum face, GLenum name, const GLfloat* params);
+void glStatsLightf(GLenum light, GLenum name, GLfloat param);
+void glStatsLightfv(GLenum light, GLenum name, const GLfloat* params);
+void glStatsEnable(GLenum capability);
+void glStatsDisable(GLenum capability);
+void glStatsBindTexture(GLenum target, GLuint texture);
+void glStatsGenTextures(GLsizei n, GLuint* textures);
+void glStatsTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+	GLint border, GLenum format, GLenum type, const void* pixels);
+void glStatsDrawArrays(GLenum mode, GLint first, GLsizei count);
+void glStatsDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices);
+void glStatsDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instances);
+void glStatsBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+void glStatsBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+void glStatsCylinder(GLUquadric* quad, GLdouble base, GLdouble top, GLdouble height, GLint slices, GLint stacks);
+void glStatsSphere(GLUquadric* quad, GLdouble radius, GLint slices, GLint stacks);
+void glStatsSolidCube(GLdouble size);
+void glStatsSolidSphere(GLdouble radius, GLint slices, GLint stacks);
+
+#define glVertex3f(x, y, z) glStatsVertex3f(x, y, z)
+#define glVertex3fv(v) glStatsVertex3fv(v)
+#define glVertex3d(x, y, z) glStatsVertex3d(x, y, z)
+#define glNormal3f(x, y, z) glStatsNormal3f(x, y, z)
+#define glNormal3fv(v) glStatsNormal3fv(v)
+#define glTexCoord2f(s, t) glStatsTexCoord2f(s, t)
+#define glColor3f(r, g, b) glStatsColor3f(r, g, b)
+#define glColor4fv(v) glStatsColor4fv(v)
+#define glBegin(mode) glStatsBegin(mode)
+#define glMaterialf(face, name, param) glStatsMaterialf(face, name, param)
+#define glMaterialfv(face, name, params) glStatsMaterialfv(face, name, params)
+#define glLightf(light, name, param) glStatsLightf(light, name, param)
+#define glLightfv(light, name, params) glStatsLightfv(light, name, params)
+#define glEnable(capability) glStatsEnable(capability)
+#define glDisable(capability) glStatsDisable(capability)
+#define glBindTexture(target, texture) glStatsBindTexture(target, texture)
+#define glGenTextures(n, textures) glStatsGenTextures(n, textures)
+#define glTexImage2D(target, level, internalFormat, width, height, border, format, type, pixels) \
+	glStatsTexImage2D(target, level, internalFormat, width, height, border, format, type, pixels)
+#define glDrawArrays(mode, first, count) glStatsDrawArrays(mode, first, count)
+#define glDrawElements(mode, count, type, indices) glStatsDrawElements(mode, count, type, indices)
+
+// These replace glfuncs.h's own macros for the same names.
+#undef glDrawElementsInstanced
+#undef glBufferData
+#undef glBufferSubData
+#define glDrawElementsInstanced(mode, count, type, indices, instances) \
+	glStatsDrawElementsInstanced(mode, count, type, indices, instances)
+#define glBufferData(target, size, data, usage) glStatsBufferData(target, size, data, usage)
+#define glBufferSubData(target, offset, size, data) glStatsBufferSubData(target, offset, size, data)
+#define gluCylinder(quad, base, top, height, slices, stacks) glStatsCylinder(quad, base, top, height, slices, stacks)
+#define gluSphere(quad, radius, slices, stacks) glStatsSphere(quad, radius, slices, stacks)
+#define platformSolidCube(size) glStatsSolidCube(size)
+#define platformSolidSphere(radius, slices, stacks) glStatsSolidSphere(radius, slices, stacks)
+
+#endif
+
+#endif
@@ -0,0 +1,232 @@
+/******************************************************************************
+ *
+ * Height Field Queries (see heightfield.h)
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "heightfield.h"
+#include "platform.h"
+#include "terrainpager.h"
+
+// SSE2 is always there on x64 (and on x86 when MSVC is told to use it).
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HEIGHTFIELD_SSE
+#include <emmintrin.h>
+#endif
+
+#define QUANTIZED_MAX 65535
+
+static int usable(const heightfield_t* field)
+{
+	return field->heights != NULL && field->sizeX >= 2 && field->sizeZ >= 2;
+}
+
+/******************************************************************************
+ * Quantization
+ ******************************************************************************/
+
+void heightfieldSetRange(heightfield_t* field, GLfloat low, GLfloat high)
+{
+	GLfloat range = high > low ? high - low : 1.0f;
+	GLfloat scale = ldexpf(1.0f, (int)ceilf(log2f(range / QUANTIZED_MAX)));
+
+	// Snapping the offset down to a step can push the top of the range past
+	// the last one; the next power of two up always fits.
+	while ((high - floorf(low / scale) * scale) / scale > QUANTIZED_MAX) {
+		scale *= 2.0f;
+	}
+	field->scale = scale;
+	field->offset = floorf(low / scale) * scale;
+}
+
+unsigned short heightfieldQuantize(const heightfield_t* field, GLfloat height)
+{
+	GLfloat steps = roundf((height - field->offset) / field->scale);
+	return (unsigned short)(steps > 0.0f ? steps < QUANTIZED_MAX ? steps : QUANTIZED_MAX : 0.0f);
+}
+
+GLfloat heightfieldVertex(const heightfield_t* field, int x, int z)
+{
+	return field->heights[(size_t)x * field->sizeZ + z] * field->scale + field->offset;
+}
+
+/******************************************************************************
+ * Queries
+ ******************************************************************************/
+
+// Clamping is written as SSE's max and min work (the second operand wins
+// unless the comparison holds), so NaNs end up on the near edge in both paths.
+// The interpolation is done in quantized steps (whole numbers, so the
+// differences are exact) and scaled once at the end.
+GLfloat heightfieldSample(const heightfield_t* field, GLfloat x, GLfloat z)
+{
+	if (!usable(field)) {
+		return 0.0f;
+	}
+
+	GLfloat gx = (x - field->originX) / field->spacing;
+	GLfloat gz = (z - field->originZ) / field->spacing;
+	GLfloat lastX = (GLfloat)(field->sizeX - 1), lastZ = (GLfloat)(field->sizeZ - 1);
+	gx = gx > 0.0f ? gx : 0.0f;
+	gz = gz > 0.0f ? gz : 0.0f;
+	gx = gx < lastX ? gx : lastX;
+	gz = gz < lastZ ? gz : lastZ;
+
+	// The cell's first corner; the far edges use the last cell.
+	GLfloat cellX = (GLfloat)(int)gx, cellZ = (GLfloat)(int)gz;
+	cellX = cellX < lastX - 1.0f ? cellX : lastX - 1.0f;
+	cellZ = cellZ < lastZ - 1.0f ? cellZ : lastZ - 1.0f;
+	GLfloat fx = gx - cellX, fz = gz - cellZ;
+
+	const unsigned short* corner = &field->heights[(size_t)cellX * field->sizeZ + (size_t)cellZ];
+	GLfloat h00 = corner[0], h01 = corner[1], h10 = corner[field->sizeZ], h11 = corner[field->sizeZ + 1];
+	GLfloat near = h00 + (h01 - h00) * fz;
+	GLfloat far = h10 + (h11 - h10) * fz;
+	return (near + (far - near) * fx) * field->scale + field->offset;
+}
+
+void heightfieldSampleBatch(const heightfield_t* field, const GLfloat* x, const GLfloat* z, GLfloat* heights,
+	int count)
+{
+	int i = 0;
+
+	if (!usable(field)) {
+		memset(heights, 0, sizeof(GLfloat) * count);
+		return;
+	}
+
+#ifdef HEIGHTFIELD_SSE
+	const __m128 originX = _mm_set1_ps(field->originX), originZ = _mm_set1_ps(field->originZ);
+	const __m128 spacing = _mm_set1_ps(field->spacing);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 lastX = _mm_set1_ps((GLfloat)(field->sizeX - 1)), lastZ = _mm_set1_ps((GLfloat)(field->sizeZ - 1));
+	const __m128 lastCellX = _mm_set1_ps((GLfloat)(field->sizeX - 2));
+	const __m128 lastCellZ = _mm_set1_ps((GLfloat)(field->sizeZ - 2));
+	const __m128 scale = _mm_set1_ps(field->scale), offset = _mm_set1_ps(field->offset);
+	const int sizeZ = field->sizeZ;
+	int cellX[4], cellZ[4];
+	GLfloat h00[4], h01[4], h10[4], h11[4];
+
+	for (; i + 4 <= count; i += 4) {
+		__m128 gx = _mm_div_ps(_mm_sub_ps(_mm_loadu_ps(x + i), originX), spacing);
+		__m128 gz = _mm_div_ps(_mm_sub_ps(_mm_loadu_ps(z + i), originZ), spacing);
+		gx = _mm_min_ps(_mm_max_ps(gx, zero), lastX);
+		gz = _mm_min_ps(_mm_max_ps(gz, zero), lastZ);
+
+		__m128 cx = _mm_min_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(gx)), lastCellX);
+		__m128 cz = _mm_min_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(gz)), lastCellZ);
+		__m128 fx = _mm_sub_ps(gx, cx), fz = _mm_sub_ps(gz, cz);
+
+		// SSE2 has no gather, so the corners are fetched one point at a time.
+		_mm_storeu_si128((__m128i*)cellX, _mm_cvttps_epi32(cx));
+		_mm_storeu_si128((__m128i*)cellZ, _mm_cvttps_epi32(cz));
+		for (int j = 0; j < 4; j++) {
+			const unsigned short* corner = &field->heights[(size_t)cellX[j] * sizeZ + cellZ[j]];
+			h00[j] = corner[0];
+			h01[j] = corner[1];
+			h10[j] = corner[sizeZ];
+			h11[j] = corner[sizeZ + 1];
+		}
+
+		__m128 c00 = _mm_loadu_ps(h00), c01 = _mm_loadu_ps(h01), c10 = _mm_loadu_ps(h10), c11 = _mm_loadu_ps(h11);
+		__m128 near = _mm_add_ps(c00, _mm_mul_ps(_mm_sub_ps(c01, c00), fz));
+		__m128 far = _mm_add_ps(c10, _mm_mul_ps(_mm_sub_ps(c11, c10), fz));
+		__m128 steps = _mm_add_ps(near, _mm_mul_ps(_mm_sub_ps(far, near), fx));
+		_mm_storeu_ps(heights + i, _mm_add_ps(_mm_mul_ps(steps, scale), offset));
+	}
+#endif
+
+	for (; i < count; i++) {
+		heights[i] = heightfieldSample(field, x[i], z[i]);
+	}
+}
+
+/******************************************************************************
+ * Benchmark
+ ******************************************************************************/
+
+void heightfieldBenchmark(int size)
+{
+	const int points = 1 << 20, batch = 4096, repeats = 10;
+	heightfield_t field = { NULL, 1.0f, 0.0f, size, size, -(size - 1) / 2.0f, -(size - 1) / 2.0f, 1.0f };
+
+	if (size < 2) {
+		printf("The height field needs to be at least 2x2\n");
+		return;
+	}
+	GLfloat* heights = malloc(sizeof(GLfloat) * size * size);
+	unsigned short* quantized = malloc(sizeof(unsigned short) * size * size);
+	GLfloat* x = malloc(sizeof(GLfloat) * points);
+	GLfloat* z = malloc(sizeof(GLfloat) * points);
+	GLfloat* single = malloc(sizeof(GLfloat) * points);
+	GLfloat* batched = malloc(sizeof(GLfloat) * points);
+	if (heights == NULL || quantized == NULL || x == NULL || z == NULL || single == NULL || batched == NULL) {
+		printf("Out of memory\n");
+		free(heights);
+		free(quantized);
+		free(x);
+		free(z);
+		free(single);
+		free(batched);
+		return;
+	}
+	GLfloat low = terrainSyntheticHeight(NULL, 0, 0), high = low;
+	for (int i = 0; i < size; i++) {
+		for (int j = 0; j < size; j++) {
+			GLfloat height = terrainSyntheticHeight(NULL, i, j);
+			heights[(size_t)i * size + j] = height;
+			low = height < low ? height : low;
+			high = height > high ? height : high;
+		}
+	}
+	heightfieldSetRange(&field, low, high);
+	GLfloat worstError = 0.0f;
+	for (size_t i = 0; i < (size_t)size * size; i++) {
+		quantized[i] = heightfieldQuantize(&field, heights[i]);
+		GLfloat error = fabsf(quantized[i] * field.scale + field.offset - heights[i]);
+		worstError = error > worstError ? error : worstError;
+	}
+	field.heights = quantized;
+
+	// Points over the whole field and a little way off it, to exercise the clamping.
+	srand(1);
+	for (int i = 0; i < points; i++) {
+		x[i] = ((GLfloat)rand() / RAND_MAX - 0.5f) * size * 1.1f;
+		z[i] = ((GLfloat)rand() / RAND_MAX - 0.5f) * size * 1.1f;
+	}
+
+	double start = platformTimeSeconds();
+	for (int n = 0; n < repeats; n++) {
+		for (int i = 0; i < points; i++) {
+			single[i] = heightfieldSample(&field, x[i], z[i]);
+		}
+	}
+	double singleNs = (platformTimeSeconds() - start) * 1e9 / ((double)points * repeats);
+
+	start = platformTimeSeconds();
+	for (int n = 0; n < repeats; n++) {
+		for (int i = 0; i < points; i += batch) {
+			heightfieldSampleBatch(&field, x + i, z + i, batched + i, batch);
+		}
+	}
+	double batchNs = (platformTimeSeconds() - start) * 1e9 / ((double)points * repeats);
+
+	printf("%dx%d height field, %d random points in batches of %d:\n", size, size, points, batch);
+	printf("  heights from %.3f to %.3f in steps of %g (%.1f MB quantized, %.1f MB as floats), worst error %g\n",
+		low, high, field.scale, sizeof(unsigned short) * (double)size * size / (1024.0 * 1024.0),
+		sizeof(GLfloat) * (double)size * size / (1024.0 * 1024.0), worstError);
+	printf("  heightfieldSample()       %6.2f ns per point\n", singleNs);
+	printf("  heightfieldSampleBatch()  %6.2f ns per point (%.2fx), %s\n", batchNs, singleNs / batchNs,
+		memcmp(single, batched, sizeof(GLfloat) * points) == 0 ? "same results" : "RESULTS DIFFER");
+
+	free(heights);
+	free(quantized);
+	free(x);
+	free(z);
+	free(single);
+	free(batched);
+}
@@ -0,0 +1,55 @@
+/******************************************************************************
+ *
+ * Height Field Queries
+ *
+ * The ground height anywhere over a regular grid of heights, interpolated
+ * bilinearly between the four around the point. Points off the grid (or not
+ * numbers at all) are clamped to its edges, so a query can never read
+ * outside it whatever it's asked.
+ *
+ * Heights are stored quantized to 16 bits between a scale and offset chosen
+ * for the grid's range, two bytes each. The scale is a power of two and the
+ * offset a multiple of it, so heights on the quantization steps (whole
+ * numbers, for one) come back exactly.
+ *
+ * heightfieldSampleBatch() answers many points in one call, four at a time
+ * with SSE where the compiler targets it; it gives exactly the same answers
+ * as heightfieldSample().
+ *
+ ******************************************************************************/
+
+#ifndef HEIGHTFIELD_H
+#define HEIGHTFIELD_H
+
+#include <freeglut.h>
+
+typedef struct {
+	const unsigned short* heights;	// sizeX * sizeZ; vertex (x, z) is heights[x * sizeZ + z]...
+	GLfloat scale, offset;			// ...times scale plus offset (see heightfieldSetRange())
+	int sizeX, sizeZ;				// At least 2 each, or every query answers 0
+	GLfloat originX, originZ;		// Where vertex (0, 0) is
+	GLfloat spacing;				// Distance between neighbouring vertices
+} heightfield_t;
+
+// Choose the field's scale and offset to cover heights from low to high.
+void heightfieldSetRange(heightfield_t* field, GLfloat low, GLfloat high);
+
+// A height in the field's range, quantized to store in its heights.
+unsigned short heightfieldQuantize(const heightfield_t* field, GLfloat height);
+
+// Height of vertex (x, z).
+GLfloat heightfieldVertex(const heightfield_t* field, int x, int z);
+
+// Height of the ground at (x, z).
+GLfloat heightfieldSample(const heightfield_t* field, GLfloat x, GLfloat z);
+
+// Height of the ground at (x[i], z[i]) into heights[i], for count points.
+void heightfieldSampleBatch(const heightfield_t* field, const GLfloat* x, const GLfloat* z, GLfloat* heights,
+	int count);
+
+// Time single and batched queries of random points over a size x size
+// field, and check them against the unquantized heights, printing the results
+// to stdout.
+void heightfieldBenchmark(int size);
+
+#endif
@@ -0,0 +1,418 @@
+/******************************************************************************
+ *
+ * Instanced Meshes (see instancing.h)
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "glfuncs.h"
+#include "glstats.h"
+#include "glstate.h"
+#include "instancing.h"
+#include "renderbackend.h"
+
+// Generic attribute slots; the transform takes four (one per column).
+#define ATTRIB_POSITION		0
+#define ATTRIB_NORMAL		1
+#define ATTRIB_COLOR		2
+#define ATTRIB_SPIN			3
+#define ATTRIB_TRANSFORM	4
+#define ATTRIB_TINT			8
+#define ATTRIB_PHASE		9
+#define ATTRIB_COUNT		10
+
+// Fixed-function lighting (single-sided, local viewer off, colour sum
+// clamped by the fixed pipeline) for the baked vertices of each instance.
+// Built for one set of enabled lights at a time (see buildProgram()), so the
+// compiler drops the lights that are off just as the fixed pipeline does.
+static const char* const vertexShaderSource =
+	"attribute vec3 position;\n"
+	"attribute vec3 normal;\n"
+	"attribute vec4 color;\n"
+	"attribute vec2 spin;\n"
+	"attribute mat4 instanceTransform;\n"
+	"attribute vec4 instanceColor;\n"
+	"attribute float instancePhase;\n"
+	"uniform float spinAngle;\n"
+	"uniform vec3 spinPivot;\n"
+	"uniform bool colorIsAmbient;\n"
+	"void main()\n"
+	"{\n"
+	"	vec3 p = position;\n"
+	"	vec3 n = normal;\n"
+	"	if (spin.x > 0.0) {\n"
+	"		float angle = spinAngle + spin.y + instancePhase;\n"
+	"		float c = cos(angle), s = sin(angle);\n"
+	"		p -= spinPivot;\n"
+	"		p = spinPivot + vec3(c * p.x - s * p.y, s * p.x + c * p.y, p.z);\n"
+	"		n = vec3(c * n.x - s * n.y, s * n.x + c * n.y, n.z);\n"
+	"	}\n"
+	"	vec4 eye = gl_ModelViewMatrix * (instanceTransform * vec4(p, 1.0));\n"
+	"	vec3 N = normalize(gl_NormalMatrix * (mat3(instanceTransform) * n));\n"
+	"	vec4 diffuse = color * instanceColor;\n"
+	"	vec4 ambient = colorIsAmbient ? diffuse : gl_FrontMaterial.ambient;\n"
+	"	vec4 result = diffuse;\n"
+	"	if (lightingEnabled) {\n"
+	"		result = gl_FrontMaterial.emission + ambient * gl_LightModel.ambient;\n"
+	"		for (int i = 0; i < 8; i++) {\n"
+	"			if (!lightEnabled[i]) {\n"
+	"				continue;\n"
+	"			}\n"
+	"			vec3 L = gl_LightSource[i].position.xyz;\n"
+	"			float attenuation = 1.0;\n"
+	"			if (gl_LightSource[i].position.w != 0.0) {\n"
+	"				L -= eye.xyz;\n"
+	"				float d = length(L);\n"
+	"				attenuation = 1.0 / (gl_LightSource[i].constantAttenuation +\n"
+	"					gl_LightSource[i].linearAttenuation * d + gl_LightSource[i].quadraticAttenuation * d * d);\n"
+	"				L /= d;\n"
+	"				if (gl_LightSource[i].spotCutoff <= 90.0) {\n"
+	"					float spotCos = dot(-L, normalize(gl_LightSource[i].spotDirection));\n"
+	"					attenuation *= spotCos < gl_LightSource[i].spotCosCutoff ? 0.0 :\n"
+	"						pow(spotCos, gl_LightSource[i].spotExponent);\n"
+	"				}\n"
+	"			}\n"
+	"			else {\n"
+	"				L = normalize(L);\n"
+	"			}\n"
+	"			float NdotL = max(dot(N, L), 0.0);\n"
+	"			vec4 term = ambient * gl_LightSource[i].ambient + NdotL * diffuse * gl_LightSource[i].diffuse;\n"
+	"			if (NdotL > 0.0) {\n"
+	"				float NdotH = max(dot(N, normalize(L + vec3(0.0, 0.0, 1.0))), 0.0);\n"
+	"				term += pow(NdotH, gl_FrontMaterial.shininess) * gl_FrontMaterial.specular * gl_LightSource[i].specular;\n"
+	"			}\n"
+	"			result += attenuation * term;\n"
+	"		}\n"
+	"		result.a = diffuse.a;\n"
+	"	}\n"
+	"	gl_FrontColor = result;\n"
+	"	gl_Position = gl_ProjectionMatrix * eye;\n"
+	"	gl_FogFragCoord = abs(eye.z);\n"
+	"}\n";
+
+static const char* const attribNames[] = {
+	"position", "normal", "color", "spin", "instanceTransform", NULL, NULL, NULL, "instanceColor", "instancePhase"
+};
+
+// One program per combination of GL_LIGHTING and GL_LIGHT0-7: bit 8 is
+// lighting, bits 0-7 the lights.
+#define PROGRAM_VARIANTS 512
+
+typedef struct {
+	GLuint program;
+	GLint spinAngleLocation;
+	GLint spinPivotLocation;
+	GLint colorIsAmbientLocation;
+} instancingprogram_t;
+
+static int availability = 0;	// 0 not checked yet, 1 available, -1 unavailable
+static int enabled = 1;
+static instancingprogram_t programs[PROGRAM_VARIANTS];
+
+// Compile and link the variant for a lighting mask. Returns 0 on failure.
+static int buildProgram(int variant, instancingprogram_t* out)
+{
+	GLint status;
+	GLchar log[1024];
+	char lightingHeader[256];
+	const GLchar* sources[2] = { lightingHeader, vertexShaderSource };
+
+	int length = snprintf(lightingHeader, sizeof(lightingHeader),
+		"#version 120\nconst bool lightingEnabled = %s;\nconst bool lightEnabled[8] = bool[8](",
+		(variant & 0x100) ? "true" : "false");
+	for (int i = 0; i < 8; i++) {
+		length += snprintf(lightingHeader + length, sizeof(lightingHeader) - length, "%s%s",
+			(variant & (1 << i)) ? "true" : "false", i < 7 ? ", " : ");\n");
+	}
+
+	GLuint shader = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(shader, 2, sources, NULL);
+	glCompileShader(shader);
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+	if (!status) {
+		glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+		printf("Instancing shader failed to compile:\n%s\n", log);
+		glDeleteShader(shader);
+		return 0;
+	}
+
+	GLuint program = glCreateProgram();
+	glAttachShader(program, shader);
+	for (int i = 0; i < ATTRIB_COUNT; i++) {
+		if (attribNames[i] != NULL) {
+			glBindAttribLocation(program, i, attribNames[i]);
+		}
+	}
+	glLinkProgram(program);
+	glDeleteShader(shader);
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (!status) {
+		glGetProgramInfoLog(program, sizeof(log), NULL, log);
+		printf("Instancing shader failed to link:\n%s\n", log);
+		glDeleteProgram(program);
+		return 0;
+	}
+
+	out->program = program;
+	out->spinAngleLocation = glGetUniformLocation(program, "spinAngle");
+	out->spinPivotLocation = glGetUniformLocation(program, "spinPivot");
+	out->colorIsAmbientLocation = glGetUniformLocation(program, "colorIsAmbient");
+	return 1;
+}
+
+// The program for the current lighting state, or NULL if it can't be built.
+static const instancingprogram_t* currentProgram(void)
+{
+	int variant = glIsEnabled(GL_LIGHTING) ? 0x100 : 0;
+	for (int i = 0; i < 8; i++) {
+		if (glIsEnabled(GL_LIGHT0 + i)) {
+			variant |= 1 << i;
+		}
+	}
+
+	instancingprogram_t* program = &programs[variant];
+	if (program->program == 0 && !buildProgram(variant, program)) {
+		return NULL;
+	}
+	return program;
+}
+
+void instancingEnable(int enable)
+{
+	enabled = enable;
+}
+
+int instancingAvailable(void)
+{
+	if (!enabled || !glFuncs.hasBuffers || !glFuncs.hasShaders || !glFuncs.hasInstancing) {
+		return 0;
+	}
+
+	// The core backend draws instances with its own program.
+	if (renderBackendCurrent() == RENDER_BACKEND_CORE) {
+		return renderBackendAvailable(RENDER_BACKEND_CORE);
+	}
+	if (availability == 0) {
+		availability = currentProgram() != NULL ? 1 : -1;
+	}
+	return availability == 1;
+}
+
+/******************************************************************************
+ * Building
+ ******************************************************************************/
+
+// Grow an array to hold at least count elements. Returns 0 if out of memory.
+static int reserve(void** array, int* capacity, int count, size_t elementSize)
+{
+	if (count <= *capacity) {
+		return 1;
+	}
+
+	int newCapacity = *capacity > 0 ? *capacity : 256;
+	while (newCapacity < count) {
+		newCapacity *= 2;
+	}
+	void* grown = realloc(*array, newCapacity * elementSize);
+	if (grown == NULL) {
+		return 0;
+	}
+	*array = grown;
+	*capacity = newCapacity;
+	return 1;
+}
+
+// Inverse transpose of a column-major matrix's upper 3x3, for normals (row-major out).
+static void normalMatrix(const GLfloat m[16], GLfloat out[9])
+{
+	GLfloat a = m[0], b = m[4], c = m[8];
+	GLfloat d = m[1], e = m[5], f = m[9];
+	GLfloat g = m[2], h = m[6], k = m[10];
+
+	GLfloat cofactors[9] = {
+		e * k - f * h, f * g - d * k, d * h - e * g,
+		c * h - b * k, a * k - c * g, b * g - a * h,
+		b * f - c * e, c * d - a * f, a * e - b * d
+	};
+	GLfloat determinant = a * cofactors[0] + b * cofactors[1] + c * cofactors[2];
+	GLfloat scale = determinant != 0.0f ? 1.0f / determinant : 0.0f;
+
+	for (int i = 0; i < 9; i++) {
+		out[i] = cofactors[i] * scale;
+	}
+}
+
+void instancedMeshAddPrimitive(instancedmesh_t* mesh, const primitive_t* primitive, const GLfloat transform[16],
+	const GLfloat color[4], int spins, GLfloat spinStart)
+{
+	static const GLfloat identity[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+	const GLfloat* m = transform != NULL ? transform : identity;
+	GLfloat n[9];
+
+	if (primitive == NULL ||
+		!reserve((void**)&mesh->vertices, &mesh->vertexCapacity, mesh->vertexCount + primitive->vertexCount, sizeof(meshvertex_t)) ||
+		!reserve((void**)&mesh->indices, &mesh->indexCapacity, mesh->indexCount + primitive->indexCount, sizeof(GLuint))) {
+		return;
+	}
+	normalMatrix(m, n);
+
+	for (int i = 0; i < primitive->vertexCount; i++) {
+		const GLfloat* source = &primitive->vertices[i * 6];
+		meshvertex_t* vertex = &mesh->vertices[mesh->vertexCount + i];
+
+		for (int row = 0; row < 3; row++) {
+			vertex->position[row] = m[row] * source[0] + m[4 + row] * source[1] + m[8 + row] * source[2] + m[12 + row];
+			vertex->normal[row] = n[row * 3] * source[3] + n[row * 3 + 1] * source[4] + n[row * 3 + 2] * source[5];
+		}
+		GLfloat length = sqrtf(vertex->normal[0] * vertex->normal[0] + vertex->normal[1] * vertex->normal[1] +
+			vertex->normal[2] * vertex->normal[2]);
+		if (length > 0.0f) {
+			vertex->normal[0] /= length;
+			vertex->normal[1] /= length;
+			vertex->normal[2] /= length;
+		}
+		memcpy(vertex->color, color, sizeof(vertex->color));
+		vertex->spin[0] = spins ? 1.0f : 0.0f;
+		vertex->spin[1] = spinStart;
+	}
+
+	for (int i = 0; i < primitive->indexCount; i++) {
+		mesh->indices[mesh->indexCount + i] = primitive->indices[i] + (GLuint)mesh->vertexCount;
+	}
+	mesh->vertexCount += primitive->vertexCount;
+	mesh->indexCount += primitive->indexCount;
+	mesh->uploaded = 0;
+}
+
+void instanceTransform(meshinstance_t* instance, GLfloat tx, GLfloat ty, GLfloat tz,
+	GLfloat angle, GLfloat x, GLfloat y, GLfloat z)
+{
+	GLfloat* m = instance->transform;
+	GLfloat length = sqrtf(x * x + y * y + z * z);
+	GLfloat radians = angle * 3.14159265358979323846f / 180.0f;
+	GLfloat c = cosf(radians), s = sinf(radians), t = 1.0f - c;
+
+	if (length > 0.0f) {
+		x /= length;
+		y /= length;
+		z /= length;
+	}
+
+	// The glRotatef matrix, columns first, with the translation in the last column.
+	m[0] = t * x * x + c;		m[4] = t * x * y - s * z;	m[8] = t * x * z + s * y;	m[12] = tx;
+	m[1] = t * x * y + s * z;	m[5] = t * y * y + c;		m[9] = t * y * z - s * x;	m[13] = ty;
+	m[2] = t * x * z - s * y;	m[6] = t * y * z + s * x;	m[10] = t * z * z + c;		m[14] = tz;
+	m[3] = 0.0f;				m[7] = 0.0f;				m[11] = 0.0f;				m[15] = 1.0f;
+}
+
+/******************************************************************************
+ * Drawing
+ ******************************************************************************/
+
+void instancedMeshSetInstances(instancedmesh_t* mesh, const meshinstance_t* instances, int count)
+{
+	if (!instancingAvailable()) {
+		return;
+	}
+	if (mesh->instanceBuffer == 0) {
+		glGenBuffers(1, &mesh->instanceBuffer);
+	}
+
+	// Respecified rather than updated, so a frame still drawing the old ones never stalls us.
+	glBindBuffer(GL_ARRAY_BUFFER, mesh->instanceBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(meshinstance_t) * count, instances, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	mesh->instanceCount = count;
+}
+
+static void upload(instancedmesh_t* mesh)
+{
+	if (mesh->vertexBuffer == 0) {
+		glGenBuffers(1, &mesh->vertexBuffer);
+		glGenBuffers(1, &mesh->indexBuffer);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(meshvertex_t) * mesh->vertexCount, mesh->vertices, GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * mesh->indexCount, mesh->indices, GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	mesh->uploaded = 1;
+}
+
+void instancedMeshDraw(instancedmesh_t* mesh, GLfloat spinAngle)
+{
+	if (mesh->instanceCount == 0 || mesh->indexCount == 0 || !instancingAvailable()) {
+		return;
+	}
+
+	if (!mesh->uploaded) {
+		upload(mesh);
+	}
+	if (renderBackendCurrent() == RENDER_BACKEND_CORE) {
+		renderBackendDrawInstanced(mesh, spinAngle);
+		return;
+	}
+
+	const instancingprogram_t* program = currentProgram();
+	if (program == NULL) {
+		return;
+	}
+
+	glUseProgram(program->program);
+	glUniform1f(program->spinAngleLocation, spinAngle);
+	glUniform3fv(program->spinPivotLocation, 1, mesh->spinPivot);
+	glUniform1i(program->colorIsAmbientLocation, mesh->colorIsAmbient);
+
+	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
+	glVertexAttribPointer(ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(meshvertex_t), (const void*)offsetof(meshvertex_t, position));
+	glVertexAttribPointer(ATTRIB_NORMAL, 3, GL_FLOAT, GL_FALSE, sizeof(meshvertex_t), (const void*)offsetof(meshvertex_t, normal));
+	glVertexAttribPointer(ATTRIB_COLOR, 4, GL_FLOAT, GL_FALSE, sizeof(meshvertex_t), (const void*)offsetof(meshvertex_t, color));
+	glVertexAttribPointer(ATTRIB_SPIN, 2, GL_FLOAT, GL_FALSE, sizeof(meshvertex_t), (const void*)offsetof(meshvertex_t, spin));
+
+	glBindBuffer(GL_ARRAY_BUFFER, mesh->instanceBuffer);
+	for (int column = 0; column < 4; column++) {
+		glVertexAttribPointer(ATTRIB_TRANSFORM + column, 4, GL_FLOAT, GL_FALSE, sizeof(meshinstance_t),
+			(const void*)(offsetof(meshinstance_t, transform) + column * 4 * sizeof(GLfloat)));
+	}
+	glVertexAttribPointer(ATTRIB_TINT, 4, GL_FLOAT, GL_FALSE, sizeof(meshinstance_t), (const void*)offsetof(meshinstance_t, color));
+	glVertexAttribPointer(ATTRIB_PHASE, 1, GL_FLOAT, GL_FALSE, sizeof(meshinstance_t), (const void*)offsetof(meshinstance_t, phase));
+
+	for (int i = 0; i < ATTRIB_COUNT; i++) {
+		glEnableVertexAttribArray(i);
+		if (i >= ATTRIB_TRANSFORM) {
+			glVertexAttribDivisor(i, 1);
+		}
+	}
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
+	glDrawElementsInstanced(GL_TRIANGLES, mesh->indexCount, GL_UNSIGNED_INT, NULL, mesh->instanceCount);
+
+	for (int i = 0; i < ATTRIB_COUNT; i++) {
+		if (i >= ATTRIB_TRANSFORM) {
+			glVertexAttribDivisor(i, 0);
+		}
+		glDisableVertexAttribArray(i);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	glUseProgram(0);
+}
+
+void instancedMeshFree(instancedmesh_t* mesh)
+{
+	if (mesh->vertexBuffer != 0) {
+		glDeleteBuffers(1, &mesh->vertexBuffer);
+		glDeleteBuffers(1, &mesh->indexBuffer);
+	}
+	if (mesh->instanceBuffer != 0) {
+		glDeleteBuffers(1, &mesh->instanceBuffer);
+	}
+	free(mesh->vertices);
+	free(mesh->indices);
+	memset(mesh, 0, sizeof(instancedmesh_t));
+}
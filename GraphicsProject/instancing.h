@@ -0,0 +1,93 @@
+/******************************************************************************
+ *
+ * Instanced Meshes
+ *
+ * A mesh is built once from cached primitives, each baked in place with its
+ * own transform and colour, and then drawn any number of times with a single
+ * glDrawElementsInstanced call. Every instance carries its own transform,
+ * a colour that tints the whole mesh and a phase for the mesh's spinning
+ * part (e.g. windmill blades), so the draw count stays at one however many
+ * instances there are.
+ *
+ * With the fixed render backend only the vertex stage is programmable: a
+ * compatibility-profile shader that does the fixed-function per-vertex
+ * lighting (the same eight lights, material and light model state), leaving
+ * texturing and fog to the fixed pipeline. The core backend draws instances
+ * with its own program (see renderbackend.h). Needs OpenGL 3.3 entry points;
+ * instancingAvailable() tells the caller when it has to draw the old way.
+ *
+ ******************************************************************************/
+
+#ifndef INSTANCING_H
+#define INSTANCING_H
+
+#include <freeglut.h>
+#include "primitives.h"
+
+// One vertex of an instanced mesh, in mesh space.
+typedef struct {
+	GLfloat position[3];
+	GLfloat normal[3];
+	GLfloat color[4];
+	GLfloat spin[2];		// 1 if the vertex turns with the spin, and the angle (radians) it starts at
+} meshvertex_t;
+
+// Per-instance data, uploaded as is.
+typedef struct {
+	GLfloat transform[16];	// Mesh to world, column-major like glMultMatrixf
+	GLfloat color[4];		// Multiplies the vertex colours
+	GLfloat phase;			// Radians added to the spin angle
+} meshinstance_t;
+
+typedef struct {
+	meshvertex_t* vertices;
+	GLuint* indices;
+	int vertexCount;
+	int indexCount;
+	int vertexCapacity;
+	int indexCapacity;
+
+	// Spinning vertices turn about the z axis through this point (in the
+	// space they were added in, before their transform).
+	GLfloat spinPivot[3];
+
+	// 1 if the colours set the ambient as well as the diffuse material (like
+	// GL_AMBIENT_AND_DIFFUSE), 0 to take the ambient from the current material.
+	int colorIsAmbient;
+
+	// Private: GL buffers, created on first draw.
+	GLuint vertexBuffer;
+	GLuint indexBuffer;
+	GLuint instanceBuffer;
+	int instanceCount;
+	int uploaded;
+} instancedmesh_t;
+
+// 1 if instanced meshes can be drawn on the current context (compiling the shader the first time).
+int instancingAvailable(void);
+
+// Append a primitive to a mesh, placed by a transform (column-major, NULL for
+// none) and coloured. Spinning parts rotate about the mesh's spin pivot,
+// starting at spinStart radians, with the transform applied first.
+void instancedMeshAddPrimitive(instancedmesh_t* mesh, const primitive_t* primitive, const GLfloat transform[16],
+	const GLfloat color[4], int spins, GLfloat spinStart);
+
+// Turn instanced drawing off (or back on); when off instancingAvailable() returns 0.
+void instancingEnable(int enabled);
+
+// Replace a mesh's instances. Call again whenever they change.
+void instancedMeshSetInstances(instancedmesh_t* mesh, const meshinstance_t* instances, int count);
+
+// Draw every instance of a mesh with the current modelview matrix, spinning
+// parts turned by spinAngle (radians) plus each instance's phase.
+void instancedMeshDraw(instancedmesh_t* mesh, GLfloat spinAngle);
+
+// Free a mesh's arrays and buffers.
+void instancedMeshFree(instancedmesh_t* mesh);
+
+// Set an instance transform to a translation followed by a rotation of angle
+// degrees about (x, y, z), like glTranslatef then glRotatef.
+void instanceTransform(meshinstance_t* instance, GLfloat tx, GLfloat ty, GLfloat tz,
+	GLfloat angle, GLfloat x, GLfloat y, GLfloat z);
+
+#endif
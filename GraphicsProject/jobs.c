@@ -0,0 +1,166 @@
+/******************************************************************************
+ *
+ * Worker Pool (see jobs.h)
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include "jobs.h"
+#include "platform.h"
+#include "trace.h"
+
+#define JOBS_QUEUE_SIZE 256
+
+typedef struct {
+	jobfunc_t func;
+	void* argument;
+} job_t;
+
+// Everything below is guarded by mutex.
+static platformmutex_t* mutex = NULL;
+static platformcondition_t* jobQueued = NULL;		// Signalled when a job is queued or the pool stops.
+static platformcondition_t* jobFinished = NULL;		// Signalled when the last outstanding job finishes.
+static job_t queue[JOBS_QUEUE_SIZE];
+static int queueHead = 0;
+static int queueCount = 0;
+static int jobsOutstanding = 0;						// Queued plus running.
+static int stopping = 0;
+
+static platformthread_t* threads[JOBS_MAX_THREADS];
+static int threadCount = 0;
+
+// Take the next job off the queue. The mutex must be held and the queue not empty.
+static job_t popJob(void)
+{
+	job_t job = queue[queueHead];
+	queueHead = (queueHead + 1) % JOBS_QUEUE_SIZE;
+	queueCount--;
+	return job;
+}
+
+// Run a job with the mutex released, then mark it finished.
+static void runJob(job_t job)
+{
+	platformMutexUnlock(mutex);
+	job.func(job.argument);
+	platformMutexLock(mutex);
+
+	jobsOutstanding--;
+	if (jobsOutstanding == 0) {
+		platformConditionBroadcast(jobFinished);
+	}
+}
+
+static void workerMain(void* argument)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "worker %d", (int)(size_t)argument);
+	traceSetThreadName(name);
+
+	platformMutexLock(mutex);
+	for (;;) {
+		while (queueCount == 0 && !stopping) {
+			platformConditionWait(jobQueued, mutex);
+		}
+		if (queueCount == 0) {
+			break;
+		}
+		runJob(popJob());
+	}
+	platformMutexUnlock(mutex);
+}
+
+int jobsStart(int count)
+{
+	if (mutex != NULL) {
+		return threadCount;
+	}
+
+	if (count <= 0) {
+		count = platformCpuCount() - 1;
+	}
+	if (count > JOBS_MAX_THREADS) {
+		count = JOBS_MAX_THREADS;
+	}
+
+	mutex = platformMutexCreate();
+	jobQueued = platformConditionCreate();
+	jobFinished = platformConditionCreate();
+	stopping = 0;
+
+	for (int i = 0; i < count; i++) {
+		threads[threadCount] = platformThreadCreate(workerMain, (void*)(size_t)(i + 1));
+		if (threads[threadCount] == NULL) {
+			break;
+		}
+		threadCount++;
+	}
+	return threadCount;
+}
+
+void jobsSubmit(jobfunc_t func, void* argument)
+{
+	if (mutex == NULL) {
+		func(argument);
+		return;
+	}
+
+	platformMutexLock(mutex);
+	if (queueCount == JOBS_QUEUE_SIZE) {
+		platformMutexUnlock(mutex);
+		func(argument);
+		return;
+	}
+
+	queue[(queueHead + queueCount) % JOBS_QUEUE_SIZE] = (job_t){ func, argument };
+	queueCount++;
+	jobsOutstanding++;
+	platformConditionSignal(jobQueued);
+	platformMutexUnlock(mutex);
+}
+
+void jobsWait(void)
+{
+	if (mutex == NULL) {
+		return;
+	}
+
+	tracezone_t traceZone = traceBegin("jobsWait");
+	platformMutexLock(mutex);
+	while (jobsOutstanding > 0) {
+		if (queueCount > 0) {
+			runJob(popJob());
+		}
+		else {
+			platformConditionWait(jobFinished, mutex);
+		}
+	}
+	platformMutexUnlock(mutex);
+	traceEnd(traceZone);
+}
+
+void jobsStop(void)
+{
+	if (mutex == NULL) {
+		return;
+	}
+
+	jobsWait();
+
+	platformMutexLock(mutex);
+	stopping = 1;
+	platformConditionBroadcast(jobQueued);
+	platformMutexUnlock(mutex);
+
+	for (int i = 0; i < threadCount; i++) {
+		platformThreadJoin(threads[i]);
+	}
+	threadCount = 0;
+
+	platformConditionDestroy(jobQueued);
+	platformConditionDestroy(jobFinished);
+	platformMutexDestroy(mutex);
+	jobQueued = NULL;
+	jobFinished = NULL;
+	mutex = NULL;
+}
@@ -0,0 +1,35 @@
+/******************************************************************************
+ *
+ * Worker Pool
+ *
+ * A small pool of worker threads for independent pieces of work (decoding
+ * assets and the like). Jobs are taken in the order they were submitted, and
+ * a thread waiting in jobsWait() runs queued jobs itself rather than idling,
+ * so the pool also works (serially) with no worker threads at all.
+ *
+ ******************************************************************************/
+
+#ifndef JOBS_H
+#define JOBS_H
+
+// Most worker threads the pool will start.
+#define JOBS_MAX_THREADS 8
+
+typedef void (*jobfunc_t)(void* argument);
+
+// Start the worker threads. threadCount <= 0 picks one fewer than the number of
+// processors. Calling it again once started does nothing. Returns the number of
+// worker threads running.
+int jobsStart(int threadCount);
+
+// Queue func(argument) to run on the pool (or run it straight away, on the
+// calling thread, if the pool hasn't been started or its queue is full).
+void jobsSubmit(jobfunc_t func, void* argument);
+
+// Wait until every job submitted so far has finished.
+void jobsWait(void);
+
+// Finish any queued jobs and stop the worker threads.
+void jobsStop(void);
+
+#endif
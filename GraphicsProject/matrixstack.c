@@ -0,0 +1,249 @@
+/******************************************************************************
+ *
+ * Matrix Stacks (see matrixstack.h)
+ *
+ ******************************************************************************/
+
+#define MATRIXSTACK_IMPLEMENTATION
+
+#include <math.h>
+#include <string.h>
+#include "glfuncs.h"
+#include "matrixstack.h"
+
+typedef struct {
+	GLfloat matrices[MATRIX_STACK_DEPTH][16];
+	int depth;					// Index of the top
+} matrixstack_t;
+
+static const GLfloat identity[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+
+static matrixstack_t modelview = { { { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 } }, 0 };
+static matrixstack_t projection = { { { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 } }, 0 };
+static matrixstack_t* current = &modelview;
+
+// Whether changes go on to OpenGL's own stacks too.
+static int forward(void)
+{
+	return !glFuncs.coreProfile;
+}
+
+static GLfloat* topMatrix(void)
+{
+	return current->matrices[current->depth];
+}
+
+void matrixMultiply(const GLfloat a[16], const GLfloat b[16], GLfloat out[16])
+{
+	GLfloat result[16];
+
+	for (int column = 0; column < 4; column++) {
+		for (int row = 0; row < 4; row++) {
+			result[column * 4 + row] = a[row] * b[column * 4] + a[4 + row] * b[column * 4 + 1] +
+				a[8 + row] * b[column * 4 + 2] + a[12 + row] * b[column * 4 + 3];
+		}
+	}
+	memcpy(out, result, sizeof(result));
+}
+
+// Post-multiply the current matrix, like every GL matrix function does.
+static void multiply(const GLfloat matrix[16])
+{
+	matrixMultiply(topMatrix(), matrix, topMatrix());
+}
+
+/******************************************************************************
+ * Stack
+ ******************************************************************************/
+
+void matrixStackMode(GLenum mode)
+{
+	current = mode == GL_PROJECTION ? &projection : &modelview;
+	if (forward()) {
+		glMatrixMode(mode);
+	}
+}
+
+void matrixStackLoadIdentity(void)
+{
+	memcpy(topMatrix(), identity, sizeof(identity));
+	if (forward()) {
+		glLoadIdentity();
+	}
+}
+
+void matrixStackLoad(const GLfloat matrix[16])
+{
+	memcpy(topMatrix(), matrix, 16 * sizeof(GLfloat));
+	if (forward()) {
+		glLoadMatrixf(matrix);
+	}
+}
+
+void matrixStackMultiply(const GLfloat matrix[16])
+{
+	multiply(matrix);
+	if (forward()) {
+		glMultMatrixf(matrix);
+	}
+}
+
+void matrixStackPush(void)
+{
+	// Overflowing (or underflowing, below) is an error that OpenGL ignores too.
+	if (current->depth < MATRIX_STACK_DEPTH - 1) {
+		memcpy(current->matrices[current->depth + 1], topMatrix(), 16 * sizeof(GLfloat));
+		current->depth++;
+	}
+	if (forward()) {
+		glPushMatrix();
+	}
+}
+
+void matrixStackPop(void)
+{
+	if (current->depth > 0) {
+		current->depth--;
+	}
+	if (forward()) {
+		glPopMatrix();
+	}
+}
+
+const GLfloat* matrixStackTop(GLenum mode)
+{
+	const matrixstack_t* stack = mode == GL_PROJECTION ? &projection : &modelview;
+	return stack->matrices[stack->depth];
+}
+
+/******************************************************************************
+ * Transforms
+ ******************************************************************************/
+
+void matrixStackTranslate(GLfloat x, GLfloat y, GLfloat z)
+{
+	GLfloat* m = topMatrix();
+
+	for (int row = 0; row < 4; row++) {
+		m[12 + row] += m[row] * x + m[4 + row] * y + m[8 + row] * z;
+	}
+	if (forward()) {
+		glTranslatef(x, y, z);
+	}
+}
+
+void matrixStackRotate(GLfloat angle, GLfloat x, GLfloat y, GLfloat z)
+{
+	GLfloat length = sqrtf(x * x + y * y + z * z);
+	GLfloat radians = angle * 3.14159265358979323846f / 180.0f;
+	GLfloat c = cosf(radians), s = sinf(radians), t = 1.0f - c;
+
+	if (length > 0.0f) {
+		GLfloat ux = x / length, uy = y / length, uz = z / length;
+		GLfloat rotation[16] = {
+			t * ux * ux + c,		t * ux * uy + s * uz,	t * ux * uz - s * uy,	0.0f,
+			t * ux * uy - s * uz,	t * uy * uy + c,		t * uy * uz + s * ux,	0.0f,
+			t * ux * uz + s * uy,	t * uy * uz - s * ux,	t * uz * uz + c,		0.0f,
+			0.0f,					0.0f,					0.0f,					1.0f
+		};
+		multiply(rotation);
+	}
+	if (forward()) {
+		glRotatef(angle, x, y, z);
+	}
+}
+
+void matrixStackScale(GLfloat x, GLfloat y, GLfloat z)
+{
+	GLfloat* m = topMatrix();
+
+	for (int row = 0; row < 4; row++) {
+		m[row] *= x;
+		m[4 + row] *= y;
+		m[8 + row] *= z;
+	}
+	if (forward()) {
+		glScalef(x, y, z);
+	}
+}
+
+void matrixStackOrtho(GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble zNear, GLdouble zFar)
+{
+	GLfloat ortho[16] = {
+		(GLfloat)(2.0 / (right - left)), 0.0f, 0.0f, 0.0f,
+		0.0f, (GLfloat)(2.0 / (top - bottom)), 0.0f, 0.0f,
+		0.0f, 0.0f, (GLfloat)(-2.0 / (zFar - zNear)), 0.0f,
+		(GLfloat)(-(right + left) / (right - left)), (GLfloat)(-(top + bottom) / (top - bottom)),
+		(GLfloat)(-(zFar + zNear) / (zFar - zNear)), 1.0f
+	};
+
+	multiply(ortho);
+	if (forward()) {
+		glOrtho(left, right, bottom, top, zNear, zFar);
+	}
+}
+
+void matrixStackPerspective(GLdouble fovy, GLdouble aspect, GLdouble zNear, GLdouble zFar)
+{
+	GLdouble f = 1.0 / tan(fovy * 3.14159265358979323846 / 360.0);
+	GLfloat perspective[16] = {
+		(GLfloat)(f / aspect), 0.0f, 0.0f, 0.0f,
+		0.0f, (GLfloat)f, 0.0f, 0.0f,
+		0.0f, 0.0f, (GLfloat)((zFar + zNear) / (zNear - zFar)), -1.0f,
+		0.0f, 0.0f, (GLfloat)(2.0 * zFar * zNear / (zNear - zFar)), 0.0f
+	};
+
+	multiply(perspective);
+	if (forward()) {
+		gluPerspective(fovy, aspect, zNear, zFar);
+	}
+}
+
+void matrixStackLookAt(GLdouble eyeX, GLdouble eyeY, GLdouble eyeZ, GLdouble centerX, GLdouble centerY,
+	GLdouble centerZ, GLdouble upX, GLdouble upY, GLdouble upZ)
+{
+	GLdouble forwardAxis[3] = { centerX - eyeX, centerY - eyeY, centerZ - eyeZ };
+	GLdouble length = sqrt(forwardAxis[0] * forwardAxis[0] + forwardAxis[1] * forwardAxis[1] + forwardAxis[2] * forwardAxis[2]);
+
+	if (length > 0.0) {
+		forwardAxis[0] /= length;
+		forwardAxis[1] /= length;
+		forwardAxis[2] /= length;
+	}
+
+	// side = forward x up, then up = side x forward, as gluLookAt does.
+	GLdouble side[3] = {
+		forwardAxis[1] * upZ - forwardAxis[2] * upY,
+		forwardAxis[2] * upX - forwardAxis[0] * upZ,
+		forwardAxis[0] * upY - forwardAxis[1] * upX
+	};
+	length = sqrt(side[0] * side[0] + side[1] * side[1] + side[2] * side[2]);
+	if (length > 0.0) {
+		side[0] /= length;
+		side[1] /= length;
+		side[2] /= length;
+	}
+	GLdouble up[3] = {
+		side[1] * forwardAxis[2] - side[2] * forwardAxis[1],
+		side[2] * forwardAxis[0] - side[0] * forwardAxis[2],
+		side[0] * forwardAxis[1] - side[1] * forwardAxis[0]
+	};
+
+	GLfloat view[16] = {
+		(GLfloat)side[0], (GLfloat)up[0], (GLfloat)-forwardAxis[0], 0.0f,
+		(GLfloat)side[1], (GLfloat)up[1], (GLfloat)-forwardAxis[1], 0.0f,
+		(GLfloat)side[2], (GLfloat)up[2], (GLfloat)-forwardAxis[2], 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	};
+
+	multiply(view);
+
+	// Then move the eye to the origin.
+	GLfloat* m = topMatrix();
+	for (int row = 0; row < 4; row++) {
+		m[12 + row] += m[row] * (GLfloat)-eyeX + m[4 + row] * (GLfloat)-eyeY + m[8 + row] * (GLfloat)-eyeZ;
+	}
+	if (forward()) {
+		gluLookAt(eyeX, eyeY, eyeZ, centerX, centerY, centerZ, upX, upY, upZ);
+	}
+}
@@ -0,0 +1,64 @@
+/******************************************************************************
+ *
+ * Matrix Stacks
+ *
+ * CPU-side copies of the modelview and projection matrix stacks. Including
+ * this header redirects the GL/GLU matrix functions the project uses here,
+ * so the current matrices can be read back without a glGet (the render queue
+ * does it for every item) and exist at all in a core profile context, which
+ * has no matrix stacks of its own. Every change is also passed on to OpenGL
+ * unless the context is a core profile one (see glFuncs.coreProfile), so the
+ * fixed-function pipeline sees the same matrices.
+ *
+ ******************************************************************************/
+
+#ifndef MATRIXSTACK_H
+#define MATRIXSTACK_H
+
+#include <freeglut.h>
+
+// Deepest either stack can go (OpenGL guarantees 32 and 2).
+#define MATRIX_STACK_DEPTH 32
+
+void matrixStackMode(GLenum mode);
+void matrixStackLoadIdentity(void);
+void matrixStackLoad(const GLfloat matrix[16]);
+void matrixStackMultiply(const GLfloat matrix[16]);
+void matrixStackPush(void);
+void matrixStackPop(void);
+void matrixStackTranslate(GLfloat x, GLfloat y, GLfloat z);
+void matrixStackRotate(GLfloat angle, GLfloat x, GLfloat y, GLfloat z);
+void matrixStackScale(GLfloat x, GLfloat y, GLfloat z);
+void matrixStackOrtho(GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble zNear, GLdouble zFar);
+void matrixStackPerspective(GLdouble fovy, GLdouble aspect, GLdouble zNear, GLdouble zFar);
+void matrixStackLookAt(GLdouble eyeX, GLdouble eyeY, GLdouble eyeZ, GLdouble centerX, GLdouble centerY,
+	GLdouble centerZ, GLdouble upX, GLdouble upY, GLdouble upZ);
+
+// The top of the GL_MODELVIEW or GL_PROJECTION stack (column-major, like glGetFloatv).
+const GLfloat* matrixStackTop(GLenum mode);
+
+// out = a * b, all column-major (out may be either of them).
+void matrixMultiply(const GLfloat a[16], const GLfloat b[16], GLfloat out[16]);
+
+#ifndef MATRIXSTACK_IMPLEMENTATION
+
+#define glMatrixMode(mode) matrixStackMode(mode)
+#define glLoadIdentity() matrixStackLoadIdentity()
+#define glLoadMatrixf(matrix) matrixStackLoad(matrix)
+#define glMultMatrixf(matrix) matrixStackMultiply(matrix)
+#define glPushMatrix() matrixStackPush()
+#define glPopMatrix() matrixStackPop()
+#define glTranslatef(x, y, z) matrixStackTranslate(x, y, z)
+#define glTranslated(x, y, z) matrixStackTranslate((GLfloat)(x), (GLfloat)(y), (GLfloat)(z))
+#define glRotatef(angle, x, y, z) matrixStackRotate(angle, x, y, z)
+#define glRotated(angle, x, y, z) matrixStackRotate((GLfloat)(angle), (GLfloat)(x), (GLfloat)(y), (GLfloat)(z))
+#define glScalef(x, y, z) matrixStackScale(x, y, z)
+#define glScaled(x, y, z) matrixStackScale((GLfloat)(x), (GLfloat)(y), (GLfloat)(z))
+#define glOrtho(left, right, bottom, top, zNear, zFar) matrixStackOrtho(left, right, bottom, top, zNear, zFar)
+#define gluPerspective(fovy, aspect, zNear, zFar) matrixStackPerspective(fovy, aspect, zNear, zFar)
+#define gluLookAt(eyeX, eyeY, eyeZ, centerX, centerY, centerZ, upX, upY, upZ) \
+	matrixStackLookAt(eyeX, eyeY, eyeZ, centerX, centerY, centerZ, upX, upY, upZ)
+
+#endif
+
+#endif
@@ -0,0 +1,393 @@
+/******************************************************************************
+ *
+ * Occlusion Culling (see occlusion.h)
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "jobs.h"
+#include "occlusion.h"
+
+// Floats per screen space triangle: x, y and 1 / w for each corner.
+#define TRIANGLE_FLOATS 9
+
+static int reserve(void** items, int* capacity, int needed, size_t itemSize)
+{
+	if (needed <= *capacity) {
+		return 1;
+	}
+	int grown = *capacity > 0 ? *capacity : 256;
+	while (grown < needed) {
+		grown *= 2;
+	}
+	void* resized = realloc(*items, itemSize * grown);
+	if (resized == NULL) {
+		return 0;
+	}
+	*items = resized;
+	*capacity = grown;
+	return 1;
+}
+
+/******************************************************************************
+ * Occluders
+ ******************************************************************************/
+
+static GLfloat heightAt(const GLfloat* heights, size_t heightStride, size_t index)
+{
+	return *(const GLfloat*)((const char*)heights + index * heightStride);
+}
+
+int occluderFromHeights(occluder_t* occluder, const GLfloat* heights, size_t heightStride, int sizeX, int sizeZ,
+	GLfloat originX, GLfloat originZ, GLfloat spacing, int step)
+{
+	occluder->vertexCount = 0;
+	occluder->indexCount = 0;
+	if (sizeX < 2 || sizeZ < 2 || step < 1) {
+		return 1;
+	}
+
+	// Every step-th row and column, and always the last.
+	int countX = (sizeX - 2) / step + 2, countZ = (sizeZ - 2) / step + 2;
+	if (!reserve((void**)&occluder->vertices, &occluder->vertexCapacity, countX * countZ, sizeof(GLfloat) * 3)
+		|| !reserve((void**)&occluder->indices, &occluder->indexCapacity, 6 * (countX - 1) * (countZ - 1),
+			sizeof(GLuint))) {
+		return 0;
+	}
+
+	// Each vertex takes the lowest height of the cells around it, so the
+	// triangles between them never rise above the grid's. The lowest along
+	// z is found first, for every row, then across the rows.
+	GLfloat* lowestZ = malloc(sizeof(GLfloat) * sizeX * countZ);
+	if (lowestZ == NULL) {
+		return 0;
+	}
+	for (int x = 0; x < sizeX; x++) {
+		for (int j = 0; j < countZ; j++) {
+			int z = j < countZ - 1 ? j * step : sizeZ - 1;
+			int first = j > 0 ? (j - 1) * step : 0;
+			int last = j < countZ - 2 ? (j + 1) * step : sizeZ - 1;
+			GLfloat lowest = heightAt(heights, heightStride, (size_t)x * sizeZ + z);
+			for (int k = first; k <= last; k++) {
+				GLfloat height = heightAt(heights, heightStride, (size_t)x * sizeZ + k);
+				lowest = height < lowest ? height : lowest;
+			}
+			lowestZ[x * countZ + j] = lowest;
+		}
+	}
+	for (int i = 0; i < countX; i++) {
+		int x = i < countX - 1 ? i * step : sizeX - 1;
+		int first = i > 0 ? (i - 1) * step : 0;
+		int last = i < countX - 2 ? (i + 1) * step : sizeX - 1;
+		for (int j = 0; j < countZ; j++) {
+			int z = j < countZ - 1 ? j * step : sizeZ - 1;
+			GLfloat lowest = lowestZ[x * countZ + j];
+			for (int k = first; k <= last; k++) {
+				GLfloat height = lowestZ[k * countZ + j];
+				lowest = height < lowest ? height : lowest;
+			}
+			GLfloat* vertex = &occluder->vertices[3 * (i * countZ + j)];
+			vertex[0] = originX + x * spacing;
+			vertex[1] = lowest;
+			vertex[2] = originZ + z * spacing;
+		}
+	}
+	free(lowestZ);
+
+	// Anticlockwise seen from above.
+	GLuint* index = occluder->indices;
+	for (int i = 0; i < countX - 1; i++) {
+		for (int j = 0; j < countZ - 1; j++) {
+			GLuint corner = i * countZ + j;
+			*index++ = corner;
+			*index++ = corner + 1;
+			*index++ = corner + countZ;
+			*index++ = corner + countZ;
+			*index++ = corner + 1;
+			*index++ = corner + countZ + 1;
+		}
+	}
+	occluder->vertexCount = countX * countZ;
+	occluder->indexCount = 6 * (countX - 1) * (countZ - 1);
+	return 1;
+}
+
+void occluderFree(occluder_t* occluder)
+{
+	free(occluder->vertices);
+	free(occluder->indices);
+	memset(occluder, 0, sizeof(*occluder));
+}
+
+/******************************************************************************
+ * Rasterizing
+ ******************************************************************************/
+
+typedef struct {
+	GLfloat x, y, z, w;
+} clipvertex_t;
+
+typedef struct {
+	occlusion_t* occlusion;
+	int firstRow, lastRow;	// [firstRow, lastRow)
+} band_t;
+
+static clipvertex_t toClip(const GLfloat* m, const GLfloat* v)
+{
+	clipvertex_t c;
+	c.x = m[0] * v[0] + m[4] * v[1] + m[8] * v[2] + m[12];
+	c.y = m[1] * v[0] + m[5] * v[1] + m[9] * v[2] + m[13];
+	c.z = m[2] * v[0] + m[6] * v[1] + m[10] * v[2] + m[14];
+	c.w = m[3] * v[0] + m[7] * v[1] + m[11] * v[2] + m[15];
+	return c;
+}
+
+static clipvertex_t lerpClip(clipvertex_t a, clipvertex_t b, GLfloat t)
+{
+	clipvertex_t c = { a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t };
+	return c;
+}
+
+static void toScreen(clipvertex_t c, GLfloat* screen)
+{
+	GLfloat inverseW = 1.0f / c.w;
+	screen[0] = (c.x * inverseW * 0.5f + 0.5f) * OCCLUSION_WIDTH;
+	screen[1] = (c.y * inverseW * 0.5f + 0.5f) * OCCLUSION_HEIGHT;
+	screen[2] = inverseW;
+}
+
+static GLfloat edge(const GLfloat* a, const GLfloat* b, GLfloat x, GLfloat y)
+{
+	return (b[0] - a[0]) * (y - a[1]) - (b[1] - a[1]) * (x - a[0]);
+}
+
+// Clip a triangle to the near plane and add what's left to the screen space
+// triangles, unless it faces away. Returns 0 if out of memory.
+static int addTriangle(occlusion_t* occlusion, clipvertex_t a, clipvertex_t b, clipvertex_t c)
+{
+	clipvertex_t in[3] = { a, b, c }, out[4];
+	int count = 0;
+
+	// Wholly off one side of the frustum?
+	if ((a.x > a.w && b.x > b.w && c.x > c.w) || (a.x < -a.w && b.x < -b.w && c.x < -c.w)
+		|| (a.y > a.w && b.y > b.w && c.y > c.w) || (a.y < -a.w && b.y < -b.w && c.y < -c.w)
+		|| (a.z > a.w && b.z > b.w && c.z > c.w) || (a.z < -a.w && b.z < -b.w && c.z < -c.w)) {
+		return 1;
+	}
+
+	for (int i = 0; i < 3; i++) {
+		clipvertex_t from = in[i], to = in[(i + 1) % 3];
+		GLfloat fromDistance = from.z + from.w, toDistance = to.z + to.w;
+		if (fromDistance >= 0.0f) {
+			out[count++] = from;
+		}
+		if ((fromDistance >= 0.0f) != (toDistance >= 0.0f)) {
+			out[count++] = lerpClip(from, to, fromDistance / (fromDistance - toDistance));
+		}
+	}
+
+	// Seen from above the ground, a triangle facing away is always behind
+	// one facing the eye, so only those are drawn.
+	for (int i = 2; i < count; i++) {
+		if (!reserve((void**)&occlusion->triangles, &occlusion->triangleCapacity, occlusion->triangleCount + 1,
+			sizeof(GLfloat) * TRIANGLE_FLOATS)) {
+			return 0;
+		}
+		GLfloat* triangle = &occlusion->triangles[TRIANGLE_FLOATS * occlusion->triangleCount];
+		toScreen(out[0], triangle);
+		toScreen(out[i - 1], triangle + 3);
+		toScreen(out[i], triangle + 6);
+		if (edge(triangle, triangle + 3, triangle[6], triangle[7]) > 0.0f) {
+			occlusion->triangleCount++;
+		}
+	}
+	return 1;
+}
+
+// Draw every triangle into the band's rows of level 0, sampling at texel
+// centres and keeping the nearest depth.
+static void drawBand(void* argument)
+{
+	const band_t* band = argument;
+	occlusion_t* occlusion = band->occlusion;
+	GLfloat* depth = occlusion->depth[0];
+
+	for (int t = 0; t < occlusion->triangleCount; t++) {
+		const GLfloat* a = &occlusion->triangles[TRIANGLE_FLOATS * t];
+		const GLfloat* b = a + 3;
+		const GLfloat* c = a + 6;
+		GLfloat area = edge(a, b, c[0], c[1]);
+
+		GLfloat minX = fminf(a[0], fminf(b[0], c[0])), maxX = fmaxf(a[0], fmaxf(b[0], c[0]));
+		GLfloat minY = fminf(a[1], fminf(b[1], c[1])), maxY = fmaxf(a[1], fmaxf(b[1], c[1]));
+		int firstX = minX > 0.0f ? (int)minX : 0;
+		int lastX = maxX < OCCLUSION_WIDTH - 1 ? (int)maxX : OCCLUSION_WIDTH - 1;
+		int firstY = minY > band->firstRow ? (int)minY : band->firstRow;
+		int lastY = maxY < band->lastRow - 1 ? (int)maxY : band->lastRow - 1;
+
+		// The barycentric coordinates of each texel centre, stepped along the
+		// rows. 1 / w is linear in screen space, so it's interpolated straight
+		// from them.
+		GLfloat inverseArea = 1.0f / area;
+		GLfloat stepA = (b[1] - c[1]) * inverseArea, stepB = (c[1] - a[1]) * inverseArea;
+		for (int y = firstY; y <= lastY; y++) {
+			GLfloat* row = &depth[y * OCCLUSION_WIDTH];
+			GLfloat la = edge(b, c, firstX + 0.5f, y + 0.5f) * inverseArea;
+			GLfloat lb = edge(c, a, firstX + 0.5f, y + 0.5f) * inverseArea;
+			for (int x = firstX; x <= lastX; x++, la += stepA, lb += stepB) {
+				GLfloat lc = 1.0f - la - lb;
+				if (la >= 0.0f && lb >= 0.0f && lc >= 0.0f) {
+					GLfloat z = la * a[2] + lb * b[2] + lc * c[2];
+					row[x] = z > row[x] ? z : row[x];
+				}
+			}
+		}
+	}
+}
+
+int occlusionRender(occlusion_t* occlusion, const occluder_t* occluder, const GLfloat* projection,
+	const GLfloat* modelview)
+{
+	occlusion->ready = 0;
+	if (occlusion->depth[0] == NULL) {
+		size_t texels = 0;
+		for (int level = 0; level < OCCLUSION_LEVELS; level++) {
+			occlusion->width[level] = level == 0 ? OCCLUSION_WIDTH : (occlusion->width[level - 1] + 1) / 2;
+			occlusion->height[level] = level == 0 ? OCCLUSION_HEIGHT : (occlusion->height[level - 1] + 1) / 2;
+			texels += (size_t)occlusion->width[level] * occlusion->height[level];
+		}
+		GLfloat* depth = malloc(sizeof(GLfloat) * texels);
+		if (depth == NULL) {
+			return 0;
+		}
+		for (int level = 0; level < OCCLUSION_LEVELS; level++) {
+			occlusion->depth[level] = depth;
+			depth += occlusion->width[level] * occlusion->height[level];
+		}
+	}
+
+	for (int j = 0; j < 4; j++) {
+		for (int i = 0; i < 4; i++) {
+			occlusion->clip[i + 4 * j] = projection[i] * modelview[4 * j] + projection[i + 4] * modelview[4 * j + 1]
+				+ projection[i + 8] * modelview[4 * j + 2] + projection[i + 12] * modelview[4 * j + 3];
+		}
+	}
+
+	// Into screen space once, for all the bands.
+	if (!reserve((void**)&occlusion->clipVertices, &occlusion->clipVertexCapacity, occluder->vertexCount,
+		sizeof(clipvertex_t))) {
+		return 0;
+	}
+	clipvertex_t* clipVertices = (clipvertex_t*)occlusion->clipVertices;
+	for (int i = 0; i < occluder->vertexCount; i++) {
+		clipVertices[i] = toClip(occlusion->clip, &occluder->vertices[3 * i]);
+	}
+	occlusion->triangleCount = 0;
+	for (int i = 0; i < occluder->indexCount; i += 3) {
+		const GLuint* index = &occluder->indices[i];
+		if (!addTriangle(occlusion, clipVertices[index[0]], clipVertices[index[1]], clipVertices[index[2]])) {
+			return 0;
+		}
+	}
+
+	memset(occlusion->depth[0], 0, sizeof(GLfloat) * OCCLUSION_WIDTH * OCCLUSION_HEIGHT);
+	band_t bands[OCCLUSION_BANDS];
+	for (int i = 0; i < OCCLUSION_BANDS; i++) {
+		bands[i].occlusion = occlusion;
+		bands[i].firstRow = i * OCCLUSION_HEIGHT / OCCLUSION_BANDS;
+		bands[i].lastRow = (i + 1) * OCCLUSION_HEIGHT / OCCLUSION_BANDS;
+		jobsSubmit(drawBand, &bands[i]);
+	}
+	jobsWait();
+
+	// Each level up keeps the farthest of the (up to) 2x2 texels under it.
+	for (int level = 1; level < OCCLUSION_LEVELS; level++) {
+		const GLfloat* below = occlusion->depth[level - 1];
+		GLfloat* above = occlusion->depth[level];
+		int belowWidth = occlusion->width[level - 1], belowHeight = occlusion->height[level - 1];
+		for (int y = 0; y < occlusion->height[level]; y++) {
+			int y0 = 2 * y, y1 = 2 * y + 1 < belowHeight ? 2 * y + 1 : 2 * y;
+			for (int x = 0; x < occlusion->width[level]; x++) {
+				int x0 = 2 * x, x1 = 2 * x + 1 < belowWidth ? 2 * x + 1 : 2 * x;
+				GLfloat farthest = fminf(fminf(below[y0 * belowWidth + x0], below[y0 * belowWidth + x1]),
+					fminf(below[y1 * belowWidth + x0], below[y1 * belowWidth + x1]));
+				above[y * occlusion->width[level] + x] = farthest;
+			}
+		}
+	}
+
+	occlusion->ready = 1;
+	return 1;
+}
+
+void occlusionReset(occlusion_t* occlusion)
+{
+	occlusion->ready = 0;
+}
+
+/******************************************************************************
+ * Testing
+ ******************************************************************************/
+
+int occlusionTestBounds(const occlusion_t* occlusion, const bounds_t* bounds)
+{
+	if (!occlusion->ready) {
+		return 1;
+	}
+
+	// The box's screen rectangle and the depth of its nearest corner.
+	GLfloat minX = OCCLUSION_WIDTH, maxX = 0.0f, minY = OCCLUSION_HEIGHT, maxY = 0.0f, nearest = 0.0f;
+	for (int corner = 0; corner < 8; corner++) {
+		GLfloat position[3] = {
+			corner & 1 ? bounds->max[0] : bounds->min[0],
+			corner & 2 ? bounds->max[1] : bounds->min[1],
+			corner & 4 ? bounds->max[2] : bounds->min[2]
+		};
+		clipvertex_t c = toClip(occlusion->clip, position);
+		if (c.z < -c.w) {
+			return 1;		// In front of the near plane; there's nothing nearer to hide it.
+		}
+		GLfloat screen[3];
+		toScreen(c, screen);
+		minX = fminf(minX, screen[0]);
+		maxX = fmaxf(maxX, screen[0]);
+		minY = fminf(minY, screen[1]);
+		maxY = fmaxf(maxY, screen[1]);
+		nearest = fmaxf(nearest, screen[2]);
+	}
+	if (maxX < 0.0f || maxY < 0.0f || minX >= OCCLUSION_WIDTH || minY >= OCCLUSION_HEIGHT) {
+		return 1;		// Off screen, which is the frustum test's business.
+	}
+	int firstX = minX > 0.0f ? (int)minX : 0;
+	int lastX = maxX < OCCLUSION_WIDTH - 1 ? (int)maxX : OCCLUSION_WIDTH - 1;
+	int firstY = minY > 0.0f ? (int)minY : 0;
+	int lastY = maxY < OCCLUSION_HEIGHT - 1 ? (int)maxY : OCCLUSION_HEIGHT - 1;
+
+	// The first level where the rectangle covers no more than 4x4 texels.
+	int level = 0;
+	while (level < OCCLUSION_LEVELS - 1 && ((lastX >> level) - (firstX >> level) > 3
+		|| (lastY >> level) - (firstY >> level) > 3)) {
+		level++;
+	}
+
+	const GLfloat* depth = occlusion->depth[level];
+	int width = occlusion->width[level];
+	for (int y = firstY >> level; y <= lastY >> level; y++) {
+		for (int x = firstX >> level; x <= lastX >> level; x++) {
+			if (depth[y * width + x] <= nearest) {
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+void occlusionFree(occlusion_t* occlusion)
+{
+	free(occlusion->depth[0]);
+	free(occlusion->clipVertices);
+	free(occlusion->triangles);
+	memset(occlusion, 0, sizeof(*occlusion));
+}
@@ -0,0 +1,88 @@
+/******************************************************************************
+ *
+ * Occlusion Culling
+ *
+ * A small software depth buffer that the terrain is drawn into on the CPU
+ * each frame, so boxes hidden behind its hills can be skipped before they're
+ * sent to OpenGL. The buffer is split into bands of rows drawn in parallel
+ * on the worker pool (see jobs.h), then reduced into a hierarchical-Z chain:
+ * each level holds the farthest depth of the 2x2 texels under it, so a box
+ * is tested against a handful of texels whatever its size on screen.
+ *
+ * The occluder is a coarse copy of a height grid with every vertex lowered to
+ * the lowest height around it, so it lies on or under the real surface. With
+ * the eye above the ground, anything behind it is behind the real terrain
+ * too. Depths are sampled at texel centres, so a box showing by less than a
+ * texel past a ridge can still be culled.
+ *
+ ******************************************************************************/
+
+#ifndef OCCLUSION_H
+#define OCCLUSION_H
+
+#include <freeglut.h>
+#include <stddef.h>
+#include "culling.h"
+
+// Size of the depth buffer, its levels down to a single texel, and how many
+// bands of rows it's drawn in.
+#define OCCLUSION_WIDTH		240
+#define OCCLUSION_HEIGHT	192
+#define OCCLUSION_LEVELS	9
+#define OCCLUSION_BANDS		8
+
+// Triangles to draw into the depth buffer.
+typedef struct {
+	GLfloat* vertices;		// x, y, z each
+	int vertexCount;
+	GLuint* indices;		// Three per triangle
+	int indexCount;
+	int vertexCapacity;
+	int indexCapacity;
+} occluder_t;
+
+typedef struct {
+	// Reciprocal depth (1 / w), so nearer is bigger and 0 is nothing drawn.
+	// Level 0 is the nearest occluder at each texel; every level above holds
+	// the smallest (farthest) of the 2x2 texels under it.
+	GLfloat* depth[OCCLUSION_LEVELS];
+	int width[OCCLUSION_LEVELS];
+	int height[OCCLUSION_LEVELS];
+
+	GLfloat clip[16];		// Object to clip space of the last occlusionRender()
+	int ready;				// 0 until then, or after occlusionReset()
+
+	// The occluder's vertices in clip space, and its triangles in screen
+	// space for the bands to share: x, y and 1 / w for each corner.
+	GLfloat* clipVertices;
+	int clipVertexCapacity;
+	GLfloat* triangles;
+	int triangleCount;
+	int triangleCapacity;
+} occlusion_t;
+
+// Build an occluder from a sizeX by sizeZ grid of heights laid out from
+// (originX, originZ) spacing apart (height (x, z) is the float heightStride
+// bytes times x * sizeZ + z past heights), with a vertex every step vertices
+// of the grid. Returns 0 if out of memory.
+int occluderFromHeights(occluder_t* occluder, const GLfloat* heights, size_t heightStride, int sizeX, int sizeZ,
+	GLfloat originX, GLfloat originZ, GLfloat spacing, int step);
+
+void occluderFree(occluder_t* occluder);
+
+// Clear the depth buffer and draw the occluder into it as seen through the
+// projection and modelview matrices (column-major). Returns 0 if out of memory,
+// leaving the buffer unready.
+int occlusionRender(occlusion_t* occlusion, const occluder_t* occluder, const GLfloat* projection,
+	const GLfloat* modelview);
+
+// Stop testing against the last render (every box is visible until the next).
+void occlusionReset(occlusion_t* occlusion);
+
+// 0 if a box (in the same space as the occluder) is certainly hidden behind
+// what was drawn, otherwise 1.
+int occlusionTestBounds(const occlusion_t* occlusion, const bounds_t* bounds);
+
+void occlusionFree(occlusion_t* occlusion);
+
+#endif
@@ -0,0 +1,724 @@
+/******************************************************************************
+ *
+ * Platform Layer (see platform.h)
+ *
+ ******************************************************************************/
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#ifdef PLATFORM_HAS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include <stdlib.h>
+#include "platform.h"
+
+// Non-zero once platformInitHeadless() has created an offscreen context.
+static int headless = 0;
+
+// Set by platformRequestCoreProfile().
+static int coreProfile = 0;
+
+// Shared quadric for the headless glutSolidSphere stand-in.
+static GLUquadricObj* sphereQuadric = NULL;
+
+/******************************************************************************
+ * Timing
+ ******************************************************************************/
+
+double platformTimeSeconds(void)
+{
+#ifdef _WIN32
+	static LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+
+	if (frequency.QuadPart == 0) {
+		QueryPerformanceFrequency(&frequency);
+	}
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+#endif
+}
+
+double platformCpuTimeSeconds(void)
+{
+#ifdef _WIN32
+	FILETIME creationTime, exitTime, kernelTime, userTime;
+	ULARGE_INTEGER kernel, user;
+
+	GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime);
+	kernel.LowPart = kernelTime.dwLowDateTime;
+	kernel.HighPart = kernelTime.dwHighDateTime;
+	user.LowPart = userTime.dwLowDateTime;
+	user.HighPart = userTime.dwHighDateTime;
+
+	// FILETIME is in 100 nanosecond intervals.
+	return (double)(kernel.QuadPart + user.QuadPart) / 1e7;
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+#endif
+}
+
+unsigned int platformElapsedMs(void)
+{
+	static double startTime = -1.0;
+
+	if (startTime < 0.0) {
+		startTime = platformTimeSeconds();
+	}
+	return (unsigned int)((platformTimeSeconds() - startTime) * 1000.0);
+}
+
+void platformSleepMs(unsigned int milliseconds)
+{
+#ifdef _WIN32
+	Sleep(milliseconds);
+#else
+	struct timespec duration;
+	duration.tv_sec = milliseconds / 1000;
+	duration.tv_nsec = (long)(milliseconds % 1000) * 1000000L;
+	nanosleep(&duration, NULL);
+#endif
+}
+
+/******************************************************************************
+ * Threads & Atomics
+ ******************************************************************************/
+
+int platformAtomicLoadInt(volatile int* target)
+{
+#ifdef _MSC_VER
+	return InterlockedCompareExchange((volatile LONG*)target, 0, 0);
+#else
+	return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+#endif
+}
+
+void platformAtomicStoreInt(volatile int* target, int value)
+{
+#ifdef _MSC_VER
+	InterlockedExchange((volatile LONG*)target, value);
+#else
+	__atomic_store_n(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+int platformAtomicAddInt(volatile int* target, int amount)
+{
+#ifdef _MSC_VER
+	return InterlockedAdd((volatile LONG*)target, amount);
+#else
+	return __atomic_add_fetch(target, amount, __ATOMIC_SEQ_CST);
+#endif
+}
+
+int platformAtomicExchangeInt(volatile int* target, int value)
+{
+#ifdef _MSC_VER
+	return InterlockedExchange((volatile LONG*)target, value);
+#else
+	return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+void* platformAtomicLoadPointer(void* volatile* target)
+{
+#ifdef _MSC_VER
+	return InterlockedCompareExchangePointer(target, NULL, NULL);
+#else
+	return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+#endif
+}
+
+void platformAtomicStorePointer(void* volatile* target, void* value)
+{
+#ifdef _MSC_VER
+	InterlockedExchangePointer(target, value);
+#else
+	__atomic_store_n(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+void* platformAtomicCompareExchangePointer(void* volatile* target, void* expected, void* desired)
+{
+#ifdef _MSC_VER
+	return InterlockedCompareExchangePointer(target, desired, expected);
+#else
+	__atomic_compare_exchange_n(target, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return expected;
+#endif
+}
+
+// x86 and x64 keep loads in order with earlier loads, and stores with earlier
+// accesses, so under MSVC only the compiler has to be stopped.
+void platformAtomicFenceAcquire(void)
+{
+#ifdef _MSC_VER
+	_ReadWriteBarrier();
+#else
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+#endif
+}
+
+void platformAtomicFenceRelease(void)
+{
+#ifdef _MSC_VER
+	_ReadWriteBarrier();
+#else
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+#endif
+}
+
+int platformCpuCount(void)
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (int)count : 1;
+#endif
+}
+
+struct platformthread_s {
+	platformthreadfunc_t func;
+	void* argument;
+#ifdef _WIN32
+	HANDLE handle;
+#else
+	pthread_t handle;
+#endif
+};
+
+#ifdef _WIN32
+static DWORD WINAPI threadMain(LPVOID parameter)
+{
+	platformthread_t* thread = parameter;
+	thread->func(thread->argument);
+	return 0;
+}
+#else
+static void* threadMain(void* parameter)
+{
+	platformthread_t* thread = parameter;
+	thread->func(thread->argument);
+	return NULL;
+}
+#endif
+
+platformthread_t* platformThreadCreate(platformthreadfunc_t func, void* argument)
+{
+	platformthread_t* thread = malloc(sizeof(platformthread_t));
+	if (thread == NULL) {
+		return NULL;
+	}
+	thread->func = func;
+	thread->argument = argument;
+
+#ifdef _WIN32
+	thread->handle = CreateThread(NULL, 0, threadMain, thread, 0, NULL);
+	if (thread->handle == NULL) {
+		free(thread);
+		return NULL;
+	}
+#else
+	if (pthread_create(&thread->handle, NULL, threadMain, thread) != 0) {
+		free(thread);
+		return NULL;
+	}
+#endif
+	return thread;
+}
+
+void platformThreadJoin(platformthread_t* thread)
+{
+#ifdef _WIN32
+	WaitForSingleObject(thread->handle, INFINITE);
+	CloseHandle(thread->handle);
+#else
+	pthread_join(thread->handle, NULL);
+#endif
+	free(thread);
+}
+
+struct platformmutex_s {
+#ifdef _WIN32
+	CRITICAL_SECTION section;
+#else
+	pthread_mutex_t mutex;
+#endif
+};
+
+platformmutex_t* platformMutexCreate(void)
+{
+	platformmutex_t* mutex = malloc(sizeof(platformmutex_t));
+	if (mutex != NULL) {
+#ifdef _WIN32
+		InitializeCriticalSection(&mutex->section);
+#else
+		pthread_mutex_init(&mutex->mutex, NULL);
+#endif
+	}
+	return mutex;
+}
+
+void platformMutexDestroy(platformmutex_t* mutex)
+{
+#ifdef _WIN32
+	DeleteCriticalSection(&mutex->section);
+#else
+	pthread_mutex_destroy(&mutex->mutex);
+#endif
+	free(mutex);
+}
+
+void platformMutexLock(platformmutex_t* mutex)
+{
+#ifdef _WIN32
+	EnterCriticalSection(&mutex->section);
+#else
+	pthread_mutex_lock(&mutex->mutex);
+#endif
+}
+
+void platformMutexUnlock(platformmutex_t* mutex)
+{
+#ifdef _WIN32
+	LeaveCriticalSection(&mutex->section);
+#else
+	pthread_mutex_unlock(&mutex->mutex);
+#endif
+}
+
+struct platformcondition_s {
+#ifdef _WIN32
+	CONDITION_VARIABLE variable;
+#else
+	pthread_cond_t variable;
+#endif
+};
+
+platformcondition_t* platformConditionCreate(void)
+{
+	platformcondition_t* condition = malloc(sizeof(platformcondition_t));
+	if (condition != NULL) {
+#ifdef _WIN32
+		InitializeConditionVariable(&condition->variable);
+#else
+		pthread_cond_init(&condition->variable, NULL);
+#endif
+	}
+	return condition;
+}
+
+void platformConditionDestroy(platformcondition_t* condition)
+{
+#ifndef _WIN32
+	pthread_cond_destroy(&condition->variable);
+#endif
+	free(condition);
+}
+
+void platformConditionWait(platformcondition_t* condition, platformmutex_t* mutex)
+{
+#ifdef _WIN32
+	SleepConditionVariableCS(&condition->variable, &mutex->section, INFINITE);
+#else
+	pthread_cond_wait(&condition->variable, &mutex->mutex);
+#endif
+}
+
+void platformConditionSignal(platformcondition_t* condition)
+{
+#ifdef _WIN32
+	WakeConditionVariable(&condition->variable);
+#else
+	pthread_cond_signal(&condition->variable);
+#endif
+}
+
+void platformConditionBroadcast(platformcondition_t* condition)
+{
+#ifdef _WIN32
+	WakeAllConditionVariable(&condition->variable);
+#else
+	pthread_cond_broadcast(&condition->variable);
+#endif
+}
+
+/******************************************************************************
+ * File I/O
+ ******************************************************************************/
+
+FILE* platformOpenFile(const char* path, const char* mode)
+{
+#ifdef _MSC_VER
+	FILE* file = NULL;
+	if (fopen_s(&file, path, mode) != 0) {
+		return NULL;
+	}
+	return file;
+#else
+	return fopen(path, mode);
+#endif
+}
+
+int platformFileStamp(const char* path, unsigned long long* size, long long* modified)
+{
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if (!GetFileAttributesExA(path, GetFileExInfoStandard, &attributes)) {
+		return 0;
+	}
+	*size = ((unsigned long long)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+	*modified = (long long)((((unsigned long long)attributes.ftLastWriteTime.dwHighDateTime << 32) |
+		attributes.ftLastWriteTime.dwLowDateTime) / 10000000ull);
+#else
+	struct stat info;
+	if (stat(path, &info) != 0) {
+		return 0;
+	}
+	*size = (unsigned long long)info.st_size;
+	*modified = (long long)info.st_mtime;
+#endif
+	return 1;
+}
+
+const void* platformMapFile(const char* path, size_t* size)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return NULL;
+	}
+
+	LARGE_INTEGER length;
+	if (!GetFileSizeEx(file, &length) || length.QuadPart == 0) {
+		CloseHandle(file);
+		return NULL;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if (mapping == NULL) {
+		return NULL;
+	}
+
+	// The view keeps the mapping alive after its handle is closed.
+	const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (data == NULL) {
+		return NULL;
+	}
+
+	*size = (size_t)length.QuadPart;
+	return data;
+#else
+	int file = open(path, O_RDONLY);
+	if (file < 0) {
+		return NULL;
+	}
+
+	struct stat info;
+	if (fstat(file, &info) != 0 || info.st_size == 0) {
+		close(file);
+		return NULL;
+	}
+
+	void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (data == MAP_FAILED) {
+		return NULL;
+	}
+
+	*size = (size_t)info.st_size;
+	return data;
+#endif
+}
+
+void platformUnmapFile(const void* data, size_t size)
+{
+	if (data == NULL) {
+		return;
+	}
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+#else
+	munmap((void*)data, size);
+#endif
+}
+
+unsigned char* platformReadFile(const char* path, size_t* size)
+{
+	FILE* file = platformOpenFile(path, "rb");
+	if (file == NULL) {
+		return NULL;
+	}
+
+	long length = -1;
+	if (fseek(file, 0, SEEK_END) == 0) {
+		length = ftell(file);
+	}
+	if (length < 0 || fseek(file, 0, SEEK_SET) != 0) {
+		fclose(file);
+		return NULL;
+	}
+
+	// One spare byte so text parsers can rely on a terminator.
+	unsigned char* data = malloc((size_t)length + 1);
+	if (data == NULL) {
+		fclose(file);
+		return NULL;
+	}
+
+	if (fread(data, 1, (size_t)length, file) != (size_t)length) {
+		free(data);
+		fclose(file);
+		return NULL;
+	}
+	data[length] = '\0';
+
+	fclose(file);
+	*size = (size_t)length;
+	return data;
+}
+
+int platformReadFileAt(FILE* file, unsigned long long offset, void* buffer, size_t size)
+{
+#ifdef _MSC_VER
+	if (_fseeki64(file, (long long)offset, SEEK_SET) != 0) {
+		return 0;
+	}
+#else
+	if (fseeko(file, (off_t)offset, SEEK_SET) != 0) {
+		return 0;
+	}
+#endif
+	return fread(buffer, 1, size, file) == size;
+}
+
+/******************************************************************************
+ * Context & Window
+ ******************************************************************************/
+
+int platformInitHeadless(int width, int height)
+{
+#ifdef PLATFORM_HAS_EGL
+	EGLint configAttributes[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RED_SIZE, 8,
+		EGL_GREEN_SIZE, 8,
+		EGL_BLUE_SIZE, 8,
+		EGL_DEPTH_SIZE, 24,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_NONE
+	};
+	EGLint surfaceAttributes[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+	EGLDisplay display = EGL_NO_DISPLAY;
+	EGLConfig config;
+	EGLint numConfigs, major, minor;
+
+	// Prefer Mesa's surfaceless platform so no X server is needed.
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+		(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay != NULL) {
+		display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	}
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+			fprintf(stderr, "platform: could not initialise an EGL display\n");
+			return 0;
+		}
+	}
+
+	if (!eglChooseConfig(display, configAttributes, &config, 1, &numConfigs) || numConfigs < 1) {
+		fprintf(stderr, "platform: no suitable EGL config\n");
+		return 0;
+	}
+
+	EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+	if (surface == EGL_NO_SURFACE) {
+		fprintf(stderr, "platform: could not create a %dx%d pbuffer\n", width, height);
+		return 0;
+	}
+
+	EGLint coreAttributes[] = {
+		EGL_CONTEXT_MAJOR_VERSION_KHR, 3,
+		EGL_CONTEXT_MINOR_VERSION_KHR, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+		EGL_NONE
+	};
+
+	eglBindAPI(EGL_OPENGL_API);
+	EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, coreProfile ? coreAttributes : NULL);
+	if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, surface, surface, context)) {
+		fprintf(stderr, "platform: could not create an OpenGL context\n");
+		return 0;
+	}
+
+	printf("Headless OpenGL: %s (%s)\n", glGetString(GL_RENDERER), glGetString(GL_VERSION));
+	headless = 1;
+	return 1;
+#else
+	fprintf(stderr, "platform: headless rendering needs EGL, which this build doesn't have\n");
+	return 0;
+#endif
+}
+
+void platformRequestCoreProfile(void)
+{
+	coreProfile = 1;
+}
+
+void platformInitWindow(int* argc, char** argv, int width, int height, const char* title)
+{
+	glutInit(argc, argv);
+	if (coreProfile) {
+		glutInitContextVersion(3, 3);
+		glutInitContextProfile(GLUT_CORE_PROFILE);
+	}
+	glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
+	glutInitWindowSize(width, height);
+	glutCreateWindow(title);
+}
+
+int platformIsHeadless(void)
+{
+	return headless;
+}
+
+void platformSwapBuffers(void)
+{
+	if (headless) {
+		// There's no window to present to; make sure the frame has actually been
+		// rendered so that per-frame timings include the GPU (or llvmpipe) work.
+		glFinish();
+	}
+	else {
+		glutSwapBuffers();
+	}
+}
+
+void platformPostRedisplay(void)
+{
+	if (!headless) {
+		glutPostRedisplay();
+	}
+}
+
+int platformSaveFramebuffer(const char* path, int width, int height)
+{
+	FILE* file = platformOpenFile(path, "wb");
+	if (file == NULL) {
+		return 0;
+	}
+
+	unsigned char* pixels = malloc((size_t)width * height * 3);
+	if (pixels == NULL) {
+		fclose(file);
+		return 0;
+	}
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+
+	// OpenGL's origin is the bottom left, PPM's is the top left.
+	fprintf(file, "P6\n%d %d\n255\n", width, height);
+	for (int row = height - 1; row >= 0; row--) {
+		fwrite(pixels + (size_t)row * width * 3, 3, width, file);
+	}
+
+	free(pixels);
+	fclose(file);
+	return 1;
+}
+
+void* platformGetProcAddress(const char* name)
+{
+#ifdef PLATFORM_HAS_EGL
+	if (headless) {
+		return (void*)eglGetProcAddress(name);
+	}
+#endif
+	return (void*)glutGetProcAddress(name);
+}
+
+/******************************************************************************
+ * GLUT Stand-ins
+ ******************************************************************************/
+
+void platformSolidCube(GLdouble size)
+{
+	if (!headless) {
+		glutSolidCube(size);
+		return;
+	}
+
+	static const GLfloat normals[6][3] = {
+		{ -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f },
+		{ 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f }
+	};
+	static const int faces[6][4] = {
+		{ 0, 1, 2, 3 }, { 3, 2, 6, 7 }, { 7, 6, 5, 4 },
+		{ 4, 5, 1, 0 }, { 5, 6, 2, 1 }, { 7, 4, 0, 3 }
+	};
+	GLfloat half = (GLfloat)size / 2.0f;
+	GLfloat vertices[8][3];
+
+	// Same corner layout as the classic GLUT cube.
+	vertices[0][0] = vertices[1][0] = vertices[2][0] = vertices[3][0] = -half;
+	vertices[4][0] = vertices[5][0] = vertices[6][0] = vertices[7][0] = half;
+	vertices[0][1] = vertices[1][1] = vertices[4][1] = vertices[5][1] = -half;
+	vertices[2][1] = vertices[3][1] = vertices[6][1] = vertices[7][1] = half;
+	vertices[0][2] = vertices[3][2] = vertices[4][2] = vertices[7][2] = -half;
+	vertices[1][2] = vertices[2][2] = vertices[5][2] = vertices[6][2] = half;
+
+	glBegin(GL_QUADS);
+	for (int i = 5; i >= 0; i--) {
+		glNormal3fv(normals[i]);
+		for (int j = 0; j < 4; j++) {
+			glVertex3fv(vertices[faces[i][j]]);
+		}
+	}
+	glEnd();
+}
+
+void platformSolidSphere(GLdouble radius, GLint slices, GLint stacks)
+{
+	if (!headless) {
+		glutSolidSphere(radius, slices, stacks);
+		return;
+	}
+
+	if (sphereQuadric == NULL) {
+		sphereQuadric = gluNewQuadric();
+	}
+	gluSphere(sphereQuadric, radius, slices, stacks);
+}
+
+void platformBitmapCharacter(void* font, int character)
+{
+	// Bitmap fonts live inside GLUT; headless frames simply have no HUD text.
+	if (!headless) {
+		glutBitmapCharacter(font, character);
+	}
+}
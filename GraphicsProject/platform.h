@@ -0,0 +1,150 @@
+/******************************************************************************
+ *
+ * Platform Layer
+ *
+ * A thin layer over the handful of operating system and windowing services the
+ * project needs (timing, sleeping, file I/O and the OpenGL context), so the same
+ * display()/think() loop builds on Windows and Linux and can also run headless
+ * on an offscreen EGL context (e.g. Mesa llvmpipe on a render farm).
+ *
+ ******************************************************************************/
+
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#include <freeglut.h>
+#include <stdio.h>
+
+/******************************************************************************
+ * Timing
+ ******************************************************************************/
+
+// Milliseconds elapsed since the platform layer was initialised.
+unsigned int platformElapsedMs(void);
+
+// High resolution wall clock time in seconds (arbitrary epoch).
+double platformTimeSeconds(void);
+
+// CPU time consumed by the whole process in seconds (includes driver worker threads).
+double platformCpuTimeSeconds(void);
+
+// Suspend the calling thread for the given number of milliseconds.
+void platformSleepMs(unsigned int milliseconds);
+
+/******************************************************************************
+ * Threads & Atomics
+ ******************************************************************************/
+
+// Storage class for variables with one instance per thread.
+#ifdef _MSC_VER
+#define PLATFORM_THREAD_LOCAL __declspec(thread)
+#else
+#define PLATFORM_THREAD_LOCAL _Thread_local
+#endif
+
+// Sequentially consistent atomic operations on ints and pointers, usable from any thread.
+int platformAtomicLoadInt(volatile int* target);
+void platformAtomicStoreInt(volatile int* target, int value);
+int platformAtomicAddInt(volatile int* target, int amount);		// Returns the new value.
+int platformAtomicExchangeInt(volatile int* target, int value);	// Returns the old value.
+void* platformAtomicLoadPointer(void* volatile* target);
+void platformAtomicStorePointer(void* volatile* target, void* value);
+// Store desired if *target still equals expected; returns the value *target held beforehand.
+void* platformAtomicCompareExchangePointer(void* volatile* target, void* expected, void* desired);
+
+// Fences for data shared without a lock, guarded by an atomic counter: after
+// an acquire fence no later access moves before the loads ahead of it, and
+// after a release fence no later store moves before the accesses ahead of it.
+void platformAtomicFenceAcquire(void);
+void platformAtomicFenceRelease(void);
+
+// Number of logical processors available to the process (at least 1).
+int platformCpuCount(void);
+
+// Threads run func(argument) until it returns; platformThreadJoin() waits for
+// that and frees the thread. platformThreadCreate() returns NULL on failure.
+typedef struct platformthread_s platformthread_t;
+typedef void (*platformthreadfunc_t)(void* argument);
+platformthread_t* platformThreadCreate(platformthreadfunc_t func, void* argument);
+void platformThreadJoin(platformthread_t* thread);
+
+// A mutex and a condition variable to wait on with it (spurious wake-ups are possible).
+typedef struct platformmutex_s platformmutex_t;
+platformmutex_t* platformMutexCreate(void);
+void platformMutexDestroy(platformmutex_t* mutex);
+void platformMutexLock(platformmutex_t* mutex);
+void platformMutexUnlock(platformmutex_t* mutex);
+
+typedef struct platformcondition_s platformcondition_t;
+platformcondition_t* platformConditionCreate(void);
+void platformConditionDestroy(platformcondition_t* condition);
+void platformConditionWait(platformcondition_t* condition, platformmutex_t* mutex);
+void platformConditionSignal(platformcondition_t* condition);
+void platformConditionBroadcast(platformcondition_t* condition);
+
+/******************************************************************************
+ * File I/O
+ ******************************************************************************/
+
+// Open a file, returning NULL on failure (wraps fopen_s where available).
+FILE* platformOpenFile(const char* path, const char* mode);
+
+// Size and last modification time (seconds since an OS-specific epoch) of a file.
+// Returns 0 if the file doesn't exist.
+int platformFileStamp(const char* path, unsigned long long* size, long long* modified);
+
+// Map a whole file read-only into memory. Returns NULL on failure; otherwise
+// sets *size and the mapping stays valid until platformUnmapFile().
+const void* platformMapFile(const char* path, size_t* size);
+void platformUnmapFile(const void* data, size_t size);
+
+// Read a whole file into memory with a single read. Returns a malloc'd buffer
+// (free it with free()) and sets *size, or returns NULL on failure.
+unsigned char* platformReadFile(const char* path, size_t* size);
+
+// Read size bytes starting offset bytes into an open file (which may be past
+// 2GB). Returns 0 unless all of them were read.
+int platformReadFileAt(FILE* file, unsigned long long offset, void* buffer, size_t size);
+
+/******************************************************************************
+ * Context & Window
+ ******************************************************************************/
+
+// Create an offscreen OpenGL context of the given size instead of a GLUT window.
+// Returns 0 if no offscreen context could be created (or EGL isn't available).
+int platformInitHeadless(int width, int height);
+
+// Make platformInitHeadless() (and platformInitWindow()) create an OpenGL 3.3
+// core profile context - no fixed-function pipeline - instead of the default one.
+void platformRequestCoreProfile(void);
+
+// Create the GLUT window, asking for a core profile context if one was requested.
+void platformInitWindow(int* argc, char** argv, int width, int height, const char* title);
+
+// Non-zero when rendering into an offscreen context rather than a GLUT window.
+int platformIsHeadless(void);
+
+// Present the finished frame (waits for rendering to complete when headless).
+void platformSwapBuffers(void);
+
+// Ask for display() to be called again (no-op when headless; the caller drives the loop).
+void platformPostRedisplay(void);
+
+// Write the current contents of the back buffer to a binary PPM file.
+int platformSaveFramebuffer(const char* path, int width, int height);
+
+// Look up an OpenGL entry point in the current context. Returns NULL if it isn't available.
+void* platformGetProcAddress(const char* name);
+
+/******************************************************************************
+ * GLUT Stand-ins
+ *
+ * GLUT's geometry and font helpers need a GLUT window, so these fall back to
+ * GLU/immediate mode equivalents when running headless.
+ ******************************************************************************/
+
+void platformSolidCube(GLdouble size);
+void platformSolidSphere(GLdouble radius, GLint slices, GLint stacks);
+void platformBitmapCharacter(void* font, int character);
+
+#endif
@@ -0,0 +1,393 @@
+/******************************************************************************
+ *
+ * Primitive Cache (see primitives.h)
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "glfuncs.h"
+#include "glstats.h"
+#include "glstate.h"
+#include "matrixstack.h"
+#include "primitives.h"
+#include "renderbackend.h"
+
+#define PRIMITIVE_CYLINDER	0
+#define PRIMITIVE_SPHERE	1
+#define PRIMITIVE_CUBE		2
+
+#define PRIMITIVE_STRIDE (6 * sizeof(GLfloat))
+
+static primitive_t cache[PRIMITIVE_CACHE_SIZE];
+static int cacheCount = 0;
+
+// Space for the vertices and indices of a new shape. Returns 0 if out of memory.
+static int allocate(primitive_t* primitive, int vertexCount, int indexCount)
+{
+	primitive->vertices = malloc(PRIMITIVE_STRIDE * vertexCount);
+	primitive->indices = malloc(sizeof(GLuint) * indexCount);
+	primitive->vertexCount = 0;
+	primitive->indexCount = 0;
+	return primitive->vertices != NULL && primitive->indices != NULL;
+}
+
+static void addVertex(primitive_t* primitive, GLfloat x, GLfloat y, GLfloat z, GLfloat nx, GLfloat ny, GLfloat nz)
+{
+	GLfloat* vertex = &primitive->vertices[primitive->vertexCount * 6];
+	vertex[0] = x;
+	vertex[1] = y;
+	vertex[2] = z;
+	vertex[3] = nx;
+	vertex[4] = ny;
+	vertex[5] = nz;
+	primitive->vertexCount++;
+}
+
+static void addTriangle(primitive_t* primitive, GLuint a, GLuint b, GLuint c)
+{
+	primitive->indices[primitive->indexCount++] = a;
+	primitive->indices[primitive->indexCount++] = b;
+	primitive->indices[primitive->indexCount++] = c;
+}
+
+// gluCylinder with height 1: rings of slices + 1 vertices (the seam is
+// duplicated) from z = 0 up to z = 1, radius going from base to top.
+static int buildCylinder(primitive_t* primitive)
+{
+	GLint slices = primitive->slices, stacks = primitive->stacks;
+
+	if (!allocate(primitive, (slices + 1) * (stacks + 1), slices * stacks * 6)) {
+		return 0;
+	}
+
+	// The side slopes in by (base - top) over the height, tilting every normal up by the same amount.
+	GLfloat slope = primitive->baseRadius - primitive->topRadius;
+	GLfloat normalScale = 1.0f / sqrtf(1.0f + slope * slope);
+
+	for (int stack = 0; stack <= stacks; stack++) {
+		GLfloat z = (GLfloat)stack / stacks;
+		GLfloat radius = primitive->baseRadius + (primitive->topRadius - primitive->baseRadius) * z;
+
+		for (int slice = 0; slice <= slices; slice++) {
+			double angle = 2.0 * 3.14159265358979323846 * (slice == slices ? 0 : slice) / slices;
+			GLfloat s = (GLfloat)sin(angle), c = (GLfloat)cos(angle);
+			addVertex(primitive, radius * s, radius * c, z, s * normalScale, c * normalScale, slope * normalScale);
+		}
+	}
+
+	for (int stack = 0; stack < stacks; stack++) {
+		for (int slice = 0; slice < slices; slice++) {
+			GLuint lower = stack * (slices + 1) + slice;
+			GLuint upper = lower + slices + 1;
+			addTriangle(primitive, lower, upper, lower + 1);
+			addTriangle(primitive, lower + 1, upper, upper + 1);
+		}
+	}
+	return 1;
+}
+
+// gluSphere with radius 1: stacks from the +z pole down to the -z pole, with a
+// single triangle per slice in the stacks touching the poles.
+static int buildSphere(primitive_t* primitive)
+{
+	GLint slices = primitive->slices, stacks = primitive->stacks;
+
+	if (!allocate(primitive, (slices + 1) * (stacks + 1), slices * stacks * 6)) {
+		return 0;
+	}
+
+	for (int stack = 0; stack <= stacks; stack++) {
+		double polar = 3.14159265358979323846 * stack / stacks;
+		GLfloat ringRadius = (GLfloat)sin(polar), z = (GLfloat)cos(polar);
+
+		for (int slice = 0; slice <= slices; slice++) {
+			double angle = 2.0 * 3.14159265358979323846 * (slice == slices ? 0 : slice) / slices;
+			GLfloat x = ringRadius * (GLfloat)sin(angle), y = ringRadius * (GLfloat)cos(angle);
+			addVertex(primitive, x, y, z, x, y, z);
+		}
+	}
+
+	for (int stack = 0; stack < stacks; stack++) {
+		for (int slice = 0; slice < slices; slice++) {
+			GLuint upper = stack * (slices + 1) + slice;
+			GLuint lower = upper + slices + 1;
+			if (stack > 0) {
+				addTriangle(primitive, upper, upper + 1, lower);
+			}
+			if (stack < stacks - 1) {
+				addTriangle(primitive, upper + 1, lower + 1, lower);
+			}
+		}
+	}
+	return 1;
+}
+
+// glutSolidCube(1): four vertices per face so each face has its own normal.
+static int buildCube(primitive_t* primitive)
+{
+	static const GLfloat normals[6][3] = {
+		{ -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f },
+		{ 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f }
+	};
+	static const int faces[6][4] = {
+		{ 0, 1, 2, 3 }, { 3, 2, 6, 7 }, { 7, 6, 5, 4 },
+		{ 4, 5, 1, 0 }, { 5, 6, 2, 1 }, { 7, 4, 0, 3 }
+	};
+
+	if (!allocate(primitive, 24, 36)) {
+		return 0;
+	}
+
+	for (int face = 0; face < 6; face++) {
+		GLuint first = primitive->vertexCount;
+
+		for (int corner = 0; corner < 4; corner++) {
+			// Corner n of the GLUT cube (the layout platformSolidCube uses too).
+			int index = faces[face][corner];
+			GLfloat x = index >= 4 ? 0.5f : -0.5f;
+			GLfloat y = (index & 3) == 2 || (index & 3) == 3 ? 0.5f : -0.5f;
+			GLfloat z = (index & 3) == 1 || (index & 3) == 2 ? 0.5f : -0.5f;
+			addVertex(primitive, x, y, z, normals[face][0], normals[face][1], normals[face][2]);
+		}
+		addTriangle(primitive, first, first + 1, first + 2);
+		addTriangle(primitive, first, first + 2, first + 3);
+	}
+	return 1;
+}
+
+static void upload(primitive_t* primitive)
+{
+	if (!glFuncs.hasBuffers) {
+		return;
+	}
+
+	glGenBuffers(1, &primitive->vertexBuffer);
+	glGenBuffers(1, &primitive->indexBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, primitive->vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, PRIMITIVE_STRIDE * primitive->vertexCount, primitive->vertices, GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, primitive->indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * primitive->indexCount, primitive->indices, GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+static void release(primitive_t* primitive)
+{
+	if (primitive->vertexBuffer != 0) {
+		glDeleteBuffers(1, &primitive->vertexBuffer);
+		glDeleteBuffers(1, &primitive->indexBuffer);
+	}
+	free(primitive->vertices);
+	free(primitive->indices);
+	memset(primitive, 0, sizeof(primitive_t));
+}
+
+// Find a shape in the cache, or build and add it. Returns NULL if it can't be built.
+static const primitive_t* lookup(int kind, GLint slices, GLint stacks, GLfloat baseRadius, GLfloat topRadius)
+{
+	static primitive_t uncached;
+
+	for (int i = 0; i < cacheCount; i++) {
+		primitive_t* entry = &cache[i];
+		if (entry->kind == kind && entry->slices == slices && entry->stacks == stacks &&
+			fabsf(entry->baseRadius - baseRadius) < 1e-5f && fabsf(entry->topRadius - topRadius) < 1e-5f) {
+			return entry;
+		}
+	}
+
+	// With the cache full, build into a scratch entry that's replaced every time.
+	primitive_t* primitive = &cache[cacheCount];
+	if (cacheCount == PRIMITIVE_CACHE_SIZE) {
+		release(&uncached);
+		primitive = &uncached;
+	}
+
+	primitive->kind = kind;
+	primitive->slices = slices;
+	primitive->stacks = stacks;
+	primitive->baseRadius = baseRadius;
+	primitive->topRadius = topRadius;
+
+	int built = kind == PRIMITIVE_CYLINDER ? buildCylinder(primitive) :
+		kind == PRIMITIVE_SPHERE ? buildSphere(primitive) : buildCube(primitive);
+	if (!built) {
+		release(primitive);
+		return NULL;
+	}
+	upload(primitive);
+
+	if (primitive != &uncached) {
+		cacheCount++;
+	}
+	return primitive;
+}
+
+const primitive_t* primitiveGetCylinder(GLfloat baseRadius, GLfloat topRadius, GLint slices, GLint stacks)
+{
+	if (slices < 2 || stacks < 1) {
+		return NULL;
+	}
+	return lookup(PRIMITIVE_CYLINDER, slices, stacks, baseRadius, topRadius);
+}
+
+const primitive_t* primitiveGetSphere(GLint slices, GLint stacks)
+{
+	if (slices < 2 || stacks < 2) {
+		return NULL;
+	}
+	return lookup(PRIMITIVE_SPHERE, slices, stacks, 1.0f, 1.0f);
+}
+
+const primitive_t* primitiveGetCube(void)
+{
+	return lookup(PRIMITIVE_CUBE, 0, 0, 1.0f, 1.0f);
+}
+
+void primitiveDraw(const primitive_t* primitive)
+{
+	static const vertexformat_t format = { PRIMITIVE_STRIDE, 0, 3 * sizeof(GLfloat), -1, -1 };
+
+	renderBackendDrawElements(&format, primitive->vertexBuffer, primitive->vertices,
+		primitive->indexBuffer, primitive->indices, GL_TRIANGLES, primitive->indexCount);
+}
+
+void primitiveCylinder(GLdouble base, GLdouble top, GLdouble height, GLint slices, GLint stacks)
+{
+	// The unit shape's larger end has radius 1, so cones (either way up) share it too.
+	GLdouble scale = base > top ? base : top;
+	if (scale <= 0.0) {
+		return;
+	}
+
+	const primitive_t* primitive = primitiveGetCylinder((GLfloat)(base / scale), (GLfloat)(top / scale), slices, stacks);
+	if (primitive != NULL) {
+		glPushMatrix();
+		glScaled(scale, scale, height);
+		primitiveDraw(primitive);
+		glPopMatrix();
+	}
+}
+
+void primitiveSphere(GLdouble radius, GLint slices, GLint stacks)
+{
+	const primitive_t* primitive = primitiveGetSphere(slices, stacks);
+	if (primitive != NULL) {
+		glPushMatrix();
+		glScaled(radius, radius, radius);
+		primitiveDraw(primitive);
+		glPopMatrix();
+	}
+}
+
+void primitiveCube(GLdouble size)
+{
+	const primitive_t* primitive = primitiveGetCube();
+	if (primitive != NULL) {
+		glPushMatrix();
+		glScaled(size, size, size);
+		primitiveDraw(primitive);
+		glPopMatrix();
+	}
+}
+
+void primitivesClear(void)
+{
+	for (int i = 0; i < cacheCount; i++) {
+		release(&cache[i]);
+	}
+	cacheCount = 0;
+}
+
+/******************************************************************************
+ * Benchmark
+ ******************************************************************************/
+
+typedef struct {
+	const char* label;
+	int kind;
+	GLdouble base, top, height;
+	GLint slices, stacks;
+} benchshape_t;
+
+static void drawShape(const benchshape_t* shape, GLUquadric* quadric, int cached)
+{
+	switch (shape->kind) {
+	case PRIMITIVE_CYLINDER:
+		if (cached) {
+			primitiveCylinder(shape->base, shape->top, shape->height, shape->slices, shape->stacks);
+		}
+		else {
+			gluCylinder(quadric, shape->base, shape->top, shape->height, shape->slices, shape->stacks);
+		}
+		break;
+	case PRIMITIVE_SPHERE:
+		if (cached) {
+			primitiveSphere(shape->base, shape->slices, shape->stacks);
+		}
+		else {
+			gluSphere(quadric, shape->base, shape->slices, shape->stacks);
+		}
+		break;
+	default:
+		if (cached) {
+			primitiveCube(shape->base);
+		}
+		else {
+			platformSolidCube(shape->base);
+		}
+		break;
+	}
+}
+
+void primitivesBenchmark(int iterations)
+{
+	static const benchshape_t shapes[] = {
+		{ "cylinder 50x50", PRIMITIVE_CYLINDER, 0.02, 0.02, 0.7, 50, 50 },
+		{ "cone 50x50", PRIMITIVE_CYLINDER, 1.5, 1.8, 1.5, 50, 50 },
+		{ "sphere 50x50", PRIMITIVE_SPHERE, 0.7, 0.7, 0.7, 50, 50 },
+		{ "sphere 100x100", PRIMITIVE_SPHERE, 0.25, 0.25, 0.25, 100, 100 },
+		{ "cube", PRIMITIVE_CUBE, 1.0, 1.0, 1.0, 0, 0 }
+	};
+	GLUquadric* quadric = gluNewQuadric();
+
+	// Keep rasterisation out of the measurement as far as possible: a tiny
+	// viewport and shapes far smaller than a pixel.
+	glViewport(0, 0, 8, 8);
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	glOrtho(-100.0, 100.0, -100.0, 100.0, -100.0, 100.0);
+	glMatrixMode(GL_MODELVIEW);
+	glLoadIdentity();
+	glEnable(GL_LIGHTING);
+	glEnable(GL_LIGHT0);
+	glEnable(GL_NORMALIZE);
+
+	printf("%-16s %10s %14s %14s %8s\n", "shape", "triangles", "GLU tris/s", "cached tris/s", "speedup");
+	for (size_t i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++) {
+		const benchshape_t* shape = &shapes[i];
+		unsigned long triangles = shape->kind == PRIMITIVE_CYLINDER ? glStatsCylinderTriangles(shape->slices, shape->stacks) :
+			shape->kind == PRIMITIVE_SPHERE ? glStatsSphereTriangles(shape->slices, shape->stacks) : 12;
+		double rates[2];
+
+		for (int cached = 0; cached <= 1; cached++) {
+			// One untimed draw builds the cache entry.
+			drawShape(shape, quadric, cached);
+			glFinish();
+
+			double start = platformTimeSeconds();
+			for (int n = 0; n < iterations; n++) {
+				drawShape(shape, quadric, cached);
+			}
+			glFinish();
+			rates[cached] = (double)triangles * iterations / (platformTimeSeconds() - start);
+		}
+
+		printf("%-16s %10lu %14.3e %14.3e %7.1fx\n", shape->label, triangles, rates[0], rates[1], rates[1] / rates[0]);
+	}
+
+	gluDeleteQuadric(quadric);
+}
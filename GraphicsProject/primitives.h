@@ -0,0 +1,61 @@
+/******************************************************************************
+ *
+ * Primitive Cache
+ *
+ * Replacements for gluCylinder, gluSphere and glutSolidCube that tessellate
+ * each distinct shape once - a unit cylinder (or cone), sphere or cube keyed
+ * by its slices, stacks and radius ratio - keep it in buffer objects, and
+ * draw it with a single indexed draw scaled into place by the modelview
+ * matrix. The shapes match the GLU/GLUT ones (same axes, vertex layout and
+ * smooth outward normals, counter-clockwise seen from outside), without
+ * texture coordinates.
+ *
+ * Non-uniformly scaled cylinders rely on GL_NORMALIZE for their lighting.
+ *
+ ******************************************************************************/
+
+#ifndef PRIMITIVES_H
+#define PRIMITIVES_H
+
+#include <freeglut.h>
+
+// Most distinct shapes the cache holds; beyond that shapes are built and
+// thrown away on every draw.
+#define PRIMITIVE_CACHE_SIZE 64
+
+// A tessellated unit shape: interleaved position/normal vertices and triangle indices.
+typedef struct {
+	int kind;
+	GLint slices;
+	GLint stacks;
+	GLfloat baseRadius;		// Cylinders: radii at z = 0 and z = 1, the larger being 1.
+	GLfloat topRadius;
+	GLfloat* vertices;		// x, y, z, nx, ny, nz per vertex
+	GLuint* indices;
+	int vertexCount;
+	int indexCount;
+	GLuint vertexBuffer;	// 0 when drawn from the arrays above instead
+	GLuint indexBuffer;
+} primitive_t;
+
+// Same parameters as the GLU/GLUT functions they replace.
+void primitiveCylinder(GLdouble base, GLdouble top, GLdouble height, GLint slices, GLint stacks);
+void primitiveSphere(GLdouble radius, GLint slices, GLint stacks);
+void primitiveCube(GLdouble size);
+
+// Look up (building if needed) the unit shapes behind the functions above, and
+// draw one with the current modelview matrix. Lets other code (e.g. instanced
+// rendering) reuse the cached geometry.
+const primitive_t* primitiveGetCylinder(GLfloat baseRadius, GLfloat topRadius, GLint slices, GLint stacks);
+const primitive_t* primitiveGetSphere(GLint slices, GLint stacks);
+const primitive_t* primitiveGetCube(void);
+void primitiveDraw(const primitive_t* primitive);
+
+// Delete every cached shape (e.g. before the GL context goes away).
+void primitivesClear(void);
+
+// Draw a set of shapes through GLU/GLUT and through the cache and print the
+// triangles per second of each. Needs a current GL context.
+void primitivesBenchmark(int iterations);
+
+#endif
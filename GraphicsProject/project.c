@@ -1,2080 +1,3234 @@
-/******************************************************************************
- *
- * Computer Graphics Programming 2020 Project Template v1.0 (11/04/2021)
- *
- * Based on: Animation Controller v1.0 (11/04/2021)
- *
- * This template provides a basic FPS-limited render loop for an animated scene,
- * plus keyboard handling for smooth game-like control of an object such as a
- * character or vehicle.
- *
- * A simple static lighting setup is provided via initLights(), which is not
- * included in the animationalcontrol.c template. There are no other changes.
- *
- ******************************************************************************/
-
-#include <Windows.h>
-#include <freeglut.h>
-#include <math.h>
-#include <stdio.h>
-#include <time.h>
-
- /******************************************************************************
-  * Animation & Timing Setup
-  ******************************************************************************/
-
-// Target frame rate (number of Frames Per Second).
-#define TARGET_FPS 60				
-
-// Ideal time each frame should be displayed for (in milliseconds).
-const unsigned int FRAME_TIME = 1000 / TARGET_FPS;
-
-// Frame time in fractional seconds.
-// Note: This is calculated to accurately reflect the truncated integer value of
-// FRAME_TIME, which is used for timing, rather than the more accurate fractional
-// value we'd get if we simply calculated "FRAME_TIME_SEC = 1.0f / TARGET_FPS".
-const float FRAME_TIME_SEC = (1000 / TARGET_FPS) / 1000.0f;
-
-// Time we started preparing the current frame (in milliseconds since GLUT was initialized).
-unsigned int frameStartTime = 0;
-
-/******************************************************************************
- * Some Simple Definitions of Motion
- ******************************************************************************/
-
-#define MOTION_NONE 0				// No motion.
-#define MOTION_CLOCKWISE -1			// Clockwise rotation.
-#define MOTION_ANTICLOCKWISE 1		// Anticlockwise rotation.
-#define MOTION_BACKWARD -1			// Backward motion.
-#define MOTION_FORWARD 1			// Forward motion.
-#define MOTION_LEFT -1				// Leftward motion.
-#define MOTION_RIGHT 1				// Rightward motion.
-#define MOTION_DOWN -1				// Downward motion.
-#define MOTION_UP 1					// Upward motion.
-#define WIDTH 200
-#define HEIGHT 200
-#define SCALE 0.2f
- // Represents the motion of an object on four axes (Yaw, Surge, Sway, and Heave).
- // 
- // You can use any numeric values, as specified in the comments for each axis. However,
- // the MOTION_ definitions offer an easy way to define a "unit" movement without using
- // magic numbers (e.g. instead of setting Surge = 1, you can set Surge = MOTION_FORWARD).
- //
-typedef GLubyte Texture3D[100][100][3];
-
-typedef struct {
-	unsigned char* data;
-	int width;
-	int height;
-} ImageData;
-
-typedef struct {
-	int r;
-	int g;
-	int b;
-	float greyscale;
-
-} pixel;
-
-typedef struct {
-	double x;
-	double y;
-	double z;
-	int alive;
-	double velocityx;
-	double velocityz;
-	int colorCode;
-} Spotlight;
-
-typedef struct {
-	int Yaw;		// Turn about the Z axis	[<0 = Clockwise, 0 = Stop, >0 = Anticlockwise]
-	int Surge;		// Move forward or back		[<0 = Backward,	0 = Stop, >0 = Forward]
-	int Sway;		// Move sideways (strafe)	[<0 = Left, 0 = Stop, >0 = Right]
-	int Heave;		// Move vertically			[<0 = Down, 0 = Stop, >0 = Up]
-} motionstate4_t;
-
-typedef struct {
-	float x, y, z;
-} vec3d;
-
-typedef struct {
-	float x, y;
-} vec2d;
-
-typedef struct {
-	int vIndex[3], tIndex[3], nIndex[3];
-} meshObjectFace;
-
-typedef struct {
-	int vertexCount;
-	vec3d* vertices;
-	int texCoordCount;
-	vec2d* texCoords;
-	int normalCount;
-	vec3d* normals;
-	int faceCount;
-	meshObjectFace* faces;
-} meshObject;
-
-typedef struct {
-	GLfloat angle;
-	GLfloat axisX;
-	GLfloat axisY;
-	GLfloat axisZ;
-}Electron;
-/******************************************************************************
- * Keyboard Input Handling Setup
- ******************************************************************************/
-
- // Represents the state of a single keyboard key.Represents the state of a single keyboard key.
-typedef enum {
-	KEYSTATE_UP = 0,	// Key is not pressed.
-	KEYSTATE_DOWN		// Key is pressed down.
-} keystate_t;
-
-// Represents the states of a set of keys used to control an object's motion.
-typedef struct {
-	keystate_t MoveForward;
-	keystate_t MoveBackward;
-	keystate_t MoveLeft;
-	keystate_t MoveRight;
-	keystate_t MoveUp;
-	keystate_t MoveDown;
-	keystate_t TurnLeft;
-	keystate_t TurnRight;
-} motionkeys_t;
-
-// Current state of all keys used to control our "player-controlled" object's motion.
-motionkeys_t motionKeyStates = {
-	KEYSTATE_UP, KEYSTATE_UP, KEYSTATE_UP, KEYSTATE_UP,
-	KEYSTATE_UP, KEYSTATE_UP, KEYSTATE_UP, KEYSTATE_UP };
-
-// How our "player-controlled" object should currently be moving, solely based on keyboard input.
-//
-// Note: this may not represent the actual motion of our object, which could be subject to
-// other controls (e.g. mouse input) or other simulated forces (e.g. gravity).
-motionstate4_t keyboardMotion = { MOTION_NONE, MOTION_NONE, MOTION_NONE, MOTION_NONE };
-
-// Define all character keys used for input (add any new key definitions here).
-// Note: USE ONLY LOWERCASE CHARACTERS HERE. The keyboard handler provided converts all
-// characters typed by the user to lowercase, so the SHIFT key is ignored.
-
-#define KEY_MOVE_FORWARD	'w'
-#define KEY_MOVE_BACKWARD	's'
-#define KEY_MOVE_LEFT		'a'
-#define KEY_MOVE_RIGHT		'd'
-#define KEY_RENDER_FILL		'l'
-#define KEY_EXIT			27 // Escape key.
-
-// Define all GLUT special keys used for input (add any new key definitions here).
-
-#define SP_KEY_MOVE_UP		GLUT_KEY_UP
-#define SP_KEY_MOVE_DOWN	GLUT_KEY_DOWN
-#define SP_KEY_TURN_LEFT	GLUT_KEY_LEFT
-#define SP_KEY_TURN_RIGHT	GLUT_KEY_RIGHT
-
-/******************************************************************************
- * GLUT Callback Prototypes
- ******************************************************************************/
-
-void display(void);
-void reshape(int width, int h);
-void keyPressed(unsigned char key, int x, int y);
-void specialKeyPressed(int key, int x, int y);
-void keyReleased(unsigned char key, int x, int y);
-void specialKeyReleased(int key, int x, int y);
-void idle(void);
-
-/******************************************************************************
- * Animation-Specific Function Prototypes (add your own here)
- ******************************************************************************/
-void drawOrigin(void);
-void main(int argc, char** argv);
-void init(void);
-void think(void);
-void initLights(void);
-void drawPropeller(GLfloat x, GLfloat y, GLfloat z);
-void drawChopper(GLfloat x, GLfloat y, GLfloat z);
-void loadImage(void);
-void drawTerrain(float terrainScale);
-void CrossProduct(GLfloat* v1, GLfloat* v2, GLfloat* crossProduct);
-void Normalize(GLfloat* v);
-void loadTexture(char str[], Texture3D* texture);
-void drawSkyCylinder(float radius, float height, int numSegments);
-void terrainColorPicker(GLfloat height);
-void drawHelipad(float radius, float height, int numSegments);
-void drawCube(float posX, float posY, float posZ, float size);
-void drawWindmill(double rotation, GLfloat x, GLfloat y, GLfloat z);
-void drawSpotlight(GLenum light, Spotlight spotlight);
-void drawBitmapString(const char* str, float x, float y, float r, float g, float b);
-void resetSpotlight(Spotlight* spotlight);
-void flashColors(GLfloat coneColours[][4]);
-void drawAtom(void);
-
-/******************************************************************************
- * Animation-Specific Setup (Add your own definitions, constants, and globals here)
- ******************************************************************************/
-
- // Render objects as filled polygons (1) or wireframes (0). Default filled.
-int renderFillEnabled = 1;
-GLfloat cameraPosition[] = { 1, 1, 5 };
-GLfloat bladeRotation[] = { 0, 90 };
-GLfloat windmillBladeRotation[] = { 0, 90 };
-GLfloat heliCoord[] = { 0.0f, 10.05f, -38.0f };
-GLint windowWidth = 500;
-GLint windowHeight = 400;
-const float PI = 3.14159265358979323846f;
-const int NUM_SEGMENTS = 100;
-GLUquadricObj* myQuadric;
-GLUquadricObj* cone;
-GLUquadricObj* windMill;
-GLfloat heliX = 210;
-GLfloat heliY = 0;
-GLfloat heliZ = 0;
-GLfloat lastFrameTime = 0.0f;
-GLfloat helicopterVelocityY = 0.0f;
-const GLfloat gravity = -0.8f;
-GLint gravityon = 1;
-GLint taperX = 0;
-GLfloat rx, pitch = 0;
-GLfloat moveSpeed = 0.02f;
-GLfloat sideMoveSpeed = 0.00f;
-GLuint texture_id;
-GLuint texture_id2;
-int imageWidth, imageHeight;
-GLfloat bladeSpeed = 0.0f;
-pixel imageData[HEIGHT][WIDTH];
-Texture3D groundTexture;
-Texture3D concreteTexture;
-Texture3D waterTexture;
-int grounded = 1;
-const float TERRAINCOLOUR1[] = { 0.0275f, 0.3608f, 0.0431f, 1.0f };
-const float TERRAINCOLOUR2[] = { 0.0588f, 0.4000f, 0.0196f, 1.0f };
-const float TERRAINCOLOUR3[] = { 0.1216f, 0.4471f, 0.0392f, 1.0f };
-const float TERRAINCOLOUR4[] = { 0.2039f, 0.3137f, 0.0941f, 1.0f };
-const float TERRAINCOLOUR5[] = { 0.3020f, 0.5569f, 0.2431f, 1.0f };
-const float TERRAINCOLOUR6[] = { 0.3020f, 0.5569f, 0.2431f, 1.0f };
-const float TERRAINCOLOUR7[] = { 0.3882f, 0.5765f, 0.3412f, 1.0f };
-const float TERRAINCOLOUR8[] = { 0.4431f, 0.5882f, 0.3882f, 1.0f };
-const float TERRAINCOLOUR9[] = { 0.4431f, 0.5608f, 0.3490f, 1.0f };
-const float TERRAINCOLOUR10[] = { 0.4431f, 0.5098f, 0.3059f, 1.0f };
-const float TERRAINCOLOUR11[] = { 0.4431f, 0.4784f, 0.2627f, 1.0f };
-const float TERRAINCOLOUR12[] = { 0.4471f, 0.4039f, 0.1843f, 1.0f };
-const float TERRAINCOLOUR13[] = { 0.4471f, 0.3686f, 0.1373f, 1.0f };
-const float TERRAINCOLOUR14[] = { 0.4431f, 0.3412f, 0.0941f, 1.0f };
-const float TERRAINCOLOUR15[] = { 0.4431f, 0.3412f, 0.0941f, 1.0f };
-const float TERRAINCOLOUR16[] = { 0.5176f, 0.3804f, 0.1922f, 1.0f };
-const float TERRAINCOLOUR17[] = { 0.6353f, 0.5019f, 0.3137f, 1.0f };
-const float TERRAINCOLOUR18[] = { 0.7255f, 0.6000f, 0.4471f, 1.0f };
-const float TERRAINCOLOUR19[] = { 0.8509f, 0.7294f, 0.6157f, 1.0f };
-const float SKYBLUE[] = { 0.271f, 0.678f, 0.922f, 1.0f };
-const float GOLD[] = { 0.9804f, 0.9019f, 0.6196f, 1.0f };
-const float BLUE[] = { 0.2784f, 0.5725f, 0.9019f, 1.0f };
-const float BODYCOLOR[] = { 0.75f, 0.75f, 0.75f, 1.0f };
-const float BLACK[] = { 0.0f, 0.0f, 0.0f, 1.0f };
-const float WHITE[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-const float CREAM[] = { 0.9686f, 0.9608f, 0.8f, 1.0f };
-const float RED[] = { 0.7176f, 0.1608f, 0.1608f, 1.0f };
-meshObject obj;
-GLfloat lightX = 0.0f;
-double windmillRotation[20];
-GLfloat lightVelocityX = 0.03;
-Spotlight spotlights[25];
-GLenum lights[25];
-
-const double windmillCoordinates[][3] = {
-		{14.127081, 9.732650, -1.002306},
-	{-7.250275, 10.658718, 66.065704},
-	{43.784729, 9.575411, -69.858345},
-	{-80.844543, 6.885019, -23.915012},
-	{-0.916259, 9.763863, -26.361935},
-	{-44.359699, 9.938830, -6.498155},
-	{43.469288, 8.574178, 9.094833},
-	{66.182175, 8.805546, 49.777252}
-};
-
-GLfloat coneColours[][4] = {
-	{ 10.0f, 0.0f, 0.0f, 0.20f },   
-	{ 10.0f, 5.0f, 0.0f, 0.20f },    
-	{ 10.0f, 10.0f, 0.0f, 0.20f },   
-	{ 0.0f, 10.0f, 0.0f, 0.20f },    
-	{ 0.0f, 0.0f, 10.0f, 0.20f },    
-	{ 4.0f, 0.0f, 8.0f, 0.20f },    
-	{ 8.0f, 0.0f, 10.0f, 0.20f }    
-};
-GLfloat lightColours[][4] = {
-	{ 10.0f, 0.0f, 0.0f, 1.0f },    
-	{ 10.0f, 5.0f, 0.0f, 1.0f },    
-	{ 10.0f, 10.0f, 0.0f, 1.0f },   
-	{ 0.0f, 10.0f, 0.0f, 1.0f },    
-	{ 0.0f, 0.0f, 10.0f, 1.0f },    
-	{ 4.0f, 0.0f, 8.0f, 1.0f },     
-	{ 8.0f, 0.0f, 10.0f, 1.0f }     
-};
-int score = 0;
-int verticalSpeedResetSwitch = 0;
-int tip = 1;
-GLfloat orbitRadius = 3.0f; 
-GLfloat orbitSpeed = 0.05f; 
-GLfloat electronAngle = 0.0f;  
-int numElectrons = 1;
-
-/******************************************************************************
- * Entry Point (don't put anything except the main function here)
- ******************************************************************************/
-void main(int argc, char** argv)
-{
-	// Initialize the OpenGL window.
-	glutInit(&argc, argv);
-	glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
-	glutInitWindowSize(1000, 800);
-	glutCreateWindow("Project");
-
-	// Set up the scene.
-	init();
-	
-	// Disable key repeat (keyPressed or specialKeyPressed will only be called once when a key is first pressed).
-	glutSetKeyRepeat(GLUT_KEY_REPEAT_OFF);
-
-	// Register GLUT callbacks.
-	glutDisplayFunc(display);
-	glutReshapeFunc(reshape);
-	glutKeyboardFunc(keyPressed);
-	glutSpecialFunc(specialKeyPressed);
-	glutKeyboardUpFunc(keyReleased);
-	glutSpecialUpFunc(specialKeyReleased);
-	glutIdleFunc(idle);
-
-	// Record when we started rendering the very first frame (which should happen after we call glutMainLoop).
-	frameStartTime = (unsigned int)glutGet(GLUT_ELAPSED_TIME);
-
-	// Enter the main drawing loop (this will never return).
-	glutMainLoop();
-}
-
-/******************************************************************************
- * GLUT Callbacks (don't add any other functions here)
- ******************************************************************************/
-
- /*
-	 Called when GLUT wants us to (re)draw the current animation frame.
-
-	 Note: This function must not do anything to update the state of our simulated
-	 world. Animation (moving or rotating things, responding to keyboard input,
-	 etc.) should only be performed within the think() function provided below.
- */
-void display(void) {
-
-
-
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	glMatrixMode(GL_PROJECTION);
-	glLoadIdentity();
-	gluPerspective(60.0f, 1.2f, 1.0f, 300.0f);
-	glMatrixMode(GL_MODELVIEW);
-	glLoadIdentity();
-	
-	//Control 'l'
-	if (!renderFillEnabled) {
-		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-
-	}
-	if (renderFillEnabled) {
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-	}
-	
-	//Camera calculations
-	GLfloat objectRadius = 5.0f; 
-	GLfloat objectRotationX = heliX * PI / 180.0f;
-	GLfloat objectRotationY = heliY * PI / 180.0f;
-	GLfloat objectRotationZ = heliZ * PI / 180.0f;
-
-	GLfloat cameraDistance = 4.0f;
-
-	GLfloat objectX = heliCoord[0] + objectRadius * cos(objectRotationX);
-	GLfloat objectY = heliCoord[1] + objectRadius * sin(objectRotationY);
-	GLfloat objectZ = heliCoord[2] + objectRadius * sin(objectRotationZ);
-
-	GLfloat cameraX = heliCoord[0] + cameraDistance * sin(objectRotationX);
-	GLfloat cameraY = objectY + 1;
-	GLfloat cameraZ = heliCoord[2] + cameraDistance * cos(objectRotationX);
-
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, texture_id);
-
-	glDisable(GL_TEXTURE_2D);
-
-	gluLookAt(cameraX, cameraY, cameraZ,
-	heliCoord[0], heliCoord[1], heliCoord[2],
-	0.0f, 1.0f, 0.0f);
-
-	//Sky
-	drawSkyCylinder(100, 80, 50);
-	
-	//Ground
-	drawTerrain(1);
-	
-	//Sky atom :)
-	glPushMatrix();
-	glTranslatef(0.0, 25.0, 0.0);
-	glScalef(3.0, 3.0, 3.0);
-	drawAtom();
-	glPopMatrix();
-
-	//Helicopter
-	glPushMatrix();
-	drawChopper(heliCoord[0], heliCoord[1], heliCoord[2]);
-	glPopMatrix();
-
-	//Helipad
-	glPushMatrix();
-	glTranslatef(0.0f, 9.35f, -38.0f);
-	glColor3f(1.0, 1.0, 1.0);
-	drawHelipad(3.0, 0.05, 40);
-	glPopMatrix();
-
-	//Spotlights
-	drawSpotlight(GL_LIGHT1,spotlights[0], coneColours[spotlights[0].colorCode], lightColours[spotlights[0].colorCode]);
-	drawSpotlight(GL_LIGHT2, spotlights[1], coneColours[spotlights[1].colorCode], lightColours[spotlights[1].colorCode]);
-	drawSpotlight(GL_LIGHT3,spotlights[2], coneColours[spotlights[2].colorCode], lightColours[spotlights[2].colorCode]);
-	drawSpotlight(GL_LIGHT4,spotlights[3], coneColours[spotlights[3].colorCode], lightColours[spotlights[3].colorCode]);
-	drawSpotlight(GL_LIGHT5, spotlights[4], coneColours[spotlights[4].colorCode], lightColours[spotlights[4].colorCode]);
-	drawSpotlight(GL_LIGHT6, spotlights[5], coneColours[spotlights[5].colorCode], lightColours[spotlights[5].colorCode]);
-	drawSpotlight(GL_LIGHT7, spotlights[6], coneColours[spotlights[6].colorCode], lightColours[spotlights[6].colorCode]);
-	
-	//Windmills
-	int numLines = sizeof(windmillCoordinates) / sizeof(windmillCoordinates[0]);
-
-	for (int i = 0; i < numLines; i++) {
-
-		double x = windmillCoordinates[i][0];
-		double y = windmillCoordinates[i][1];
-		double z = windmillCoordinates[i][2];
-		drawWindmill(windmillRotation[i], x, y, z);
-	}
-
-	
-	//HUD
-	glMatrixMode(GL_PROJECTION);
-	glLoadIdentity();
-	glOrtho(0, windowWidth, 0, windowHeight, -1, 1);
-
-	glMatrixMode(GL_MODELVIEW);
-	glLoadIdentity();
-
-	
-	char scoreString[256];
-	sprintf_s(scoreString, sizeof(scoreString), "Score: %d", score);
-
-	drawBitmapString(scoreString, 10, windowHeight - 20, 1.0f, 1.0f, 1.0f);
-	if (tip == 1) {
-		drawBitmapString("Catch the spotlights to score points", 320, windowHeight - 70, 1.0f, 1.0f, 1.0f);
-		drawBitmapString(" and add electrons to the sky atom", 322, windowHeight - 97, 1.0f, 1.0f, 1.0f);
-	}
-	glutSwapBuffers();
-}
-
-
-/*
-	Called when the OpenGL window has been resized.
-*/
-void reshape(int width, int h)
-{// update the new width
-	windowWidth = width;
-	// update the new height
-	windowHeight = h;
-
-	// update the viewport to still be all of the window
-	glViewport(0, 0, windowWidth, windowHeight);
-
-	// change into projection mode so that we can change the camera properties
-	glMatrixMode(GL_PROJECTION);
-
-	// load the identity matrix into the projection matrix
-	glLoadIdentity();
-
-	// gluPerspective(fovy, aspect, near, far)
-	gluPerspective(45, (float)windowWidth / (float)windowHeight, 1, 20);
-
-	// change into model-view mode so that we can change the object positions
-	glMatrixMode(GL_MODELVIEW);
-}
-
-/*
-	Called each time a character key (e.g. a letter, number, or symbol) is pressed.
-*/
-void keyPressed(unsigned char key, int x, int y)
-{
-	switch (tolower(key)) {
-
-		/*
-			Keyboard-Controlled Motion Handler - DON'T CHANGE THIS SECTION
-
-			Whenever one of our movement keys is pressed, we do two things:
-			(1) Update motionKeyStates to record that the key is held down. We use
-				this later in the keyReleased callback.
-			(2) Update the relevant axis in keyboardMotion to set the new direction
-				we should be moving in. The most recent key always "wins" (e.g. if
-				you're holding down KEY_MOVE_LEFT then also pressed KEY_MOVE_RIGHT,
-				our object will immediately start moving right).
-		*/
-	case KEY_MOVE_FORWARD:
-		motionKeyStates.MoveForward = KEYSTATE_DOWN;
-		keyboardMotion.Surge = MOTION_FORWARD;
-		break;
-	case KEY_MOVE_BACKWARD:
-		motionKeyStates.MoveBackward = KEYSTATE_DOWN;
-		keyboardMotion.Surge = MOTION_BACKWARD;
-		break;
-	case KEY_MOVE_LEFT:
-		motionKeyStates.MoveLeft = KEYSTATE_DOWN;
-		keyboardMotion.Sway = MOTION_LEFT;
-		break;
-	case KEY_MOVE_RIGHT:
-		motionKeyStates.MoveRight = KEYSTATE_DOWN;
-		keyboardMotion.Sway = MOTION_RIGHT;
-		break;
-
-		/*
-			Other Keyboard Functions (add any new character key controls here)
-
-			Rather than using literals (e.g. "t" for spotlight), create a new KEY_
-			definition in the "Keyboard Input Handling Setup" section of this file.
-			For example, refer to the existing keys used here (KEY_MOVE_FORWARD,
-			KEY_MOVE_LEFT, KEY_EXIT, etc).
-		*/
-	case KEY_RENDER_FILL:
-		renderFillEnabled = !renderFillEnabled;
-		break;
-	case KEY_EXIT:
-		exit(0);
-		break;
-	}
-}
-
-/*
-	Called each time a "special" key (e.g. an arrow key) is pressed.
-*/
-void specialKeyPressed(int key, int x, int y)
-{
-	switch (key) {
-
-		/*
-			Keyboard-Controlled Motion Handler - DON'T CHANGE THIS SECTION
-
-			This works as per the motion keys in keyPressed.
-		*/
-	case SP_KEY_MOVE_UP:
-		motionKeyStates.MoveUp = KEYSTATE_DOWN;
-		keyboardMotion.Heave = MOTION_UP;
-		break;
-	case SP_KEY_MOVE_DOWN:
-		motionKeyStates.MoveDown = KEYSTATE_DOWN;
-		keyboardMotion.Heave = MOTION_DOWN;
-		break;
-	case SP_KEY_TURN_LEFT:
-		motionKeyStates.TurnLeft = KEYSTATE_DOWN;
-
-		keyboardMotion.Yaw = MOTION_ANTICLOCKWISE;
-		break;
-	case SP_KEY_TURN_RIGHT:
-		motionKeyStates.TurnRight = KEYSTATE_DOWN;
-
-		keyboardMotion.Yaw = MOTION_CLOCKWISE;
-		break;
-
-		/*
-			Other Keyboard Functions (add any new special key controls here)
-
-			Rather than directly using the GLUT constants (e.g. GLUT_KEY_F1), create
-			a new SP_KEY_ definition in the "Keyboard Input Handling Setup" section of
-			this file. For example, refer to the existing keys used here (SP_KEY_MOVE_UP,
-			SP_KEY_TURN_LEFT, etc).
-		*/
-	}
-}
-
-/*
-	Called each time a character key (e.g. a letter, number, or symbol) is released.
-*/
-void keyReleased(unsigned char key, int x, int y)
-{
-	switch (tolower(key)) {
-
-		/*
-			Keyboard-Controlled Motion Handler - DON'T CHANGE THIS SECTION
-
-			Whenever one of our movement keys is released, we do two things:
-			(1) Update motionKeyStates to record that the key is no longer held down;
-				we need to know when we get to step (2) below.
-			(2) Update the relevant axis in keyboardMotion to set the new direction
-				we should be moving in. This gets a little complicated to ensure
-				the controls work smoothly. When the user releases a key that moves
-				in one direction (e.g. KEY_MOVE_RIGHT), we check if its "opposite"
-				key (e.g. KEY_MOVE_LEFT) is pressed down. If it is, we begin moving
-				in that direction instead. Otherwise, we just stop moving.
-		*/
-	case KEY_MOVE_FORWARD:
-		motionKeyStates.MoveForward = KEYSTATE_UP;
-		keyboardMotion.Surge = (motionKeyStates.MoveBackward == KEYSTATE_DOWN) ? MOTION_BACKWARD : MOTION_NONE;
-		taperX = 1;
-
-		break;
-	case KEY_MOVE_BACKWARD:
-		motionKeyStates.MoveBackward = KEYSTATE_UP;
-		keyboardMotion.Surge = (motionKeyStates.MoveForward == KEYSTATE_DOWN) ? MOTION_FORWARD : MOTION_NONE;
-		taperX = 2;
-
-		break;
-	case KEY_MOVE_LEFT:
-		motionKeyStates.MoveLeft = KEYSTATE_UP;
-		keyboardMotion.Sway = (motionKeyStates.MoveRight == KEYSTATE_DOWN) ? MOTION_RIGHT : MOTION_NONE;
-
-		break;
-	case KEY_MOVE_RIGHT:
-		motionKeyStates.MoveRight = KEYSTATE_UP;
-		keyboardMotion.Sway = (motionKeyStates.MoveLeft == KEYSTATE_DOWN) ? MOTION_LEFT : MOTION_NONE;
-
-		break;
-
-		/*
-			Other Keyboard Functions (add any new character key controls here)
-
-			Note: If you only care when your key is first pressed down, you don't have to
-			add anything here. You only need to put something in keyReleased if you care
-			what happens when the user lets go, like we do with our movement keys above.
-			For example: if you wanted a spotlight to come on while you held down "t", you
-			would need to set a flag to turn the spotlight on in keyPressed, and update the
-			flag to turn it off in keyReleased.
-		*/
-	}
-}
-
-/*
-	Called each time a "special" key (e.g. an arrow key) is released.
-*/
-void specialKeyReleased(int key, int x, int y)
-{
-	switch (key) {
-		/*
-			Keyboard-Controlled Motion Handler - DON'T CHANGE THIS SECTION
-
-			This works as per the motion keys in keyReleased.
-		*/
-	case SP_KEY_MOVE_UP:
-		motionKeyStates.MoveUp = KEYSTATE_UP;
-		gravityon = 1;
-
-		keyboardMotion.Heave = (motionKeyStates.MoveDown == KEYSTATE_DOWN) ? MOTION_DOWN : MOTION_NONE;
-		break;
-	case SP_KEY_MOVE_DOWN:
-		motionKeyStates.MoveDown = KEYSTATE_UP;
-		gravityon = 1;
-		keyboardMotion.Heave = (motionKeyStates.MoveUp == KEYSTATE_DOWN) ? MOTION_UP : MOTION_NONE;
-		break;
-	case SP_KEY_TURN_LEFT:
-		motionKeyStates.TurnLeft = KEYSTATE_UP;
-
-		keyboardMotion.Yaw = (motionKeyStates.TurnRight == KEYSTATE_DOWN) ? MOTION_CLOCKWISE : MOTION_NONE;
-
-		break;
-	case SP_KEY_TURN_RIGHT:
-		motionKeyStates.TurnRight = KEYSTATE_UP;
-		keyboardMotion.Yaw = (motionKeyStates.TurnLeft == KEYSTATE_DOWN) ? MOTION_ANTICLOCKWISE : MOTION_NONE;
-		break;
-
-		/*
-			Other Keyboard Functions (add any new special key controls here)
-
-			As per keyReleased, you only need to handle the key here if you want something
-			to happen when the user lets go. If you just want something to happen when the
-			key is first pressed, add you code to specialKeyPressed instead.
-		*/
-	}
-}
-
-/*
-	Called by GLUT when it's not rendering a frame.
-
-	Note: We use this to handle animation and timing. You shouldn't need to modify
-	this callback at all. Instead, place your animation logic (e.g. moving or rotating
-	things) within the think() method provided with this template.
-*/
-void idle(void)
-{
-	// Wait until it's time to render the next frame.
-
-	unsigned int frameTimeElapsed = (unsigned int)glutGet(GLUT_ELAPSED_TIME) - frameStartTime;
-	if (frameTimeElapsed < FRAME_TIME)
-	{
-		// This frame took less time to render than the ideal FRAME_TIME: we'll suspend this thread for the remaining time,
-		// so we're not taking up the CPU until we need to render another frame.
-		unsigned int timeLeft = FRAME_TIME - frameTimeElapsed;
-		Sleep(timeLeft);
-	}
-
-	// Begin processing the next frame.
-
-	frameStartTime = glutGet(GLUT_ELAPSED_TIME); // Record when we started work on the new frame.
-
-	think(); // Update our simulated world before the next call to display().
-
-	glutPostRedisplay(); // Tell OpenGL there's a new frame ready to be drawn.
-}
-
-/******************************************************************************
- * Animation-Specific Functions (Add your own functions at the end of this section)
- ******************************************************************************/
-
- /*
-	 Initialise OpenGL and set up our scene before we begin the render loop.
- */
-void init(void)
-{
-	srand(time(NULL));
-	glEnable(GL_DEPTH_TEST);
-	loadImage();
-
-
-	loadTexture("waterTexture.ppm", &waterTexture);
-	loadTexture("concreteTexture.ppm", &concreteTexture);
-	loadTexture("mountaintexture1.ppm", &groundTexture);
-
-	initLights();
-	myQuadric = gluNewQuadric();
-	cone = gluNewQuadric();
-	windMill = gluNewQuadric();
-	gluQuadricDrawStyle(myQuadric, GL_LINE);
-
-	
-	glEnable(GL_FOG);
-	GLfloat fogColor[4] = { 1,1,1,1 };
-	glFogfv(GL_FOG_COLOR, fogColor);
-	glFogf(GL_FOG_MODE, GL_EXP);
-	glFogf(GL_FOG_DENSITY, 0.02);
-
-	for (int i = 0; i < 24; i++) {
-		windmillRotation[i] = ((double)rand() / RAND_MAX) * 360.0;
-	}
-
-
-	for (int i = 0; i < 24; i++) {
-		Spotlight spotlight;
-		spotlight.x = (double)rand() / RAND_MAX * 200 - 100; // Random value between -100 and 100
-		spotlight.y = 10.0;
-		spotlight.z = (double)rand() / RAND_MAX * 200 - 100;
-		spotlight.alive = 1;
-		spotlight.velocityx = -0.2f + ((float)rand() / RAND_MAX) * 0.4f;
-		spotlight.velocityz = -0.2f + ((float)rand() / RAND_MAX) * 0.4f;
-		spotlight.colorCode = i; // Random value between 0 and 10
-		spotlights[i] = spotlight;
-	}
-	for (int i = 0; i < 24; i++) {
-		lights[i] = GL_LIGHT1 + i;
-		
-	}
-
-}
-void drawBitmapString(const char* str, float x, float y, float r, float g, float b) {
-	glColor3f(r, g, b);
-	glRasterPos2f(x, y);
-
-	while (*str) {
-		glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *str);
-		str++;
-	}
-}
-
-void drawSkyCylinder(float radius, float height, int numSegments) {
-	float segmentAngle = 2.0f * 3.15f / numSegments;
-	float segmentHeight = height / numSegments;
-	glEnable(GL_COLOR_MATERIAL);
-	glColor4fv(BLUE);
-	glBegin(GL_QUAD_STRIP);
-	for (int i = 0; i <= numSegments; i++) {
-		float angle = i * segmentAngle;
-		float x = radius * cos(angle);
-		float z = radius * sin(angle);
-
-		glVertex3f(x, height / 2.0, z);
-		glVertex3f(x, -height / 2.0, z);
-	}
-	glEnd();
-
-
-	glBegin(GL_TRIANGLE_FAN);
-	glVertex3f(0.0, height / 2.0, 0.0);
-	for (int i = 0; i <= numSegments; i++) {
-		float angle = i * segmentAngle;
-		float x = radius * cos(angle);
-		float z = radius * sin(angle);
-
-		glVertex3f(x, height / 2.0, z);
-	}
-	glEnd();
-
-	glBegin(GL_TRIANGLE_FAN);
-	glVertex3f(0.0, -height / 2.0, 0.0);
-	for (int i = 0; i <= numSegments; i++) {
-		float angle = i * segmentAngle;
-		float x = radius * cos(angle);
-		float z = radius * sin(angle);
-
-		glVertex3f(x, -height / 2.0, z);
-	}
-	glEnd();
-	glDisable(GL_COLOR_MATERIAL);
-}
-
-void drawCube(float posX, float posY, float posZ, float size) {
-	float halfSize = size / 2.0f;
-
-	float vertices[8][3] = {
-		{posX - halfSize, posY - halfSize, posZ + halfSize},
-		{posX + halfSize, posY - halfSize, posZ + halfSize},
-		{posX + halfSize, posY + halfSize, posZ + halfSize},
-		{posX - halfSize, posY + halfSize, posZ + halfSize},
-		{posX - halfSize, posY - halfSize, posZ - halfSize},
-		{posX + halfSize, posY - halfSize, posZ - halfSize},
-		{posX + halfSize, posY + halfSize, posZ - halfSize},
-		{posX - halfSize, posY + halfSize, posZ - halfSize}
-	};
-
-
-	int faces[6][4] = {
-		{0, 1, 2, 3},
-		{1, 5, 6, 2},
-		{5, 4, 7, 6},
-		{4, 0, 3, 7},
-		{3, 2, 6, 7},
-		{4, 5, 1, 0}
-	};
-
-
-	float normals[6][3] = {
-		{0.0f, 0.0f, 1.0f},
-		{1.0f, 0.0f, 0.0f},
-		{0.0f, 0.0f, -1.0f},
-		{-1.0f, 0.0f, 0.0f},
-		{0.0f, 1.0f, 0.0f},
-		{0.0f, -1.0f, 0.0f}
-	};
-
-
-	glBegin(GL_QUADS);
-	GLfloat ambientMat[] = { 1.0, 1.0, 0.0, 0.6 };
-	GLfloat diffuseMat[] = { 1.0, 1.0, 0.0, 0.6 };
-	GLfloat specularMat[] = { 1.0, 1.0, 0.0, 0.6 };
-	GLfloat shine = 100.0;
-
-	glMaterialfv(GL_FRONT, GL_AMBIENT, ambientMat);
-	glMaterialfv(GL_FRONT, GL_DIFFUSE, diffuseMat);
-	glMaterialfv(GL_FRONT, GL_SPECULAR, specularMat);
-	glMaterialf(GL_FRONT, GL_SHININESS, shine);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, diffuseMat);
-
-	glEnable(GL_NORMALIZE);
-	for (int i = 0; i < 6; i++) {
-		glNormal3fv(normals[i]);
-		for (int j = 0; j < 4; j++) {
-			glVertex3fv(vertices[faces[i][j]]);
-		}
-	}
-	glEnd();
-
-
-}
-
-
-void drawHelipad(float radius, float height, int numSegments) {
-
-	float segmentAngle = 2.0f * 3.15f / numSegments;
-	float segmentHeight = height / numSegments;
-	glEnable(GL_TEXTURE_2D);
-	GLfloat mat_ambient[] = { 0.5, 0.5, 0.5, 1.0 };
-	GLfloat mat_diffuse[] = { 0.8, 0.8, 0.8, 1.0 };
-	GLfloat mat_specular[] = { 1.0, 1.0, 1.0, 1.0 };
-	GLfloat mat_emission[] = { 0.0, 0.0, 0.0, 1.0 };
-	GLfloat mat_shininess = 64.0;
-
-	glMaterialfv(GL_FRONT, GL_AMBIENT, mat_ambient);
-	glMaterialfv(GL_FRONT, GL_DIFFUSE, mat_diffuse);
-	glMaterialfv(GL_FRONT, GL_SPECULAR, mat_specular);
-	glMaterialfv(GL_FRONT, GL_EMISSION, mat_emission);
-	glMaterialf(GL_FRONT, GL_SHININESS, mat_shininess);
-	GLuint textureID;
-	glGenTextures(1, &concreteTexture);
-	glBindTexture(GL_TEXTURE_2D, concreteTexture);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 100, 100, 0, GL_RGB, GL_UNSIGNED_BYTE, concreteTexture);
-
-	glBegin(GL_QUAD_STRIP);
-	for (int i = 0; i <= numSegments; i++) {
-		float angle = i * segmentAngle;
-		float x = radius * cos(angle);
-		float z = radius * sin(angle);
-		float nx = cos(angle);
-		float ny = 0.0f;
-		float nz = sin(angle);
-		glNormal3f(nx, ny, nz);
-
-
-		glVertex3f(x, height / 2.0, z);
-
-
-		glVertex3f(x, -height / 2.0, z);
-	}
-	glEnd();
-
-
-	glBegin(GL_TRIANGLE_FAN);
-	glNormal3f(0.0f, 1.0f, 0.0f);
-	glTexCoord2f(0.0, 0.0);
-	glVertex3f(0.0, height / 2.0, 0.0);
-	for (int i = 0; i <= numSegments; i++) {
-		float angle = i * segmentAngle;
-		float x = radius * cos(angle);
-		float z = radius * sin(angle);
-
-
-		glTexCoord2f(x, z);
-		glVertex3f(x, height / 2.0, z);
-	}
-	glEnd();
-
-	glBegin(GL_TRIANGLE_FAN);
-	glTexCoord2f(0.0, 0.0);
-	glNormal3f(0.0f, -1.0f, 0.0f);
-	glVertex3f(0.0, -height / 2.0, 0.0);
-	for (int i = 0; i <= numSegments; i++) {
-		float angle = i * segmentAngle;
-		float x = radius * cos(angle);
-		float z = radius * sin(angle);
-
-
-		glTexCoord2f(x, z);
-		glVertex3f(x, -height / 2.0, z);
-	}
-	glEnd();
-
-	glDisable(GL_TEXTURE_2D);
-
-	float symbolWidth = radius * 0.6f;
-	float symbolHeight = height * 0.04f;
-	float symbolDepth = radius * 0.1f;
-
-	float symbolX = 0.0f;
-	float symbolY = height / 2.0f + 0.001f;
-	float symbolZ = 0.0f;
-
-	GLfloat ymat_ambient[] = { 1.0f, 1.0f, 0.0f, 1.0f };
-	GLfloat ymat_diffuse[] = { 1.0f, 1.0f, 0.0f, 1.0f };
-	GLfloat ymat_specular[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-	GLfloat ymat_emission[] = { 0.0f, 0.0f, 0.0f, 1.0f };
-	GLfloat ymat_shininess = 64.0f;
-
-	glMaterialfv(GL_FRONT, GL_AMBIENT, ymat_ambient);
-	glMaterialfv(GL_FRONT, GL_DIFFUSE, ymat_diffuse);
-	glMaterialfv(GL_FRONT, GL_SPECULAR, ymat_specular);
-	glMaterialfv(GL_FRONT, GL_EMISSION, ymat_emission);
-	glMaterialf(GL_FRONT, GL_SHININESS, ymat_shininess);
-
-	glBegin(GL_QUADS);
-	glNormal3f(0.0f, 1.0f, 0.0f);
-
-	glEnd();
-	glPushMatrix();
-	glScalef(1.1, 0.06, 0.5);
-	drawCube(0, 0, 0, 1);
-	glPopMatrix();
-	glPushMatrix();
-	glRotatef(90, 0.0, 1.0, 0.0);
-	glTranslatef(0.0, 0.0, 0.8);
-	glScalef(3.0, 0.06, 0.5);
-	drawCube(0, 0, 0, 1);
-	glPopMatrix();
-	glPushMatrix();
-	glRotatef(90, 0.0, 1.0, 0.0);
-	glTranslatef(0.0, 0.0, -0.8);
-	glScalef(3.0, 0.06, 0.5);
-	drawCube(0, 0, 0, 1);
-	glPopMatrix();
-
-	GLfloat mat_ambient_reset[] = { 0.5f, 0.5f, 0.5f, 1.0f };
-	GLfloat mat_diffuse_reset[] = { 0.8f, 0.8f, 0.8f, 1.0f };
-	GLfloat mat_specular_reset[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-	GLfloat mat_emission_reset[] = { 0.0f, 0.0f, 0.0f, 1.0f };
-	GLfloat mat_shininess_reset = 64.0f;
-
-	glMaterialfv(GL_FRONT, GL_AMBIENT, mat_ambient_reset);
-	glMaterialfv(GL_FRONT, GL_DIFFUSE, mat_diffuse_reset);
-	glMaterialfv(GL_FRONT, GL_SPECULAR, mat_specular_reset);
-	glMaterialfv(GL_FRONT, GL_EMISSION, mat_emission_reset);
-	glMaterialf(GL_FRONT, GL_SHININESS, mat_shininess_reset);
-
-}
-void loadTexture(char str[], Texture3D* texture) {
-
-	FILE* fileID;
-	int maxValue, i, red, green, blue;
-	char tempChar;
-	char headerLine[100];
-
-	fopen_s(&fileID, str, "r");
-
-	fscanf_s(fileID, "%[^\n] ", headerLine, _countof(headerLine));
-
-	if ((headerLine[0] != 'P') || (headerLine[1] != '3')) {
-		printf("This is not a PPM file!\n");
-		exit(0);
-	}
-
-	fscanf_s(fileID, "%c", &tempChar, 1);
-
-	while (tempChar == '#') {
-		fscanf_s(fileID, "%[^\n] ", headerLine, _countof(headerLine));
-		fscanf_s(fileID, "%c", &tempChar, 1);
-	}
-
-	ungetc(tempChar, fileID);
-
-	fscanf_s(fileID, "%d %d %d", &imageWidth, &imageHeight, &maxValue);
-
-	int totalPixels = imageWidth * imageHeight;
-
-	for (int i = 0; i < totalPixels; i++) {
-		fscanf_s(fileID, "%d %d %d", &red, &green, &blue);
-
-		int row = i / imageWidth;
-		int col = i % imageWidth;
-		(*texture)[row][col][0] = (GLubyte)red;
-		(*texture)[row][col][1] = (GLubyte)green;
-		(*texture)[row][col][2] = (GLubyte)blue;
-	}
-
-	fclose(fileID);
-
-}
-
-
-void drawTerrain(float terrainScale) {
-
-	glEnable(GL_TEXTURE_2D);
-	glEnable(GL_COLOR_MATERIAL);
-	GLuint textureID;
-	glGenTextures(1, &textureID);
-	glBindTexture(GL_TEXTURE_2D, groundTexture);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 100, 100, 0, GL_RGB, GL_UNSIGNED_BYTE, groundTexture);
-
-	glBegin(GL_TRIANGLES);
-	GLfloat ambient[] = { 0.2f, 0.2f, 0.2f, 1.0f };
-	GLfloat diffuse[] = { 0.8f, 0.8f, 0.8f, 1.0f };
-	GLfloat specular[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-	glMaterialfv(GL_FRONT, GL_AMBIENT, ambient);
-	glMaterialfv(GL_FRONT, GL_DIFFUSE, diffuse);
-	glMaterialfv(GL_FRONT, GL_SPECULAR, specular);
-	int x, z;
-	int size = 100;
-	int step = 1;
-
-
-	for (x = 0; x < 200; x += step) {
-		for (z = 0; z < 200; z += step) {
-
-			GLfloat height1 = imageData[x][z].greyscale / 100.0f * 4;
-			GLfloat height2 = imageData[x + step][z].greyscale / 100.0f * 4;
-			GLfloat height3 = imageData[x][z + step].greyscale / 100.0f * 4;
-			GLfloat height4 = imageData[x + step][z + step].greyscale / 100.0f * 4;
-
-			terrainColorPicker(height1);
-
-			GLfloat normal[3];
-			GLfloat edge1[3] = { step, height2 - height1, 0 };
-			GLfloat edge2[3] = { 0, height3 - height1, step };
-			CrossProduct(edge1, edge2, normal);
-			Normalize(normal);
-
-			glNormal3fv(normal);
-
-			glTexCoord2f((float)(x - 100), (float)(z - 100));
-			glVertex3f(x - 100, height1, z - 100);
-
-			glTexCoord2f((float)(x + step - 100), (float)(z - 100));
-			glVertex3f(x + step - 100, height2, z - 100);
-
-			glTexCoord2f((float)(x - 100), (float)(z + step - 100));
-			glVertex3f(x - 100, height3, z + step - 100);
-
-			glTexCoord2f((float)(x + step - 100), (float)(z - 100));
-			glVertex3f(x + step - 100, height2, z - 100);
-
-			glTexCoord2f((float)(x + step - 100), (float)(z + step - 100));
-			glVertex3f(x + step - 100, height4, z + step - 100);
-
-			glTexCoord2f((float)(x - 100), (float)(z + step - 100));
-			glVertex3f(x - 100, height3, z + step - 100);
-		}
-	}
-
-	glEnd();
-	glDisable(GL_COLOR_MATERIAL);
-	glDisable(GL_TEXTURE_2D);
-}
-
-
-void drawAtom() {
-
-	GLfloat matAmbient[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-	GLfloat matDiffuse[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-	GLfloat matSpecular[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-	GLfloat matShininess = 50.0f;
-	GLfloat redAmbient[] = { 8.0f, 0.0f, 0.0f, 1.0f };
-
-	glMaterialfv(GL_FRONT, GL_AMBIENT, matAmbient);
-	glMaterialfv(GL_FRONT, GL_DIFFUSE, matDiffuse);
-	glMaterialfv(GL_FRONT, GL_SPECULAR, matSpecular);
-	glMaterialf(GL_FRONT, GL_SHININESS, matShininess);
-
-	glutSolidSphere(1.0f, 20, 20);
-
-	GLfloat angleIncrement = 2 * PI / numElectrons;
-
-	for (int i = 0; i < numElectrons; ++i) {
-
-		GLfloat electronX = orbitRadius * sin(electronAngle + i * angleIncrement);
-		GLfloat electronY = 0.0f;
-		GLfloat electronZ = orbitRadius * cos(electronAngle + i * angleIncrement);
-
-		if (i % 2 == 0) {
-			electronX = orbitRadius * sin(electronAngle + i * angleIncrement);
-			electronY = 0.0f;
-			electronZ = orbitRadius * cos(electronAngle + i * angleIncrement);
-		}
-		if (i % 3 == 0) {
-			electronX = orbitRadius * cos(electronAngle + i * angleIncrement);
-			electronY = orbitRadius * sin(electronAngle + i * angleIncrement);
-			electronZ = 0.0f;
-		}
-		if (i % 4 == 0) {
-			electronX = 0.0f;
-			electronY = orbitRadius * sin(electronAngle + i * angleIncrement);
-			electronZ = orbitRadius * cos(electronAngle + i * angleIncrement);
-		}
-
-		GLfloat electronRotationAngle = electronAngle + i * angleIncrement;
-
-		glPushMatrix();
-		glMaterialfv(GL_FRONT, GL_AMBIENT, redAmbient);
-		glTranslatef(electronX, electronY, electronZ);
-		glRotatef(electronRotationAngle * 180.0f / PI, 0.0f, 1.0f, 0.0f);
-		glutSolidSphere(0.2f, 10, 10);
-		glPopMatrix();
-	}
-
-}
-
-void terrainColorPicker(GLfloat height) {
-
-	if (height >= 0.0f && height < 0.5f) {
-		glColor4fv(TERRAINCOLOUR1);
-
-	}
-	else
-		if (height >= 0.5f && height < 1.0f) {
-			glColor4fv(TERRAINCOLOUR2);
-		}
-		else
-			if (height >= 1.0f && height < 1.5f) {
-				glColor4fv(TERRAINCOLOUR3);
-			}
-			else
-				if (height >= 1.5f && height < 2.0f) {
-					glColor4fv(TERRAINCOLOUR4);
-				}
-				else
-					if (height >= 2.0f && height < 2.5f) {
-						glColor4fv(TERRAINCOLOUR5);
-					}
-					else
-						if (height >= 2.5f && height < 3.0f) {
-							glColor4fv(TERRAINCOLOUR6);
-						}
-						else
-							if (height >= 3.0f && height < 3.5f) {
-								glColor4fv(TERRAINCOLOUR7);
-							}
-							else
-								if (height >= 3.5f && height < 4.0f) {
-									glColor4fv(TERRAINCOLOUR8);
-								}
-								else
-									if (height >= 4.0f && height < 4.5f) {
-										glColor4fv(TERRAINCOLOUR9);
-									}
-									else
-										if (height >= 4.5f && height < 5.0f) {
-											glColor4fv(TERRAINCOLOUR10);
-										}
-										else
-											if (height >= 5.0f && height < 5.5f) {
-												glColor4fv(TERRAINCOLOUR11);
-											}
-											else
-												if (height >= 5.5f && height < 6.0f) {
-													glColor4fv(TERRAINCOLOUR12);
-												}
-												else
-													if (height >= 6.0f && height < 6.5f) {
-														glColor4fv(TERRAINCOLOUR13);
-													}
-													else
-														if (height >= 6.5f && height < 7.0f) {
-															glColor4fv(TERRAINCOLOUR14);
-														}
-														else
-															if (height >= 7.0f && height < 7.5f) {
-																glColor4fv(TERRAINCOLOUR15);
-															}
-															else
-																if (height >= 7.5f && height < 8.0f) {
-																	glColor4fv(TERRAINCOLOUR16);
-																}
-																else
-																	if (height >= 8.0f && height < 8.5f) {
-																		glColor4fv(TERRAINCOLOUR17);
-																	}
-																	else
-																		if (height >= 8.5f && height < 9.0f) {
-																			glColor4fv(TERRAINCOLOUR18);
-																		}
-																		else
-																			if (height >= 9.5f && height < 10.0f) {
-																				glColor4fv(TERRAINCOLOUR19);
-																			}
-
-}
-
-void CrossProduct(GLfloat* v1, GLfloat* v2, GLfloat* crossProduct)
-{
-	crossProduct[0] = v1[1] * v2[2] - v1[2] * v2[1];
-	crossProduct[1] = v1[2] * v2[0] - v1[0] * v2[2];
-	crossProduct[2] = v1[0] * v2[1] - v1[1] * v2[0];
-}
-
-void Normalize(GLfloat* v)
-{
-	GLfloat length = sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
-	v[0] /= length;
-	v[1] /= length;
-	v[2] /= length;
-}
-
-void loadImage(void)
-{
-	FILE* fileID;
-	int maxValue, totalPixels, i, red, green, blue;
-	char tempChar;
-	char headerLine[100];
-	float RGBScaling;
-
-	fopen_s(&fileID, "terrain.ppm", "r");
-
-	fscanf_s(fileID, "%[^\n] ", &headerLine, _countof(headerLine));
-
-	if ((headerLine[0] != 'P') || (headerLine[1] != '3'))
-	{
-		printf("This is not a PPM file!\n");
-		exit(0);
-	}
-
-	fscanf_s(fileID, "%c", &tempChar, 1);
-
-	while (tempChar == '#')
-	{
-		fscanf_s(fileID, "%[^\n] ", headerLine, _countof(headerLine));
-		fscanf_s(fileID, "%c", &tempChar, 1);
-	}
-
-	ungetc(tempChar, fileID);
-
-	fscanf_s(fileID, "%d %d %d", &imageWidth, &imageHeight, &maxValue);
-
-	totalPixels = imageWidth * imageHeight;
-
-	RGBScaling = 255.0 / maxValue;
-
-	for (int i = 0; i < 40000; i++) {
-
-		fscanf_s(fileID, "%d %d %d", &red, &green, &blue);
-
-		int row = i / 200;
-		int col = i % 200;
-		imageData[row][col].r = red;
-		imageData[row][col].g = green;
-		imageData[row][col].b = blue;
-		imageData[row][col].greyscale = 0.2126 * red + 0.7152 * green + 0.0722 * blue;
-
-	}
-
-	fclose(fileID);
-
-
-}
-
-void drawPropeller(GLfloat x, GLfloat y, GLfloat z) {
-
-	glPushMatrix();
-	glTranslatef(0.0f, 0.3f, 0.0f);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLACK);
-	glRotatef(bladeRotation[0], 0.0f, 1.0f, 0.0f);
-	glScalef(1.5, 0.005, 0.08);
-	glutSolidCube(1.0f);
-	glPopMatrix();
-
-	glPushMatrix();
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLACK);
-	glTranslatef(x + 0.0f, y + 0.3f, z + 0.0f);
-	glRotatef(bladeRotation[1], 0.0f, 1.0f, 0.0f);
-	glScalef(1.5, 0.005, 0.08);
-	glutSolidCube(1.0f);
-	glPopMatrix();
-}
-
-
-void drawChopper(GLfloat x, GLfloat y, GLfloat z) {
-
-	GLfloat ambientMat[] = { 0.2, 0.2, 0.2, 1.0 };
-	GLfloat diffuseMat[] = { 0.2, 0.2, 0.2, 1.0 };
-	GLfloat specularMat[] = { 0.2, 0.2, 0.2, 1.0 };
-	GLfloat shine = 100.0;
-
-	glMaterialfv(GL_FRONT, GL_AMBIENT, ambientMat);
-	glMaterialfv(GL_FRONT, GL_DIFFUSE, diffuseMat);
-	glMaterialfv(GL_FRONT, GL_SPECULAR, specularMat);
-	glMaterialf(GL_FRONT, GL_SHININESS, shine);
-
-	glEnable(GL_NORMALIZE);
-
-	glTranslatef(x, y, z);
-	glRotatef(heliX, 0.0f, 1.0f, 0.0f);
-	glRotatef(rx, 1.0f, 0.0f, 0.0f);
-	glRotatef(pitch, 0.0f, 0.0f, 1.0f);
-	glTranslatef(-x, -y, -z);
-
-
-	glPushMatrix();
-	glTranslatef(x + 0.0f, y + 0.0f, z + 0.0f);
-	glRotatef(15.0f, 1.0f, 0.0f, 0.0f);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLACK);
-	gluCylinder(myQuadric, 0.26, 0.05, 0.6, 50, 50);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glScalef(1, 1, 1);
-	glTranslatef(x + 0.0f, y + 0.0f, z + 0.0f);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLUE);
-	gluSphere(myQuadric, 0.25, 100, 100);
-	drawPropeller(x, y, z);
-
-
-	glPushMatrix();
-	glTranslatef(x, y + 0.25, z);
-	glRotatef(90.0f, 0.0f, 0.2f, 0.0f);
-	glRotatef(-90.0, 1.0, 0.0, 0.0);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLUE);
-	gluCylinder(myQuadric, 0.05, 0.05, 0.1, 50, 50);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glTranslatef(x + 0.2, y - 0.3, z - 0.2);
-	glRotatef(90.0, 0.0, 0.0, 1.0);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLACK);
-	gluCylinder(myQuadric, 0.02, 0.02, 0.7, 50, 50);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glTranslatef(x - 0.2, y - 0.3, z - 0.2);
-	glRotatef(90.0, 0.0, 0.0, 1.0);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLACK);
-	gluCylinder(myQuadric, 0.02, 0.02, 0.7, 50, 50);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glTranslatef(x - 0.2, y - 0.25, z - 0.28);
-	glRotatef(30.0, 1.0, 0.0, 0.0);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLACK);
-	gluCylinder(myQuadric, 0.02, 0.02, 0.1, 50, 50);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glTranslatef(x + 0.2, y - 0.25, z - 0.28);
-	glRotatef(30.0, 1.0, 0.0, 0.0);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLACK);
-	gluCylinder(myQuadric, 0.02, 0.02, 0.1, 50, 50);
-	glPopMatrix();
-
-	//TAIL
-	glPushMatrix();
-	glTranslatef(x, y - 0.15, z + 0.58);
-	glRotatef(0.0, 1.0, 0.0, 0.0);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLUE);
-	gluCylinder(myQuadric, 0.05, 0.05, 0.15, 50, 50);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glTranslatef(x + 0.04, y - 0.15, z + 0.70);
-	glRotatef(90.0, 0.0, 1.0, 0.0);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLACK);
-	gluCylinder(myQuadric, 0.02, 0.02, 0.05, 50, 50);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glTranslatef(x + 0.09, y - 0.15, z + 0.70);
-	glRotatef(bladeRotation[0], 1.0f, 0.0f, 0.0f);
-	glScalef(0.008, 0.25, 0.05);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLACK);
-	glutSolidCube(1.0f);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glTranslatef(x + 0.09, y - 0.15, z + 0.70);
-	glRotatef(bladeRotation[1], 1.0f, 0.0f, 0.0f);
-	glScalef(0.008, 0.25, 0.05);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLACK);
-	glutSolidCube(1.0f);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glTranslatef(x + 0.12, y - 0.22, z - 0.02);
-	glRotatef(90.0, 1.0, 1.0, 0.0);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLACK);
-	gluCylinder(myQuadric, 0.01, 0.01, 0.11, 50, 50);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glTranslatef(x + 0.09, y - 0.195, z + 0.15);
-	glRotatef(90.0, 1.0, 1.0, 0.0);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLACK);
-	gluCylinder(myQuadric, 0.01, 0.01, 0.14, 50, 50);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glTranslatef(x - 0.20, y - 0.3, z - 0.02);
-	glRotatef(90.0, -1.0, 1.0, 0.0);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLACK);
-	gluCylinder(myQuadric, 0.01, 0.01, 0.11, 50, 50);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glTranslatef(x - 0.19, y - 0.3, z + 0.15);
-	glRotatef(90, -1.0, 1.0, 0.0);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLACK);
-	gluCylinder(myQuadric, 0.01, 0.01, 0.14, 50, 50);
-	glPopMatrix();
-
-}
-
-void drawWindmill(double rotation, GLfloat x, GLfloat y, GLfloat z) {
-
-	GLfloat ambientMat[] = { 0.2, 0.2, 0.2, 1.0 };
-	GLfloat diffuseMat[] = { 0.2, 0.2, 0.2, 1.0 };
-	GLfloat specularMat[] = { 0.2, 0.2, 0.2, 1.0 };
-	GLfloat shine = 100.0;
-
-	glMaterialfv(GL_FRONT, GL_AMBIENT, ambientMat);
-	glMaterialfv(GL_FRONT, GL_DIFFUSE, diffuseMat);
-	glMaterialfv(GL_FRONT, GL_SPECULAR, specularMat);
-	glMaterialf(GL_FRONT, GL_SHININESS, shine);
-
-	glEnable(GL_NORMALIZE);
-
-	glPushMatrix();
-	glTranslatef(x, y, z);
-	glRotatef(rotation, 0, 1.0, 0);
-	glTranslatef(-x, -y, -z);
-
-
-	glPushMatrix();
-	glTranslatef(x, y, z);
-	glRotatef(90, 1.0, 0, 0);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, RED);
-	gluCylinder(windMill, 1.5, 1.8, 1.5, 50, 50);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glTranslatef(x, y + 1.4, z);
-	glRotatef(90, 1.0, 0, 0);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, CREAM);
-	gluCylinder(windMill, 1.2, 1.5, 1.5, 50, 50);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glTranslatef(x, y + 2.8, z);
-	glRotatef(90, 1.0, 0, 0);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, RED);
-	gluCylinder(windMill, 0.9, 1.2, 1.5, 50, 50);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glTranslatef(x, y + 4.5, z);
-	glRotatef(90, 1.0, 0, 0);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, RED);
-	gluSphere(windMill, 0.7, 50, 50);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glTranslatef(x, y + 4.2, z);
-	glRotatef(90, 1.0, 0, 0);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, CREAM);
-	gluCylinder(windMill, 0.6, 0.9, 1.5, 50, 50);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glTranslatef(x, y + 4.5, z + 0.8);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, CREAM);
-	glRotatef(90, 1.0, 0, 0);
-	gluSphere(windMill, 0.4, 50, 50);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glTranslatef(x + 0.0f, y + 4.6f, z + 1.1f);
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLACK);
-	glRotatef(90, 1.0f, 0.0f, 0.0f);
-	glRotatef(windmillBladeRotation[0], 0.0f, 1.0f, 0.0f);
-	glScalef(4.5, 0.010, 0.3);
-	glutSolidCube(1.0f);
-	glPopMatrix();
-
-
-	glPushMatrix();
-	glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, BLACK);
-	glTranslatef(x + 0.0f, y + 4.6f, z + 1.1f);
-	glRotatef(90, 1.0f, 0.0f, 0.0f);
-	glRotatef(windmillBladeRotation[1], 0.0f, 1.0f, 0.0f);
-	glScalef(4.5, 0.010, 0.3);
-	glutSolidCube(1.0f);
-	glPopMatrix();
-
-	glPopMatrix();
-}
-
-void drawSpotlight(GLenum light, Spotlight spotlight, GLfloat coneDiffuse[], GLfloat lightDiffuse[]) {
-
-	glPushMatrix();
-
-	int i = spotlight.colorCode;
-
-	GLfloat ambientLight[] = { 10.2f, 0.2f, 0.2f, 1.0f };
-	GLfloat light_position[] = { spotlight.x, spotlight.y, spotlight.z, 1.0f };
-	GLfloat spot_direction[] = { 0.0f, -1.0f, 0.0f };
-
-	glLightfv(light, GL_DIFFUSE, lightDiffuse);
-
-	if (spotlight.alive == 1) {
-		glEnable(light);
-	}
-	else {
-
-		glDisable(light);
-
-	}
-
-	glLightfv(light, GL_POSITION, light_position);
-	glLightfv(light, GL_SPOT_DIRECTION, spot_direction);
-	glLightf(light, GL_SPOT_CUTOFF, 25.0f);
-
-
-	GLfloat noAmbient[] = { 0.0f, 0.0f, 0.0f, 1.0f };
-	GLfloat noSpecular[] = { 0.0f, 0.0f, 0.0f, 1.0f };
-
-
-	if (spotlight.alive == 1) {
-		glMaterialfv(GL_FRONT_AND_BACK, GL_DIFFUSE, coneDiffuse);
-
-
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glTranslatef(spotlight.x, spotlight.y - 6, spotlight.z);
-		glRotatef(-90, 1.0f, 0.0f, 0.0f);
-		gluCylinder(cone, 2.0, 0.3, 4.5, 50, 50);
-	}
-
-	glPopMatrix();
-
-}
-/*
-	Advance our animation by FRAME_TIME milliseconds.
-
-	Note: Our template's GLUT idle() callback calls this once before each new
-	frame is drawn, EXCEPT the very first frame drawn after our application
-	starts. Any setup required before the first frame is drawn should be placed
-	in init().
-*/
-void think(void)
-{
-	
-	electronAngle += orbitSpeed;
-	lightX += lightVelocityX;
-	printf("hx: %f, hz: %f\n", heliCoord[0], heliCoord[2]);
-
-	if (motionKeyStates.MoveForward == KEYSTATE_UP) {
-		if (rx < 0) {
-			rx++;
-		}
-
-	}
-	if (motionKeyStates.MoveBackward == KEYSTATE_UP) {
-		if (rx > 0) {
-			rx--;
-		}
-
-	}
-	if (motionKeyStates.MoveLeft == KEYSTATE_UP) {
-		if (pitch > 0) {
-			pitch--;
-		}
-
-	}
-	if (motionKeyStates.MoveRight == KEYSTATE_UP) {
-		if (pitch < 0) {
-			pitch++;
-		}
-	}
-
-
-	int currentFrameTime = glutGet(GLUT_ELAPSED_TIME);
-
-
-	float deltaTime = (currentFrameTime - lastFrameTime) / 1000.0f;
-
-	lastFrameTime = currentFrameTime;
-
-
-	int x = round(heliCoord[0]);
-	int z = round(heliCoord[2]);
-	x += 100;
-	z += 100;
-
-
-	GLfloat ground = imageData[x][z].greyscale / 100.0f * 4;
-
-
-	if (heliCoord[1] > (ground + 0.5)) {
-
-		if (gravityon == 1) {
-
-			if (heliCoord[1] > 37) {
-				helicopterVelocityY = 0;
-			}
-
-			if (!(heliCoord[0] > -1.0f && heliCoord[0] < 1.0f)) {
-				if (!(heliCoord[0] > -1.0f && heliCoord[0] < 1.0f)) {
-					helicopterVelocityY -= 1 - ((bladeSpeed * 2) / 10);
-
-					if (round(heliCoord[1]) <= 38) {
-						heliCoord[1] += helicopterVelocityY / 250;
-					}
-				}
-			}
-			else {
-				if (heliCoord[1] > 4.7f) {
-					
-					
-					helicopterVelocityY -= 1 - ((bladeSpeed * 2) / 10);
-					
-					if (round(heliCoord[1]) <= 38) {
-						heliCoord[1] += helicopterVelocityY / 250;
-					}
-				}
-				else {
-					helicopterVelocityY = 0;
-					moveSpeed = 0;
-				}
-			}
-
-		}
-	}
-	else {
-		grounded = 1;
-		
-		if (verticalSpeedResetSwitch == 0) {
-			helicopterVelocityY = 0;
-			verticalSpeedResetSwitch = 1;
-		}
-		sideMoveSpeed = 0;
-		moveSpeed = 0;
-		gravityon = 0;
-	}
-	for (int i = 0; i < 2; i++) {
-
-		if (bladeRotation[i] == 360.0f) {
-			bladeRotation[i] = bladeSpeed;
-		}
-		else {
-			bladeRotation[i] += bladeSpeed * 8;
-		}
-	}
-
-
-	for (int i = 0; i < 2; i++) {
-
-		if (windmillBladeRotation[i] == 360.0f) {
-			windmillBladeRotation[i] = bladeSpeed;
-		}
-		else {
-			windmillBladeRotation[i] += 0.7;
-		}
-	}
-
-
-	/*
-		Keyboard motion handler: complete this section to make your "player-controlled"
-		object respond to keyboard input.
-	*/
-	if (keyboardMotion.Yaw != MOTION_NONE) {
-
-		if (keyboardMotion.Yaw == MOTION_ANTICLOCKWISE) {
-
-			if (heliX == 360.0f) {
-				heliX = 0.0f;
-			}
-			else {
-				heliX += 1.0f;
-			}
-
-
-		}
-		if (keyboardMotion.Yaw == MOTION_CLOCKWISE) {
-
-			if (heliX == 0.0f) {
-				heliX = 360.0f;
-			}
-			else {
-				heliX -= 1.0f;
-			}
-
-		}
-		/* TEMPLATE: Turn your object right (clockwise) if .Yaw < 0, or left (anticlockwise) if .Yaw > 0 */
-	}
-
-	if (keyboardMotion.Surge != MOTION_NONE) {
-		if (keyboardMotion.Surge > 0) {
-
-			if (rx > -20.0f) {
-				rx--;
-			}
-		}
-		else if (keyboardMotion.Surge < 0) {
-
-			if (rx < 20.0f) {
-				rx++;
-			}
-		}
-	}
-
-	if (!grounded) {
-		if ((keyboardMotion.Surge != MOTION_NONE) || taperX > 0) {
-			/* TEMPLATE: Move your object backward if .Surge < 0, or forward if .Surge > 0 */
-			float radians = heliX * PI / 180.0f;
-
-			float deltaX = moveSpeed * sin(radians);
-			float deltaZ = moveSpeed * cos(radians);
-			if (keyboardMotion.Surge > 0) {
-
-				taperX = 0;
-
-
-				heliCoord[0] -= deltaX;
-				heliCoord[2] -= deltaZ;
-
-				if (moveSpeed < 0.3f) {
-					moveSpeed += 0.01f;
-				}
-			}
-			else if (keyboardMotion.Surge < 0) {
-
-				taperX = 0;
-
-
-				heliCoord[0] -= deltaX;
-				heliCoord[2] -= deltaZ;
-				if (moveSpeed > -0.2f) {
-					moveSpeed -= 0.01f;
-				}
-			}
-
-			if (taperX == 1) {
-				heliCoord[0] -= deltaX;
-				heliCoord[2] -= deltaZ;
-
-				if (moveSpeed > 0.0f) {
-					moveSpeed -= 0.001f;
-
-				}
-				else {
-					taperX = 0;
-				}
-			}
-			if (taperX == 2) {
-				heliCoord[0] -= deltaX;
-				heliCoord[2] -= deltaZ;
-
-				if (moveSpeed < 0.0f) {
-					moveSpeed += 0.001f;
-
-				}
-				else {
-					taperX = 0;
-				}
-			}
-		}
-
-		if (keyboardMotion.Sway != MOTION_NONE) {
-			/* TEMPLATE: Move (strafe) your object left if .Sway < 0, or right if .Sway > 0 */
-
-			float radians = heliX * PI / 180.0f;
-
-			float deltaX = sideMoveSpeed * sin(radians);
-			float deltaZ = sideMoveSpeed * cos(radians);
-			if (keyboardMotion.Sway > 0) {
-				
-				if (pitch > -20.0f) {
-					pitch--;
-				}
-
-				heliCoord[0] += deltaZ;
-				heliCoord[2] -= deltaX;
-				
-				if (sideMoveSpeed< 0.2f) {
-					sideMoveSpeed += 0.005;
-				}
-			}
-			else if (keyboardMotion.Sway < 0) {
-				
-				if (pitch < 20.0f) {
-					pitch++;
-				}
-				
-				heliCoord[0] += deltaZ;
-				heliCoord[2] -= deltaX;
-				
-				if (sideMoveSpeed > -0.2f) {
-					sideMoveSpeed -= 0.005;
-				}
-			}
-		}
-		else {
-			float radians = heliX * PI / 180.0f;
-			float deltaX = sideMoveSpeed * sin(radians);
-			float deltaZ = sideMoveSpeed * cos(radians);
-		
-			if (sideMoveSpeed > 0) {
-				
-				sideMoveSpeed -= 0.001;
-				
-			
-				heliCoord[0] += deltaZ;
-				heliCoord[2] -= deltaX;
-			}
-			else if(sideMoveSpeed < 0) {
-				sideMoveSpeed += 0.001;
-				heliCoord[0] += deltaZ;
-				heliCoord[2] -= deltaX;
-			}
-		}
-
-	}
-
-
-	if (keyboardMotion.Heave != MOTION_NONE) {
-
-		/* TEMPLATE: Move your object down if .Heave < 0, or up if .Heave > 0 */
-		if (keyboardMotion.Heave < 0) {
-			
-				helicopterVelocityY -= 1;
-				heliCoord[1] += helicopterVelocityY / 400;
-			
-		}
-		if (keyboardMotion.Heave > 0 && heliCoord[1] < 37.0f) {
-			
-			if (bladeSpeed > 2.0f) {
-				tip = 0;
-				helicopterVelocityY += 1;
-				gravityon = 0;
-				heliCoord[1] += helicopterVelocityY / 400;
-				if (heliCoord[1] > ground + 0.5f) {
-					verticalSpeedResetSwitch = 0;
-				}
-				grounded = 0;
-			}
-
-			if (bladeSpeed < 5.0f) {
-				bladeSpeed += 0.02f;
-			}
-
-		}
-
-
-	}
-	else {
-		
-		if (bladeSpeed > 0.0f) {
-			bladeSpeed -= 0.01f;
-
-		}
-	}
-
-	
-	for (int i = 0; i < 7; i++) {
-		spotlights[i].x += spotlights[i].velocityx;
-		spotlights[i].z += spotlights[i].velocityz;
-	}
-	for (int i = 0; i < 7; i++) {
-		if (spotlights[i].x > 95 || spotlights[i].x < -95) {
-			spotlights[i].velocityx *= -1;
-		}
-		if (spotlights[i].z > 95 || spotlights[i].z < -95) {
-			spotlights[i].velocityz *= -1;
-		}
-	}
-	
-
-
-	for (int i = 0; i < 7; i++) {
-		
-		if (heliCoord[0] < (spotlights[i].x + 0.5f)) {
-
-			if (heliCoord[0] > (spotlights[i].x - 0.5f)) {
-
-				if (heliCoord[2] > (spotlights[i].z - 0.5f)) {
-
-					if (heliCoord[2] < (spotlights[i].z + 0.5f)) {
-						if (heliCoord[1] < spotlights[i].y)
-						{
-							if (spotlights[i].alive == 1) {
-								score += 1;
-								numElectrons++;
-								spotlights[i].alive = 0;
-							
-								resetSpotlight(&spotlights[i]);
-
-							}
-							
-						}
-					}
-				}
-			}
-		}
-	}
-
-	flashColors(coneColours);
-}
-
-void flashColors(GLfloat coneColours[][4]) {
-	for (int i = 0; i < 7; i++) {
-
-		while (coneColours[i][3] > 0.00f) {
-			coneColours[i][3] -= 0.001f;
-		
-		}
-
-		while (coneColours[i][3] < 0.20f) {
-			coneColours[i][3] += 0.001f;
-		
-		}
-	}
-}
-void resetSpotlight(Spotlight* spotlight) {
-	
-	spotlight->x = (double)rand() / RAND_MAX * 200 - 100;
-	spotlight->y = 10.0;
-	spotlight->z = (double)rand() / RAND_MAX * 200 - 100;
-	spotlight->velocityx = -0.2f + ((float)rand() / RAND_MAX) * 0.4f;
-	spotlight->velocityz = -0.2f + ((float)rand() / RAND_MAX) * 0.4f;
-	spotlight->colorCode = rand() % 7;
-	spotlight->alive = 1;
-}
-/*
-	Initialise OpenGL lighting before we begin the render loop.
-
-	Note (advanced): If you're using dynamic lighting (e.g. lights that move around, turn on or
-	off, or change colour) you may want to replace this with a drawLights function that gets called
-	at the beginning of display() instead of init().
-*/
-void initLights(void)
-{
-
-	GLfloat globalAmbient[] = { 0.9f, 0.6f, 0.6f, 1 };
-	GLfloat lightPosition[] = { 0.0f, 40.0f, 0.0f, 1.0f };
-	GLfloat ambientLight[] = { 0.2f, 0.2f, 0.2f, 1.0f };
-	GLfloat diffuseLightRed[] = { 6.0f, 0.0f, 0.0f, 1.0f };
-	GLfloat specularLight[] = { 1.0f, 1.0f, 0.8f, 1.0f };
-	GLfloat diffuseLight[] = { 0.3f, 0.3f, 0.3f, 1.0f };
-
-	glLightModelfv(GL_LIGHT_MODEL_AMBIENT, globalAmbient);
-	
-	glLightModelfv(GL_LIGHT_MODEL_AMBIENT, globalAmbient);
-
-	glLightfv(GL_LIGHT0, GL_POSITION, lightPosition);
-	glLightfv(GL_LIGHT0, GL_AMBIENT, ambientLight);
-	glLightfv(GL_LIGHT0, GL_DIFFUSE, diffuseLight);
-	glLightfv(GL_LIGHT0, GL_SPECULAR, specularLight);
-
-	glEnable(GL_LIGHTING);	
-	glEnable(GL_LIGHT0);
-
-	glEnable(GL_NORMALIZE);
-
-
-}
-
-void drawOrigin(void) {
-
-	glBegin(GL_LINES);
-	
-	glColor3f(1.0f, 0.0f, 0.0f);
-	glVertex3d(-2.0, 7.0, 0.0);
-	glVertex3d(2.0, 7.0, 0.0);
-
-	
-	glColor3f(0.0f, 0.0f, 1.0f);
-	glVertex3d(0.0, 9.0, 0.0);
-	glVertex3d(0.0, 5.0, 0.0);
-
-	
-	glColor3f(0.0f, 0.0f, 1.0f);
-	glVertex3d(0.0, 9.0, 1.0);
-	glVertex3d(0.0, 5.0, 1.0);
-
-	
-	glColor3f(0.0f, 1.0f, 0.0f);
-	glVertex3d(0.0, 7.0, 2.0);
-	glVertex3d(0.0, 7.0, -2.0);
-
-	glEnd();
-}
+/******************************************************************************
+ *
+ * Computer Graphics Programming 2020 Project Template v1.0 (11/04/2021)
+ *
+ * Based on: Animation Controller v1.0 (11/04/2021)
+ *
+ * This template provides a basic FPS-limited render loop for an animated scene,
+ * plus keyboard handling for smooth game-like control of an object such as a
+ * character or vehicle.
+ *
+ * A simple static lighting setup is provided via initLights(), which is not
+ * included in the animationalcontrol.c template. There are no other changes.
+ *
+ ******************************************************************************/
+
+#include <freeglut.h>
+#include <ctype.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "arena.h"
+#include "assetcache.h"
+#include "bench.h"
+#include "culling.h"
+#include "platform.h"
+#include "glfuncs.h"
+#include "glstats.h"
+#include "glstate.h"
+#include "heightfield.h"
+#include "instancing.h"
+#include "jobs.h"
+#include "matrixstack.h"
+#include "occlusion.h"
+#include "ppm.h"
+#include "primitives.h"
+#include "renderbackend.h"
+#include "renderqueue.h"
+#include "simclock.h"
+#include "terrainlod.h"
+#include "terrainnormals.h"
+#include "terrainpager.h"
+#include "textures.h"
+#include "trace.h"
+#include "triplebuffer.h"
+
+ /******************************************************************************
+  * Animation & Timing Setup
+  ******************************************************************************/
+
+// Target frame rate (number of Frames Per Second).
+#define TARGET_FPS 60				
+
+// Simulation ticks per second. think() moves everything a fixed amount each
+// tick, so this sets the game's speed, whatever the frame rate.
+#define SIM_TICK_RATE 60
+
+// Ideal time each frame should be displayed for (in milliseconds; --fps changes it).
+unsigned int frameTime = 1000 / TARGET_FPS;
+
+// Time we started preparing the current frame (in milliseconds since GLUT was initialized).
+unsigned int frameStartTime = 0;
+
+// Whether idle() sleeps to hold the frame rate (benchmarks and --fps 0 run flat out instead).
+int frameLimiterEnabled = 1;
+
+// Runs think() SIM_TICK_RATE times a second of real time, on the simulation
+// thread or from idle()...
+simclock_t simClock;
+
+// ...unless it's run exactly once a frame instead, so headless runs and
+// benchmarks give the same frames however fast they're drawn.
+int simLockstep = 0;
+
+// Whether the window runs think() on a thread of its own, so ticks and
+// frames overlap (--no-sim-thread runs it from idle() instead).
+int simThreadEnabled = 1;
+
+/******************************************************************************
+ * Some Simple Definitions of Motion
+ ******************************************************************************/
+
+#define MOTION_NONE 0				// No motion.
+#define MOTION_CLOCKWISE -1			// Clockwise rotation.
+#define MOTION_ANTICLOCKWISE 1		// Anticlockwise rotation.
+#define MOTION_BACKWARD -1			// Backward motion.
+#define MOTION_FORWARD 1			// Forward motion.
+#define MOTION_LEFT -1				// Leftward motion.
+#define MOTION_RIGHT 1				// Rightward motion.
+#define MOTION_DOWN -1				// Downward motion.
+#define MOTION_UP 1					// Upward motion.
+#define WIDTH 200
+#define HEIGHT 200
+#define WORLD_WINDOW 257			// Vertices along each side of the terrain mesh when streaming a world (8 LOD chunks).
+#define TERRAIN_COLOUR_STEPS 32		// Entries in the terrain's height to colour table per unit of height (a power of two, so band edges are exact)...
+#define TERRAIN_COLOUR_ENTRIES 512	// ...up to a height of 16; higher takes the last entry.
+#define WORLD_BUDGET_MB 32			// Default memory budget for a streamed world's tiles.
+#define SCREEN_WIDTH 1000			// Initial window (or offscreen buffer) width.
+#define SCREEN_HEIGHT 800			// Initial window (or offscreen buffer) height.
+#define SCALE 0.2f
+#define NUM_SPOTLIGHTS 7			// Spotlights drawn, each lit by its own light (GL_LIGHT1 on).
+#define NUM_WINDMILLS 8				// Windmills standing around the terrain.
+#define OCCLUDER_STEP 2				// Terrain vertices between those of the coarse copy drawn for occlusion culling.
+#define SPOTLIGHT_HEIGHT 6.0f		// How high spotlights hang above the ground (their cones reach down to it).
+#define SHAPE_CYLINDER 0			// Kinds of queued primitive (see shapeitem_t).
+#define SHAPE_SPHERE 1
+#define SHAPE_CUBE 2
+ // Represents the motion of an object on four axes (Yaw, Surge, Sway, and Heave).
+ // 
+ // You can use any numeric values, as specified in the comments for each axis. However,
+ // the MOTION_ definitions offer an easy way to define a "unit" movement without using
+ // magic numbers (e.g. instead of setting Surge = 1, you can set Surge = MOTION_FORWARD).
+ //
+// An RGB image at the size given in its file: width * height RGB triples, top row
+// first. The pixels live in assetArena and are freed with it.
+typedef struct {
+	unsigned char* data;
+	int width;
+	int height;
+} ImageData;
+
+// One vertex of the retained terrain, sky and helipad meshes, interleaved for the vertex array pointers.
+typedef struct {
+	GLfloat position[3];
+	GLfloat normal[3];
+	GLfloat color[4];
+	GLfloat texCoord[2];
+} scenevertex_t;
+
+// Where a band of terrain colour starts.
+typedef struct {
+	GLfloat height;
+	GLfloat color[4];
+} colourstop_t;
+
+// An asset file decoded on the worker pool by loadAssets().
+typedef struct {
+	const char* path;
+	int planes;				// ASSET_PLANE_ flags
+	assetimage_t image;
+	int loaded;
+	double milliseconds;	// Time spent loading it (on whichever thread did).
+} assetload_t;
+
+// A cached primitive waiting in the render queue (see submitCylinder() and friends).
+typedef struct {
+	int kind;				// SHAPE_ value
+	GLdouble size[3];		// Cylinder base, top and height; sphere radius; cube size
+	GLint slices;
+	GLint stacks;
+} shapeitem_t;
+
+// Size of the sky cylinder or helipad disc waiting in the render queue.
+typedef struct {
+	float radius;
+	float height;
+	int numSegments;
+} cylinderitem_t;
+
+// The sky cylinder or helipad disc as a retained mesh, built by buildCylinderMesh().
+typedef struct {
+	cylinderitem_t size;		// What it was built for
+	scenevertex_t* vertices;
+	GLuint* indices;
+	int indexCount;
+	GLuint vertexBuffer;		// ...and their copies in buffer objects, when they're available.
+	GLuint indexBuffer;
+} cylindermesh_t;
+
+typedef struct {
+	double x;
+	double y;
+	double z;
+	int alive;
+	double velocityx;
+	double velocityz;
+	int colorCode;
+} Spotlight;
+
+// What display() draws of the simulated world, copied out of it after every
+// tick; frames are drawn between the last two copies (see blendWorld()).
+typedef struct {
+	GLfloat heliCoord[3];
+	GLfloat heliYaw;			// heliX, rx and pitch
+	GLfloat heliRoll;
+	GLfloat heliPitch;
+	GLfloat bladeRotation[2];
+	GLfloat windmillBladeRotation[2];
+	GLfloat electronAngle;
+	int numElectrons;
+	Spotlight spotlights[NUM_SPOTLIGHTS];
+	GLfloat coneColours[NUM_SPOTLIGHTS][4];
+	int score;
+	int tip;
+} worldstate_t;
+
+// The world as a tick left it, handed to display() whole (see worldSnapshots).
+typedef struct {
+	worldstate_t previous;		// Before the tick...
+	worldstate_t current;		// ...and after it
+	double time;				// When the tick was due (platformTimeSeconds())
+} worldsnapshot_t;
+
+typedef struct {
+	int Yaw;		// Turn about the Z axis	[<0 = Clockwise, 0 = Stop, >0 = Anticlockwise]
+	int Surge;		// Move forward or back		[<0 = Backward,	0 = Stop, >0 = Forward]
+	int Sway;		// Move sideways (strafe)	[<0 = Left, 0 = Stop, >0 = Right]
+	int Heave;		// Move vertically			[<0 = Down, 0 = Stop, >0 = Up]
+} motionstate4_t;
+
+typedef struct {
+	float x, y, z;
+} vec3d;
+
+typedef struct {
+	float x, y;
+} vec2d;
+
+typedef struct {
+	int vIndex[3], tIndex[3], nIndex[3];
+} meshObjectFace;
+
+typedef struct {
+	int vertexCount;
+	vec3d* vertices;
+	int texCoordCount;
+	vec2d* texCoords;
+	int normalCount;
+	vec3d* normals;
+	int faceCount;
+	meshObjectFace* faces;
+} meshObject;
+
+typedef struct {
+	GLfloat angle;
+	GLfloat axisX;
+	GLfloat axisY;
+	GLfloat axisZ;
+}Electron;
+/******************************************************************************
+ * Keyboard Input Handling Setup
+ ******************************************************************************/
+
+ // Represents the state of a single keyboard key.Represents the state of a single keyboard key.
+typedef enum {
+	KEYSTATE_UP = 0,	// Key is not pressed.
+	KEYSTATE_DOWN		// Key is pressed down.
+} keystate_t;
+
+// Represents the states of a set of keys used to control an object's motion.
+typedef struct {
+	keystate_t MoveForward;
+	keystate_t MoveBackward;
+	keystate_t MoveLeft;
+	keystate_t MoveRight;
+	keystate_t MoveUp;
+	keystate_t MoveDown;
+	keystate_t TurnLeft;
+	keystate_t TurnRight;
+} motionkeys_t;
+
+// Current state of all keys used to control our "player-controlled" object's motion.
+motionkeys_t motionKeyStates = {
+	KEYSTATE_UP, KEYSTATE_UP, KEYSTATE_UP, KEYSTATE_UP,
+	KEYSTATE_UP, KEYSTATE_UP, KEYSTATE_UP, KEYSTATE_UP };
+
+// How our "player-controlled" object should currently be moving, solely based on keyboard input.
+//
+// Note: this may not represent the actual motion of our object, which could be subject to
+// other controls (e.g. mouse input) or other simulated forces (e.g. gravity).
+motionstate4_t keyboardMotion = { MOTION_NONE, MOTION_NONE, MOTION_NONE, MOTION_NONE };
+
+// Define all character keys used for input (add any new key definitions here).
+// Note: USE ONLY LOWERCASE CHARACTERS HERE. The keyboard handler provided converts all
+// characters typed by the user to lowercase, so the SHIFT key is ignored.
+
+#define KEY_MOVE_FORWARD	'w'
+#define KEY_MOVE_BACKWARD	's'
+#define KEY_MOVE_LEFT		'a'
+#define KEY_MOVE_RIGHT		'd'
+#define KEY_RENDER_FILL		'l'
+#define KEY_TRACE			't' // Start tracing, or write the trace so far if already tracing.
+#define KEY_GL_STATS		'g' // Print the last frame's GL call counts.
+#define KEY_RELOAD			'r' // Reload the terrain and textures from their files.
+#define KEY_BACKEND			'b' // Switch between the fixed-function and GLSL render backends.
+#define KEY_EXIT			27 // Escape key.
+
+// Define all GLUT special keys used for input (add any new key definitions here).
+
+#define SP_KEY_MOVE_UP		GLUT_KEY_UP
+#define SP_KEY_MOVE_DOWN	GLUT_KEY_DOWN
+#define SP_KEY_TURN_LEFT	GLUT_KEY_LEFT
+#define SP_KEY_TURN_RIGHT	GLUT_KEY_RIGHT
+
+/******************************************************************************
+ * GLUT Callback Prototypes
+ ******************************************************************************/
+
+void display(void);
+void reshape(int width, int h);
+void keyPressed(unsigned char key, int x, int y);
+void specialKeyPressed(int key, int x, int y);
+void keyReleased(unsigned char key, int x, int y);
+void specialKeyReleased(int key, int x, int y);
+void idle(void);
+
+/******************************************************************************
+ * Animation-Specific Function Prototypes (add your own here)
+ ******************************************************************************/
+void drawOrigin(void);
+int main(int argc, char** argv);
+void init(void);
+void think(void);
+void initLights(void);
+void drawPropeller(GLfloat x, GLfloat y, GLfloat z);
+void drawChopper(GLfloat x, GLfloat y, GLfloat z);
+void loadImage(const assetimage_t* image);
+void buildTerrainMesh(void);
+void updateWorld(void);
+void closeWorld(void);
+GLfloat heightmapTileHeight(void* context, int x, int z);
+void drawTerrain(float terrainScale);
+void loadTexture(const assetimage_t* image, ImageData* texture);
+void decodeAsset(void* argument);
+void loadAssets(void);
+void buildCylinderMesh(cylindermesh_t* mesh, const cylinderitem_t* size, int sky);
+void drawCylinderMesh(cylindermesh_t* mesh, const cylinderitem_t* size, int sky);
+void drawSkyCylinder(float radius, float height, int numSegments);
+void drawSkyCylinderItem(const void* data);
+void drawTerrainItem(const void* data);
+void bakeTerrainColours(void);
+void drawHelipad(float radius, float height, int numSegments);
+void drawHelipadDisc(const void* data);
+void submitCylinder(const material_t* material, GLdouble base, GLdouble top, GLdouble height, GLint slices, GLint stacks);
+void submitSphere(const material_t* material, GLdouble radius, GLint slices, GLint stacks);
+void submitCube(const material_t* material, GLdouble size);
+void drawShapeItem(const void* data);
+void drawWindmill(double rotation, GLfloat x, GLfloat y, GLfloat z);
+void buildWindmillMesh(void);
+void addWindmillPart(const primitive_t* primitive, GLfloat y, GLfloat z, GLfloat scaleX, GLfloat scaleY, GLfloat scaleZ,
+	const float color[], int spins, GLfloat spinStart);
+void drawWindmills(void);
+void drawWindmillsItem(const void* data);
+void placeSpotlight(GLenum light, Spotlight spotlight, GLfloat lightDiffuse[]);
+void drawSpotlight(GLenum light, Spotlight spotlight, GLfloat coneDiffuse[], GLfloat lightDiffuse[]);
+void drawSpotlights(void);
+void drawSpotlightConesItem(const void* data);
+void drawBitmapString(const char* str, float x, float y, float r, float g, float b);
+void resetSpotlight(Spotlight* spotlight);
+void groundHeights(const GLfloat* x, const GLfloat* z, GLfloat* heights, int count);
+void placeSpotlights(void);
+void placeWindmills(void);
+void cullScene(GLfloat cameraX, GLfloat cameraY, GLfloat cameraZ);
+void sceneBox(int object, GLfloat x, GLfloat y, GLfloat z, GLfloat halfX, GLfloat halfY, GLfloat halfZ);
+void flashColors(GLfloat coneColours[][4]);
+void drawAtom(void);
+void playBenchmarkFlight(int frame);
+void writeTrace(void);
+void advanceWorld(double now);
+void stepWorld(void);
+void startSimulationThread(void);
+void stopSimulationThread(void);
+void simulationThreadMain(void* argument);
+void lockWorld(void);
+void unlockWorld(void);
+void captureWorld(worldstate_t* world);
+void blendWorld(worldstate_t* world, const worldstate_t* from, const worldstate_t* to, GLfloat alpha);
+GLfloat blendAngle(GLfloat from, GLfloat to, GLfloat alpha);
+void benchmarkSimulation(int ticks);
+
+/******************************************************************************
+ * Animation-Specific Setup (Add your own definitions, constants, and globals here)
+ ******************************************************************************/
+
+ // Render objects as filled polygons (1) or wireframes (0). Default filled.
+int renderFillEnabled = 1;
+GLfloat cameraPosition[] = { 1, 1, 5 };
+GLfloat bladeRotation[] = { 0, 90 };
+GLfloat windmillBladeRotation[] = { 0, 90 };
+GLfloat heliCoord[] = { 0.0f, 10.05f, -38.0f };
+GLint windowWidth = 500;
+GLint windowHeight = 400;
+const float PI = 3.14159265358979323846f;
+const int NUM_SEGMENTS = 100;
+GLfloat heliX = 210;
+GLfloat heliY = 0;
+GLfloat heliZ = 0;
+GLfloat helicopterVelocityY = 0.0f;
+const GLfloat gravity = -0.8f;
+GLint gravityon = 1;
+GLint taperX = 0;
+GLfloat rx, pitch = 0;
+GLfloat moveSpeed = 0.02f;
+GLfloat sideMoveSpeed = 0.00f;
+GLuint texture_id;
+GLuint texture_id2;
+GLfloat bladeSpeed = 0.0f;
+heightfield_t groundHeightfield;	// The heightmap's heights, 16 bits each (in assetArena).
+arena_t assetArena;		// Everything loaded from asset files; reset when they're reloaded.
+ImageData groundTexture;
+ImageData concreteTexture;
+ImageData waterTexture;
+texturehandle_t groundTextureHandle;	// GL copies of the textures above (see textures.h).
+texturehandle_t concreteTextureHandle;
+texturehandle_t waterTextureHandle;
+scenevertex_t* terrainVertices;	// The terrain mesh, from groundHeightfield (in assetArena)...
+GLuint terrainVertexBuffer;			// ...and its copy in a buffer object, when they're available.
+terrainlod_t terrainLod;			// The terrain's chunks and the triangles chosen to draw them with.
+float terrainPixelError = 2.0f;		// Most a terrain chunk's simplification may show, in pixels.
+int terrainMeshDirty = 1;			// Set whenever the heightmap changes.
+int terrainSizeX = HEIGHT;			// Vertices along each side of the terrain mesh.
+int terrainSizeZ = WIDTH;
+terrainpager_t* worldPager;			// With --world, the terrain streams from a tile file instead...
+int worldWindowX, worldWindowZ;		// ...the mesh being the window onto it starting at this vertex...
+unsigned int worldGeneration;		// ...built from this generation of its tiles...
+int worldWindowMoved;				// ...unless the window has moved since.
+cylindermesh_t skyMesh;
+cylindermesh_t helipadMesh;
+const vertexformat_t sceneVertexFormat = { sizeof(scenevertex_t), offsetof(scenevertex_t, position),
+	offsetof(scenevertex_t, normal), offsetof(scenevertex_t, color), offsetof(scenevertex_t, texCoord) };
+int grounded = 1;
+// The terrain's colour by height: each band runs from its height up to the next
+// one's; heights below the first band take its colour, and above the last the last's.
+const colourstop_t terrainColourStops[] = {
+	{ 0.0f, { 0.0275f, 0.3608f, 0.0431f, 1.0f } },
+	{ 0.5f, { 0.0588f, 0.4000f, 0.0196f, 1.0f } },
+	{ 1.0f, { 0.1216f, 0.4471f, 0.0392f, 1.0f } },
+	{ 1.5f, { 0.2039f, 0.3137f, 0.0941f, 1.0f } },
+	{ 2.0f, { 0.3020f, 0.5569f, 0.2431f, 1.0f } },
+	{ 2.5f, { 0.3020f, 0.5569f, 0.2431f, 1.0f } },
+	{ 3.0f, { 0.3882f, 0.5765f, 0.3412f, 1.0f } },
+	{ 3.5f, { 0.4431f, 0.5882f, 0.3882f, 1.0f } },
+	{ 4.0f, { 0.4431f, 0.5608f, 0.3490f, 1.0f } },
+	{ 4.5f, { 0.4431f, 0.5098f, 0.3059f, 1.0f } },
+	{ 5.0f, { 0.4431f, 0.4784f, 0.2627f, 1.0f } },
+	{ 5.5f, { 0.4471f, 0.4039f, 0.1843f, 1.0f } },
+	{ 6.0f, { 0.4471f, 0.3686f, 0.1373f, 1.0f } },
+	{ 6.5f, { 0.4431f, 0.3412f, 0.0941f, 1.0f } },
+	{ 7.0f, { 0.4431f, 0.3412f, 0.0941f, 1.0f } },
+	{ 7.5f, { 0.5176f, 0.3804f, 0.1922f, 1.0f } },
+	{ 8.0f, { 0.6353f, 0.5019f, 0.3137f, 1.0f } },
+	{ 8.5f, { 0.7255f, 0.6000f, 0.4471f, 1.0f } },		// Also 9.0-9.5, which used to fall between the bands
+	{ 9.5f, { 0.8509f, 0.7294f, 0.6157f, 1.0f } }
+};
+GLfloat terrainColourTable[TERRAIN_COLOUR_ENTRIES][4];	// terrainColourStops, baked by bakeTerrainColours().
+int terrainColourBlend = 0;			// Blend smoothly from each band to the next instead of stepping (--terrain-blend).
+const float SKYBLUE[] = { 0.271f, 0.678f, 0.922f, 1.0f };
+const float GOLD[] = { 0.9804f, 0.9019f, 0.6196f, 1.0f };
+const float BLUE[] = { 0.2784f, 0.5725f, 0.9019f, 1.0f };
+const float BODYCOLOR[] = { 0.75f, 0.75f, 0.75f, 1.0f };
+const float BLACK[] = { 0.0f, 0.0f, 0.0f, 1.0f };
+const float WHITE[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+const float CREAM[] = { 0.9686f, 0.9608f, 0.8f, 1.0f };
+const float RED[] = { 0.7176f, 0.1608f, 0.1608f, 1.0f };
+
+// Materials everything is drawn with (ambient, diffuse, specular, emission,
+// shininess, colour material), handed to the render queue with each item.
+const material_t skyMaterial = { { 0.2f, 0.2f, 0.2f, 1.0f }, { 0.8f, 0.8f, 0.8f, 1.0f },
+	{ 0.2f, 0.2f, 0.2f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, 100.0f, 1 };
+const material_t terrainMaterial = { { 0.2f, 0.2f, 0.2f, 1.0f }, { 0.8f, 0.8f, 0.8f, 1.0f },
+	{ 1.0f, 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, 100.0f, 1 };
+const material_t atomMaterial = { { 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f, 1.0f },
+	{ 1.0f, 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, 50.0f, 0 };
+const material_t electronMaterial = { { 8.0f, 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f, 1.0f, 1.0f },
+	{ 1.0f, 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, 50.0f, 0 };
+const material_t helipadMaterial = { { 0.5f, 0.5f, 0.5f, 1.0f }, { 0.8f, 0.8f, 0.8f, 1.0f },
+	{ 1.0f, 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, 64.0f, 0 };
+const material_t helipadMarkingMaterial = { { 1.0f, 1.0f, 0.0f, 0.6f }, { 1.0f, 1.0f, 0.0f, 0.6f },
+	{ 1.0f, 1.0f, 0.0f, 0.6f }, { 0.0f, 0.0f, 0.0f, 1.0f }, 100.0f, 0 };
+const material_t coneMaterial = { { 0.5f, 0.5f, 0.5f, 1.0f }, { 0.8f, 0.8f, 0.8f, 1.0f },
+	{ 1.0f, 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, 64.0f, 0 };
+const material_t windmillMaterial = { { 0.2f, 0.2f, 0.2f, 1.0f }, { 0.2f, 0.2f, 0.2f, 1.0f },
+	{ 0.2f, 0.2f, 0.2f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, 100.0f, 0 };
+const material_t blackMaterial = { { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f },
+	{ 0.2f, 0.2f, 0.2f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, 100.0f, 0 };
+const material_t blueMaterial = { { 0.2784f, 0.5725f, 0.9019f, 1.0f }, { 0.2784f, 0.5725f, 0.9019f, 1.0f },
+	{ 0.2f, 0.2f, 0.2f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, 100.0f, 0 };
+const material_t redMaterial = { { 0.7176f, 0.1608f, 0.1608f, 1.0f }, { 0.7176f, 0.1608f, 0.1608f, 1.0f },
+	{ 0.2f, 0.2f, 0.2f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, 100.0f, 0 };
+const material_t creamMaterial = { { 0.9686f, 0.9608f, 0.8f, 1.0f }, { 0.9686f, 0.9608f, 0.8f, 1.0f },
+	{ 0.2f, 0.2f, 0.2f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, 100.0f, 0 };
+meshObject obj;
+GLfloat lightX = 0.0f;
+double windmillRotation[20];
+GLfloat lightVelocityX = 0.03;
+Spotlight spotlights[25];
+GLenum lights[25];
+instancedmesh_t windmillMesh;			// One windmill, drawn at every windmill position at once...
+instancedmesh_t spotlightConeMesh;		// ...and one cone, drawn for every live spotlight.
+
+double windmillCoordinates[NUM_WINDMILLS][3] = {		// The heights are set from the ground by placeWindmills().
+		{14.127081, 9.732650, -1.002306},
+	{-7.250275, 10.658718, 66.065704},
+	{43.784729, 9.575411, -69.858345},
+	{-80.844543, 6.885019, -23.915012},
+	{-0.916259, 9.763863, -26.361935},
+	{-44.359699, 9.938830, -6.498155},
+	{43.469288, 8.574178, 9.094833},
+	{66.182175, 8.805546, 49.777252}
+};
+
+// The scene's objects, each with a box culled against the view frustum every
+// frame by cullScene(); only those inside it are drawn.
+enum {
+	SCENE_SKY,
+	SCENE_ATOM,
+	SCENE_CHOPPER,
+	SCENE_HELIPAD,
+	SCENE_WINDMILLS,									// One per windmill...
+	SCENE_SPOTLIGHTS = SCENE_WINDMILLS + NUM_WINDMILLS,	// ...and per spotlight cone
+	SCENE_OBJECTS = SCENE_SPOTLIGHTS + NUM_SPOTLIGHTS
+};
+bounds_t sceneBounds[SCENE_OBJECTS];
+bvh_t sceneHierarchy;
+unsigned char sceneVisible[SCENE_OBJECTS];
+int cullingEnabled = 1;				// Skip objects and terrain chunks outside the view frustum (--no-culling turns it off).
+occluder_t terrainOccluder;			// A coarse terrain drawn into sceneOcclusion each frame...
+occlusion_t sceneOcclusion;			// ...to skip windmills, spotlights and chunks hidden behind hills.
+int occlusionEnabled = 1;			// --no-occlusion turns that off.
+
+GLfloat coneColours[][4] = {
+	{ 10.0f, 0.0f, 0.0f, 0.20f },   
+	{ 10.0f, 5.0f, 0.0f, 0.20f },    
+	{ 10.0f, 10.0f, 0.0f, 0.20f },   
+	{ 0.0f, 10.0f, 0.0f, 0.20f },    
+	{ 0.0f, 0.0f, 10.0f, 0.20f },    
+	{ 4.0f, 0.0f, 8.0f, 0.20f },    
+	{ 8.0f, 0.0f, 10.0f, 0.20f }    
+};
+GLfloat lightColours[][4] = {
+	{ 10.0f, 0.0f, 0.0f, 1.0f },    
+	{ 10.0f, 5.0f, 0.0f, 1.0f },    
+	{ 10.0f, 10.0f, 0.0f, 1.0f },   
+	{ 0.0f, 10.0f, 0.0f, 1.0f },    
+	{ 0.0f, 0.0f, 10.0f, 1.0f },    
+	{ 4.0f, 0.0f, 8.0f, 1.0f },     
+	{ 8.0f, 0.0f, 10.0f, 1.0f }     
+};
+int score = 0;
+int verticalSpeedResetSwitch = 0;
+int tip = 1;
+GLfloat orbitRadius = 3.0f; 
+GLfloat orbitSpeed = 0.05f; 
+GLfloat electronAngle = 0.0f;  
+int numElectrons = 1;
+
+// The world after the last two ticks, kept by whichever thread runs them...
+worldstate_t previousWorld;
+worldstate_t currentWorld;
+
+// ...and published after each for display() to draw between, through a triple
+// buffer so neither thread ever waits for the other.
+triplebuffer_t worldSnapshots;
+worldstate_t frameWorld;
+
+// The simulation thread, and the lock it ticks under. Anything else that
+// touches what think() does (the key states, the assets, the world pager)
+// takes it with lockWorld() first.
+platformthread_t* simThread = NULL;
+platformmutex_t* worldMutex = NULL;
+volatile int simThreadStopping = 0;
+int worldLocked = 0;				// lockWorld() has been called (only ever on the GL thread).
+
+// Where writeTrace() saves the Chrome trace (set by --trace, or when KEY_TRACE is first pressed).
+const char* tracePath = NULL;
+
+// Seed for the random windmill rotations and spotlight placement (fixed when benchmarking).
+unsigned int sceneSeed = 0;
+int requestedBackend = -1;		// RENDER_BACKEND_ value from --backend, or -1 for the default.
+
+/******************************************************************************
+ * Benchmark Flight Script
+ ******************************************************************************/
+
+// A single scripted key press or release, replayed through the normal keyboard callbacks.
+typedef struct {
+	int frame;		// Frame (within the script) on which the event happens.
+	int pressed;	// 1 = key pressed, 0 = key released.
+	int special;	// 1 = GLUT special key (SP_KEY_), 0 = character key (KEY_).
+	int key;
+} scriptedkey_t;
+
+// Take off, fly a full circle, coast out of it while still turning, strafe, then
+// descend under gravity. The flight stays over the map when the script is replayed,
+// which happens for benchmarks longer than BENCHMARK_FLIGHT_FRAMES.
+#define BENCHMARK_FLIGHT_FRAMES 900
+
+const scriptedkey_t benchmarkFlight[] = {
+	{   0, 1, 1, SP_KEY_MOVE_UP },
+	{ 200, 1, 0, KEY_MOVE_FORWARD },
+	{ 200, 1, 1, SP_KEY_TURN_LEFT },
+	{ 560, 0, 0, KEY_MOVE_FORWARD },
+	{ 600, 1, 0, KEY_MOVE_RIGHT },
+	{ 660, 0, 0, KEY_MOVE_RIGHT },
+	{ 760, 0, 1, SP_KEY_MOVE_UP },
+	{ 860, 0, 1, SP_KEY_TURN_LEFT }
+};
+
+/******************************************************************************
+ * Entry Point (don't put anything except the main function here)
+ ******************************************************************************/
+int main(int argc, char** argv)
+{
+	int headlessFrames = 0;
+	int benchFrames = 0;
+	int benchSync = 0;
+	const char* screenshotPath = NULL;
+	const char* benchOutputPath = NULL;
+	int primitiveBenchIterations = 0;
+	int terrainBenchSize = 0;
+	int simBenchTicks = 0;
+	const char* worldPath = NULL;
+	size_t worldBudget = (size_t)WORLD_BUDGET_MB << 20;
+
+	sceneSeed = (unsigned int)time(NULL);
+
+	// Command line options (all optional):
+	//   --headless N       render N frames into an offscreen context, then exit
+	//   --screenshot FILE  with --headless, save the final frame as a PPM
+	//   --bench N          headless benchmark: N frames of the scripted flight, no frame limiter
+	//   --bench-out FILE   write per-frame timings to FILE (.csv or .json)
+	//   --bench-sync       glFinish around each timed section to attribute rendering cost
+	//   --seed S           random seed for the scene (defaults to the time, or 1 when benchmarking)
+	//   --trace FILE       record hot-path zones and write them to FILE (Chrome trace JSON) on exit
+	//   --bench-ppm FILE   time loading FILE with fscanf versus the bulk PPM loader, then exit
+	//   --no-asset-cache   decode the PPMs every run instead of using (or writing) their .cache files
+	//   --bench-primitives N  draw each shape N times through GLU and through the primitive cache, then exit
+	//   --no-instancing    draw windmills and spotlight cones one at a time, as without OpenGL 3.3
+	//   --no-state-cache   send every state change to OpenGL, even ones that change nothing
+	//   --backend B        draw with the "fixed" function pipeline or the GLSL "core" backend
+	//   --core-profile     ask for an OpenGL 3.3 core profile context (implies --backend core)
+	//   --terrain-error PX most pixels of error a terrain chunk's level of detail may cause (0 for full detail)
+	//   --bench-terrain-lod N  time terrain level of detail selection on an N x N heightmap, then exit
+	//   --bench-normals    time the terrain normal kernels on 200x200, 2048x2048 and 8192x8192 grids, then exit
+	//   --terrain-blend    blend the terrain's colour smoothly between height bands
+	//   --no-culling       draw every object and terrain chunk, even those outside the view frustum
+	//   --no-occlusion     draw windmills, spotlights and terrain chunks even when hills hide them
+	//   --bench-heights N  time single and batched ground height queries over an N x N height field, then exit
+	//   --world FILE       stream the terrain from a tile file around the helicopter instead of terrain.ppm
+	//   --world-budget MB  memory the streamed tiles may use (default 32)
+	//   --tile-heightmap PPM FILE  write a heightmap as a tile file for --world, then exit
+	//   --tile-synthetic N FILE    write an N x N synthetic world as a tile file for --world, then exit
+	//   --fps N            draw at most N frames a second, or as many as possible for 0 (default 60)
+	//   --bench-sim N      run N simulation ticks of the scripted flight without drawing anything, then exit
+	//   --no-sim-thread    run the simulation between frames on the GL thread rather than alongside them
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--headless") == 0 && i + 1 < argc) {
+			headlessFrames = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--screenshot") == 0 && i + 1 < argc) {
+			screenshotPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+			benchFrames = atoi(argv[++i]);
+			sceneSeed = 1;
+		}
+		else if (strcmp(argv[i], "--bench-out") == 0 && i + 1 < argc) {
+			benchOutputPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--bench-sync") == 0) {
+			benchSync = 1;
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+			sceneSeed = (unsigned int)strtoul(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+			tracePath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--bench-ppm") == 0 && i + 1 < argc) {
+			ppmBenchmark(argv[++i], 20);
+			return 0;
+		}
+		else if (strcmp(argv[i], "--no-asset-cache") == 0) {
+			assetCacheEnable(0);
+		}
+		else if (strcmp(argv[i], "--no-instancing") == 0) {
+			instancingEnable(0);
+		}
+		else if (strcmp(argv[i], "--no-state-cache") == 0) {
+			glStateCacheEnable(0);
+		}
+		else if (strcmp(argv[i], "--backend") == 0 && i + 1 < argc) {
+			i++;
+			requestedBackend = strcmp(argv[i], "core") == 0 ? RENDER_BACKEND_CORE : RENDER_BACKEND_FIXED;
+		}
+		else if (strcmp(argv[i], "--core-profile") == 0) {
+			platformRequestCoreProfile();
+			requestedBackend = RENDER_BACKEND_CORE;
+		}
+		else if (strcmp(argv[i], "--bench-primitives") == 0 && i + 1 < argc) {
+			primitiveBenchIterations = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--terrain-error") == 0 && i + 1 < argc) {
+			terrainPixelError = (float)atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--bench-terrain-lod") == 0 && i + 1 < argc) {
+			terrainBenchSize = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--terrain-blend") == 0) {
+			terrainColourBlend = 1;
+		}
+		else if (strcmp(argv[i], "--no-culling") == 0) {
+			cullingEnabled = 0;
+		}
+		else if (strcmp(argv[i], "--no-occlusion") == 0) {
+			occlusionEnabled = 0;
+		}
+		else if (strcmp(argv[i], "--bench-heights") == 0 && i + 1 < argc) {
+			heightfieldBenchmark(atoi(argv[++i]));
+			return 0;
+		}
+		else if (strcmp(argv[i], "--bench-normals") == 0) {
+			terrainNormalsBenchmark();
+			return 0;
+		}
+		else if (strcmp(argv[i], "--world") == 0 && i + 1 < argc) {
+			worldPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--world-budget") == 0 && i + 1 < argc) {
+			worldBudget = (size_t)(atof(argv[++i]) * 1048576.0);
+		}
+		else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+			int fps = atoi(argv[++i]);
+			frameLimiterEnabled = fps > 0;
+			frameTime = fps > 0 ? 1000 / fps : 0;
+		}
+		else if (strcmp(argv[i], "--no-sim-thread") == 0) {
+			simThreadEnabled = 0;
+		}
+		else if (strcmp(argv[i], "--bench-sim") == 0 && i + 1 < argc) {
+			simBenchTicks = atoi(argv[++i]);
+			sceneSeed = 1;
+		}
+		else if (strcmp(argv[i], "--tile-heightmap") == 0 && i + 2 < argc) {
+			assetimage_t image;
+			if (!assetLoadImage(argv[i + 1], ASSET_PLANE_HEIGHT, &image)) {
+				return 1;
+			}
+			int written = terrainTilesWrite(argv[i + 2], image.height, image.width, -100.0f, -100.0f, 1.0f,
+				heightmapTileHeight, &image);
+			assetRelease(&image);
+			printf(written ? "Wrote %s\n" : "Could not write %s\n", argv[i + 2]);
+			return written ? 0 : 1;
+		}
+		else if (strcmp(argv[i], "--tile-synthetic") == 0 && i + 2 < argc) {
+			int size = atoi(argv[i + 1]);
+			GLfloat half = (size - 1) / 2.0f;
+			double start = platformTimeSeconds();
+			int written = terrainTilesWrite(argv[i + 2], size, size, -half, -half, 1.0f, terrainSyntheticHeight, NULL);
+			printf(written ? "Wrote %s in %.1f s\n" : "Could not write %s\n", argv[i + 2],
+				platformTimeSeconds() - start);
+			return written ? 0 : 1;
+		}
+	}
+
+	traceSetThreadName("main");
+	if (tracePath != NULL) {
+		traceEnable(1);
+	}
+	// atexit runs these last first, so the trace is written before the workers are stopped.
+	atexit(jobsStop);
+	atexit(writeTrace);
+
+	if (worldPath != NULL) {
+		worldPager = terrainPagerOpen(worldPath, worldBudget);
+		if (worldPager == NULL) {
+			return 1;
+		}
+		atexit(closeWorld);
+	}
+
+	if (primitiveBenchIterations > 0) {
+		if (!platformInitHeadless(SCREEN_WIDTH, SCREEN_HEIGHT)) {
+			return 1;
+		}
+		glFuncsLoad();
+		primitivesBenchmark(primitiveBenchIterations);
+		return 0;
+	}
+
+	if (terrainBenchSize > 0) {
+		if (!platformInitHeadless(SCREEN_WIDTH, SCREEN_HEIGHT)) {
+			return 1;
+		}
+		glFuncsLoad();
+		terrainLodBenchmark(terrainBenchSize);
+		return 0;
+	}
+
+	if (simBenchTicks > 0) {
+		if (!platformInitHeadless(SCREEN_WIDTH, SCREEN_HEIGHT)) {
+			return 1;
+		}
+		init();
+		benchmarkSimulation(simBenchTicks);
+		return 0;
+	}
+
+	if (benchFrames > 0) {
+		headlessFrames = benchFrames;
+	}
+
+	if (headlessFrames > 0) {
+		// Create an offscreen context instead of a window and drive the same
+		// display()/idle() cycle that glutMainLoop would.
+		if (!platformInitHeadless(SCREEN_WIDTH, SCREEN_HEIGHT)) {
+			return 1;
+		}
+
+		init();
+		reshape(SCREEN_WIDTH, SCREEN_HEIGHT);
+
+		// Headless runs advance exactly one think() per frame; benchmarks do it as fast as possible.
+		simLockstep = 1;
+		if (benchFrames > 0) {
+			frameLimiterEnabled = 0;
+			if (!benchStart(benchFrames, benchSync)) {
+				return 1;
+			}
+		}
+		frameStartTime = platformElapsedMs();
+
+		for (int frame = 0; frame < headlessFrames; frame++) {
+			if (benchFrames > 0) {
+				playBenchmarkFlight(frame);
+			}
+
+			benchBeginFrame();
+			display();
+			idle();
+			benchEndFrame();
+		}
+
+		if (benchFrames > 0) {
+			benchPrintSummary();
+			terrainLodPrintStats(&terrainLod);
+			if (worldPager != NULL) {
+				terrainPagerPrintStats(worldPager);
+			}
+			if (benchOutputPath != NULL && !benchWriteResults(benchOutputPath)) {
+				printf("Could not write %s\n", benchOutputPath);
+			}
+			benchStop();
+		}
+
+		if (screenshotPath != NULL && !platformSaveFramebuffer(screenshotPath, SCREEN_WIDTH, SCREEN_HEIGHT)) {
+			printf("Could not write %s\n", screenshotPath);
+			return 1;
+		}
+		return 0;
+	}
+
+	// Initialize the OpenGL window.
+	platformInitWindow(&argc, argv, SCREEN_WIDTH, SCREEN_HEIGHT, "Project");
+
+	// Set up the scene.
+	init();
+	
+	// Disable key repeat (keyPressed or specialKeyPressed will only be called once when a key is first pressed).
+	glutSetKeyRepeat(GLUT_KEY_REPEAT_OFF);
+
+	// Register GLUT callbacks.
+	glutDisplayFunc(display);
+	glutReshapeFunc(reshape);
+	glutKeyboardFunc(keyPressed);
+	glutSpecialFunc(specialKeyPressed);
+	glutKeyboardUpFunc(keyReleased);
+	glutSpecialUpFunc(specialKeyReleased);
+	glutIdleFunc(idle);
+
+	// Record when we started rendering the very first frame (which should happen after we call glutMainLoop).
+	frameStartTime = platformElapsedMs();
+	simClockStart(&simClock, SIM_TICK_RATE, platformTimeSeconds());
+	if (simThreadEnabled) {
+		startSimulationThread();
+	}
+
+	// Enter the main drawing loop (this will never return).
+	glutMainLoop();
+	return 0;
+}
+
+/******************************************************************************
+ * GLUT Callbacks (don't add any other functions here)
+ ******************************************************************************/
+
+ /*
+	 Called when GLUT wants us to (re)draw the current animation frame.
+
+	 Note: This function must not do anything to update the state of our simulated
+	 world. Animation (moving or rotating things, responding to keyboard input,
+	 etc.) should only be performed within the think() function provided below.
+ */
+void display(void) {
+	tracezone_t traceZone = traceBegin("display");
+
+	// Draw the world as far past the last tick as now is (or just as it left it, in lockstep).
+	const worldsnapshot_t* snapshot = tripleBufferRead(&worldSnapshots);
+	GLfloat alpha = simLockstep ? 1.0f : (GLfloat)((platformTimeSeconds() - snapshot->time) * SIM_TICK_RATE);
+	blendWorld(&frameWorld, &snapshot->previous, &snapshot->current, alpha < 1.0f ? alpha : 1.0f);
+
+	// GLUT (or anything else that bypasses the state cache) may have changed GL state since the last frame.
+	glStateInvalidate();
+
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	gluPerspective(60.0f, 1.2f, 1.0f, 300.0f);
+	glMatrixMode(GL_MODELVIEW);
+	glLoadIdentity();
+	
+	//Control 'l'
+	if (!renderFillEnabled) {
+		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+
+	}
+	if (renderFillEnabled) {
+		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	}
+	
+	//Camera calculations
+	GLfloat objectRadius = 5.0f; 
+	GLfloat objectRotationX = frameWorld.heliYaw * PI / 180.0f;
+	GLfloat objectRotationY = heliY * PI / 180.0f;
+	GLfloat objectRotationZ = heliZ * PI / 180.0f;
+
+	GLfloat cameraDistance = 4.0f;
+
+	GLfloat objectX = frameWorld.heliCoord[0] + objectRadius * cos(objectRotationX);
+	GLfloat objectY = frameWorld.heliCoord[1] + objectRadius * sin(objectRotationY);
+	GLfloat objectZ = frameWorld.heliCoord[2] + objectRadius * sin(objectRotationZ);
+
+	GLfloat cameraX = frameWorld.heliCoord[0] + cameraDistance * sin(objectRotationX);
+	GLfloat cameraY = objectY + 1;
+	GLfloat cameraZ = frameWorld.heliCoord[2] + cameraDistance * cos(objectRotationX);
+
+	glEnable(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, texture_id);
+
+	glDisable(GL_TEXTURE_2D);
+
+	gluLookAt(cameraX, cameraY, cameraZ,
+	frameWorld.heliCoord[0], frameWorld.heliCoord[1], frameWorld.heliCoord[2],
+	0.0f, 1.0f, 0.0f);
+
+	cullScene(cameraX, cameraY, cameraZ);
+
+	// Everything up to the HUD goes through the render queue, drawn (sorted by
+	// state) by renderFlush(); each item is timed under the section it came from.
+
+	//Sky
+	benchBeginSection(BENCH_SKY_CYLINDER);
+	renderSetSection(BENCH_SKY_CYLINDER);
+	if (sceneVisible[SCENE_SKY]) {
+		cylinderitem_t sky = { 100, 80, 50 };
+		renderSubmit(RENDER_PASS_BACKGROUND, &skyMaterial, 0, drawSkyCylinderItem, &sky, sizeof(sky));
+	}
+	benchEndSection(BENCH_SKY_CYLINDER);
+	
+	//Ground
+	benchBeginSection(BENCH_TERRAIN);
+	renderSetSection(BENCH_TERRAIN);
+	updateWorld();
+	float terrainScale = 1;
+	renderSubmit(RENDER_PASS_OPAQUE, &terrainMaterial, groundTextureHandle, drawTerrainItem, &terrainScale, sizeof(terrainScale));
+	benchEndSection(BENCH_TERRAIN);
+	
+	//Sky atom :)
+	benchBeginSection(BENCH_ATOM);
+	renderSetSection(BENCH_ATOM);
+	if (sceneVisible[SCENE_ATOM]) {
+		glPushMatrix();
+		glTranslatef(0.0, 25.0, 0.0);
+		glScalef(3.0, 3.0, 3.0);
+		drawAtom();
+		glPopMatrix();
+	}
+	benchEndSection(BENCH_ATOM);
+
+	//Helicopter
+	benchBeginSection(BENCH_CHOPPER);
+	renderSetSection(BENCH_CHOPPER);
+	if (sceneVisible[SCENE_CHOPPER]) {
+		glPushMatrix();
+		drawChopper(frameWorld.heliCoord[0], frameWorld.heliCoord[1], frameWorld.heliCoord[2]);
+		glPopMatrix();
+	}
+	benchEndSection(BENCH_CHOPPER);
+
+	//Helipad
+	benchBeginSection(BENCH_HELIPAD);
+	renderSetSection(BENCH_HELIPAD);
+	if (sceneVisible[SCENE_HELIPAD]) {
+		glPushMatrix();
+		glTranslatef(0.0f, 9.35f, -38.0f);
+		glColor3f(1.0, 1.0, 1.0);
+		drawHelipad(3.0, 0.05, 40);
+		glPopMatrix();
+	}
+	benchEndSection(BENCH_HELIPAD);
+
+	//Spotlights
+	benchBeginSection(BENCH_SPOTLIGHT);
+	renderSetSection(BENCH_SPOTLIGHT);
+	if (instancingAvailable()) {
+		drawSpotlights();
+	}
+	else {
+		// The lights still light the scene when their cones are out of sight.
+		for (int i = 0; i < NUM_SPOTLIGHTS; i++) {
+			if (sceneVisible[SCENE_SPOTLIGHTS + i]) {
+				drawSpotlight(lights[i], frameWorld.spotlights[i], frameWorld.coneColours[frameWorld.spotlights[i].colorCode], lightColours[frameWorld.spotlights[i].colorCode]);
+			}
+			else {
+				placeSpotlight(lights[i], frameWorld.spotlights[i], lightColours[frameWorld.spotlights[i].colorCode]);
+			}
+		}
+	}
+	benchEndSection(BENCH_SPOTLIGHT);
+	
+	//Windmills
+	benchBeginSection(BENCH_WINDMILL);
+	renderSetSection(BENCH_WINDMILL);
+	if (instancingAvailable()) {
+		drawWindmills();
+	}
+	else {
+		int numLines = sizeof(windmillCoordinates) / sizeof(windmillCoordinates[0]);
+
+		for (int i = 0; i < numLines; i++) {
+			if (!sceneVisible[SCENE_WINDMILLS + i]) {
+				continue;
+			}
+
+			double x = windmillCoordinates[i][0];
+			double y = windmillCoordinates[i][1];
+			double z = windmillCoordinates[i][2];
+			drawWindmill(windmillRotation[i], x, y, z);
+		}
+	}
+	benchEndSection(BENCH_WINDMILL);
+
+	renderSetSection(-1);
+	renderFlush();
+
+	
+	//HUD
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	glOrtho(0, windowWidth, 0, windowHeight, -1, 1);
+
+	glMatrixMode(GL_MODELVIEW);
+	glLoadIdentity();
+
+	
+	// GLUT's bitmap fonts need the fixed-function pipeline, so a core profile
+	// context goes without the text.
+	if (!glFuncs.coreProfile) {
+		char scoreString[256];
+		snprintf(scoreString, sizeof(scoreString), "Score: %d", frameWorld.score);
+
+		drawBitmapString(scoreString, 10, windowHeight - 20, 1.0f, 1.0f, 1.0f);
+		if (frameWorld.tip == 1) {
+			drawBitmapString("Catch the spotlights to score points", 320, windowHeight - 70, 1.0f, 1.0f, 1.0f);
+			drawBitmapString(" and add electrons to the sky atom", 322, windowHeight - 97, 1.0f, 1.0f, 1.0f);
+		}
+	}
+	platformSwapBuffers();
+	glStatsEndFrame();
+
+	traceEnd(traceZone);
+}
+
+/*
+	Called by display() once the camera is placed: box each object where it
+	is this frame and mark the ones inside the view frustum, and not hidden
+	behind the terrain, in sceneVisible. The boxes are a little generous, so
+	nothing is culled while any of it could be on screen.
+*/
+void cullScene(GLfloat cameraX, GLfloat cameraY, GLfloat cameraZ) {
+	tracezone_t traceZone = traceBegin("cullScene");
+
+	const GLfloat* projection = matrixStackTop(GL_PROJECTION);
+	const GLfloat* modelview = matrixStackTop(GL_MODELVIEW);
+	unsigned char hidden[SCENE_OBJECTS] = { 0 };
+
+	GLfloat atomRadius = 3.0f * (orbitRadius + 0.2f);
+	sceneBox(SCENE_SKY, 0.0f, 0.0f, 0.0f, 100.0f, 40.0f, 100.0f);
+	sceneBox(SCENE_ATOM, 0.0f, 25.0f, 0.0f, atomRadius, atomRadius, atomRadius);
+	sceneBox(SCENE_CHOPPER, frameWorld.heliCoord[0], frameWorld.heliCoord[1], frameWorld.heliCoord[2], 1.5f, 1.5f, 1.5f);
+	sceneBox(SCENE_HELIPAD, 0.0f, 9.35f, -38.0f, 3.0f, 0.1f, 3.0f);
+	for (int i = 0; i < NUM_WINDMILLS; i++) {
+		// From the bottom of the base to the tip of a blade, whichever way it faces.
+		sceneBox(SCENE_WINDMILLS + i, (GLfloat)windmillCoordinates[i][0], (GLfloat)windmillCoordinates[i][1] + 2.75f,
+			(GLfloat)windmillCoordinates[i][2], 3.0f, 4.25f, 3.0f);
+	}
+	for (int i = 0; i < NUM_SPOTLIGHTS; i++) {
+		sceneBox(SCENE_SPOTLIGHTS + i, frameWorld.spotlights[i].x, frameWorld.spotlights[i].y - 3.75f, frameWorld.spotlights[i].z, 2.0f, 2.25f, 2.0f);
+	}
+
+	if (cullingEnabled && bvhBuild(&sceneHierarchy, sceneBounds, sizeof(bounds_t), SCENE_OBJECTS)) {
+		frustum_t frustum;
+		frustumExtract(&frustum, projection, modelview);
+		bvhCull(&sceneHierarchy, sceneBounds, sizeof(bounds_t), &frustum, sceneVisible);
+	}
+	else {
+		memset(sceneVisible, 1, sizeof(sceneVisible));
+	}
+
+	// The terrain only hides what's behind it from a camera above it. The
+	// depth drawn here is kept for drawTerrain() to test the chunks against.
+	GLfloat ground;
+	lockWorld();
+	groundHeights(&cameraX, &cameraZ, &ground, 1);
+	unlockWorld();
+	if (occlusionEnabled && cameraY > ground
+		&& occlusionRender(&sceneOcclusion, &terrainOccluder, projection, modelview)) {
+		for (int i = SCENE_WINDMILLS; i < SCENE_OBJECTS; i++) {
+			if (sceneVisible[i] && !occlusionTestBounds(&sceneOcclusion, &sceneBounds[i])) {
+				sceneVisible[i] = 0;
+				hidden[i] = 1;
+			}
+		}
+	}
+	else {
+		occlusionReset(&sceneOcclusion);
+	}
+
+	// Dead spotlights aren't drawn either way, so they don't count.
+	for (int i = 0; i < SCENE_OBJECTS; i++) {
+		if (i >= SCENE_SPOTLIGHTS && frameWorld.spotlights[i - SCENE_SPOTLIGHTS].alive != 1) {
+			continue;
+		}
+		if (sceneVisible[i]) {
+			glStats.objectsSubmitted++;
+		}
+		else if (hidden[i]) {
+			glStats.objectsOccluded++;
+		}
+		else {
+			glStats.objectsCulled++;
+		}
+	}
+
+	traceEnd(traceZone);
+}
+
+/*
+	Set an object's box from its centre and half its size along each axis.
+*/
+void sceneBox(int object, GLfloat x, GLfloat y, GLfloat z, GLfloat halfX, GLfloat halfY, GLfloat halfZ) {
+	bounds_t* box = &sceneBounds[object];
+
+	box->min[0] = x - halfX;
+	box->min[1] = y - halfY;
+	box->min[2] = z - halfZ;
+	box->max[0] = x + halfX;
+	box->max[1] = y + halfY;
+	box->max[2] = z + halfZ;
+}
+
+
+/*
+	Called when the OpenGL window has been resized.
+*/
+void reshape(int width, int h)
+{// update the new width
+	windowWidth = width;
+	// update the new height
+	windowHeight = h;
+
+	// update the viewport to still be all of the window
+	glViewport(0, 0, windowWidth, windowHeight);
+
+	// change into projection mode so that we can change the camera properties
+	glMatrixMode(GL_PROJECTION);
+
+	// load the identity matrix into the projection matrix
+	glLoadIdentity();
+
+	// gluPerspective(fovy, aspect, near, far)
+	gluPerspective(45, (float)windowWidth / (float)windowHeight, 1, 20);
+
+	// change into model-view mode so that we can change the object positions
+	glMatrixMode(GL_MODELVIEW);
+}
+
+/*
+	Called each time a character key (e.g. a letter, number, or symbol) is pressed.
+*/
+void keyPressed(unsigned char key, int x, int y)
+{
+	// The key states (and the assets KEY_RELOAD replaces) are the simulation thread's while it runs.
+	lockWorld();
+	switch (tolower(key)) {
+
+		/*
+			Keyboard-Controlled Motion Handler - DON'T CHANGE THIS SECTION
+
+			Whenever one of our movement keys is pressed, we do two things:
+			(1) Update motionKeyStates to record that the key is held down. We use
+				this later in the keyReleased callback.
+			(2) Update the relevant axis in keyboardMotion to set the new direction
+				we should be moving in. The most recent key always "wins" (e.g. if
+				you're holding down KEY_MOVE_LEFT then also pressed KEY_MOVE_RIGHT,
+				our object will immediately start moving right).
+		*/
+	case KEY_MOVE_FORWARD:
+		motionKeyStates.MoveForward = KEYSTATE_DOWN;
+		keyboardMotion.Surge = MOTION_FORWARD;
+		break;
+	case KEY_MOVE_BACKWARD:
+		motionKeyStates.MoveBackward = KEYSTATE_DOWN;
+		keyboardMotion.Surge = MOTION_BACKWARD;
+		break;
+	case KEY_MOVE_LEFT:
+		motionKeyStates.MoveLeft = KEYSTATE_DOWN;
+		keyboardMotion.Sway = MOTION_LEFT;
+		break;
+	case KEY_MOVE_RIGHT:
+		motionKeyStates.MoveRight = KEYSTATE_DOWN;
+		keyboardMotion.Sway = MOTION_RIGHT;
+		break;
+
+		/*
+			Other Keyboard Functions (add any new character key controls here)
+
+			Rather than using literals (e.g. "t" for spotlight), create a new KEY_
+			definition in the "Keyboard Input Handling Setup" section of this file.
+			For example, refer to the existing keys used here (KEY_MOVE_FORWARD,
+			KEY_MOVE_LEFT, KEY_EXIT, etc).
+		*/
+	case KEY_RENDER_FILL:
+		renderFillEnabled = !renderFillEnabled;
+		break;
+	case KEY_GL_STATS:
+		glStatsPrint(glStatsLastFrame());
+		texturesPrintStats();
+		terrainLodPrintStats(&terrainLod);
+		if (worldPager != NULL) {
+			terrainPagerPrintStats(worldPager);
+		}
+		break;
+	case KEY_RELOAD:
+		loadAssets();
+		break;
+	case KEY_BACKEND: {
+		int backend = renderBackendCurrent() == RENDER_BACKEND_FIXED ? RENDER_BACKEND_CORE : RENDER_BACKEND_FIXED;
+		if (renderBackendSelect(backend)) {
+			printf("Drawing with the %s backend\n", renderBackendName(backend));
+		}
+		else {
+			printf("The %s backend isn't available\n", renderBackendName(backend));
+		}
+		break;
+	}
+	case KEY_TRACE:
+		if (!traceIsEnabled()) {
+			if (tracePath == NULL) {
+				tracePath = "trace.json";
+			}
+			traceEnable(1);
+		}
+		else {
+			writeTrace();
+		}
+		break;
+	case KEY_EXIT:
+		exit(0);
+		break;
+	}
+	unlockWorld();
+}
+
+/*
+	Called each time a "special" key (e.g. an arrow key) is pressed.
+*/
+void specialKeyPressed(int key, int x, int y)
+{
+	lockWorld();
+	switch (key) {
+
+		/*
+			Keyboard-Controlled Motion Handler - DON'T CHANGE THIS SECTION
+
+			This works as per the motion keys in keyPressed.
+		*/
+	case SP_KEY_MOVE_UP:
+		motionKeyStates.MoveUp = KEYSTATE_DOWN;
+		keyboardMotion.Heave = MOTION_UP;
+		break;
+	case SP_KEY_MOVE_DOWN:
+		motionKeyStates.MoveDown = KEYSTATE_DOWN;
+		keyboardMotion.Heave = MOTION_DOWN;
+		break;
+	case SP_KEY_TURN_LEFT:
+		motionKeyStates.TurnLeft = KEYSTATE_DOWN;
+
+		keyboardMotion.Yaw = MOTION_ANTICLOCKWISE;
+		break;
+	case SP_KEY_TURN_RIGHT:
+		motionKeyStates.TurnRight = KEYSTATE_DOWN;
+
+		keyboardMotion.Yaw = MOTION_CLOCKWISE;
+		break;
+
+		/*
+			Other Keyboard Functions (add any new special key controls here)
+
+			Rather than directly using the GLUT constants (e.g. GLUT_KEY_F1), create
+			a new SP_KEY_ definition in the "Keyboard Input Handling Setup" section of
+			this file. For example, refer to the existing keys used here (SP_KEY_MOVE_UP,
+			SP_KEY_TURN_LEFT, etc).
+		*/
+	}
+	unlockWorld();
+}
+
+/*
+	Called each time a character key (e.g. a letter, number, or symbol) is released.
+*/
+void keyReleased(unsigned char key, int x, int y)
+{
+	lockWorld();
+	switch (tolower(key)) {
+
+		/*
+			Keyboard-Controlled Motion Handler - DON'T CHANGE THIS SECTION
+
+			Whenever one of our movement keys is released, we do two things:
+			(1) Update motionKeyStates to record that the key is no longer held down;
+				we need to know when we get to step (2) below.
+			(2) Update the relevant axis in keyboardMotion to set the new direction
+				we should be moving in. This gets a little complicated to ensure
+				the controls work smoothly. When the user releases a key that moves
+				in one direction (e.g. KEY_MOVE_RIGHT), we check if its "opposite"
+				key (e.g. KEY_MOVE_LEFT) is pressed down. If it is, we begin moving
+				in that direction instead. Otherwise, we just stop moving.
+		*/
+	case KEY_MOVE_FORWARD:
+		motionKeyStates.MoveForward = KEYSTATE_UP;
+		keyboardMotion.Surge = (motionKeyStates.MoveBackward == KEYSTATE_DOWN) ? MOTION_BACKWARD : MOTION_NONE;
+		taperX = 1;
+
+		break;
+	case KEY_MOVE_BACKWARD:
+		motionKeyStates.MoveBackward = KEYSTATE_UP;
+		keyboardMotion.Surge = (motionKeyStates.MoveForward == KEYSTATE_DOWN) ? MOTION_FORWARD : MOTION_NONE;
+		taperX = 2;
+
+		break;
+	case KEY_MOVE_LEFT:
+		motionKeyStates.MoveLeft = KEYSTATE_UP;
+		keyboardMotion.Sway = (motionKeyStates.MoveRight == KEYSTATE_DOWN) ? MOTION_RIGHT : MOTION_NONE;
+
+		break;
+	case KEY_MOVE_RIGHT:
+		motionKeyStates.MoveRight = KEYSTATE_UP;
+		keyboardMotion.Sway = (motionKeyStates.MoveLeft == KEYSTATE_DOWN) ? MOTION_LEFT : MOTION_NONE;
+
+		break;
+
+		/*
+			Other Keyboard Functions (add any new character key controls here)
+
+			Note: If you only care when your key is first pressed down, you don't have to
+			add anything here. You only need to put something in keyReleased if you care
+			what happens when the user lets go, like we do with our movement keys above.
+			For example: if you wanted a spotlight to come on while you held down "t", you
+			would need to set a flag to turn the spotlight on in keyPressed, and update the
+			flag to turn it off in keyReleased.
+		*/
+	}
+	unlockWorld();
+}
+
+/*
+	Called each time a "special" key (e.g. an arrow key) is released.
+*/
+void specialKeyReleased(int key, int x, int y)
+{
+	lockWorld();
+	switch (key) {
+		/*
+			Keyboard-Controlled Motion Handler - DON'T CHANGE THIS SECTION
+
+			This works as per the motion keys in keyReleased.
+		*/
+	case SP_KEY_MOVE_UP:
+		motionKeyStates.MoveUp = KEYSTATE_UP;
+		gravityon = 1;
+
+		keyboardMotion.Heave = (motionKeyStates.MoveDown == KEYSTATE_DOWN) ? MOTION_DOWN : MOTION_NONE;
+		break;
+	case SP_KEY_MOVE_DOWN:
+		motionKeyStates.MoveDown = KEYSTATE_UP;
+		gravityon = 1;
+		keyboardMotion.Heave = (motionKeyStates.MoveUp == KEYSTATE_DOWN) ? MOTION_UP : MOTION_NONE;
+		break;
+	case SP_KEY_TURN_LEFT:
+		motionKeyStates.TurnLeft = KEYSTATE_UP;
+
+		keyboardMotion.Yaw = (motionKeyStates.TurnRight == KEYSTATE_DOWN) ? MOTION_CLOCKWISE : MOTION_NONE;
+
+		break;
+	case SP_KEY_TURN_RIGHT:
+		motionKeyStates.TurnRight = KEYSTATE_UP;
+		keyboardMotion.Yaw = (motionKeyStates.TurnLeft == KEYSTATE_DOWN) ? MOTION_ANTICLOCKWISE : MOTION_NONE;
+		break;
+
+		/*
+			Other Keyboard Functions (add any new special key controls here)
+
+			As per keyReleased, you only need to handle the key here if you want something
+			to happen when the user lets go. If you just want something to happen when the
+			key is first pressed, add you code to specialKeyPressed instead.
+		*/
+	}
+	unlockWorld();
+}
+
+/*
+	Called by GLUT when it's not rendering a frame.
+
+	Note: We use this to handle animation and timing. You shouldn't need to modify
+	this callback at all. Instead, place your animation logic (e.g. moving or rotating
+	things) within the think() method provided with this template.
+*/
+void idle(void)
+{
+	tracezone_t traceZone = traceBegin("idle");
+	// Wait until it's time to render the next frame.
+
+	unsigned int frameTimeElapsed = platformElapsedMs() - frameStartTime;
+	if (frameLimiterEnabled && frameTimeElapsed < frameTime)
+	{
+		// This frame took less time to render than the ideal frameTime: we'll suspend this thread for the remaining time,
+		// so we're not taking up the CPU until we need to render another frame.
+		unsigned int timeLeft = frameTime - frameTimeElapsed;
+		tracezone_t sleepZone = traceBegin("sleep");
+		platformSleepMs(timeLeft);
+		traceEnd(sleepZone);
+	}
+	else if (frameTime > 0 && frameTimeElapsed > frameTime) {
+		traceInstant("frame over budget");
+	}
+
+	// Begin processing the next frame.
+
+	frameStartTime = platformElapsedMs(); // Record when we started work on the new frame.
+
+	// Update our simulated world before the next call to display(), unless its own thread is.
+	if (simThread == NULL) {
+		benchBeginSection(BENCH_THINK);
+		advanceWorld(platformTimeSeconds());
+		benchEndSection(BENCH_THINK);
+	}
+
+	platformPostRedisplay(); // Tell OpenGL there's a new frame ready to be drawn.
+
+	traceEnd(traceZone);
+}
+
+/******************************************************************************
+ * Animation-Specific Functions (Add your own functions at the end of this section)
+ ******************************************************************************/
+
+ /*
+	 Initialise OpenGL and set up our scene before we begin the render loop.
+ */
+void init(void)
+{
+	tracezone_t traceZone = traceBegin("init");
+	srand(sceneSeed);
+	glEnable(GL_DEPTH_TEST);
+	glFuncsLoad();
+	if (requestedBackend >= 0 && !renderBackendSelect(requestedBackend)) {
+		printf("The %s render backend isn't available; using the %s one.\n",
+			renderBackendName(requestedBackend), renderBackendName(renderBackendCurrent()));
+	}
+	arenaInit(&assetArena, 1024 * 1024);
+	jobsStart(0);
+	bakeTerrainColours();
+	loadAssets();
+
+	initLights();
+
+	
+	glEnable(GL_FOG);
+	GLfloat fogColor[4] = { 1,1,1,1 };
+	glFogfv(GL_FOG_COLOR, fogColor);
+	glFogf(GL_FOG_MODE, GL_EXP);
+	glFogf(GL_FOG_DENSITY, 0.02);
+
+	for (size_t i = 0; i < sizeof(windmillRotation) / sizeof(windmillRotation[0]); i++) {
+		windmillRotation[i] = ((double)rand() / RAND_MAX) * 360.0;
+	}
+
+
+	for (int i = 0; i < 24; i++) {
+		Spotlight spotlight;
+		spotlight.x = (double)rand() / RAND_MAX * 200 - 100; // Random value between -100 and 100
+		spotlight.y = 10.0;
+		spotlight.z = (double)rand() / RAND_MAX * 200 - 100;
+		spotlight.alive = 1;
+		spotlight.velocityx = -0.2f + ((float)rand() / RAND_MAX) * 0.4f;
+		spotlight.velocityz = -0.2f + ((float)rand() / RAND_MAX) * 0.4f;
+		spotlight.colorCode = i; // Random value between 0 and 10
+		spotlights[i] = spotlight;
+	}
+	for (int i = 0; i < 24; i++) {
+		lights[i] = GL_LIGHT1 + i;
+		
+	}
+	placeSpotlights();
+
+	captureWorld(&currentWorld);
+	previousWorld = currentWorld;
+	worldsnapshot_t snapshot = { currentWorld, currentWorld, platformTimeSeconds() };
+	if (!tripleBufferInit(&worldSnapshots, sizeof(snapshot), &snapshot)) {
+		printf("Out of memory\n");
+		exit(1);
+	}
+
+	traceEnd(traceZone);
+}
+void drawBitmapString(const char* str, float x, float y, float r, float g, float b) {
+	tracezone_t traceZone = traceBegin("drawBitmapString");
+	glColor3f(r, g, b);
+	glRasterPos2f(x, y);
+
+	while (*str) {
+		platformBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *str);
+		str++;
+	}
+
+	traceEnd(traceZone);
+}
+
+/*
+	Build the sky cylinder (sky = 1: lit from below, coloured BLUE) or the
+	helipad disc (sky = 0: outward normals, texture coordinates from x and z)
+	as triangles: the side, then the top and bottom caps.
+*/
+void buildCylinderMesh(cylindermesh_t* mesh, const cylinderitem_t* size, int sky) {
+	int numSegments = size->numSegments;
+	float segmentAngle = 2.0f * 3.15f / numSegments;
+	float halfHeight = size->height / 2.0f;
+	int vertexCount = 2 * (numSegments + 1) + 2 * (numSegments + 2);
+
+	free(mesh->vertices);
+	free(mesh->indices);
+	mesh->vertices = malloc(vertexCount * sizeof(scenevertex_t));
+	mesh->indices = malloc(12 * numSegments * sizeof(GLuint));
+	if (mesh->vertices == NULL || mesh->indices == NULL) {
+		printf("Out of memory building a %d segment cylinder!\n", numSegments);
+		exit(0);
+	}
+	mesh->size = *size;
+
+	// The side used to be drawn first, with the texture coordinate the bottom
+	// cap left behind: its last rim vertex.
+	float lastAngle = numSegments * segmentAngle;
+	GLfloat sideTexCoord[2] = { size->radius * cosf(lastAngle), size->radius * sinf(lastAngle) };
+
+	scenevertex_t* vertex = mesh->vertices;
+	for (int i = 0; i <= numSegments; i++) {
+		float angle = i * segmentAngle;
+		for (int j = 0; j < 2; j++, vertex++) {
+			vertex->position[0] = size->radius * cosf(angle);
+			vertex->position[1] = j == 0 ? halfHeight : -halfHeight;
+			vertex->position[2] = size->radius * sinf(angle);
+			vertex->normal[0] = sky ? 0.0f : cosf(angle);
+			vertex->normal[1] = sky ? -1.0f : 0.0f;
+			vertex->normal[2] = sky ? 0.0f : sinf(angle);
+			vertex->texCoord[0] = sky ? 0.0f : sideTexCoord[0];
+			vertex->texCoord[1] = sky ? 0.0f : sideTexCoord[1];
+		}
+	}
+	for (int cap = 0; cap < 2; cap++) {
+		float y = cap == 0 ? halfHeight : -halfHeight;
+		for (int i = -1; i <= numSegments; i++, vertex++) {
+			float angle = i * segmentAngle;
+			float radius = i < 0 ? 0.0f : size->radius;		// The centre first
+			vertex->position[0] = radius * cosf(angle);
+			vertex->position[1] = y;
+			vertex->position[2] = radius * sinf(angle);
+			vertex->normal[0] = 0.0f;
+			vertex->normal[1] = sky || cap == 1 ? -1.0f : 1.0f;
+			vertex->normal[2] = 0.0f;
+			vertex->texCoord[0] = sky ? 0.0f : vertex->position[0];
+			vertex->texCoord[1] = sky ? 0.0f : vertex->position[2];
+		}
+	}
+	for (int i = 0; i < vertexCount; i++) {
+		memcpy(mesh->vertices[i].color, sky ? BLUE : WHITE, sizeof(mesh->vertices[i].color));
+	}
+
+	// Each side quad split the way the quad strip was, then the cap fans.
+	GLuint* index = mesh->indices;
+	for (int i = 0; i < numSegments; i++) {
+		GLuint top = 2 * i;
+		*index++ = top + 2;
+		*index++ = top;
+		*index++ = top + 3;
+		*index++ = top;
+		*index++ = top + 1;
+		*index++ = top + 3;
+	}
+	for (int cap = 0; cap < 2; cap++) {
+		GLuint centre = 2 * (numSegments + 1) + cap * (numSegments + 2);
+		for (int i = 0; i < numSegments; i++) {
+			*index++ = centre;
+			*index++ = centre + 1 + i;
+			*index++ = centre + 2 + i;
+		}
+	}
+	mesh->indexCount = (int)(index - mesh->indices);
+
+	if (glFuncs.hasBuffers) {
+		if (mesh->vertexBuffer == 0) {
+			glGenBuffers(1, &mesh->vertexBuffer);
+			glGenBuffers(1, &mesh->indexBuffer);
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
+		glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(scenevertex_t), mesh->vertices, GL_STATIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh->indexCount * sizeof(GLuint), mesh->indices, GL_STATIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
+}
+
+/*
+	Draw a cylinder mesh, (re)building it first if it isn't the size asked for.
+*/
+void drawCylinderMesh(cylindermesh_t* mesh, const cylinderitem_t* size, int sky) {
+	if (mesh->vertices == NULL || memcmp(&mesh->size, size, sizeof(*size)) != 0) {
+		buildCylinderMesh(mesh, size, sky);
+	}
+	renderBackendDrawElements(&sceneVertexFormat, mesh->vertexBuffer, mesh->vertices,
+		mesh->indexBuffer, mesh->indices, GL_TRIANGLES, mesh->indexCount);
+}
+
+void drawSkyCylinder(float radius, float height, int numSegments) {
+	tracezone_t traceZone = traceBegin("drawSkyCylinder");
+	cylinderitem_t size = { radius, height, numSegments };
+	drawCylinderMesh(&skyMesh, &size, 1);
+	traceEnd(traceZone);
+}
+
+void drawSkyCylinderItem(const void* data) {
+	const cylinderitem_t* sky = data;
+	drawSkyCylinder(sky->radius, sky->height, sky->numSegments);
+}
+
+/*
+	Queue a cached cylinder, sphere or cube (the same parameters as
+	primitiveCylinder() and friends) at the current modelview matrix.
+*/
+void submitCylinder(const material_t* material, GLdouble base, GLdouble top, GLdouble height, GLint slices, GLint stacks) {
+	shapeitem_t shape = { SHAPE_CYLINDER, { base, top, height }, slices, stacks };
+	renderSubmit(RENDER_PASS_OPAQUE, material, 0, drawShapeItem, &shape, sizeof(shape));
+}
+
+void submitSphere(const material_t* material, GLdouble radius, GLint slices, GLint stacks) {
+	shapeitem_t shape = { SHAPE_SPHERE, { radius, 0.0, 0.0 }, slices, stacks };
+	renderSubmit(RENDER_PASS_OPAQUE, material, 0, drawShapeItem, &shape, sizeof(shape));
+}
+
+void submitCube(const material_t* material, GLdouble size) {
+	shapeitem_t shape = { SHAPE_CUBE, { size, 0.0, 0.0 }, 0, 0 };
+	renderSubmit(RENDER_PASS_OPAQUE, material, 0, drawShapeItem, &shape, sizeof(shape));
+}
+
+void drawShapeItem(const void* data) {
+	const shapeitem_t* shape = data;
+
+	switch (shape->kind) {
+	case SHAPE_CYLINDER:
+		primitiveCylinder(shape->size[0], shape->size[1], shape->size[2], shape->slices, shape->stacks);
+		break;
+	case SHAPE_SPHERE:
+		primitiveSphere(shape->size[0], shape->slices, shape->stacks);
+		break;
+	default:
+		primitiveCube(shape->size[0]);
+		break;
+	}
+}
+
+/*
+	Queue the helipad: the concrete disc and the yellow H on top of it (which
+	is translucent, letting the concrete show through).
+*/
+void drawHelipad(float radius, float height, int numSegments) {
+	tracezone_t traceZone = traceBegin("drawHelipad");
+
+	cylinderitem_t disc = { radius, height, numSegments };
+	renderSubmit(RENDER_PASS_OPAQUE, &helipadMaterial, concreteTextureHandle, drawHelipadDisc, &disc, sizeof(disc));
+
+	// The H, from the cached unit cube.
+	shapeitem_t marking = { SHAPE_CUBE, { 1.0, 0.0, 0.0 }, 0, 0 };
+	glPushMatrix();
+	glScalef(1.1, 0.06, 0.5);
+	renderSubmit(RENDER_PASS_BLENDED, &helipadMarkingMaterial, 0, drawShapeItem, &marking, sizeof(marking));
+	glPopMatrix();
+	glPushMatrix();
+	glRotatef(90, 0.0, 1.0, 0.0);
+	glTranslatef(0.0, 0.0, 0.8);
+	glScalef(3.0, 0.06, 0.5);
+	renderSubmit(RENDER_PASS_BLENDED, &helipadMarkingMaterial, 0, drawShapeItem, &marking, sizeof(marking));
+	glPopMatrix();
+	glPushMatrix();
+	glRotatef(90, 0.0, 1.0, 0.0);
+	glTranslatef(0.0, 0.0, -0.8);
+	glScalef(3.0, 0.06, 0.5);
+	renderSubmit(RENDER_PASS_BLENDED, &helipadMarkingMaterial, 0, drawShapeItem, &marking, sizeof(marking));
+	glPopMatrix();
+
+	traceEnd(traceZone);
+}
+
+void drawHelipadDisc(const void* data) {
+	drawCylinderMesh(&helipadMesh, data, 0);
+}
+void loadTexture(const assetimage_t* image, ImageData* texture) {
+
+	size_t size = (size_t)image->width * image->height * 3;
+	texture->data = arenaAlloc(&assetArena, size);
+	if (texture->data == NULL) {
+		printf("Out of memory loading a %dx%d texture!\n", image->width, image->height);
+		exit(0);
+	}
+	texture->width = image->width;
+	texture->height = image->height;
+	memcpy(texture->data, image->rgb, size);
+}
+
+/*
+	Runs on the worker pool: read and decode one asset file (through the asset cache).
+*/
+void decodeAsset(void* argument) {
+	assetload_t* load = argument;
+	tracezone_t traceZone = traceBegin("decodeAsset");
+	double start = platformTimeSeconds();
+
+	load->loaded = assetLoadImage(load->path, load->planes, &load->image);
+
+	load->milliseconds = (platformTimeSeconds() - start) * 1000.0;
+	traceEnd(traceZone);
+}
+
+/*
+	Called at startup and when KEY_RELOAD is pressed: (re)load the heightmap and
+	textures, freeing whatever the previous load put in the asset arena. The files
+	are decoded in parallel on the worker pool; once they've all finished, the
+	results are copied into the scene here on the calling thread.
+*/
+void loadAssets(void) {
+	assetload_t loads[] = {
+		{ .path = "terrain.ppm", .planes = ASSET_PLANE_HEIGHT },
+		{ .path = "waterTexture.ppm", .planes = ASSET_PLANE_RGB },
+		{ .path = "concreteTexture.ppm", .planes = ASSET_PLANE_RGB },
+		{ .path = "mountaintexture1.ppm", .planes = ASSET_PLANE_RGB }
+	};
+	int numLoads = sizeof(loads) / sizeof(loads[0]);
+	double start = platformTimeSeconds();
+
+	for (int i = 0; i < numLoads; i++) {
+		jobsSubmit(decodeAsset, &loads[i]);
+	}
+	jobsWait();
+
+	for (int i = 0; i < numLoads; i++) {
+		if (!loads[i].loaded) {
+			exit(0);
+		}
+	}
+
+	arenaReset(&assetArena);
+	loadImage(&loads[0].image);
+	terrainMeshDirty = 1;
+	placeWindmills();
+	loadTexture(&loads[1].image, &waterTexture);
+	loadTexture(&loads[2].image, &concreteTexture);
+	loadTexture(&loads[3].image, &groundTexture);
+
+	// Upload once here; drawing only binds the handles (reloading keeps them).
+	waterTextureHandle = textureUpload(waterTextureHandle, loads[1].path, waterTexture.width, waterTexture.height, waterTexture.data);
+	concreteTextureHandle = textureUpload(concreteTextureHandle, loads[2].path, concreteTexture.width, concreteTexture.height, concreteTexture.data);
+	groundTextureHandle = textureUpload(groundTextureHandle, loads[3].path, groundTexture.width, groundTexture.height, groundTexture.data);
+
+	for (int i = 0; i < numLoads; i++) {
+		printf("Loaded %-22s %4dx%-4d %-7s %8.2f ms\n", loads[i].path, loads[i].image.width, loads[i].image.height,
+			loads[i].image.fromCache ? "(cache)" : "", loads[i].milliseconds);
+		assetRelease(&loads[i].image);
+	}
+	printf("Loaded %d assets in %.2f ms\n", numLoads, (platformTimeSeconds() - start) * 1000.0);
+}
+
+
+/*
+	Build the terrain mesh from the heightmap, or from the streamed world's window:
+	one vertex per height, uploaded to a buffer object when the driver has
+	them, and the chunks that drawTerrain() picks the triangles from (see
+	terrainlod.h). When the world's window is rebuilt in place because tiles
+	came or went, only the normals and vertices around the heights that
+	changed are redone.
+*/
+void buildTerrainMesh(void) {
+	tracezone_t traceZone = traceBegin("buildTerrainMesh");
+
+	GLfloat originX = -100.0f, originZ = -100.0f, spacing = 1.0f;
+	int rebuild = 1;
+	int x, z;
+
+	if (worldPager == NULL) {
+		terrainVertices = arenaAlloc(&assetArena, sizeof(scenevertex_t) * HEIGHT * WIDTH);
+	}
+	else {
+		// The window is rebuilt as the helicopter moves and tiles arrive, so it keeps one allocation.
+		int sizeX, sizeZ;
+		terrainPagerGetExtent(worldPager, &sizeX, &sizeZ, &originX, &originZ, &spacing);
+		originX += worldWindowX * spacing;
+		originZ += worldWindowZ * spacing;
+		rebuild = terrainVertices == NULL || worldWindowMoved;
+		if (terrainVertices == NULL) {
+			terrainVertices = malloc(sizeof(scenevertex_t) * WORLD_WINDOW * WORLD_WINDOW);
+		}
+		worldWindowMoved = 0;
+	}
+	if (terrainVertices == NULL) {
+		printf("Out of memory building the terrain mesh!\n");
+		exit(0);
+	}
+
+	// The heights, straight into the vertices, and the rows and columns of those that changed.
+	int firstX = terrainSizeX, firstZ = terrainSizeZ, lastX = -1, lastZ = -1;
+	for (x = 0; x < terrainSizeX; x++) {
+		for (z = 0; z < terrainSizeZ; z++) {
+			GLfloat* height = &terrainVertices[x * terrainSizeZ + z].position[1];
+			GLfloat newHeight;
+			if (worldPager != NULL) {
+				newHeight = terrainPagerHeight(worldPager, originX + x * spacing, originZ + z * spacing);
+			}
+			else {
+				newHeight = heightfieldVertex(&groundHeightfield, x, z);
+			}
+			if (rebuild || newHeight != *height) {
+				*height = newHeight;
+				firstX = x < firstX ? x : firstX;
+				firstZ = z < firstZ ? z : firstZ;
+				lastX = x > lastX ? x : lastX;
+				lastZ = z > lastZ ? z : lastZ;
+			}
+		}
+	}
+	if (lastX < 0) {
+		terrainMeshDirty = 0;
+		traceEnd(traceZone);
+		return;
+	}
+
+	for (x = firstX; x <= lastX; x++) {
+		for (z = firstZ; z <= lastZ; z++) {
+			scenevertex_t* vertex = &terrainVertices[x * terrainSizeZ + z];
+			int level = (int)(vertex->position[1] * TERRAIN_COLOUR_STEPS);
+
+			vertex->position[0] = originX + x * spacing;
+			vertex->position[2] = originZ + z * spacing;
+			vertex->texCoord[0] = vertex->position[0];
+			vertex->texCoord[1] = vertex->position[2];
+
+			level = level < 0 ? 0 : level < TERRAIN_COLOUR_ENTRIES ? level : TERRAIN_COLOUR_ENTRIES - 1;
+			memcpy(vertex->color, terrainColourTable[level], sizeof(vertex->color));
+		}
+	}
+
+	// Changed heights move their neighbours' normals too.
+	firstX = firstX > 0 ? firstX - 1 : 0;
+	firstZ = firstZ > 0 ? firstZ - 1 : 0;
+	lastX = lastX < terrainSizeX - 1 ? lastX + 1 : lastX;
+	lastZ = lastZ < terrainSizeZ - 1 ? lastZ + 1 : lastZ;
+	// Everything else reads the heights from the vertices too.
+	const GLfloat* heights = &terrainVertices[0].position[1];
+	if (!terrainNormals(heights, sizeof(scenevertex_t), terrainSizeX, terrainSizeZ, spacing, firstX, firstZ, lastX + 1,
+		lastZ + 1, terrainVertices[0].normal, sizeof(scenevertex_t)) ||
+		!terrainLodBuild(&terrainLod, heights, sizeof(scenevertex_t), terrainSizeX, terrainSizeZ, originX, originZ,
+		spacing) || !occluderFromHeights(&terrainOccluder, heights, sizeof(scenevertex_t), terrainSizeX, terrainSizeZ,
+		originX, originZ, spacing, OCCLUDER_STEP)) {
+		printf("Out of memory building the terrain mesh!\n");
+		exit(0);
+	}
+
+	// Rebuilt in place, only the rows that changed go to the buffer.
+	if (glFuncs.hasBuffers) {
+		if (terrainVertexBuffer == 0) {
+			glGenBuffers(1, &terrainVertexBuffer);
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, terrainVertexBuffer);
+		if (rebuild) {
+			glBufferData(GL_ARRAY_BUFFER, sizeof(scenevertex_t) * terrainSizeX * terrainSizeZ, terrainVertices,
+				worldPager != NULL ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+		}
+		else {
+			glBufferSubData(GL_ARRAY_BUFFER, sizeof(scenevertex_t) * firstX * terrainSizeZ,
+				sizeof(scenevertex_t) * (lastX - firstX + 1) * terrainSizeZ, &terrainVertices[firstX * terrainSizeZ]);
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	terrainMeshDirty = 0;
+	traceEnd(traceZone);
+}
+
+/*
+	Called every frame before the terrain is drawn: when streaming a world,
+	keep the tiles around the helicopter coming in, and mark the mesh for a
+	rebuild when its window has to move (a chunk at a time) or tiles have
+	arrived or left. Nothing here waits for a tile.
+*/
+void updateWorld(void) {
+	int sizeX, sizeZ;
+	GLfloat originX, originZ, spacing;
+
+	if (worldPager == NULL) {
+		return;
+	}
+
+	terrainPagerGetExtent(worldPager, &sizeX, &sizeZ, &originX, &originZ, &spacing);
+	terrainSizeX = sizeX < WORLD_WINDOW ? sizeX : WORLD_WINDOW;
+	terrainSizeZ = sizeZ < WORLD_WINDOW ? sizeZ : WORLD_WINDOW;
+
+	// Centre the window on the chunk under the helicopter.
+	int chunkX = (int)floorf((frameWorld.heliCoord[0] - originX) / spacing / TERRAIN_LOD_CHUNK_CELLS);
+	int chunkZ = (int)floorf((frameWorld.heliCoord[2] - originZ) / spacing / TERRAIN_LOD_CHUNK_CELLS);
+	int windowX = chunkX * TERRAIN_LOD_CHUNK_CELLS - (terrainSizeX - 1) / 2;
+	int windowZ = chunkZ * TERRAIN_LOD_CHUNK_CELLS - (terrainSizeZ - 1) / 2;
+	windowX = windowX < 0 ? 0 : windowX > sizeX - terrainSizeX ? sizeX - terrainSizeX : windowX;
+	windowZ = windowZ < 0 ? 0 : windowZ > sizeZ - terrainSizeZ ? sizeZ - terrainSizeZ : windowZ;
+
+	// Ask for twice the window's reach, so the tiles are there before the window gets to them.
+	// The simulation thread queries the pager too, and it's only for one thread at a time.
+	lockWorld();
+	terrainPagerUpdate(worldPager, frameWorld.heliCoord[0], frameWorld.heliCoord[2], WORLD_WINDOW * spacing);
+	unlockWorld();
+
+	if (windowX != worldWindowX || windowZ != worldWindowZ || terrainPagerGeneration(worldPager) != worldGeneration) {
+		worldWindowMoved |= windowX != worldWindowX || windowZ != worldWindowZ;
+		worldWindowX = windowX;
+		worldWindowZ = windowZ;
+		worldGeneration = terrainPagerGeneration(worldPager);
+		terrainMeshDirty = 1;
+	}
+}
+
+/*
+	Stop streaming the world (registered with atexit).
+*/
+void closeWorld(void) {
+	terrainPagerClose(worldPager);
+	worldPager = NULL;
+}
+
+/*
+	Supplies a heightmap's heights, scaled the way the terrain mesh does, to
+	terrainTilesWrite() for --tile-heightmap.
+*/
+GLfloat heightmapTileHeight(void* context, int x, int z) {
+	const assetimage_t* image = context;
+	return image->heights[(size_t)x * image->width + z] / 100.0f * 4;
+}
+
+void drawTerrain(float terrainScale) {
+	tracezone_t traceZone = traceBegin("drawTerrain");
+
+	if (terrainMeshDirty) {
+		lockWorld();
+		buildTerrainMesh();
+		unlockWorld();
+	}
+
+	// Each chunk in view at the coarsest level that's within terrainPixelError
+	// of the full mesh from here (allowing for the fog), drawn from the buffer
+	// objects if there are some, otherwise from memory.
+	const glfixedstate_t* state = glStateFixedFunction();
+	terrainview_t view = {
+		.modelview = matrixStackTop(GL_MODELVIEW),
+		.projection = matrixStackTop(GL_PROJECTION),
+		.viewportHeight = windowHeight,
+		.maxPixelError = terrainPixelError,
+		.fogMode = state->fog ? state->fogMode : 0,
+		.fogDensity = state->fogDensity,
+		.fogStart = state->fogStart,
+		.fogEnd = state->fogEnd,
+		.noCulling = !cullingEnabled,
+		.occlusion = sceneOcclusion.ready ? &sceneOcclusion : NULL
+	};
+	terrainLodSelect(&terrainLod, &view);
+	terrainLodDraw(&terrainLod, &sceneVertexFormat, terrainVertexBuffer, terrainVertices);
+	glStats.chunksSubmitted += terrainLod.chunksX * terrainLod.chunksZ - terrainLod.culledChunks
+		- terrainLod.occludedChunks;
+	glStats.chunksCulled += terrainLod.culledChunks;
+	glStats.chunksOccluded += terrainLod.occludedChunks;
+
+	traceEnd(traceZone);
+}
+
+void drawTerrainItem(const void* data) {
+	drawTerrain(*(const float*)data);
+}
+
+
+void drawAtom() {
+	tracezone_t traceZone = traceBegin("drawAtom");
+
+	submitSphere(&atomMaterial, 1.0f, 20, 20);
+
+	GLfloat angleIncrement = 2 * PI / frameWorld.numElectrons;
+
+	for (int i = 0; i < frameWorld.numElectrons; ++i) {
+
+		GLfloat electronX = orbitRadius * sin(frameWorld.electronAngle + i * angleIncrement);
+		GLfloat electronY = 0.0f;
+		GLfloat electronZ = orbitRadius * cos(frameWorld.electronAngle + i * angleIncrement);
+
+		if (i % 2 == 0) {
+			electronX = orbitRadius * sin(frameWorld.electronAngle + i * angleIncrement);
+			electronY = 0.0f;
+			electronZ = orbitRadius * cos(frameWorld.electronAngle + i * angleIncrement);
+		}
+		if (i % 3 == 0) {
+			electronX = orbitRadius * cos(frameWorld.electronAngle + i * angleIncrement);
+			electronY = orbitRadius * sin(frameWorld.electronAngle + i * angleIncrement);
+			electronZ = 0.0f;
+		}
+		if (i % 4 == 0) {
+			electronX = 0.0f;
+			electronY = orbitRadius * sin(frameWorld.electronAngle + i * angleIncrement);
+			electronZ = orbitRadius * cos(frameWorld.electronAngle + i * angleIncrement);
+		}
+
+		GLfloat electronRotationAngle = frameWorld.electronAngle + i * angleIncrement;
+
+		glPushMatrix();
+		glTranslatef(electronX, electronY, electronZ);
+		glRotatef(electronRotationAngle * 180.0f / PI, 0.0f, 1.0f, 0.0f);
+		submitSphere(&electronMaterial, 0.2f, 10, 10);
+		glPopMatrix();
+	}
+
+	traceEnd(traceZone);
+}
+
+/*
+	Called from init(): bake terrainColourStops into terrainColourTable, one
+	entry per 1/TERRAIN_COLOUR_STEPS of height, so colouring a terrain vertex
+	is a single lookup.
+*/
+void bakeTerrainColours(void) {
+	int stops = sizeof(terrainColourStops) / sizeof(terrainColourStops[0]);
+	int stop = 0;
+
+	for (int level = 0; level < TERRAIN_COLOUR_ENTRIES; level++) {
+		GLfloat height = (GLfloat)level / TERRAIN_COLOUR_STEPS;
+		while (stop < stops - 1 && terrainColourStops[stop + 1].height <= height) {
+			stop++;
+		}
+
+		const colourstop_t* band = &terrainColourStops[stop];
+		GLfloat blend = 0.0f;
+		if (terrainColourBlend && stop < stops - 1 && height > band->height) {
+			blend = (height - band->height) / (band[1].height - band->height);
+		}
+		for (int i = 0; i < 4; i++) {
+			terrainColourTable[level][i] = blend > 0.0f ? band->color[i] + (band[1].color[i] - band->color[i]) * blend :
+				band->color[i];
+		}
+	}
+}
+
+/*
+	Fill groundHeightfield from the terrain heightmap (the cache carries the
+	greyscale heights ready made), quantized over the map's range. Rows are x
+	and columns z; any the image doesn't reach are flat at 0.
+*/
+void loadImage(const assetimage_t* image)
+{
+	int rows = image->height < HEIGHT ? image->height : HEIGHT;
+	int cols = image->width < WIDTH ? image->width : WIDTH;
+	GLfloat low = rows < HEIGHT || cols < WIDTH ? 0.0f : image->heights[0] / 100.0f * 4, high = low;
+
+	for (int row = 0; row < rows; row++) {
+		for (int col = 0; col < cols; col++) {
+			GLfloat height = image->heights[(size_t)row * image->width + col] / 100.0f * 4;
+			low = height < low ? height : low;
+			high = height > high ? height : high;
+		}
+	}
+
+	unsigned short* heights = arenaAlloc(&assetArena, sizeof(unsigned short) * HEIGHT * WIDTH);
+	if (heights == NULL) {
+		printf("Out of memory loading the terrain!\n");
+		exit(0);
+	}
+	groundHeightfield = (heightfield_t){ heights, 1.0f, 0.0f, HEIGHT, WIDTH, -100.0f, -100.0f, 1.0f };
+	heightfieldSetRange(&groundHeightfield, low, high);
+
+	for (int row = 0; row < HEIGHT; row++) {
+		for (int col = 0; col < WIDTH; col++) {
+			int inside = row < rows && col < cols;
+			heights[row * WIDTH + col] = heightfieldQuantize(&groundHeightfield,
+				inside ? image->heights[(size_t)row * image->width + col] / 100.0f * 4 : 0.0f);
+		}
+	}
+}
+
+/*
+	Height of the ground under each of count points: the streamed world's, or
+	the heightmap's, interpolated between the heights around each point.
+*/
+void groundHeights(const GLfloat* x, const GLfloat* z, GLfloat* heights, int count) {
+	if (worldPager != NULL) {
+		for (int i = 0; i < count; i++) {
+			heights[i] = terrainPagerHeight(worldPager, x[i], z[i]);
+		}
+	}
+	else {
+		heightfieldSampleBatch(&groundHeightfield, x, z, heights, count);
+	}
+}
+
+void drawPropeller(GLfloat x, GLfloat y, GLfloat z) {
+	tracezone_t traceZone = traceBegin("drawPropeller");
+
+	glPushMatrix();
+	glTranslatef(0.0f, 0.3f, 0.0f);
+	glRotatef(frameWorld.bladeRotation[0], 0.0f, 1.0f, 0.0f);
+	glScalef(1.5, 0.005, 0.08);
+	submitCube(&blackMaterial, 1.0f);
+	glPopMatrix();
+
+	glPushMatrix();
+	glTranslatef(x + 0.0f, y + 0.3f, z + 0.0f);
+	glRotatef(frameWorld.bladeRotation[1], 0.0f, 1.0f, 0.0f);
+	glScalef(1.5, 0.005, 0.08);
+	submitCube(&blackMaterial, 1.0f);
+	glPopMatrix();
+
+	traceEnd(traceZone);
+}
+
+
+void drawChopper(GLfloat x, GLfloat y, GLfloat z) {
+	tracezone_t traceZone = traceBegin("drawChopper");
+
+	glEnable(GL_NORMALIZE);
+
+	glTranslatef(x, y, z);
+	glRotatef(frameWorld.heliYaw, 0.0f, 1.0f, 0.0f);
+	glRotatef(frameWorld.heliRoll, 1.0f, 0.0f, 0.0f);
+	glRotatef(frameWorld.heliPitch, 0.0f, 0.0f, 1.0f);
+	glTranslatef(-x, -y, -z);
+
+
+	glPushMatrix();
+	glTranslatef(x + 0.0f, y + 0.0f, z + 0.0f);
+	glRotatef(15.0f, 1.0f, 0.0f, 0.0f);
+	submitCylinder(&blackMaterial, 0.26, 0.05, 0.6, 50, 50);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glScalef(1, 1, 1);
+	glTranslatef(x + 0.0f, y + 0.0f, z + 0.0f);
+	submitSphere(&blueMaterial, 0.25, 100, 100);
+	drawPropeller(x, y, z);
+
+
+	glPushMatrix();
+	glTranslatef(x, y + 0.25, z);
+	glRotatef(90.0f, 0.0f, 0.2f, 0.0f);
+	glRotatef(-90.0, 1.0, 0.0, 0.0);
+	submitCylinder(&blueMaterial, 0.05, 0.05, 0.1, 50, 50);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glTranslatef(x + 0.2, y - 0.3, z - 0.2);
+	glRotatef(90.0, 0.0, 0.0, 1.0);
+	submitCylinder(&blackMaterial, 0.02, 0.02, 0.7, 50, 50);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glTranslatef(x - 0.2, y - 0.3, z - 0.2);
+	glRotatef(90.0, 0.0, 0.0, 1.0);
+	submitCylinder(&blackMaterial, 0.02, 0.02, 0.7, 50, 50);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glTranslatef(x - 0.2, y - 0.25, z - 0.28);
+	glRotatef(30.0, 1.0, 0.0, 0.0);
+	submitCylinder(&blackMaterial, 0.02, 0.02, 0.1, 50, 50);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glTranslatef(x + 0.2, y - 0.25, z - 0.28);
+	glRotatef(30.0, 1.0, 0.0, 0.0);
+	submitCylinder(&blackMaterial, 0.02, 0.02, 0.1, 50, 50);
+	glPopMatrix();
+
+	//TAIL
+	glPushMatrix();
+	glTranslatef(x, y - 0.15, z + 0.58);
+	glRotatef(0.0, 1.0, 0.0, 0.0);
+	submitCylinder(&blueMaterial, 0.05, 0.05, 0.15, 50, 50);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glTranslatef(x + 0.04, y - 0.15, z + 0.70);
+	glRotatef(90.0, 0.0, 1.0, 0.0);
+	submitCylinder(&blackMaterial, 0.02, 0.02, 0.05, 50, 50);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glTranslatef(x + 0.09, y - 0.15, z + 0.70);
+	glRotatef(frameWorld.bladeRotation[0], 1.0f, 0.0f, 0.0f);
+	glScalef(0.008, 0.25, 0.05);
+	submitCube(&blackMaterial, 1.0f);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glTranslatef(x + 0.09, y - 0.15, z + 0.70);
+	glRotatef(frameWorld.bladeRotation[1], 1.0f, 0.0f, 0.0f);
+	glScalef(0.008, 0.25, 0.05);
+	submitCube(&blackMaterial, 1.0f);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glTranslatef(x + 0.12, y - 0.22, z - 0.02);
+	glRotatef(90.0, 1.0, 1.0, 0.0);
+	submitCylinder(&blackMaterial, 0.01, 0.01, 0.11, 50, 50);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glTranslatef(x + 0.09, y - 0.195, z + 0.15);
+	glRotatef(90.0, 1.0, 1.0, 0.0);
+	submitCylinder(&blackMaterial, 0.01, 0.01, 0.14, 50, 50);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glTranslatef(x - 0.20, y - 0.3, z - 0.02);
+	glRotatef(90.0, -1.0, 1.0, 0.0);
+	submitCylinder(&blackMaterial, 0.01, 0.01, 0.11, 50, 50);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glTranslatef(x - 0.19, y - 0.3, z + 0.15);
+	glRotatef(90, -1.0, 1.0, 0.0);
+	submitCylinder(&blackMaterial, 0.01, 0.01, 0.14, 50, 50);
+	glPopMatrix();
+
+	traceEnd(traceZone);
+}
+
+void drawWindmill(double rotation, GLfloat x, GLfloat y, GLfloat z) {
+	tracezone_t traceZone = traceBegin("drawWindmill");
+
+	glEnable(GL_NORMALIZE);
+
+	glPushMatrix();
+	glTranslatef(x, y, z);
+	glRotatef(rotation, 0, 1.0, 0);
+	glTranslatef(-x, -y, -z);
+
+
+	glPushMatrix();
+	glTranslatef(x, y, z);
+	glRotatef(90, 1.0, 0, 0);
+	submitCylinder(&redMaterial, 1.5, 1.8, 1.5, 50, 50);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glTranslatef(x, y + 1.4, z);
+	glRotatef(90, 1.0, 0, 0);
+	submitCylinder(&creamMaterial, 1.2, 1.5, 1.5, 50, 50);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glTranslatef(x, y + 2.8, z);
+	glRotatef(90, 1.0, 0, 0);
+	submitCylinder(&redMaterial, 0.9, 1.2, 1.5, 50, 50);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glTranslatef(x, y + 4.5, z);
+	glRotatef(90, 1.0, 0, 0);
+	submitSphere(&redMaterial, 0.7, 50, 50);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glTranslatef(x, y + 4.2, z);
+	glRotatef(90, 1.0, 0, 0);
+	submitCylinder(&creamMaterial, 0.6, 0.9, 1.5, 50, 50);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glTranslatef(x, y + 4.5, z + 0.8);
+	glRotatef(90, 1.0, 0, 0);
+	submitSphere(&creamMaterial, 0.4, 50, 50);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glTranslatef(x + 0.0f, y + 4.6f, z + 1.1f);
+	glRotatef(90, 1.0f, 0.0f, 0.0f);
+	glRotatef(frameWorld.windmillBladeRotation[0], 0.0f, 1.0f, 0.0f);
+	glScalef(4.5, 0.010, 0.3);
+	submitCube(&blackMaterial, 1.0f);
+	glPopMatrix();
+
+
+	glPushMatrix();
+	glTranslatef(x + 0.0f, y + 4.6f, z + 1.1f);
+	glRotatef(90, 1.0f, 0.0f, 0.0f);
+	glRotatef(frameWorld.windmillBladeRotation[1], 0.0f, 1.0f, 0.0f);
+	glScalef(4.5, 0.010, 0.3);
+	submitCube(&blackMaterial, 1.0f);
+	glPopMatrix();
+
+	glPopMatrix();
+
+	traceEnd(traceZone);
+}
+
+/*
+	Build the windmill drawn by drawWindmills(): the parts drawWindmill() draws,
+	baked into one mesh around the windmill's base, with the blades spinning
+	about their hub.
+*/
+void buildWindmillMesh(void) {
+	windmillMesh.colorIsAmbient = 1;
+	windmillMesh.spinPivot[0] = 0.0f;
+	windmillMesh.spinPivot[1] = 4.6f;
+	windmillMesh.spinPivot[2] = 1.1f;
+
+	addWindmillPart(primitiveGetCylinder(1.5f / 1.8f, 1.0f, 50, 50), 0.0f, 0.0f, 1.8f, 1.8f, 1.5f, RED, 0, 0.0f);
+	addWindmillPart(primitiveGetCylinder(1.2f / 1.5f, 1.0f, 50, 50), 1.4f, 0.0f, 1.5f, 1.5f, 1.5f, CREAM, 0, 0.0f);
+	addWindmillPart(primitiveGetCylinder(0.9f / 1.2f, 1.0f, 50, 50), 2.8f, 0.0f, 1.2f, 1.2f, 1.5f, RED, 0, 0.0f);
+	addWindmillPart(primitiveGetSphere(50, 50), 4.5f, 0.0f, 0.7f, 0.7f, 0.7f, RED, 0, 0.0f);
+	addWindmillPart(primitiveGetCylinder(0.6f / 0.9f, 1.0f, 50, 50), 4.2f, 0.0f, 0.9f, 0.9f, 1.5f, CREAM, 0, 0.0f);
+	addWindmillPart(primitiveGetSphere(50, 50), 4.5f, 0.8f, 0.4f, 0.4f, 0.4f, CREAM, 0, 0.0f);
+	for (int i = 0; i < 2; i++) {
+		GLfloat offset = frameWorld.windmillBladeRotation[i] - frameWorld.windmillBladeRotation[0];
+		addWindmillPart(primitiveGetCube(), 4.6f, 1.1f, 4.5f, 0.010f, 0.3f, BLACK, 1, offset * PI / 180.0f);
+	}
+}
+
+/*
+	Called when the terrain is loaded: stand each windmill on the ground.
+*/
+void placeWindmills(void) {
+	enum { numLines = sizeof(windmillCoordinates) / sizeof(windmillCoordinates[0]) };
+	GLfloat x[numLines], z[numLines], ground[numLines];
+
+	for (int i = 0; i < numLines; i++) {
+		x[i] = (GLfloat)windmillCoordinates[i][0];
+		z[i] = (GLfloat)windmillCoordinates[i][2];
+	}
+	groundHeights(x, z, ground, numLines);
+	for (int i = 0; i < numLines; i++) {
+		windmillCoordinates[i][1] = ground[i];
+	}
+}
+
+/*
+	Add one part of the windmill: a unit primitive stood upright (like the
+	glRotatef(90, 1, 0, 0) in drawWindmill()), scaled, and raised to y.
+*/
+void addWindmillPart(const primitive_t* primitive, GLfloat y, GLfloat z, GLfloat scaleX, GLfloat scaleY, GLfloat scaleZ,
+	const float color[], int spins, GLfloat spinStart) {
+	GLfloat transform[16];
+
+	glPushMatrix();
+	glLoadIdentity();
+	glTranslatef(0.0f, y, z);
+	glRotatef(90, 1.0f, 0.0f, 0.0f);
+	glScalef(scaleX, scaleY, scaleZ);
+	memcpy(transform, matrixStackTop(GL_MODELVIEW), sizeof(transform));
+	glPopMatrix();
+
+	instancedMeshAddPrimitive(&windmillMesh, primitive, transform, color, spins, spinStart);
+}
+
+/*
+	Queue every windmill in view as a single instanced draw.
+*/
+void drawWindmills(void) {
+	tracezone_t traceZone = traceBegin("drawWindmills");
+
+	meshinstance_t instances[NUM_WINDMILLS];
+	int count = 0;
+
+	if (windmillMesh.indexCount == 0) {
+		buildWindmillMesh();
+	}
+
+	for (int i = 0; i < NUM_WINDMILLS; i++) {
+		if (sceneVisible[SCENE_WINDMILLS + i]) {
+			instanceTransform(&instances[count], windmillCoordinates[i][0], windmillCoordinates[i][1],
+				windmillCoordinates[i][2], windmillRotation[i], 0.0f, 1.0f, 0.0f);
+			memcpy(instances[count].color, WHITE, sizeof(instances[count].color));
+			instances[count].phase = 0.0f;
+			count++;
+		}
+	}
+	instancedMeshSetInstances(&windmillMesh, instances, count);
+
+	if (count > 0) {
+		GLfloat spinAngle = frameWorld.windmillBladeRotation[0] * PI / 180.0f;
+		renderSubmit(RENDER_PASS_OPAQUE, &windmillMaterial, 0, drawWindmillsItem, &spinAngle, sizeof(spinAngle));
+	}
+
+	traceEnd(traceZone);
+}
+
+void drawWindmillsItem(const void* data) {
+	instancedMeshDraw(&windmillMesh, *(const GLfloat*)data);
+}
+
+/*
+	Point a spotlight's light down from where it is, switched on while it's alive.
+*/
+void placeSpotlight(GLenum light, Spotlight spotlight, GLfloat lightDiffuse[]) {
+	GLfloat light_position[] = { spotlight.x, spotlight.y, spotlight.z, 1.0f };
+	GLfloat spot_direction[] = { 0.0f, -1.0f, 0.0f };
+
+	glLightfv(light, GL_DIFFUSE, lightDiffuse);
+
+	if (spotlight.alive == 1) {
+		glEnable(light);
+	}
+	else {
+
+		glDisable(light);
+
+	}
+
+	glLightfv(light, GL_POSITION, light_position);
+	glLightfv(light, GL_SPOT_DIRECTION, spot_direction);
+	glLightf(light, GL_SPOT_CUTOFF, 25.0f);
+}
+
+void drawSpotlight(GLenum light, Spotlight spotlight, GLfloat coneDiffuse[], GLfloat lightDiffuse[]) {
+	tracezone_t traceZone = traceBegin("drawSpotlight");
+
+	glPushMatrix();
+
+	placeSpotlight(light, spotlight, lightDiffuse);
+
+	if (spotlight.alive == 1) {
+		material_t material = coneMaterial;
+		shapeitem_t cone = { SHAPE_CYLINDER, { 2.0, 0.3, 4.5 }, 50, 50 };
+
+		memcpy(material.diffuse, coneDiffuse, sizeof(material.diffuse));
+		glTranslatef(spotlight.x, spotlight.y - 6, spotlight.z);
+		glRotatef(-90, 1.0f, 0.0f, 0.0f);
+		renderSubmit(RENDER_PASS_BLENDED, &material, 0, drawShapeItem, &cone, sizeof(cone));
+	}
+
+	glPopMatrix();
+
+	traceEnd(traceZone);
+}
+
+/*
+	Place every spotlight's light, then queue the cones of the live ones in
+	view as a single instanced draw.
+*/
+void drawSpotlights(void) {
+	tracezone_t traceZone = traceBegin("drawSpotlights");
+
+	meshinstance_t instances[NUM_SPOTLIGHTS];
+	int count = 0;
+
+	if (spotlightConeMesh.indexCount == 0) {
+		GLfloat transform[16];
+
+		glPushMatrix();
+		glLoadIdentity();
+		glScalef(2.0f, 2.0f, 4.5f);
+		memcpy(transform, matrixStackTop(GL_MODELVIEW), sizeof(transform));
+		glPopMatrix();
+		instancedMeshAddPrimitive(&spotlightConeMesh, primitiveGetCylinder(1.0f, 0.15f, 50, 50), transform, WHITE, 0, 0.0f);
+	}
+
+	for (int i = 0; i < NUM_SPOTLIGHTS; i++) {
+		placeSpotlight(lights[i], frameWorld.spotlights[i], lightColours[frameWorld.spotlights[i].colorCode]);
+
+		if (frameWorld.spotlights[i].alive == 1 && sceneVisible[SCENE_SPOTLIGHTS + i]) {
+			instanceTransform(&instances[count], frameWorld.spotlights[i].x, frameWorld.spotlights[i].y - 6, frameWorld.spotlights[i].z, -90, 1.0f, 0.0f, 0.0f);
+			memcpy(instances[count].color, frameWorld.coneColours[frameWorld.spotlights[i].colorCode], sizeof(instances[count].color));
+			instances[count].phase = 0.0f;
+			count++;
+		}
+	}
+	instancedMeshSetInstances(&spotlightConeMesh, instances, count);
+
+	if (count > 0) {
+		renderSubmit(RENDER_PASS_BLENDED, &coneMaterial, 0, drawSpotlightConesItem, NULL, 0);
+	}
+
+	traceEnd(traceZone);
+}
+
+void drawSpotlightConesItem(const void* data) {
+	(void)data;
+	instancedMeshDraw(&spotlightConeMesh, 0.0f);
+}
+/*
+	Advance our animation by one simulation tick (1 / SIM_TICK_RATE seconds).
+
+	Note: Our template's GLUT idle() callback calls this (through stepWorld())
+	as many times as there are ticks due before each new frame is drawn, which
+	may be none. Any setup required before the first frame is drawn should be
+	placed in init().
+*/
+void think(void)
+{
+	tracezone_t traceZone = traceBegin("think");
+	
+	electronAngle += orbitSpeed;
+	lightX += lightVelocityX;
+
+	if (motionKeyStates.MoveForward == KEYSTATE_UP) {
+		if (rx < 0) {
+			rx++;
+		}
+
+	}
+	if (motionKeyStates.MoveBackward == KEYSTATE_UP) {
+		if (rx > 0) {
+			rx--;
+		}
+
+	}
+	if (motionKeyStates.MoveLeft == KEYSTATE_UP) {
+		if (pitch > 0) {
+			pitch--;
+		}
+
+	}
+	if (motionKeyStates.MoveRight == KEYSTATE_UP) {
+		if (pitch < 0) {
+			pitch++;
+		}
+	}
+
+
+	GLfloat ground;
+	groundHeights(&heliCoord[0], &heliCoord[2], &ground, 1);
+
+
+	if (heliCoord[1] > (ground + 0.5)) {
+
+		if (gravityon == 1) {
+
+			if (heliCoord[1] > 37) {
+				helicopterVelocityY = 0;
+			}
+
+			if (!(heliCoord[0] > -1.0f && heliCoord[0] < 1.0f)) {
+				if (!(heliCoord[0] > -1.0f && heliCoord[0] < 1.0f)) {
+					helicopterVelocityY -= 1 - ((bladeSpeed * 2) / 10);
+
+					if (round(heliCoord[1]) <= 38) {
+						heliCoord[1] += helicopterVelocityY / 250;
+					}
+				}
+			}
+			else {
+				if (heliCoord[1] > 4.7f) {
+					
+					
+					helicopterVelocityY -= 1 - ((bladeSpeed * 2) / 10);
+					
+					if (round(heliCoord[1]) <= 38) {
+						heliCoord[1] += helicopterVelocityY / 250;
+					}
+				}
+				else {
+					helicopterVelocityY = 0;
+					moveSpeed = 0;
+				}
+			}
+
+		}
+	}
+	else {
+		grounded = 1;
+		
+		if (verticalSpeedResetSwitch == 0) {
+			helicopterVelocityY = 0;
+			verticalSpeedResetSwitch = 1;
+		}
+		sideMoveSpeed = 0;
+		moveSpeed = 0;
+		gravityon = 0;
+	}
+	for (int i = 0; i < 2; i++) {
+
+		if (bladeRotation[i] == 360.0f) {
+			bladeRotation[i] = bladeSpeed;
+		}
+		else {
+			bladeRotation[i] += bladeSpeed * 8;
+		}
+	}
+
+
+	for (int i = 0; i < 2; i++) {
+
+		if (windmillBladeRotation[i] == 360.0f) {
+			windmillBladeRotation[i] = bladeSpeed;
+		}
+		else {
+			windmillBladeRotation[i] += 0.7;
+		}
+	}
+
+
+	/*
+		Keyboard motion handler: complete this section to make your "player-controlled"
+		object respond to keyboard input.
+	*/
+	if (keyboardMotion.Yaw != MOTION_NONE) {
+
+		if (keyboardMotion.Yaw == MOTION_ANTICLOCKWISE) {
+
+			if (heliX == 360.0f) {
+				heliX = 0.0f;
+			}
+			else {
+				heliX += 1.0f;
+			}
+
+
+		}
+		if (keyboardMotion.Yaw == MOTION_CLOCKWISE) {
+
+			if (heliX == 0.0f) {
+				heliX = 360.0f;
+			}
+			else {
+				heliX -= 1.0f;
+			}
+
+		}
+		/* TEMPLATE: Turn your object right (clockwise) if .Yaw < 0, or left (anticlockwise) if .Yaw > 0 */
+	}
+
+	if (keyboardMotion.Surge != MOTION_NONE) {
+		if (keyboardMotion.Surge > 0) {
+
+			if (rx > -20.0f) {
+				rx--;
+			}
+		}
+		else if (keyboardMotion.Surge < 0) {
+
+			if (rx < 20.0f) {
+				rx++;
+			}
+		}
+	}
+
+	if (!grounded) {
+		if ((keyboardMotion.Surge != MOTION_NONE) || taperX > 0) {
+			/* TEMPLATE: Move your object backward if .Surge < 0, or forward if .Surge > 0 */
+			float radians = heliX * PI / 180.0f;
+
+			float deltaX = moveSpeed * sin(radians);
+			float deltaZ = moveSpeed * cos(radians);
+			if (keyboardMotion.Surge > 0) {
+
+				taperX = 0;
+
+
+				heliCoord[0] -= deltaX;
+				heliCoord[2] -= deltaZ;
+
+				if (moveSpeed < 0.3f) {
+					moveSpeed += 0.01f;
+				}
+			}
+			else if (keyboardMotion.Surge < 0) {
+
+				taperX = 0;
+
+
+				heliCoord[0] -= deltaX;
+				heliCoord[2] -= deltaZ;
+				if (moveSpeed > -0.2f) {
+					moveSpeed -= 0.01f;
+				}
+			}
+
+			if (taperX == 1) {
+				heliCoord[0] -= deltaX;
+				heliCoord[2] -= deltaZ;
+
+				if (moveSpeed > 0.0f) {
+					moveSpeed -= 0.001f;
+
+				}
+				else {
+					taperX = 0;
+				}
+			}
+			if (taperX == 2) {
+				heliCoord[0] -= deltaX;
+				heliCoord[2] -= deltaZ;
+
+				if (moveSpeed < 0.0f) {
+					moveSpeed += 0.001f;
+
+				}
+				else {
+					taperX = 0;
+				}
+			}
+		}
+
+		if (keyboardMotion.Sway != MOTION_NONE) {
+			/* TEMPLATE: Move (strafe) your object left if .Sway < 0, or right if .Sway > 0 */
+
+			float radians = heliX * PI / 180.0f;
+
+			float deltaX = sideMoveSpeed * sin(radians);
+			float deltaZ = sideMoveSpeed * cos(radians);
+			if (keyboardMotion.Sway > 0) {
+				
+				if (pitch > -20.0f) {
+					pitch--;
+				}
+
+				heliCoord[0] += deltaZ;
+				heliCoord[2] -= deltaX;
+				
+				if (sideMoveSpeed< 0.2f) {
+					sideMoveSpeed += 0.005;
+				}
+			}
+			else if (keyboardMotion.Sway < 0) {
+				
+				if (pitch < 20.0f) {
+					pitch++;
+				}
+				
+				heliCoord[0] += deltaZ;
+				heliCoord[2] -= deltaX;
+				
+				if (sideMoveSpeed > -0.2f) {
+					sideMoveSpeed -= 0.005;
+				}
+			}
+		}
+		else {
+			float radians = heliX * PI / 180.0f;
+			float deltaX = sideMoveSpeed * sin(radians);
+			float deltaZ = sideMoveSpeed * cos(radians);
+		
+			if (sideMoveSpeed > 0) {
+				
+				sideMoveSpeed -= 0.001;
+				
+			
+				heliCoord[0] += deltaZ;
+				heliCoord[2] -= deltaX;
+			}
+			else if(sideMoveSpeed < 0) {
+				sideMoveSpeed += 0.001;
+				heliCoord[0] += deltaZ;
+				heliCoord[2] -= deltaX;
+			}
+		}
+
+	}
+
+
+	if (keyboardMotion.Heave != MOTION_NONE) {
+
+		/* TEMPLATE: Move your object down if .Heave < 0, or up if .Heave > 0 */
+		if (keyboardMotion.Heave < 0) {
+			
+				helicopterVelocityY -= 1;
+				heliCoord[1] += helicopterVelocityY / 400;
+			
+		}
+		if (keyboardMotion.Heave > 0 && heliCoord[1] < 37.0f) {
+			
+			if (bladeSpeed > 2.0f) {
+				tip = 0;
+				helicopterVelocityY += 1;
+				gravityon = 0;
+				heliCoord[1] += helicopterVelocityY / 400;
+				if (heliCoord[1] > ground + 0.5f) {
+					verticalSpeedResetSwitch = 0;
+				}
+				grounded = 0;
+			}
+
+			if (bladeSpeed < 5.0f) {
+				bladeSpeed += 0.02f;
+			}
+
+		}
+
+
+	}
+	else {
+		
+		if (bladeSpeed > 0.0f) {
+			bladeSpeed -= 0.01f;
+
+		}
+	}
+
+	
+	for (int i = 0; i < 7; i++) {
+		spotlights[i].x += spotlights[i].velocityx;
+		spotlights[i].z += spotlights[i].velocityz;
+	}
+	for (int i = 0; i < 7; i++) {
+		if (spotlights[i].x > 95 || spotlights[i].x < -95) {
+			spotlights[i].velocityx *= -1;
+		}
+		if (spotlights[i].z > 95 || spotlights[i].z < -95) {
+			spotlights[i].velocityz *= -1;
+		}
+	}
+	
+
+
+	for (int i = 0; i < 7; i++) {
+		
+		if (heliCoord[0] < (spotlights[i].x + 0.5f)) {
+
+			if (heliCoord[0] > (spotlights[i].x - 0.5f)) {
+
+				if (heliCoord[2] > (spotlights[i].z - 0.5f)) {
+
+					if (heliCoord[2] < (spotlights[i].z + 0.5f)) {
+						if (heliCoord[1] < spotlights[i].y)
+						{
+							if (spotlights[i].alive == 1) {
+								score += 1;
+								numElectrons++;
+								spotlights[i].alive = 0;
+							
+								resetSpotlight(&spotlights[i]);
+
+							}
+							
+						}
+					}
+				}
+			}
+		}
+	}
+
+	placeSpotlights();
+	flashColors(coneColours);
+
+	traceEnd(traceZone);
+}
+
+/*
+	Run the ticks due by now (just the one, in lockstep), publishing each for
+	display(). Called by idle(), or over and over by the simulation thread.
+*/
+void advanceWorld(double now) {
+	int ticks = simLockstep ? 1 : simClockAdvance(&simClock, now);
+	double lastTick = simClockLastTick(&simClock);
+
+	for (int i = 0; i < ticks; i++) {
+		if (worldMutex != NULL) {
+			platformMutexLock(worldMutex);
+		}
+		stepWorld();
+		if (worldMutex != NULL) {
+			platformMutexUnlock(worldMutex);
+		}
+
+		worldsnapshot_t* snapshot = tripleBufferWriteSlot(&worldSnapshots);
+		snapshot->previous = previousWorld;
+		snapshot->current = currentWorld;
+		snapshot->time = lastTick - (ticks - 1 - i) * simClock.tickSeconds;
+		tripleBufferPublish(&worldSnapshots);
+	}
+}
+
+/*
+	Run one tick of the simulation, keeping what the world looked like before it.
+*/
+void stepWorld(void) {
+	previousWorld = currentWorld;
+	think();
+	captureWorld(&currentWorld);
+}
+
+/*
+	Called once the window's up: run the simulation on a thread of its own from
+	now on, so display() can draw one tick while the next is worked out. If
+	the thread can't be started, idle() carries on running it.
+*/
+void startSimulationThread(void) {
+	worldMutex = platformMutexCreate();
+	if (worldMutex == NULL) {
+		return;
+	}
+	simThread = platformThreadCreate(simulationThreadMain, NULL);
+	if (simThread == NULL) {
+		platformMutexDestroy(worldMutex);
+		worldMutex = NULL;
+		return;
+	}
+	atexit(stopSimulationThread);
+}
+
+/*
+	Stop the simulation thread (registered with atexit, which may be called
+	from a key handler holding the world's lock).
+*/
+void stopSimulationThread(void) {
+	if (worldLocked) {
+		unlockWorld();
+	}
+	platformAtomicStoreInt(&simThreadStopping, 1);
+	platformThreadJoin(simThread);
+	simThread = NULL;
+}
+
+/*
+	The simulation thread: run the ticks due, then sleep until the next one is.
+*/
+void simulationThreadMain(void* argument) {
+	(void)argument;
+	traceSetThreadName("simulation");
+
+	while (!platformAtomicLoadInt(&simThreadStopping)) {
+		tracezone_t traceZone = traceBegin("advanceWorld");
+		advanceWorld(platformTimeSeconds());
+		traceEnd(traceZone);
+
+		double wait = simClock.tickSeconds - simClock.accumulator;
+		platformSleepMs(wait > 0.0 ? (unsigned int)(wait * 1000.0) : 0);
+	}
+}
+
+/*
+	Keep the simulation thread from ticking until unlockWorld(). Only for the
+	GL thread; does nothing without a simulation thread.
+*/
+void lockWorld(void) {
+	if (worldMutex != NULL) {
+		platformMutexLock(worldMutex);
+		worldLocked = 1;
+	}
+}
+
+void unlockWorld(void) {
+	if (worldMutex != NULL) {
+		worldLocked = 0;
+		platformMutexUnlock(worldMutex);
+	}
+}
+
+/*
+	Copy what display() draws out of the simulation's globals.
+*/
+void captureWorld(worldstate_t* world) {
+	memcpy(world->heliCoord, heliCoord, sizeof(world->heliCoord));
+	world->heliYaw = heliX;
+	world->heliRoll = rx;
+	world->heliPitch = pitch;
+	memcpy(world->bladeRotation, bladeRotation, sizeof(world->bladeRotation));
+	memcpy(world->windmillBladeRotation, windmillBladeRotation, sizeof(world->windmillBladeRotation));
+	world->electronAngle = electronAngle;
+	world->numElectrons = numElectrons;
+	memcpy(world->spotlights, spotlights, sizeof(world->spotlights));
+	memcpy(world->coneColours, coneColours, sizeof(world->coneColours));
+	world->score = score;
+	world->tip = tip;
+}
+
+/*
+	Called by display(): the world alpha of the way from one tick to the next.
+	Angles turn the short way round, and a spotlight that's jumped (been caught
+	and put somewhere new) is drawn where it is now.
+*/
+void blendWorld(worldstate_t* world, const worldstate_t* from, const worldstate_t* to, GLfloat alpha) {
+	*world = *to;
+	if (alpha >= 1.0f) {
+		return;
+	}
+
+	for (int i = 0; i < 3; i++) {
+		world->heliCoord[i] = from->heliCoord[i] + (to->heliCoord[i] - from->heliCoord[i]) * alpha;
+	}
+	world->heliYaw = blendAngle(from->heliYaw, to->heliYaw, alpha);
+	world->heliRoll = blendAngle(from->heliRoll, to->heliRoll, alpha);
+	world->heliPitch = blendAngle(from->heliPitch, to->heliPitch, alpha);
+	for (int i = 0; i < 2; i++) {
+		world->bladeRotation[i] = blendAngle(from->bladeRotation[i], to->bladeRotation[i], alpha);
+		world->windmillBladeRotation[i] = blendAngle(from->windmillBladeRotation[i], to->windmillBladeRotation[i], alpha);
+	}
+	world->electronAngle = from->electronAngle + (to->electronAngle - from->electronAngle) * alpha;
+
+	for (int i = 0; i < NUM_SPOTLIGHTS; i++) {
+		const Spotlight* a = &from->spotlights[i];
+		Spotlight* b = &world->spotlights[i];
+		if (a->alive == b->alive && fabs(b->x - a->x) < 1.0 && fabs(b->z - a->z) < 1.0) {
+			b->x = a->x + (b->x - a->x) * alpha;
+			b->y = a->y + (b->y - a->y) * alpha;
+			b->z = a->z + (b->z - a->z) * alpha;
+		}
+	}
+}
+
+/*
+	An angle (in degrees) alpha of the way from one to another, turning whichever
+	way is shorter.
+*/
+GLfloat blendAngle(GLfloat from, GLfloat to, GLfloat alpha) {
+	GLfloat turn = to - from;
+	turn -= 360.0f * floorf((turn + 180.0f) / 360.0f);
+	return from + turn * alpha;
+}
+
+/*
+	Fly the benchmark flight for some ticks of the simulation with nothing
+	drawn, and print how fast they ran (--bench-sim).
+*/
+void benchmarkSimulation(int ticks) {
+	double worst = 0.0;
+	double start = platformTimeSeconds();
+
+	for (int tick = 0; tick < ticks; tick++) {
+		double tickStart = platformTimeSeconds();
+		playBenchmarkFlight(tick);
+		stepWorld();
+		double elapsed = platformTimeSeconds() - tickStart;
+		worst = elapsed > worst ? elapsed : worst;
+	}
+
+	double total = platformTimeSeconds() - start;
+	printf("%d simulation ticks in %.1f ms: %.0f ticks per second (%.0fx real time at %d Hz)\n", ticks,
+		total * 1000.0, ticks / total, ticks / total / SIM_TICK_RATE, SIM_TICK_RATE);
+	printf("  %.2f us per tick on average, %.2f us at worst\n", total * 1e6 / ticks, worst * 1e6);
+	printf("  the helicopter ends at (%.3f, %.3f, %.3f) with a score of %d\n", heliCoord[0], heliCoord[1],
+		heliCoord[2], score);
+}
+
+void flashColors(GLfloat coneColours[][4]) {
+	for (int i = 0; i < 7; i++) {
+
+		while (coneColours[i][3] > 0.00f) {
+			coneColours[i][3] -= 0.001f;
+		
+		}
+
+		while (coneColours[i][3] < 0.20f) {
+			coneColours[i][3] += 0.001f;
+		
+		}
+	}
+}
+/*
+	Called every think() (and once the spotlights are made): hang each
+	spotlight SPOTLIGHT_HEIGHT above the ground under it.
+*/
+void placeSpotlights(void) {
+	GLfloat x[NUM_SPOTLIGHTS], z[NUM_SPOTLIGHTS], ground[NUM_SPOTLIGHTS];
+
+	for (int i = 0; i < NUM_SPOTLIGHTS; i++) {
+		x[i] = (GLfloat)spotlights[i].x;
+		z[i] = (GLfloat)spotlights[i].z;
+	}
+	groundHeights(x, z, ground, NUM_SPOTLIGHTS);
+	for (int i = 0; i < NUM_SPOTLIGHTS; i++) {
+		spotlights[i].y = ground[i] + SPOTLIGHT_HEIGHT;
+	}
+}
+
+void resetSpotlight(Spotlight* spotlight) {
+	
+	spotlight->x = (double)rand() / RAND_MAX * 200 - 100;
+	spotlight->y = 10.0;
+	spotlight->z = (double)rand() / RAND_MAX * 200 - 100;
+	spotlight->velocityx = -0.2f + ((float)rand() / RAND_MAX) * 0.4f;
+	spotlight->velocityz = -0.2f + ((float)rand() / RAND_MAX) * 0.4f;
+	spotlight->colorCode = rand() % 7;
+	spotlight->alive = 1;
+}
+/*
+	Replay the benchmark flight script's key events for the given frame.
+*/
+void playBenchmarkFlight(int frame) {
+	int numEvents = sizeof(benchmarkFlight) / sizeof(benchmarkFlight[0]);
+	int scriptFrame = frame % BENCHMARK_FLIGHT_FRAMES;
+
+	for (int i = 0; i < numEvents; i++) {
+		const scriptedkey_t* event = &benchmarkFlight[i];
+
+		if (event->frame != scriptFrame) {
+			continue;
+		}
+
+		if (event->special) {
+			if (event->pressed) {
+				specialKeyPressed(event->key, 0, 0);
+			}
+			else {
+				specialKeyReleased(event->key, 0, 0);
+			}
+		}
+		else {
+			if (event->pressed) {
+				keyPressed((unsigned char)event->key, 0, 0);
+			}
+			else {
+				keyReleased((unsigned char)event->key, 0, 0);
+			}
+		}
+	}
+}
+
+/*
+	Save the hot-path trace recorded so far (registered with atexit, so it also runs on exit).
+*/
+void writeTrace(void) {
+	if (tracePath == NULL || !traceIsEnabled()) {
+		return;
+	}
+
+	if (traceWrite(tracePath)) {
+		printf("Trace written to %s\n", tracePath);
+	}
+	else {
+		printf("Could not write %s\n", tracePath);
+	}
+}
+
+/*
+	Initialise OpenGL lighting before we begin the render loop.
+
+	Note (advanced): If you're using dynamic lighting (e.g. lights that move around, turn on or
+	off, or change colour) you may want to replace this with a drawLights function that gets called
+	at the beginning of display() instead of init().
+*/
+void initLights(void)
+{
+
+	GLfloat globalAmbient[] = { 0.9f, 0.6f, 0.6f, 1 };
+	GLfloat lightPosition[] = { 0.0f, 40.0f, 0.0f, 1.0f };
+	GLfloat ambientLight[] = { 0.2f, 0.2f, 0.2f, 1.0f };
+	GLfloat diffuseLightRed[] = { 6.0f, 0.0f, 0.0f, 1.0f };
+	GLfloat specularLight[] = { 1.0f, 1.0f, 0.8f, 1.0f };
+	GLfloat diffuseLight[] = { 0.3f, 0.3f, 0.3f, 1.0f };
+
+	glLightModelfv(GL_LIGHT_MODEL_AMBIENT, globalAmbient);
+	
+	glLightModelfv(GL_LIGHT_MODEL_AMBIENT, globalAmbient);
+
+	glLightfv(GL_LIGHT0, GL_POSITION, lightPosition);
+	glLightfv(GL_LIGHT0, GL_AMBIENT, ambientLight);
+	glLightfv(GL_LIGHT0, GL_DIFFUSE, diffuseLight);
+	glLightfv(GL_LIGHT0, GL_SPECULAR, specularLight);
+
+	glEnable(GL_LIGHTING);	
+	glEnable(GL_LIGHT0);
+
+	glEnable(GL_NORMALIZE);
+
+
+}
+
+void drawOrigin(void) {
+	tracezone_t traceZone = traceBegin("drawOrigin");
+
+	glBegin(GL_LINES);
+	
+	glColor3f(1.0f, 0.0f, 0.0f);
+	glVertex3d(-2.0, 7.0, 0.0);
+	glVertex3d(2.0, 7.0, 0.0);
+
+	
+	glColor3f(0.0f, 0.0f, 1.0f);
+	glVertex3d(0.0, 9.0, 0.0);
+	glVertex3d(0.0, 5.0, 0.0);
+
+	
+	glColor3f(0.0f, 0.0f, 1.0f);
+	glVertex3d(0.0, 9.0, 1.0);
+	glVertex3d(0.0, 5.0, 1.0);
+
+	
+	glColor3f(0.0f, 1.0f, 0.0f);
+	glVertex3d(0.0, 7.0, 2.0);
+	glVertex3d(0.0, 7.0, -2.0);
+
+	glEnd();
+
+	traceEnd(traceZone);
+}
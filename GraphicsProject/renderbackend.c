@@ -0,0 +1,637 @@
+/******************************************************************************
+ *
+ * Render Backends (see renderbackend.h)
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "glfuncs.h"
+#include "glstats.h"
+#include "glstate.h"
+#include "matrixstack.h"
+#include "renderbackend.h"
+
+// Generic attribute slots of the core program; the instance transform takes
+// four (one per column).
+#define ATTRIB_POSITION		0
+#define ATTRIB_NORMAL		1
+#define ATTRIB_COLOR		2
+#define ATTRIB_TEXCOORD		3
+#define ATTRIB_SPIN			4
+#define ATTRIB_TRANSFORM	5
+#define ATTRIB_TINT			9
+#define ATTRIB_PHASE		10
+#define ATTRIB_COUNT		11
+
+// Uniform buffer binding point of the Frame block.
+#define FRAME_BINDING 0
+
+// Fog modes as the shader numbers them (fog[0] in the Frame block).
+#define FOG_OFF		0.0f
+#define FOG_LINEAR	1.0f
+#define FOG_EXP		2.0f
+#define FOG_EXP2	3.0f
+
+// One enabled light, laid out for std140 (all vec4s).
+typedef struct {
+	GLfloat position[4];
+	GLfloat ambient[4];
+	GLfloat diffuse[4];
+	GLfloat specular[4];
+	GLfloat spotDirection[4];	// w: cosine of the cutoff, or -2 for a light that isn't a spotlight
+	GLfloat attenuation[4];		// Constant, linear, quadratic, spot exponent
+} framelight_t;
+
+// The Frame uniform block.
+typedef struct {
+	GLfloat projection[16];
+	GLfloat lightModelAmbient[4];
+	GLfloat fogColor[4];
+	GLfloat fog[4];				// Mode (FOG_), density, start, end
+	GLint lightCount[4];
+	framelight_t lights[GLSTATE_MAX_LIGHTS];
+} frameblock_t;
+
+#define STRING(x) #x
+#define EXPAND_STRING(x) STRING(x)
+
+// Shared by both stages.
+static const char* const headerSource =
+	"#version 330 core\n"
+	"struct Light {\n"
+	"	vec4 position;\n"
+	"	vec4 ambient;\n"
+	"	vec4 diffuse;\n"
+	"	vec4 specular;\n"
+	"	vec4 spotDirection;\n"
+	"	vec4 attenuation;\n"
+	"};\n"
+	"layout(std140) uniform Frame {\n"
+	"	mat4 projection;\n"
+	"	vec4 lightModelAmbient;\n"
+	"	vec4 fogColor;\n"
+	"	vec4 fog;\n"
+	"	ivec4 lightCount;\n"
+	"	Light lights[" EXPAND_STRING(GLSTATE_MAX_LIGHTS) "];\n"
+	"};\n";
+
+// Fixed-function per-vertex lighting (single-sided, local viewer off, the
+// colour clamped), as instancing.c's compatibility shader does it, for plain
+// and instanced meshes alike.
+static const char* const vertexShaderSource =
+	"layout(location = 0) in vec3 position;\n"
+	"layout(location = 1) in vec3 normal;\n"
+	"layout(location = 2) in vec4 color;\n"
+	"layout(location = 3) in vec2 texCoord;\n"
+	"layout(location = 4) in vec2 spin;\n"
+	"layout(location = 5) in mat4 instanceTransform;\n"
+	"layout(location = 9) in vec4 instanceColor;\n"
+	"layout(location = 10) in float instancePhase;\n"
+	"uniform mat4 modelView;\n"
+	"uniform mat4 normalMatrix;\n"
+	"uniform vec4 materialAmbient;\n"
+	"uniform vec4 materialDiffuse;\n"
+	"uniform vec4 materialSpecular;\n"
+	"uniform vec4 materialEmission;\n"
+	"uniform float materialShininess;\n"
+	"uniform bool lighting;\n"
+	"uniform bool colorAmbient;\n"
+	"uniform bool colorDiffuse;\n"
+	"uniform bool instanced;\n"
+	"uniform float spinAngle;\n"
+	"uniform vec3 spinPivot;\n"
+	"out vec4 vertexColor;\n"
+	"out vec2 vertexTexCoord;\n"
+	"out float fogDistance;\n"
+	"void main()\n"
+	"{\n"
+	"	vec3 p = position;\n"
+	"	vec3 n = normal;\n"
+	"	vec4 c = color;\n"
+	"	mat4 model = mat4(1.0);\n"
+	"	if (instanced) {\n"
+	"		if (spin.x > 0.0) {\n"
+	"			float angle = spinAngle + spin.y + instancePhase;\n"
+	"			float co = cos(angle), si = sin(angle);\n"
+	"			p -= spinPivot;\n"
+	"			p = spinPivot + vec3(co * p.x - si * p.y, si * p.x + co * p.y, p.z);\n"
+	"			n = vec3(co * n.x - si * n.y, si * n.x + co * n.y, n.z);\n"
+	"		}\n"
+	"		model = instanceTransform;\n"
+	"		c *= instanceColor;\n"
+	"	}\n"
+	"	vec4 eye = modelView * (model * vec4(p, 1.0));\n"
+	"	vec4 result = c;\n"
+	"	if (lighting) {\n"
+	"		vec3 N = normalize(mat3(normalMatrix) * (mat3(model) * n));\n"
+	"		vec4 diffuse = colorDiffuse ? c : materialDiffuse;\n"
+	"		vec4 ambient = colorAmbient ? c : materialAmbient;\n"
+	"		result = materialEmission + ambient * lightModelAmbient;\n"
+	"		for (int i = 0; i < lightCount.x; i++) {\n"
+	"			vec3 L = lights[i].position.xyz;\n"
+	"			float attenuation = 1.0;\n"
+	"			if (lights[i].position.w != 0.0) {\n"
+	"				L -= eye.xyz;\n"
+	"				float d = length(L);\n"
+	"				attenuation = 1.0 / (lights[i].attenuation.x + lights[i].attenuation.y * d +\n"
+	"					lights[i].attenuation.z * d * d);\n"
+	"				L /= d;\n"
+	"				if (lights[i].spotDirection.w >= -1.0) {\n"
+	"					float spotCos = dot(-L, normalize(lights[i].spotDirection.xyz));\n"
+	"					attenuation *= spotCos < lights[i].spotDirection.w ? 0.0 :\n"
+	"						pow(spotCos, lights[i].attenuation.w);\n"
+	"				}\n"
+	"			}\n"
+	"			else {\n"
+	"				L = normalize(L);\n"
+	"			}\n"
+	"			float NdotL = max(dot(N, L), 0.0);\n"
+	"			vec4 term = ambient * lights[i].ambient + NdotL * diffuse * lights[i].diffuse;\n"
+	"			if (NdotL > 0.0) {\n"
+	"				float NdotH = max(dot(N, normalize(L + vec3(0.0, 0.0, 1.0))), 0.0);\n"
+	"				float specular = materialShininess > 0.0 ? pow(NdotH, materialShininess) : 1.0;\n"
+	"				term += specular * materialSpecular * lights[i].specular;\n"
+	"			}\n"
+	"			result += attenuation * term;\n"
+	"		}\n"
+	"		result = clamp(result, 0.0, 1.0);\n"
+	"		result.a = diffuse.a;\n"
+	"	}\n"
+	"	vertexColor = result;\n"
+	"	vertexTexCoord = texCoord;\n"
+	"	fogDistance = abs(eye.z);\n"
+	"	gl_Position = projection * eye;\n"
+	"}\n";
+
+// GL_MODULATE texturing, then fog on the colour (not the alpha).
+static const char* const fragmentShaderSource =
+	"uniform bool texturing;\n"
+	"uniform sampler2D colorTexture;\n"
+	"in vec4 vertexColor;\n"
+	"in vec2 vertexTexCoord;\n"
+	"in float fogDistance;\n"
+	"layout(location = 0) out vec4 fragColor;\n"
+	"void main()\n"
+	"{\n"
+	"	vec4 c = vertexColor;\n"
+	"	if (texturing) {\n"
+	"		c *= texture(colorTexture, vertexTexCoord);\n"
+	"	}\n"
+	"	if (fog.x > 0.0) {\n"
+	"		float f;\n"
+	"		if (fog.x == 1.0) {\n"
+	"			f = (fog.w - fogDistance) / (fog.w - fog.z);\n"
+	"		}\n"
+	"		else if (fog.x == 2.0) {\n"
+	"			f = exp(-fog.y * fogDistance);\n"
+	"		}\n"
+	"		else {\n"
+	"			f = exp(-(fog.y * fogDistance) * (fog.y * fogDistance));\n"
+	"		}\n"
+	"		c.rgb = mix(fogColor.rgb, c.rgb, clamp(f, 0.0, 1.0));\n"
+	"	}\n"
+	"	fragColor = c;\n"
+	"}\n";
+
+// Per-draw uniforms, with what was last sent to each so unchanged ones are skipped.
+typedef struct {
+	GLint location;
+	GLfloat value[16];
+	int sent;
+} uniform_t;
+
+enum {
+	UNIFORM_MODELVIEW,
+	UNIFORM_NORMAL_MATRIX,
+	UNIFORM_MATERIAL_AMBIENT,
+	UNIFORM_MATERIAL_DIFFUSE,
+	UNIFORM_MATERIAL_SPECULAR,
+	UNIFORM_MATERIAL_EMISSION,
+	UNIFORM_MATERIAL_SHININESS,
+	UNIFORM_LIGHTING,
+	UNIFORM_COLOR_AMBIENT,
+	UNIFORM_COLOR_DIFFUSE,
+	UNIFORM_INSTANCED,
+	UNIFORM_SPIN_ANGLE,
+	UNIFORM_SPIN_PIVOT,
+	UNIFORM_TEXTURING,
+	UNIFORM_COUNT
+};
+
+static const char* const uniformNames[UNIFORM_COUNT] = {
+	"modelView", "normalMatrix", "materialAmbient", "materialDiffuse", "materialSpecular", "materialEmission",
+	"materialShininess", "lighting", "colorAmbient", "colorDiffuse", "instanced", "spinAngle", "spinPivot", "texturing"
+};
+
+static int selected = -1;
+static int coreAvailability = 0;	// 0 not checked yet, 1 available, -1 unavailable
+
+static GLuint program;
+static GLuint vertexArray;
+static GLuint frameBuffer;
+static frameblock_t frame;			// As last uploaded
+static int frameUploaded = 0;
+static uniform_t uniforms[UNIFORM_COUNT];
+
+/******************************************************************************
+ * Selection
+ ******************************************************************************/
+
+static GLuint compileShader(GLenum type, const char* body)
+{
+	GLint status;
+	GLchar log[1024];
+	const GLchar* sources[2] = { headerSource, body };
+
+	GLuint shader = glCreateShader(type);
+	glShaderSource(shader, 2, sources, NULL);
+	glCompileShader(shader);
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+	if (!status) {
+		glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+		printf("Core backend %s shader failed to compile:\n%s\n", type == GL_VERTEX_SHADER ? "vertex" : "fragment", log);
+		glDeleteShader(shader);
+		return 0;
+	}
+	return shader;
+}
+
+// Build the program, its vertex array object and the Frame buffer. Returns 0 on failure.
+static int buildCore(void)
+{
+	GLint status;
+	GLchar log[1024];
+
+	if (!glFuncs.hasBuffers || !glFuncs.hasShaders || !glFuncs.hasInstancing || !glFuncs.hasUniformBuffers) {
+		return 0;
+	}
+
+	GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexShaderSource);
+	GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentShaderSource);
+	if (vertexShader == 0 || fragmentShader == 0) {
+		if (vertexShader != 0) {
+			glDeleteShader(vertexShader);
+		}
+		if (fragmentShader != 0) {
+			glDeleteShader(fragmentShader);
+		}
+		return 0;
+	}
+
+	program = glCreateProgram();
+	glAttachShader(program, vertexShader);
+	glAttachShader(program, fragmentShader);
+	glLinkProgram(program);
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (!status) {
+		glGetProgramInfoLog(program, sizeof(log), NULL, log);
+		printf("Core backend program failed to link:\n%s\n", log);
+		glDeleteProgram(program);
+		program = 0;
+		return 0;
+	}
+
+	for (int i = 0; i < UNIFORM_COUNT; i++) {
+		uniforms[i].location = glGetUniformLocation(program, uniformNames[i]);
+		uniforms[i].sent = 0;
+	}
+	glUniformBlockBinding(program, glGetUniformBlockIndex(program, "Frame"), FRAME_BINDING);
+	glUseProgram(program);
+	glUniform1i(glGetUniformLocation(program, "colorTexture"), 0);
+	glUseProgram(0);
+
+	glGenBuffers(1, &frameBuffer);
+	glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BINDING, frameBuffer);
+	frameUploaded = 0;
+
+	// The per-instance attributes advance once per instance; for plain meshes
+	// they're simply left disabled.
+	glGenVertexArrays(1, &vertexArray);
+	glBindVertexArray(vertexArray);
+	for (int i = ATTRIB_TRANSFORM; i < ATTRIB_COUNT; i++) {
+		glVertexAttribDivisor(i, 1);
+	}
+	glBindVertexArray(0);
+	return 1;
+}
+
+int renderBackendAvailable(int backend)
+{
+	if (backend == RENDER_BACKEND_FIXED) {
+		return !glFuncs.coreProfile;
+	}
+	if (backend != RENDER_BACKEND_CORE) {
+		return 0;
+	}
+	if (coreAvailability == 0) {
+		coreAvailability = buildCore() ? 1 : -1;
+	}
+	return coreAvailability == 1;
+}
+
+int renderBackendSelect(int backend)
+{
+	if (!renderBackendAvailable(backend)) {
+		return 0;
+	}
+	selected = backend;
+	return 1;
+}
+
+int renderBackendCurrent(void)
+{
+	if (selected >= 0) {
+		return selected;
+	}
+	return glFuncs.coreProfile ? RENDER_BACKEND_CORE : RENDER_BACKEND_FIXED;
+}
+
+const char* renderBackendName(int backend)
+{
+	return backend == RENDER_BACKEND_CORE ? "core" : "fixed";
+}
+
+/******************************************************************************
+ * Core Backend State
+ ******************************************************************************/
+
+// Inverse transpose of the modelview's upper 3x3, as a column-major mat4.
+static void normalMatrix(const GLfloat m[16], GLfloat out[16])
+{
+	GLfloat a = m[0], b = m[4], c = m[8];
+	GLfloat d = m[1], e = m[5], f = m[9];
+	GLfloat g = m[2], h = m[6], k = m[10];
+
+	// The cofactor matrix (row-major) over the determinant is the inverse transpose.
+	GLfloat cofactors[9] = {
+		e * k - f * h, f * g - d * k, d * h - e * g,
+		c * h - b * k, a * k - c * g, b * g - a * h,
+		b * f - c * e, c * d - a * f, a * e - b * d
+	};
+	GLfloat determinant = a * cofactors[0] + b * cofactors[1] + c * cofactors[2];
+	GLfloat scale = determinant != 0.0f ? 1.0f / determinant : 0.0f;
+
+	memset(out, 0, 16 * sizeof(GLfloat));
+	for (int row = 0; row < 3; row++) {
+		for (int column = 0; column < 3; column++) {
+			out[column * 4 + row] = cofactors[row * 3 + column] * scale;
+		}
+	}
+	out[15] = 1.0f;
+}
+
+// Rebuild the Frame block from the recorded state; upload it if it changed.
+static void updateFrame(void)
+{
+	const glfixedstate_t* state = glStateFixedFunction();
+	frameblock_t next;
+	int count = 0;
+
+	memset(&next, 0, sizeof(next));
+	memcpy(next.projection, matrixStackTop(GL_PROJECTION), sizeof(next.projection));
+	memcpy(next.lightModelAmbient, state->lightModelAmbient, sizeof(next.lightModelAmbient));
+	memcpy(next.fogColor, state->fogColor, sizeof(next.fogColor));
+	next.fog[0] = !state->fog ? FOG_OFF : state->fogMode == GL_LINEAR ? FOG_LINEAR : state->fogMode == GL_EXP2 ? FOG_EXP2 : FOG_EXP;
+	next.fog[1] = state->fogDensity;
+	next.fog[2] = state->fogStart;
+	next.fog[3] = state->fogEnd;
+
+	for (int i = 0; i < GLSTATE_MAX_LIGHTS; i++) {
+		const gllight_t* light = &state->lights[i];
+		framelight_t* packed = &next.lights[count];
+
+		if (!light->enabled) {
+			continue;
+		}
+		memcpy(packed->position, light->position, sizeof(packed->position));
+		memcpy(packed->ambient, light->ambient, sizeof(packed->ambient));
+		memcpy(packed->diffuse, light->diffuse, sizeof(packed->diffuse));
+		memcpy(packed->specular, light->specular, sizeof(packed->specular));
+		memcpy(packed->spotDirection, light->spotDirection, sizeof(light->spotDirection));
+		packed->spotDirection[3] = light->spotCutoff == 180.0f ? -2.0f : cosf(light->spotCutoff * 3.14159265358979323846f / 180.0f);
+		memcpy(packed->attenuation, light->attenuation, sizeof(light->attenuation));
+		packed->attenuation[3] = light->spotExponent;
+		count++;
+	}
+	next.lightCount[0] = count;
+
+	// Only as much of the block as is used goes up: the lights past the count are never read.
+	size_t size = offsetof(frameblock_t, lights) + count * sizeof(framelight_t);
+	if (frameUploaded && memcmp(&next, &frame, size) == 0) {
+		return;
+	}
+	memcpy(&frame, &next, sizeof(frame));
+	glBindBuffer(GL_UNIFORM_BUFFER, frameBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(frameblock_t), &frame, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	frameUploaded = 1;
+}
+
+static void setUniform(int index, const GLfloat* value, int count)
+{
+	uniform_t* uniform = &uniforms[index];
+
+	if (uniform->sent && memcmp(uniform->value, value, count * sizeof(GLfloat)) == 0) {
+		return;
+	}
+	memcpy(uniform->value, value, count * sizeof(GLfloat));
+	uniform->sent = 1;
+
+	switch (count) {
+	case 1:
+		glUniform1f(uniform->location, value[0]);
+		break;
+	case 3:
+		glUniform3fv(uniform->location, 1, value);
+		break;
+	case 4:
+		glUniform4fv(uniform->location, 1, value);
+		break;
+	default:
+		glUniformMatrix4fv(uniform->location, 1, GL_FALSE, value);
+		break;
+	}
+}
+
+static void setFlag(int index, int on)
+{
+	uniform_t* uniform = &uniforms[index];
+	GLfloat value = on ? 1.0f : 0.0f;
+
+	if (uniform->sent && uniform->value[0] == value) {
+		return;
+	}
+	uniform->value[0] = value;
+	uniform->sent = 1;
+	glUniform1i(uniform->location, on);
+}
+
+// Bind the program and bring everything but the vertex attributes up to date.
+static void beginCoreDraw(int instanced)
+{
+	const glfixedstate_t* state = glStateFixedFunction();
+	const GLfloat* modelview = matrixStackTop(GL_MODELVIEW);
+	GLfloat normals[16];
+
+	glUseProgram(program);
+	glBindVertexArray(vertexArray);
+	updateFrame();
+
+	normalMatrix(modelview, normals);
+	setUniform(UNIFORM_MODELVIEW, modelview, 16);
+	setUniform(UNIFORM_NORMAL_MATRIX, normals, 16);
+	setUniform(UNIFORM_MATERIAL_AMBIENT, state->material[0][GLSTATE_MATERIAL_AMBIENT], 4);
+	setUniform(UNIFORM_MATERIAL_DIFFUSE, state->material[0][GLSTATE_MATERIAL_DIFFUSE], 4);
+	setUniform(UNIFORM_MATERIAL_SPECULAR, state->material[0][GLSTATE_MATERIAL_SPECULAR], 4);
+	setUniform(UNIFORM_MATERIAL_EMISSION, state->material[0][GLSTATE_MATERIAL_EMISSION], 4);
+	setUniform(UNIFORM_MATERIAL_SHININESS, state->material[0][GLSTATE_MATERIAL_SHININESS], 1);
+	setFlag(UNIFORM_LIGHTING, state->lighting);
+	setFlag(UNIFORM_TEXTURING, state->texturing);
+	setFlag(UNIFORM_INSTANCED, instanced);
+}
+
+static void endCoreDraw(void)
+{
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glUseProgram(0);
+}
+
+static void setAttribute(GLuint index, GLint size, GLsizei stride, int offset)
+{
+	if (offset >= 0) {
+		glVertexAttribPointer(index, size, GL_FLOAT, GL_FALSE, stride, (const void*)(size_t)offset);
+		glEnableVertexAttribArray(index);
+	}
+	else {
+		glDisableVertexAttribArray(index);
+	}
+}
+
+/******************************************************************************
+ * Drawing
+ ******************************************************************************/
+
+static void drawFixed(const vertexformat_t* format, GLuint vertexBuffer, const void* vertices,
+	GLuint indexBuffer, const GLuint* indices, GLenum mode, GLsizei count)
+{
+	const char* base = vertices;
+
+	if (vertexBuffer != 0) {
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+		base = NULL;
+	}
+	if (indexBuffer != 0) {
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+		indices = NULL;
+	}
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(3, GL_FLOAT, format->stride, base + format->position);
+	if (format->normal >= 0) {
+		glEnableClientState(GL_NORMAL_ARRAY);
+		glNormalPointer(GL_FLOAT, format->stride, base + format->normal);
+	}
+	if (format->color >= 0) {
+		glEnableClientState(GL_COLOR_ARRAY);
+		glColorPointer(4, GL_FLOAT, format->stride, base + format->color);
+	}
+	if (format->texCoord >= 0) {
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(2, GL_FLOAT, format->stride, base + format->texCoord);
+	}
+
+	glDrawElements(mode, count, GL_UNSIGNED_INT, indices);
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+	if (format->normal >= 0) {
+		glDisableClientState(GL_NORMAL_ARRAY);
+	}
+	if (format->color >= 0) {
+		glDisableClientState(GL_COLOR_ARRAY);
+	}
+	if (format->texCoord >= 0) {
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	}
+	if (vertexBuffer != 0) {
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+	if (indexBuffer != 0) {
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
+}
+
+void renderBackendDrawElements(const vertexformat_t* format, GLuint vertexBuffer, const void* vertices,
+	GLuint indexBuffer, const GLuint* indices, GLenum mode, GLsizei count)
+{
+	static const GLfloat up[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+
+	if (renderBackendCurrent() == RENDER_BACKEND_FIXED) {
+		drawFixed(format, vertexBuffer, vertices, indexBuffer, indices, mode, count);
+		return;
+	}
+	if (!renderBackendAvailable(RENDER_BACKEND_CORE) || vertexBuffer == 0 || indexBuffer == 0) {
+		return;
+	}
+
+	const glfixedstate_t* state = glStateFixedFunction();
+	beginCoreDraw(0);
+	setFlag(UNIFORM_COLOR_AMBIENT, state->colorMaterial);
+	setFlag(UNIFORM_COLOR_DIFFUSE, state->colorMaterial);
+
+	glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+	setAttribute(ATTRIB_POSITION, 3, format->stride, format->position);
+	setAttribute(ATTRIB_NORMAL, 3, format->stride, format->normal);
+	setAttribute(ATTRIB_COLOR, 4, format->stride, format->color);
+	setAttribute(ATTRIB_TEXCOORD, 2, format->stride, format->texCoord);
+	for (int i = ATTRIB_SPIN; i < ATTRIB_COUNT; i++) {
+		glDisableVertexAttribArray(i);
+	}
+	if (format->normal < 0) {
+		glVertexAttrib4fv(ATTRIB_NORMAL, up);
+	}
+	if (format->color < 0) {
+		glVertexAttrib4fv(ATTRIB_COLOR, state->color);
+	}
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+	glDrawElements(mode, count, GL_UNSIGNED_INT, NULL);
+	endCoreDraw();
+}
+
+void renderBackendDrawInstanced(const instancedmesh_t* mesh, GLfloat spinAngle)
+{
+	if (!renderBackendAvailable(RENDER_BACKEND_CORE)) {
+		return;
+	}
+
+	beginCoreDraw(1);
+	setFlag(UNIFORM_COLOR_AMBIENT, mesh->colorIsAmbient);
+	setFlag(UNIFORM_COLOR_DIFFUSE, 1);
+	setUniform(UNIFORM_SPIN_ANGLE, &spinAngle, 1);
+	setUniform(UNIFORM_SPIN_PIVOT, mesh->spinPivot, 3);
+
+	glBindBuffer(GL_ARRAY_BUFFER, mesh->vertexBuffer);
+	setAttribute(ATTRIB_POSITION, 3, sizeof(meshvertex_t), offsetof(meshvertex_t, position));
+	setAttribute(ATTRIB_NORMAL, 3, sizeof(meshvertex_t), offsetof(meshvertex_t, normal));
+	setAttribute(ATTRIB_COLOR, 4, sizeof(meshvertex_t), offsetof(meshvertex_t, color));
+	setAttribute(ATTRIB_TEXCOORD, 2, sizeof(meshvertex_t), -1);
+	setAttribute(ATTRIB_SPIN, 2, sizeof(meshvertex_t), offsetof(meshvertex_t, spin));
+
+	glBindBuffer(GL_ARRAY_BUFFER, mesh->instanceBuffer);
+	for (int column = 0; column < 4; column++) {
+		setAttribute(ATTRIB_TRANSFORM + column, 4, sizeof(meshinstance_t),
+			(int)(offsetof(meshinstance_t, transform) + column * 4 * sizeof(GLfloat)));
+	}
+	setAttribute(ATTRIB_TINT, 4, sizeof(meshinstance_t), offsetof(meshinstance_t, color));
+	setAttribute(ATTRIB_PHASE, 1, sizeof(meshinstance_t), offsetof(meshinstance_t, phase));
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->indexBuffer);
+	glDrawElementsInstanced(GL_TRIANGLES, mesh->indexCount, GL_UNSIGNED_INT, NULL, mesh->instanceCount);
+	endCoreDraw();
+}
@@ -0,0 +1,68 @@
+/******************************************************************************
+ *
+ * Render Backends
+ *
+ * Meshes are drawn through one of two backends:
+ *
+ *   RENDER_BACKEND_FIXED  vertex arrays and the fixed-function pipeline.
+ *   RENDER_BACKEND_CORE   a GLSL 3.30 core profile program that reproduces
+ *                         the fixed pipeline the scene uses - per-vertex
+ *                         lighting with spotlights, colour material,
+ *                         modulated texturing and fog - from the state
+ *                         recorded by glstate.h and matrixstack.h. The
+ *                         per-frame part of it (projection, lights, fog) is
+ *                         kept in a uniform buffer, updated only when it
+ *                         changes; the rest is per-draw uniforms.
+ *
+ * Everything else stays the same whichever is in use: state is set with the
+ * usual GL calls (redirected by glstate.h and matrixstack.h) and geometry in
+ * buffer objects is drawn with renderBackendDrawElements() or, for instanced
+ * meshes, instancedMeshDraw(). The backend can be switched between frames;
+ * a core profile context only has the core one, and the core one can't draw
+ * from client memory.
+ *
+ ******************************************************************************/
+
+#ifndef RENDERBACKEND_H
+#define RENDERBACKEND_H
+
+#include <freeglut.h>
+#include "instancing.h"
+
+#define RENDER_BACKEND_FIXED	0
+#define RENDER_BACKEND_CORE		1
+
+// Where the attributes are in an interleaved vertex: byte offsets, or -1 if
+// the vertex doesn't have one (the current colour, or a +z normal, is used).
+typedef struct {
+	GLsizei stride;
+	int position;			// 3 floats
+	int normal;				// 3 floats
+	int color;				// 4 floats
+	int texCoord;			// 2 floats
+} vertexformat_t;
+
+// Whether a backend can be used in the current context (builds the core
+// program the first time it's asked).
+int renderBackendAvailable(int backend);
+
+// Switch to a backend. Returns 0 (and keeps the current one) if it isn't available.
+int renderBackendSelect(int backend);
+
+// The backend in use: the one selected, or by default the fixed one unless
+// the context is a core profile one.
+int renderBackendCurrent(void);
+
+const char* renderBackendName(int backend);
+
+// Draw indexed geometry with the current matrices and state. The vertices and
+// indices come from the buffer objects if they're non-zero, otherwise from
+// the pointers (fixed backend only).
+void renderBackendDrawElements(const vertexformat_t* format, GLuint vertexBuffer, const void* vertices,
+	GLuint indexBuffer, const GLuint* indices, GLenum mode, GLsizei count);
+
+// Draw every instance of an uploaded instanced mesh with the core backend
+// (instancedMeshDraw() calls this when it's the one in use).
+void renderBackendDrawInstanced(const instancedmesh_t* mesh, GLfloat spinAngle);
+
+#endif
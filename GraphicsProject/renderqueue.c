@@ -0,0 +1,263 @@
+/******************************************************************************
+ *
+ * Render Queue (see renderqueue.h)
+ *
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "glstats.h"
+#include "glstate.h"
+#include "matrixstack.h"
+#include "renderqueue.h"
+#include "trace.h"
+
+// Distinct materials per frame (ids are handed out in submission order).
+#define RENDER_MATERIAL_MAX 256
+
+// Eye-space distances beyond this all sort as the farthest.
+#define RENDER_DEPTH_RANGE 1024.0f
+
+typedef struct {
+	unsigned long long key;
+	renderfunc_t draw;
+	int pass;
+	int material;
+	texturehandle_t texture;
+	int section;
+	GLfloat modelview[16];
+	unsigned char data[RENDER_ITEM_DATA_SIZE];
+} renderitem_t;
+
+typedef struct {
+	unsigned long long key;
+	int item;
+} sortentry_t;
+
+static renderitem_t items[RENDER_QUEUE_MAX];
+static sortentry_t order[RENDER_QUEUE_MAX];
+static int itemCount = 0;
+
+static material_t materials[RENDER_MATERIAL_MAX];
+static int materialCount = 0;
+
+static int currentSection = -1;
+
+// What the GL was last left with by renderFlush(); -1 (or a NULL material) when unknown.
+static const material_t* appliedMaterial;
+static int appliedAmbientDiffuse;		// 0 once GL_COLOR_MATERIAL may have changed them
+static int colorMaterialOn = -1;
+static int texturingOn = -1;
+static texturehandle_t boundTexture = -1;
+static int blendOn = -1;
+
+static int findMaterial(const material_t* material)
+{
+	for (int i = 0; i < materialCount; i++) {
+		if (memcmp(&materials[i], material, sizeof(material_t)) == 0) {
+			return i;
+		}
+	}
+	if (materialCount == RENDER_MATERIAL_MAX) {
+		return -1;
+	}
+	materials[materialCount] = *material;
+	return materialCount++;
+}
+
+static unsigned long long depthBits(const GLfloat modelview[16])
+{
+	// The item's origin in eye space is the matrix's translation; -z is its distance.
+	GLfloat depth = -modelview[14] / RENDER_DEPTH_RANGE;
+	if (depth < 0.0f) {
+		depth = 0.0f;
+	}
+	if (depth > 1.0f) {
+		depth = 1.0f;
+	}
+	return (unsigned long long)(depth * 0xFFFFFF);
+}
+
+static unsigned long long makeKey(const renderitem_t* item, int sequence)
+{
+	unsigned long long pass = (unsigned long long)item->pass << 60;
+	unsigned long long material = (unsigned long long)(item->material & 0xFFF);
+	unsigned long long texture = (unsigned long long)(item->texture & 0xFFF);
+	unsigned long long depth = depthBits(item->modelview);
+
+	if (item->pass == RENDER_PASS_BLENDED) {
+		return pass | ((0xFFFFFF - depth) << 36) | (material << 24) | (texture << 12) | (unsigned long long)sequence;
+	}
+	return pass | (material << 48) | (texture << 36) | (depth << 12) | (unsigned long long)sequence;
+}
+
+static int compareEntries(const void* a, const void* b)
+{
+	unsigned long long keyA = ((const sortentry_t*)a)->key;
+	unsigned long long keyB = ((const sortentry_t*)b)->key;
+	return keyA < keyB ? -1 : keyA > keyB;
+}
+
+/******************************************************************************
+ * State Changes
+ ******************************************************************************/
+
+static void setCapability(GLenum capability, int* current, int on)
+{
+	if (*current != on) {
+		if (on) {
+			glEnable(capability);
+		}
+		else {
+			glDisable(capability);
+		}
+		*current = on;
+	}
+}
+
+// Send only the parts of a material that differ from the one already applied.
+static void applyMaterial(const material_t* material)
+{
+	const material_t* previous = appliedMaterial;
+
+	if (previous == material) {
+		if (material->colorMaterial || appliedAmbientDiffuse) {
+			return;
+		}
+	}
+
+	setCapability(GL_COLOR_MATERIAL, &colorMaterialOn, material->colorMaterial);
+	if (!material->colorMaterial) {
+		if (previous == NULL || !appliedAmbientDiffuse || memcmp(previous->ambient, material->ambient, sizeof(material->ambient)) != 0) {
+			glMaterialfv(GL_FRONT, GL_AMBIENT, material->ambient);
+		}
+		if (previous == NULL || !appliedAmbientDiffuse || memcmp(previous->diffuse, material->diffuse, sizeof(material->diffuse)) != 0) {
+			glMaterialfv(GL_FRONT, GL_DIFFUSE, material->diffuse);
+		}
+		appliedAmbientDiffuse = 1;
+	}
+	else {
+		appliedAmbientDiffuse = 0;
+	}
+	if (previous == NULL || memcmp(previous->specular, material->specular, sizeof(material->specular)) != 0) {
+		glMaterialfv(GL_FRONT, GL_SPECULAR, material->specular);
+	}
+	if (previous == NULL || memcmp(previous->emission, material->emission, sizeof(material->emission)) != 0) {
+		glMaterialfv(GL_FRONT, GL_EMISSION, material->emission);
+	}
+	if (previous == NULL || previous->shininess != material->shininess) {
+		glMaterialf(GL_FRONT, GL_SHININESS, material->shininess);
+	}
+	appliedMaterial = material;
+}
+
+static void applyTexture(texturehandle_t texture)
+{
+	setCapability(GL_TEXTURE_2D, &texturingOn, texture != 0);
+	if (texture != 0 && texture != boundTexture) {
+		textureBind(texture);
+		boundTexture = texture;
+	}
+}
+
+static void drawItem(const renderitem_t* item, const material_t* material)
+{
+	if (item->section >= 0) {
+		benchBeginSection((benchsection_t)item->section);
+	}
+
+	if (item->pass == RENDER_PASS_BLENDED && blendOn != 1) {
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	}
+	setCapability(GL_BLEND, &blendOn, item->pass == RENDER_PASS_BLENDED);
+	applyMaterial(material);
+	applyTexture(item->texture);
+
+	glLoadMatrixf(item->modelview);
+	item->draw(item->data);
+
+	if (item->section >= 0) {
+		benchEndSection((benchsection_t)item->section);
+	}
+}
+
+/******************************************************************************
+ * Queue
+ ******************************************************************************/
+
+void renderSetSection(int section)
+{
+	currentSection = section;
+}
+
+void renderSubmit(int pass, const material_t* material, texturehandle_t texture,
+	renderfunc_t draw, const void* data, int dataSize)
+{
+	renderitem_t* item = itemCount < RENDER_QUEUE_MAX ? &items[itemCount] : NULL;
+	renderitem_t overflow;
+
+	if (item == NULL) {
+		item = &overflow;
+	}
+
+	item->draw = draw;
+	item->pass = pass;
+	item->material = findMaterial(material);
+	item->texture = texture;
+	item->section = currentSection;
+	memcpy(item->modelview, matrixStackTop(GL_MODELVIEW), sizeof(item->modelview));
+	if (dataSize > RENDER_ITEM_DATA_SIZE) {
+		dataSize = RENDER_ITEM_DATA_SIZE;
+	}
+	if (dataSize > 0) {
+		memcpy(item->data, data, dataSize);
+	}
+
+	// Out of room (or of material ids): draw it now, then put the matrix back.
+	if (item == &overflow || item->material < 0) {
+		glPushMatrix();
+		appliedMaterial = NULL;
+		drawItem(item, material);
+		appliedMaterial = NULL;
+		glPopMatrix();
+		return;
+	}
+
+	item->key = makeKey(item, itemCount);
+	order[itemCount].key = item->key;
+	order[itemCount].item = itemCount;
+	itemCount++;
+}
+
+void renderFlush(void)
+{
+	tracezone_t traceZone = traceBegin("renderFlush");
+
+	qsort(order, itemCount, sizeof(sortentry_t), compareEntries);
+
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+
+	// Whatever happened since the last flush may have changed any of it.
+	appliedMaterial = NULL;
+	colorMaterialOn = -1;
+	texturingOn = -1;
+	boundTexture = -1;
+	blendOn = -1;
+
+	for (int i = 0; i < itemCount; i++) {
+		const renderitem_t* item = &items[order[i].item];
+		drawItem(item, &materials[item->material]);
+	}
+
+	setCapability(GL_BLEND, &blendOn, 0);
+	setCapability(GL_TEXTURE_2D, &texturingOn, 0);
+	setCapability(GL_COLOR_MATERIAL, &colorMaterialOn, 0);
+	glPopMatrix();
+
+	itemCount = 0;
+	materialCount = 0;
+	appliedMaterial = NULL;
+
+	traceEnd(traceZone);
+}
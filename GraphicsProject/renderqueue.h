@@ -0,0 +1,65 @@
+/******************************************************************************
+ *
+ * Render Queue
+ *
+ * Draw functions submit items - a callback that only issues geometry, the
+ * modelview matrix at the time, and the state it needs (pass, material,
+ * texture) - instead of drawing straight away. renderFlush() sorts the
+ * frame's items by a 64-bit key and draws them, changing materials,
+ * textures and blending only between items that differ:
+ *
+ *   opaque passes:  pass | material | texture | depth (front to back) | order
+ *   blended pass:   pass | depth (back to front) | material | texture | order
+ *
+ * so opaque items are grouped by state and blended ones are drawn last, far
+ * to near, with GL_BLEND on only while they draw.
+ *
+ ******************************************************************************/
+
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <freeglut.h>
+#include "bench.h"
+#include "textures.h"
+
+// Passes, drawn in this order.
+#define RENDER_PASS_BACKGROUND	0	// Drawn first whatever its state (e.g. the sky)
+#define RENDER_PASS_OPAQUE		1
+#define RENDER_PASS_BLENDED		2	// Alpha blended, drawn back to front
+
+// Most items in one frame; later ones are drawn straight away, unsorted.
+#define RENDER_QUEUE_MAX 4096
+
+// Bytes of parameters an item can carry to its callback.
+#define RENDER_ITEM_DATA_SIZE 64
+
+// Front-face lighting material. Items that submit equal materials share them.
+typedef struct {
+	GLfloat ambient[4];
+	GLfloat diffuse[4];
+	GLfloat specular[4];
+	GLfloat emission[4];
+	GLfloat shininess;
+	int colorMaterial;		// 1 to take ambient and diffuse from glColor (GL_COLOR_MATERIAL)
+} material_t;
+
+// Draws an item's geometry with its parameters. The item's modelview matrix
+// is loaded; the callback must leave materials, textures and blending alone.
+typedef void (*renderfunc_t)(const void* data);
+
+// Queue an item drawn with the current modelview matrix. data (dataSize
+// bytes, at most RENDER_ITEM_DATA_SIZE) is copied, so it can be on the stack.
+// texture is 0 to draw untextured.
+void renderSubmit(int pass, const material_t* material, texturehandle_t texture,
+	renderfunc_t draw, const void* data, int dataSize);
+
+// Benchmark section that items submitted from now on are timed under when
+// they're drawn (see bench.h); -1 for none.
+void renderSetSection(int section);
+
+// Sort and draw everything submitted since the last flush, then leave
+// blending, texturing and GL_COLOR_MATERIAL off.
+void renderFlush(void);
+
+#endif
@@ -0,0 +1,40 @@
+/******************************************************************************
+ *
+ * Fixed Timestep Clock (see simclock.h)
+ *
+ ******************************************************************************/
+
+#include "simclock.h"
+
+void simClockStart(simclock_t* clock, int tickRate, double now)
+{
+	clock->tickSeconds = 1.0 / tickRate;
+	clock->accumulator = 0.0;
+	clock->lastTime = now;
+	clock->ticks = 0;
+	clock->dropped = 0;
+}
+
+int simClockAdvance(simclock_t* clock, double now)
+{
+	int ticks = 0;
+
+	clock->accumulator += now - clock->lastTime;
+	clock->lastTime = now;
+	while (clock->accumulator >= clock->tickSeconds) {
+		clock->accumulator -= clock->tickSeconds;
+		if (ticks < SIM_CLOCK_MAX_TICKS) {
+			ticks++;
+		}
+		else {
+			clock->dropped++;
+		}
+	}
+	clock->ticks += ticks;
+	return ticks;
+}
+
+double simClockLastTick(const simclock_t* clock)
+{
+	return clock->lastTime - clock->accumulator;
+}
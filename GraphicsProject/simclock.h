@@ -0,0 +1,43 @@
+/******************************************************************************
+ *
+ * Fixed Timestep Clock
+ *
+ * Runs a simulation in ticks of a fixed length, however long the frames
+ * drawn between them take. The real time since the last frame goes into an
+ * accumulator and a tick is run for every whole tick's worth in it; what's
+ * left over is how far the present is past the last tick, so the frame can
+ * be drawn that far between the states of the last two. The simulation runs
+ * at the same speed, and gives the same results, at any frame rate.
+ *
+ * After a stall (a breakpoint, a window being dragged) at most
+ * SIM_CLOCK_MAX_TICKS are run at once and the rest of the time is dropped,
+ * so the simulation slows down for a moment rather than spending every
+ * frame after catching up.
+ *
+ ******************************************************************************/
+
+#ifndef SIMCLOCK_H
+#define SIMCLOCK_H
+
+// Most ticks simClockAdvance() asks for at once.
+#define SIM_CLOCK_MAX_TICKS 8
+
+typedef struct {
+	double tickSeconds;		// Length of a tick
+	double accumulator;		// Real time not simulated yet, in seconds
+	double lastTime;		// When the clock was last started or advanced
+	long long ticks;		// Ticks run since simClockStart()
+	long long dropped;		// Ticks skipped after stalls
+} simclock_t;
+
+// Start the clock at tickRate ticks a second, at time now (in seconds).
+void simClockStart(simclock_t* clock, int tickRate, double now);
+
+// How many ticks to run to catch up with now.
+int simClockAdvance(simclock_t* clock, double now);
+
+// When the last tick simClockAdvance() asked for was due, a fraction of a
+// tick before the time it was given.
+double simClockLastTick(const simclock_t* clock);
+
+#endif
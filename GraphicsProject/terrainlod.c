@@ -0,0 +1,575 @@
+/******************************************************************************
+ *
+ * Terrain Level of Detail (see terrainlod.h)
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "glfuncs.h"
+#include "glstate.h"
+#include "matrixstack.h"
+#include "platform.h"
+#include "terrainlod.h"
+#include "terrainpager.h"
+
+// Most vertices along one side of a chunk (the last one in a row can be
+// nearly two chunks wide).
+#define MAX_SAMPLES (2 * TERRAIN_LOD_CHUNK_CELLS + 1)
+
+// Sides of a chunk, for stitching.
+#define SIDE_MIN_X 0
+#define SIDE_MAX_X 1
+#define SIDE_MIN_Z 2
+#define SIDE_MAX_Z 3
+
+// Grow an array to hold at least count elements. Returns 0 if out of memory.
+static int reserve(void** array, int* capacity, int count, size_t elementSize)
+{
+	if (count <= *capacity) {
+		return 1;
+	}
+
+	int newCapacity = *capacity > 0 ? *capacity : 256;
+	while (newCapacity < count) {
+		newCapacity *= 2;
+	}
+	void* grown = realloc(*array, newCapacity * elementSize);
+	if (grown == NULL) {
+		return 0;
+	}
+	*array = grown;
+	*capacity = newCapacity;
+	return 1;
+}
+
+// Vertex positions along a side of cells cells at a spacing of step: every
+// step-th one and always the last. Returns how many.
+static int samples(int cells, int step, int* out)
+{
+	int count = 0;
+	for (int position = 0; position < cells; position += step) {
+		out[count++] = position;
+	}
+	out[count++] = cells;
+	return count;
+}
+
+/******************************************************************************
+ * Building
+ ******************************************************************************/
+
+typedef struct {
+	const GLfloat* heights;
+	size_t stride;
+	int sizeZ;
+} heightgrid_t;
+
+static GLfloat heightAt(const heightgrid_t* grid, int x, int z)
+{
+	return *(const GLfloat*)((const char*)grid->heights + ((size_t)x * grid->sizeZ + z) * grid->stride);
+}
+
+// The worst difference between the chunk's heights and the surface drawn
+// with every step-th vertex, each cell of which is split like the full
+// resolution ones.
+static GLfloat levelError(const heightgrid_t* grid, const terrainchunk_t* chunk, int step)
+{
+	GLfloat worst = 0.0f;
+
+	for (int i = 0; i <= chunk->cellsX; i++) {
+		int xa = i < chunk->cellsX ? i / step * step : chunk->cellsX;
+		int xb = xa + step < chunk->cellsX ? xa + step : chunk->cellsX;
+		GLfloat u = xb > xa ? (GLfloat)(i - xa) / (xb - xa) : 0.0f;
+
+		for (int j = 0; j <= chunk->cellsZ; j++) {
+			int za = j < chunk->cellsZ ? j / step * step : chunk->cellsZ;
+			int zb = za + step < chunk->cellsZ ? za + step : chunk->cellsZ;
+			GLfloat v = zb > za ? (GLfloat)(j - za) / (zb - za) : 0.0f;
+
+			GLfloat a = heightAt(grid, chunk->x + xa, chunk->z + za);
+			GLfloat b = heightAt(grid, chunk->x + xb, chunk->z + za);
+			GLfloat c = heightAt(grid, chunk->x + xa, chunk->z + zb);
+			GLfloat d = heightAt(grid, chunk->x + xb, chunk->z + zb);
+			GLfloat drawn = u + v <= 1.0f ? a + u * (b - a) + v * (c - a) : d + (1.0f - u) * (c - d) + (1.0f - v) * (b - d);
+			GLfloat error = fabsf(heightAt(grid, chunk->x + i, chunk->z + j) - drawn);
+			if (error > worst) {
+				worst = error;
+			}
+		}
+	}
+	return worst;
+}
+
+static void measureChunk(const heightgrid_t* grid, const terrainlod_t* lod, terrainchunk_t* chunk)
+{
+	GLfloat low = heightAt(grid, chunk->x, chunk->z);
+	GLfloat high = low;
+	for (int i = 0; i <= chunk->cellsX; i++) {
+		for (int j = 0; j <= chunk->cellsZ; j++) {
+			GLfloat height = heightAt(grid, chunk->x + i, chunk->z + j);
+			low = height < low ? height : low;
+			high = height > high ? height : high;
+		}
+	}
+	chunk->bounds.min[0] = lod->originX + chunk->x * lod->spacing;
+	chunk->bounds.min[1] = low;
+	chunk->bounds.min[2] = lod->originZ + chunk->z * lod->spacing;
+	chunk->bounds.max[0] = lod->originX + (chunk->x + chunk->cellsX) * lod->spacing;
+	chunk->bounds.max[1] = high;
+	chunk->bounds.max[2] = lod->originZ + (chunk->z + chunk->cellsZ) * lod->spacing;
+
+	// Coarser levels go while there are still two cells a side. An error
+	// never shrinks going coarser, so the selection can stop at the first
+	// level that's good enough.
+	int smallest = chunk->cellsX < chunk->cellsZ ? chunk->cellsX : chunk->cellsZ;
+	chunk->levels = 0;
+	for (int level = 0; level < TERRAIN_LOD_LEVELS && (1 << level) < smallest; level++) {
+		GLfloat error = level == 0 ? 0.0f : levelError(grid, chunk, 1 << level);
+		chunk->error[level] = level > 0 && error < chunk->error[level - 1] ? chunk->error[level - 1] : error;
+		chunk->levels++;
+	}
+}
+
+int terrainLodBuild(terrainlod_t* lod, const GLfloat* heights, size_t heightStride, int sizeX, int sizeZ,
+	GLfloat originX, GLfloat originZ, GLfloat spacing)
+{
+	heightgrid_t grid = { heights, heightStride, sizeZ };
+
+	free(lod->chunks);
+	free(lod->inFrustum);
+	lod->chunks = NULL;
+	lod->inFrustum = NULL;
+	lod->hierarchy.nodeCount = 0;
+	lod->hierarchy.itemCount = 0;
+	lod->chunksX = 0;
+	lod->chunksZ = 0;
+	lod->indexCount = 0;
+	lod->selected = 0;
+	lod->sizeX = sizeX;
+	lod->sizeZ = sizeZ;
+	lod->originX = originX;
+	lod->originZ = originZ;
+	lod->spacing = spacing;
+	if (sizeX < 3 || sizeZ < 3) {
+		return 1;		// Too small to split; nothing is drawn.
+	}
+
+	int cellsX = sizeX - 1, cellsZ = sizeZ - 1;
+	lod->chunksX = cellsX / TERRAIN_LOD_CHUNK_CELLS > 0 ? cellsX / TERRAIN_LOD_CHUNK_CELLS : 1;
+	lod->chunksZ = cellsZ / TERRAIN_LOD_CHUNK_CELLS > 0 ? cellsZ / TERRAIN_LOD_CHUNK_CELLS : 1;
+	lod->chunks = calloc((size_t)lod->chunksX * lod->chunksZ, sizeof(terrainchunk_t));
+	lod->inFrustum = malloc((size_t)lod->chunksX * lod->chunksZ);
+	if (lod->chunks == NULL || lod->inFrustum == NULL) {
+		free(lod->chunks);
+		free(lod->inFrustum);
+		lod->chunks = NULL;
+		lod->inFrustum = NULL;
+		lod->chunksX = 0;
+		lod->chunksZ = 0;
+		return 0;
+	}
+
+	for (int cx = 0; cx < lod->chunksX; cx++) {
+		for (int cz = 0; cz < lod->chunksZ; cz++) {
+			terrainchunk_t* chunk = &lod->chunks[cx * lod->chunksZ + cz];
+			chunk->x = cx * TERRAIN_LOD_CHUNK_CELLS;
+			chunk->z = cz * TERRAIN_LOD_CHUNK_CELLS;
+			chunk->cellsX = cx < lod->chunksX - 1 ? TERRAIN_LOD_CHUNK_CELLS : cellsX - chunk->x;
+			chunk->cellsZ = cz < lod->chunksZ - 1 ? TERRAIN_LOD_CHUNK_CELLS : cellsZ - chunk->z;
+			measureChunk(&grid, lod, chunk);
+		}
+	}
+	return bvhBuild(&lod->hierarchy, &lod->chunks[0].bounds, sizeof(terrainchunk_t), lod->chunksX * lod->chunksZ);
+}
+
+/******************************************************************************
+ * Selection
+ ******************************************************************************/
+
+// How much of the terrain's colour survives the fog at a distance.
+static GLfloat fogVisibility(const terrainview_t* view, GLfloat distance)
+{
+	GLfloat visibility;
+
+	switch (view->fogMode) {
+	case GL_EXP:
+		visibility = expf(-view->fogDensity * distance);
+		break;
+	case GL_EXP2:
+		visibility = expf(-(view->fogDensity * distance) * (view->fogDensity * distance));
+		break;
+	case GL_LINEAR:
+		visibility = view->fogEnd > view->fogStart ? (view->fogEnd - distance) / (view->fogEnd - view->fogStart) : 1.0f;
+		break;
+	default:
+		return 1.0f;
+	}
+	return visibility < 0.0f ? 0.0f : visibility > 1.0f ? 1.0f : visibility;
+}
+
+static int chooseLevel(const terrainchunk_t* chunk, const terrainview_t* view, const GLfloat eye[3], GLfloat pixelsPerUnit)
+{
+	if (view->maxPixelError <= 0.0f) {
+		return 0;
+	}
+
+	// Distance to the nearest point of the chunk's box, where its error is
+	// biggest on screen and least fogged.
+	GLfloat squared = 0.0f;
+	for (int axis = 0; axis < 3; axis++) {
+		GLfloat outside = eye[axis] < chunk->bounds.min[axis] ? chunk->bounds.min[axis] - eye[axis] :
+			eye[axis] > chunk->bounds.max[axis] ? eye[axis] - chunk->bounds.max[axis] : 0.0f;
+		squared += outside * outside;
+	}
+	GLfloat distance = sqrtf(squared);
+	GLfloat scale = pixelsPerUnit * fogVisibility(view, distance) / (distance > 1e-3f ? distance : 1e-3f);
+
+	for (int level = chunk->levels - 1; level > 0; level--) {
+		if (chunk->error[level] * scale <= view->maxPixelError) {
+			return level;
+		}
+	}
+	return 0;
+}
+
+// Append a triangle of chunk-relative vertices, wound like the full
+// resolution cells (anticlockwise from +x to +z).
+static void emitTriangle(terrainlod_t* lod, const terrainchunk_t* chunk, int ax, int az, int bx, int bz, int cx, int cz)
+{
+	GLuint* out = &lod->indices[lod->indexCount];
+
+	if ((bx - ax) * (cz - az) - (bz - az) * (cx - ax) < 0) {
+		int swapX = bx, swapZ = bz;
+		bx = cx;
+		bz = cz;
+		cx = swapX;
+		cz = swapZ;
+	}
+	out[0] = (GLuint)((chunk->x + ax) * lod->sizeZ + chunk->z + az);
+	out[1] = (GLuint)((chunk->x + bx) * lod->sizeZ + chunk->z + bz);
+	out[2] = (GLuint)((chunk->x + cx) * lod->sizeZ + chunk->z + cz);
+	lod->indexCount += 3;
+}
+
+// Triangulate the strip between a side's outer edge, drawn through the
+// coarser neighbour's vertices, and the row of vertices just inside it,
+// walking along both and always advancing the one that's behind. The inner
+// row stops short of any other side that's stitched too, leaving the corner
+// between them to the diagonal from the chunk's corner.
+static void stitchSide(terrainlod_t* lod, const terrainchunk_t* chunk, int side, int edgeStep,
+	const int* xs, int countX, const int* zs, int countZ, const int stitched[4])
+{
+	int outer[MAX_SAMPLES];
+	const int* inner;
+	int outerCount, innerCount, outerAcross, innerAcross;
+
+	if (side == SIDE_MIN_X || side == SIDE_MAX_X) {
+		outerCount = samples(chunk->cellsZ, edgeStep, outer);
+		inner = zs + stitched[SIDE_MIN_Z];
+		innerCount = countZ - stitched[SIDE_MIN_Z] - stitched[SIDE_MAX_Z];
+		outerAcross = side == SIDE_MIN_X ? 0 : chunk->cellsX;
+		innerAcross = side == SIDE_MIN_X ? xs[1] : xs[countX - 2];
+	}
+	else {
+		outerCount = samples(chunk->cellsX, edgeStep, outer);
+		inner = xs + stitched[SIDE_MIN_X];
+		innerCount = countX - stitched[SIDE_MIN_X] - stitched[SIDE_MAX_X];
+		outerAcross = side == SIDE_MIN_Z ? 0 : chunk->cellsZ;
+		innerAcross = side == SIDE_MIN_Z ? zs[1] : zs[countZ - 2];
+	}
+
+	int i = 0, j = 0;
+	while (i < outerCount - 1 || j < innerCount - 1) {
+		int a = outer[i], aAcross = outerAcross, b, bAcross, c = inner[j], cAcross = innerAcross;
+		if (j == innerCount - 1 || (i < outerCount - 1 && outer[i + 1] <= inner[j + 1])) {
+			b = outer[++i];
+			bAcross = outerAcross;
+		}
+		else {
+			b = inner[++j];
+			bAcross = innerAcross;
+		}
+		if (side == SIDE_MIN_X || side == SIDE_MAX_X) {
+			emitTriangle(lod, chunk, aAcross, a, bAcross, b, cAcross, c);
+		}
+		else {
+			emitTriangle(lod, chunk, a, aAcross, b, bAcross, c, cAcross);
+		}
+	}
+}
+
+static int buildIndices(terrainlod_t* lod)
+{
+	lod->indexCount = 0;
+	memset(lod->levelChunks, 0, sizeof(lod->levelChunks));
+
+	for (int cx = 0; cx < lod->chunksX; cx++) {
+		for (int cz = 0; cz < lod->chunksZ; cz++) {
+			const terrainchunk_t* chunk = &lod->chunks[cx * lod->chunksZ + cz];
+			if (!chunk->visible) {
+				continue;
+			}
+			int step = 1 << chunk->level;
+			int xs[MAX_SAMPLES], zs[MAX_SAMPLES];
+			int countX = samples(chunk->cellsX, step, xs);
+			int countZ = samples(chunk->cellsZ, step, zs);
+
+			// At most two triangles per cell of the level plus a few from stitching.
+			int most = lod->indexCount + 6 * (countX - 1) * (countZ - 1) + 24;
+			if (!reserve((void**)&lod->indices, &lod->indexCapacity, most, sizeof(GLuint))) {
+				lod->indexCount = 0;
+				return 0;
+			}
+			lod->levelChunks[chunk->level]++;
+
+			// Sides next to a coarser chunk are stitched to it; the rest of the
+			// chunk is a grid like the full resolution one.
+			const terrainchunk_t* neighbours[4] = {
+				cx > 0 ? chunk - lod->chunksZ : NULL,
+				cx < lod->chunksX - 1 ? chunk + lod->chunksZ : NULL,
+				cz > 0 ? chunk - 1 : NULL,
+				cz < lod->chunksZ - 1 ? chunk + 1 : NULL
+			};
+			int stitched[4];
+			for (int side = 0; side < 4; side++) {
+				stitched[side] = neighbours[side] != NULL && neighbours[side]->level > chunk->level;
+			}
+
+			for (int i = stitched[SIDE_MIN_X]; i < countX - 1 - stitched[SIDE_MAX_X]; i++) {
+				for (int j = stitched[SIDE_MIN_Z]; j < countZ - 1 - stitched[SIDE_MAX_Z]; j++) {
+					emitTriangle(lod, chunk, xs[i], zs[j], xs[i + 1], zs[j], xs[i], zs[j + 1]);
+					emitTriangle(lod, chunk, xs[i + 1], zs[j], xs[i + 1], zs[j + 1], xs[i], zs[j + 1]);
+				}
+			}
+			for (int side = 0; side < 4; side++) {
+				if (stitched[side]) {
+					stitchSide(lod, chunk, side, 1 << neighbours[side]->level, xs, countX, zs, countZ, stitched);
+				}
+			}
+		}
+	}
+	return 1;
+}
+
+void terrainLodSelect(terrainlod_t* lod, const terrainview_t* view)
+{
+	const GLfloat* m = view->modelview;
+	const GLfloat* p = view->projection;
+
+	// The eye in terrain space (the modelview is a rotation and translation),
+	// and the pixels a unit at unit distance covers.
+	GLfloat eye[3];
+	for (int axis = 0; axis < 3; axis++) {
+		eye[axis] = -(m[axis * 4] * m[12] + m[axis * 4 + 1] * m[13] + m[axis * 4 + 2] * m[14]);
+	}
+	GLfloat pixelsPerUnit = 0.5f * view->viewportHeight * p[5];
+
+	int chunks = lod->chunksX * lod->chunksZ;
+	if (view->noCulling) {
+		memset(lod->inFrustum, 1, chunks);
+	}
+	else {
+		frustum_t frustum;
+		frustumExtract(&frustum, p, m);
+		bvhCull(&lod->hierarchy, &lod->chunks[0].bounds, sizeof(terrainchunk_t), &frustum, lod->inFrustum);
+	}
+
+	int changed = !lod->selected;
+	lod->culledChunks = 0;
+	lod->occludedChunks = 0;
+	for (int i = 0; i < chunks; i++) {
+		terrainchunk_t* chunk = &lod->chunks[i];
+		int level = chooseLevel(chunk, view, eye, pixelsPerUnit);
+		if (!lod->inFrustum[i]) {
+			lod->culledChunks++;
+		}
+		else if (view->occlusion != NULL && !occlusionTestBounds(view->occlusion, &chunk->bounds)) {
+			lod->inFrustum[i] = 0;
+			lod->occludedChunks++;
+		}
+		if (level != chunk->level || lod->inFrustum[i] != chunk->visible) {
+			chunk->level = level;
+			chunk->visible = lod->inFrustum[i];
+			changed = 1;
+		}
+	}
+	lod->selections++;
+	if (!changed) {
+		return;
+	}
+
+	// Failing leaves nothing to draw; clearing selected makes the next call try again.
+	lod->rebuilds++;
+	if (!buildIndices(lod)) {
+		printf("Out of memory indexing the terrain!\n");
+		lod->selected = 0;
+		return;
+	}
+	lod->selected = 1;
+
+	if (glFuncs.hasBuffers) {
+		if (lod->indexBuffer == 0) {
+			glGenBuffers(1, &lod->indexBuffer);
+		}
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lod->indexBuffer);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * lod->indexCount, lod->indices, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
+}
+
+/******************************************************************************
+ * Drawing and Stats
+ ******************************************************************************/
+
+void terrainLodDraw(const terrainlod_t* lod, const vertexformat_t* format, GLuint vertexBuffer, const void* vertices)
+{
+	if (lod->indexCount > 0) {
+		renderBackendDrawElements(format, vertexBuffer, vertices, lod->indexBuffer, lod->indices,
+			GL_TRIANGLES, lod->indexCount);
+	}
+}
+
+int terrainLodTriangles(const terrainlod_t* lod)
+{
+	return lod->indexCount / 3;
+}
+
+int terrainLodFullTriangles(const terrainlod_t* lod)
+{
+	return lod->sizeX > 1 && lod->sizeZ > 1 ? 2 * (lod->sizeX - 1) * (lod->sizeZ - 1) : 0;
+}
+
+void terrainLodPrintStats(const terrainlod_t* lod)
+{
+	int full = terrainLodFullTriangles(lod);
+
+	printf("Terrain: %d of %d triangles (%.1f%%) in %d chunks; chunks per level:",
+		terrainLodTriangles(lod), full, full > 0 ? 100.0 * terrainLodTriangles(lod) / full : 0.0,
+		lod->chunksX * lod->chunksZ);
+	for (int level = 0; level < TERRAIN_LOD_LEVELS; level++) {
+		printf(" %lu", lod->levelChunks[level]);
+	}
+	printf(", %lu culled, %lu hidden", lod->culledChunks, lod->occludedChunks);
+	printf("; reindexed %lu times in %lu frames\n", lod->rebuilds, lod->selections);
+}
+
+void terrainLodResetStats(terrainlod_t* lod)
+{
+	lod->selections = 0;
+	lod->rebuilds = 0;
+}
+
+void terrainLodFree(terrainlod_t* lod)
+{
+	free(lod->chunks);
+	free(lod->inFrustum);
+	free(lod->indices);
+	bvhFree(&lod->hierarchy);
+	if (lod->indexBuffer != 0) {
+		glDeleteBuffers(1, &lod->indexBuffer);
+	}
+	memset(lod, 0, sizeof(*lod));
+}
+
+/******************************************************************************
+ * Benchmark
+ ******************************************************************************/
+
+typedef struct {
+	const char* label;
+	GLfloat position[2];	// Eye x and z, as fractions of the distance from the middle to the edge
+	GLfloat height;			// Eye height above the ground there
+	GLfloat direction[3];	// Where it looks
+} benchview_t;
+
+void terrainLodBenchmark(int size)
+{
+	static const benchview_t views[] = {
+		{ "chase", { 0.0f, 0.0f }, 10.0f, { 1.0f, -0.1f, 0.0f } },
+		{ "overhead", { 0.0f, 0.0f }, 300.0f, { 0.0f, -1.0f, 0.01f } },
+		{ "corner", { -0.9f, -0.9f }, 30.0f, { 1.0f, -0.05f, 1.0f } }
+	};
+	static const GLfloat errors[] = { 0.0f, 1.0f, 2.0f, 4.0f };
+	terrainlod_t lod = { 0 };
+
+	if (size < 3) {
+		printf("The terrain needs to be at least 3x3\n");
+		return;
+	}
+	GLfloat* heights = malloc(sizeof(GLfloat) * size * size);
+	if (heights == NULL) {
+		printf("Out of memory making a %dx%d heightmap\n", size, size);
+		return;
+	}
+	for (int x = 0; x < size; x++) {
+		for (int z = 0; z < size; z++) {
+			heights[(size_t)x * size + z] = terrainSyntheticHeight(NULL, x, z);
+		}
+	}
+
+	GLfloat half = (size - 1) / 2.0f;
+	double start = platformTimeSeconds();
+	if (!terrainLodBuild(&lod, heights, sizeof(GLfloat), size, size, -half, -half, 1.0f)) {
+		printf("Out of memory building the chunks\n");
+		free(heights);
+		return;
+	}
+	printf("%dx%d heightmap: %d chunks measured in %.1f ms, %d triangles at full resolution\n", size, size,
+		lod.chunksX * lod.chunksZ, (platformTimeSeconds() - start) * 1000.0, terrainLodFullTriangles(&lod));
+
+	// The scene's projection and fog, in a 1000x800 window.
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	gluPerspective(60.0f, 1.25f, 1.0f, 300.0f);
+	glMatrixMode(GL_MODELVIEW);
+
+	printf("%-10s %6s %12s %8s %8s %12s %12s\n", "view", "pixels", "triangles", "of full", "culled", "select ms",
+		"reindex ms");
+	for (size_t v = 0; v < sizeof(views) / sizeof(views[0]); v++) {
+		const benchview_t* view = &views[v];
+		int x = (int)(half + view->position[0] * half), z = (int)(half + view->position[1] * half);
+		GLfloat eye[3] = { x - half, heights[(size_t)x * size + z] + view->height, z - half };
+
+		glLoadIdentity();
+		gluLookAt(eye[0], eye[1], eye[2], eye[0] + view->direction[0], eye[1] + view->direction[1],
+			eye[2] + view->direction[2], 0.0f, 1.0f, 0.0f);
+
+		for (size_t e = 0; e < sizeof(errors) / sizeof(errors[0]); e++) {
+			terrainview_t settings = {
+				.modelview = matrixStackTop(GL_MODELVIEW),
+				.projection = matrixStackTop(GL_PROJECTION),
+				.viewportHeight = 800,
+				.maxPixelError = errors[e],
+				.fogMode = GL_EXP,
+				.fogDensity = 0.02f,
+				.fogStart = 0.0f,
+				.fogEnd = 1.0f,
+				.noCulling = 0,
+				.occlusion = NULL
+			};
+			const int repeats = 20;
+
+			// Reindexing every time, then the usual case of an unchanged selection.
+			start = platformTimeSeconds();
+			for (int n = 0; n < repeats; n++) {
+				lod.selected = 0;
+				terrainLodSelect(&lod, &settings);
+			}
+			double reindex = (platformTimeSeconds() - start) * 1000.0 / repeats;
+			start = platformTimeSeconds();
+			for (int n = 0; n < repeats; n++) {
+				terrainLodSelect(&lod, &settings);
+			}
+			double select = (platformTimeSeconds() - start) * 1000.0 / repeats;
+
+			printf("%-10s %6.1f %12d %7.2f%% %8lu %12.3f %12.3f\n", view->label, errors[e], terrainLodTriangles(&lod),
+				100.0 * terrainLodTriangles(&lod) / terrainLodFullTriangles(&lod), lod.culledChunks, select, reindex);
+		}
+	}
+
+	terrainLodFree(&lod);
+	free(heights);
+}
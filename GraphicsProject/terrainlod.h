@@ -0,0 +1,121 @@
+/******************************************************************************
+ *
+ * Terrain Level of Detail
+ *
+ * Geomipmapping over a regular height grid. The grid is split into chunks of
+ * about TERRAIN_LOD_CHUNK_CELLS cells a side, each of which can be drawn at
+ * full resolution or with every 2nd, 4th, ... row and column of vertices. The
+ * worst height error each level makes is measured once, when the terrain is
+ * built; every frame terrainLodSelect() then picks, per chunk, the coarsest
+ * level whose error projects to no more than a given number of pixels at the
+ * chunk's distance from the camera (less whatever fog hides), so the triangle
+ * count follows what can be seen rather than the size of the heightmap.
+ *
+ * Where a chunk meets a coarser neighbour its border row is re-triangulated
+ * against the neighbour's vertices, so there are no cracks or T-junctions
+ * whatever the difference in levels. Chunks index into the caller's full
+ * resolution vertex grid (vertex (x, z) is number x * sizeZ + z), so the
+ * vertices are uploaded once and only the index list changes, and only when
+ * the selection does.
+ *
+ * Chunks wholly outside the view frustum are left out of the index list,
+ * found through a bounding volume hierarchy over their boxes, as are those an
+ * occlusion buffer says are hidden (see occlusion.h). They still get a level,
+ * so a chunk coming into view is stitched to its neighbours just as before.
+ *
+ ******************************************************************************/
+
+#ifndef TERRAINLOD_H
+#define TERRAINLOD_H
+
+#include <freeglut.h>
+#include "culling.h"
+#include "occlusion.h"
+#include "renderbackend.h"
+
+// Cells along each side of a chunk (the last chunk in a row or column takes
+// any remainder), and the most levels a chunk can have: level n uses every
+// 2^n-th vertex, down to two cells a side.
+#define TERRAIN_LOD_CHUNK_CELLS	32
+#define TERRAIN_LOD_LEVELS		5
+
+typedef struct {
+	int x, z;				// First vertex
+	int cellsX, cellsZ;
+	int levels;				// Levels it can be drawn at
+	GLfloat error[TERRAIN_LOD_LEVELS];	// Worst height error at each level, in world units
+	bounds_t bounds;		// World space box
+	int level;				// Selected by terrainLodSelect()...
+	int visible;			// ...and whether it's in the view frustum
+} terrainchunk_t;
+
+// Where the terrain is drawn from and how much error is acceptable.
+typedef struct {
+	const GLfloat* modelview;	// Terrain to eye space, column-major
+	const GLfloat* projection;
+	int viewportHeight;			// Pixels
+	GLfloat maxPixelError;		// 0 draws everything at full resolution
+	GLenum fogMode;				// GL_EXP, GL_EXP2, GL_LINEAR, or 0 for no fog
+	GLfloat fogDensity;
+	GLfloat fogStart;
+	GLfloat fogEnd;
+	int noCulling;				// Non-zero to draw chunks outside the frustum too
+	const occlusion_t* occlusion;	// Depth to test chunks against, or NULL
+} terrainview_t;
+
+typedef struct {
+	int sizeX, sizeZ;			// Vertices
+	GLfloat originX, originZ;	// World position of vertex (0, 0)...
+	GLfloat spacing;			// ...and the distance between neighbouring vertices
+	int chunksX, chunksZ;
+	terrainchunk_t* chunks;		// chunksX * chunksZ, x major
+	bvh_t hierarchy;			// Over the chunks' bounds
+	unsigned char* inFrustum;	// Culling results, one per chunk
+
+	// The selection's triangles, indexing the caller's vertex grid.
+	GLuint* indices;
+	int indexCount;
+	int indexCapacity;
+	GLuint indexBuffer;			// Copy in a buffer object, when they're available
+	int selected;				// 0 until the first selection (or after a rebuild)
+
+	// Chunks at each level in the selection and left out of it (outside the
+	// frustum or hidden), and how many selections there have been and how
+	// many of them changed it, since terrainLodResetStats().
+	unsigned long levelChunks[TERRAIN_LOD_LEVELS];
+	unsigned long culledChunks;
+	unsigned long occludedChunks;
+	unsigned long selections;
+	unsigned long rebuilds;
+} terrainlod_t;
+
+// (Re)build the chunks for a sizeX by sizeZ grid of heights (height (x, z) is
+// the float heightStride bytes times x * sizeZ + z past heights) laid out from
+// (originX, originZ) spacing apart. Returns 0 if out of memory.
+int terrainLodBuild(terrainlod_t* lod, const GLfloat* heights, size_t heightStride, int sizeX, int sizeZ,
+	GLfloat originX, GLfloat originZ, GLfloat spacing);
+
+// Pick each chunk's level for a view, cull the chunks outside its frustum,
+// and rebuild the index list if either changed.
+void terrainLodSelect(terrainlod_t* lod, const terrainview_t* view);
+
+// Draw the selection from the full resolution vertices (in vertexBuffer, or
+// at vertices if it's 0) with the current matrices and state.
+void terrainLodDraw(const terrainlod_t* lod, const vertexformat_t* format, GLuint vertexBuffer, const void* vertices);
+
+// Triangles in the selection, and in the whole grid at full resolution.
+int terrainLodTriangles(const terrainlod_t* lod);
+int terrainLodFullTriangles(const terrainlod_t* lod);
+
+void terrainLodPrintStats(const terrainlod_t* lod);
+void terrainLodResetStats(terrainlod_t* lod);
+
+// Free a terrain's chunks, indices and buffer.
+void terrainLodFree(terrainlod_t* lod);
+
+// Build an N x N synthetic heightmap and time choosing and indexing its
+// chunks from a few viewpoints, printing triangle counts. Needs a current
+// context (for the matrices and index uploads).
+void terrainLodBenchmark(int size);
+
+#endif
@@ -0,0 +1,274 @@
+/******************************************************************************
+ *
+ * Terrain Normals (see terrainnormals.h)
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "terrainnormals.h"
+#include "terrainpager.h"
+#include "trace.h"
+
+// SSE2 is always there on x64 (and on x86 when MSVC is told to use it);
+// AVX would need the whole build to target it, which it doesn't.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TERRAIN_NORMALS_SSE
+#include <emmintrin.h>
+#endif
+
+static void storeNormal(GLfloat* normals, size_t normalStride, size_t index, GLfloat x, GLfloat y, GLfloat z)
+{
+	GLfloat* normal = (GLfloat*)((char*)normals + normalStride * index);
+	normal[0] = x;
+	normal[1] = y;
+	normal[2] = z;
+}
+
+// Vertices [firstZ, lastZ) of row x, one at a time, from the rows either
+// side of it in x (the row itself on the edges). The operations (and their
+// order) match the SSE loop's exactly.
+static void scalarRow(const GLfloat* leftRow, const GLfloat* row, const GLfloat* rightRow, GLfloat xScale, int sizeZ,
+	GLfloat spacing, int x, int firstZ, int lastZ, GLfloat* normals, size_t normalStride)
+{
+	for (int z = firstZ; z < lastZ; z++) {
+		int back = z > 0 ? z - 1 : z, front = z < sizeZ - 1 ? z + 1 : z;
+		GLfloat zScale = (front - back) * spacing;
+		GLfloat gx = xScale > 0.0f ? (rightRow[z] - leftRow[z]) / xScale : 0.0f;
+		GLfloat gz = zScale > 0.0f ? (row[front] - row[back]) / zScale : 0.0f;
+		GLfloat length = sqrtf(gx * gx + gz * gz + 1.0f);
+		storeNormal(normals, normalStride, (size_t)x * sizeZ + z, gx / length, -1.0f / length, gz / length);
+	}
+}
+
+#ifdef TERRAIN_NORMALS_SSE
+// Vertices [firstZ, lastZ) of row x, four at a time. Only for rows with a
+// neighbour on each side in x, and vertices with one each side in z.
+static int sseRow(const GLfloat* leftRow, const GLfloat* row, const GLfloat* rightRow, int sizeZ, GLfloat spacing,
+	int x, int firstZ, int lastZ, GLfloat* normals, size_t normalStride)
+{
+	const __m128 scale = _mm_set1_ps(2 * spacing);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 minusOne = _mm_set1_ps(-1.0f);
+	GLfloat nx[4], ny[4], nz[4];
+	int z = firstZ;
+
+	for (; z + 4 <= lastZ; z += 4) {
+		__m128 gx = _mm_div_ps(_mm_sub_ps(_mm_loadu_ps(rightRow + z), _mm_loadu_ps(leftRow + z)), scale);
+		__m128 gz = _mm_div_ps(_mm_sub_ps(_mm_loadu_ps(row + z + 1), _mm_loadu_ps(row + z - 1)), scale);
+		__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(gx, gx), _mm_mul_ps(gz, gz)), one));
+		_mm_storeu_ps(nx, _mm_div_ps(gx, length));
+		_mm_storeu_ps(ny, _mm_div_ps(minusOne, length));
+		_mm_storeu_ps(nz, _mm_div_ps(gz, length));
+		for (int i = 0; i < 4; i++) {
+			storeNormal(normals, normalStride, (size_t)x * sizeZ + z + i, nx[i], ny[i], nz[i]);
+		}
+	}
+	return z;
+}
+#endif
+
+// Heights that aren't packed together (interleaved with the rest of a vertex,
+// say) are gathered a row at a time into rows, which holds three: row x
+// goes in rows[x % 3], so the rows either side of it are there too.
+typedef struct {
+	const GLfloat* heights;
+	size_t stride;
+	int sizeZ;
+	int firstZ, lastZ;			// The part of each row that's needed
+	GLfloat* rows;				// NULL when the heights are packed
+	int held[3];				// The row in each of rows, or -1
+} heightrows_t;
+
+static const GLfloat* heightRow(heightrows_t* grid, int x)
+{
+	if (grid->rows == NULL) {
+		return grid->heights + (size_t)x * grid->sizeZ;
+	}
+
+	GLfloat* row = grid->rows + (size_t)(x % 3) * grid->sizeZ;
+	if (grid->held[x % 3] != x) {
+		const char* height = (const char*)grid->heights + ((size_t)x * grid->sizeZ + grid->firstZ) * grid->stride;
+		for (int z = grid->firstZ; z < grid->lastZ; z++, height += grid->stride) {
+			row[z] = *(const GLfloat*)height;
+		}
+		grid->held[x % 3] = x;
+	}
+	return row;
+}
+
+static int computeNormals(const GLfloat* heights, size_t heightStride, int sizeX, int sizeZ, GLfloat spacing,
+	int firstX, int firstZ, int lastX, int lastZ, GLfloat* normals, size_t normalStride, int simd)
+{
+	firstX = firstX < 0 ? 0 : firstX;
+	firstZ = firstZ < 0 ? 0 : firstZ;
+	lastX = lastX > sizeX ? sizeX : lastX;
+	lastZ = lastZ > sizeZ ? sizeZ : lastZ;
+	if (firstX >= lastX || firstZ >= lastZ) {
+		return 1;
+	}
+
+	heightrows_t grid = { heights, heightStride, sizeZ, firstZ > 0 ? firstZ - 1 : 0,
+		lastZ < sizeZ ? lastZ + 1 : sizeZ, NULL, { -1, -1, -1 } };
+	if (heightStride != sizeof(GLfloat)) {
+		grid.rows = malloc(sizeof(GLfloat) * 3 * sizeZ);
+		if (grid.rows == NULL) {
+			return 0;
+		}
+	}
+
+	for (int x = firstX; x < lastX; x++) {
+		int left = x > 0 ? x - 1 : x, right = x < sizeX - 1 ? x + 1 : x;
+		const GLfloat* leftRow = heightRow(&grid, left);
+		const GLfloat* row = heightRow(&grid, x);
+		const GLfloat* rightRow = heightRow(&grid, right);
+		int z = firstZ;
+#ifdef TERRAIN_NORMALS_SSE
+		if (simd && x > 0 && x < sizeX - 1) {
+			if (z == 0) {
+				scalarRow(leftRow, row, rightRow, (right - left) * spacing, sizeZ, spacing, x, 0, lastZ < 1 ? lastZ : 1,
+					normals, normalStride);
+				z = 1;
+			}
+			z = sseRow(leftRow, row, rightRow, sizeZ, spacing, x, z, lastZ < sizeZ - 1 ? lastZ : sizeZ - 1, normals,
+				normalStride);
+		}
+#else
+		(void)simd;
+#endif
+		scalarRow(leftRow, row, rightRow, (right - left) * spacing, sizeZ, spacing, x, z, lastZ, normals, normalStride);
+	}
+
+	free(grid.rows);
+	return 1;
+}
+
+int terrainNormals(const GLfloat* heights, size_t heightStride, int sizeX, int sizeZ, GLfloat spacing, int firstX,
+	int firstZ, int lastX, int lastZ, GLfloat* normals, size_t normalStride)
+{
+	tracezone_t traceZone = traceBegin("terrainNormals");
+	int ok = computeNormals(heights, heightStride, sizeX, sizeZ, spacing, firstX, firstZ, lastX, lastZ, normals,
+		normalStride, 1);
+	traceEnd(traceZone);
+	return ok;
+}
+
+int terrainNormalsHaveSimd(void)
+{
+#ifdef TERRAIN_NORMALS_SSE
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+/******************************************************************************
+ * Benchmark
+ ******************************************************************************/
+
+// What the terrain did before: each vertex gets the flat normal of the cell
+// it's the first corner of, from a cross product of the cell's edges.
+static void flatNormals(const GLfloat* heights, int sizeX, int sizeZ, GLfloat spacing, GLfloat* normals)
+{
+	for (int x = 0; x < sizeX; x++) {
+		for (int z = 0; z < sizeZ; z++) {
+			int cellX = x < sizeX - 1 ? x : x - 1;
+			int cellZ = z < sizeZ - 1 ? z : z - 1;
+			const GLfloat* cell = &heights[(size_t)cellX * sizeZ + cellZ];
+			GLfloat edge1[3] = { spacing, cell[sizeZ] - cell[0], 0 };
+			GLfloat edge2[3] = { 0, cell[1] - cell[0], spacing };
+			GLfloat* normal = &normals[((size_t)x * sizeZ + z) * 3];
+			normal[0] = edge1[1] * edge2[2] - edge1[2] * edge2[1];
+			normal[1] = edge1[2] * edge2[0] - edge1[0] * edge2[2];
+			normal[2] = edge1[0] * edge2[1] - edge1[1] * edge2[0];
+			GLfloat length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			normal[0] /= length;
+			normal[1] /= length;
+			normal[2] /= length;
+		}
+	}
+}
+
+void terrainNormalsBenchmark(void)
+{
+	static const int sizes[] = { 200, 2048, 8192 };
+	const int region = TERRAIN_TILE_CELLS + 1;
+
+	printf("Smooth terrain normals: %s\n", terrainNormalsHaveSimd() ? "SSE" : "scalar only (no SIMD in this build)");
+	printf("%-10s %12s %12s %12s %8s %12s %10s\n", "grid", "flat ms", "scalar ms", "simd ms", "speedup",
+		"region ms", "results");
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+		int size = sizes[s];
+		size_t count = (size_t)size * size;
+		GLfloat* heights = malloc(sizeof(GLfloat) * count);
+		GLfloat* scalar = malloc(sizeof(GLfloat) * 3 * count);
+		GLfloat* simd = malloc(sizeof(GLfloat) * 3 * count);
+		if (heights == NULL || scalar == NULL || simd == NULL) {
+			printf("%dx%-5d out of memory\n", size, size);
+			free(heights);
+			free(scalar);
+			free(simd);
+			continue;
+		}
+		for (int x = 0; x < size; x++) {
+			for (int z = 0; z < size; z++) {
+				heights[(size_t)x * size + z] = terrainSyntheticHeight(NULL, x, z);
+			}
+		}
+
+		// Touch the outputs first, so the first pass doesn't pay for faulting them in.
+		memset(scalar, 0, sizeof(GLfloat) * 3 * count);
+		memset(simd, 0, sizeof(GLfloat) * 3 * count);
+
+		// About 16 million vertices' worth of each per round, so the small grid
+		// isn't all timer noise, and the best of a few rounds, taking turns.
+		int repeats = (int)((1 << 24) / count);
+		repeats = repeats < 1 ? 1 : repeats;
+		double flat = 0.0, scalarMs = 0.0, simdMs = 0.0;
+		for (int round = 0; round < 3; round++) {
+			double start = platformTimeSeconds();
+			for (int n = 0; n < repeats; n++) {
+				flatNormals(heights, size, size, 1.0f, scalar);
+			}
+			double elapsed = (platformTimeSeconds() - start) * 1000.0 / repeats;
+			flat = round == 0 || elapsed < flat ? elapsed : flat;
+
+			start = platformTimeSeconds();
+			for (int n = 0; n < repeats; n++) {
+				computeNormals(heights, sizeof(GLfloat), size, size, 1.0f, 0, 0, size, size, scalar, sizeof(GLfloat) * 3,
+					0);
+			}
+			elapsed = (platformTimeSeconds() - start) * 1000.0 / repeats;
+			scalarMs = round == 0 || elapsed < scalarMs ? elapsed : scalarMs;
+
+			start = platformTimeSeconds();
+			for (int n = 0; n < repeats; n++) {
+				computeNormals(heights, sizeof(GLfloat), size, size, 1.0f, 0, 0, size, size, simd, sizeof(GLfloat) * 3,
+					1);
+			}
+			elapsed = (platformTimeSeconds() - start) * 1000.0 / repeats;
+			simdMs = round == 0 || elapsed < simdMs ? elapsed : simdMs;
+		}
+		int identical = memcmp(scalar, simd, sizeof(GLfloat) * 3 * count) == 0;
+
+		// A tile's worth of changed heights in the middle, grown by a vertex each way.
+		int first = size / 2 - region / 2 - 1;
+		int regionRepeats = 200;
+		double start = platformTimeSeconds();
+		for (int n = 0; n < regionRepeats; n++) {
+			terrainNormals(heights, sizeof(GLfloat), size, size, 1.0f, first, first, first + region + 2,
+				first + region + 2, simd, sizeof(GLfloat) * 3);
+		}
+		double regionMs = (platformTimeSeconds() - start) * 1000.0 / regionRepeats;
+
+		printf("%5dx%-5d %12.3f %12.3f %12.3f %7.2fx %12.3f %10s\n", size, size, flat, scalarMs, simdMs,
+			scalarMs / simdMs, regionMs, identical ? "identical" : "DIFFER");
+
+		free(heights);
+		free(scalar);
+		free(simd);
+	}
+}
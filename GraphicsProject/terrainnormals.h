@@ -0,0 +1,44 @@
+/******************************************************************************
+ *
+ * Terrain Normals
+ *
+ * Smooth per-vertex normals for a regular height grid, from the central
+ * differences of each vertex's neighbours (one-sided on the edges). Rows are
+ * processed four vertices at a time with SSE where the compiler targets it,
+ * with a scalar loop otherwise and for the ends of rows; both give the same
+ * results to the bit, as they do the same correctly rounded operations.
+ *
+ * Normals can be recomputed for just a rectangle of the grid. A height
+ * change moves the normals of its own vertex and the four next to it, so a
+ * caller tracking the rectangle of changed heights grows it by one vertex
+ * each way before passing it in.
+ *
+ ******************************************************************************/
+
+#ifndef TERRAINNORMALS_H
+#define TERRAINNORMALS_H
+
+#include <freeglut.h>
+#include <stddef.h>
+
+// Write the normals of vertices [firstX, lastX) x [firstZ, lastZ) of a sizeX
+// by sizeZ grid of heights spacing apart (vertex (x, z)'s height is the float
+// heightStride * (x * sizeZ + z) bytes into heights). Vertex (x, z)'s normal
+// goes to the three floats normalStride * (x * sizeZ + z) bytes into normals,
+// so both can be interleaved vertices. Heights that aren't packed are
+// gathered three rows at a time; returns 0 if there's no memory for them.
+//
+// The normals point down, (dh/dx, -1, dh/dz) normalised, as the scene's
+// terrain normals always have; its lighting is set up for them.
+int terrainNormals(const GLfloat* heights, size_t heightStride, int sizeX, int sizeZ, GLfloat spacing, int firstX,
+	int firstZ, int lastX, int lastZ, GLfloat* normals, size_t normalStride);
+
+// Non-zero when terrainNormals() has a SIMD path in this build.
+int terrainNormalsHaveSimd(void);
+
+// Time the per-cell flat normals this replaces against the scalar and SIMD
+// smooth normals, and a dirty region update, on 200x200, 2048x2048 and
+// 8192x8192 grids; the results go to stdout.
+void terrainNormalsBenchmark(void);
+
+#endif
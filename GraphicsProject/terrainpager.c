@@ -0,0 +1,597 @@
+/******************************************************************************
+ *
+ * Terrain Paging (see terrainpager.h)
+ *
+ ******************************************************************************/
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "heightfield.h"
+#include "platform.h"
+#include "terrainpager.h"
+#include "trace.h"
+
+#define TILE_FILE_MAGIC "GPTILES2"
+
+// Most cells along the side of a tile a file may have, which keeps a tile's size well within an int.
+#define TILE_MAX_CELLS 4096
+
+// Where a tile is.
+#define TILE_ABSENT		0
+#define TILE_LOADING	1
+#define TILE_RESIDENT	2
+
+typedef struct {
+	char magic[8];
+	int sizeX, sizeZ;			// Vertices
+	int tileCells;				// Cells along the side of a tile (a tile holds tileCells + 1 squared heights)
+	int overviewStep;			// Vertices between overview heights
+	float originX, originZ;
+	float spacing;
+	int tilesX, tilesZ;
+	int overviewX, overviewZ;	// Overview heights along each side
+	float overviewScale;		// The overview's heights are quantized times this...
+	float overviewOffset;		// ...plus this (see heightfield.h)
+} tileheader_t;
+
+// Each tile in the file is its range, then its heights quantized over it.
+typedef struct {
+	float scale, offset;
+} tilerange_t;
+
+typedef struct {
+	int state;					// TILE_ value
+	int slot;					// Where it's held, unless it's absent
+	unsigned int wanted;		// The last update that wanted it
+} tile_t;
+
+typedef struct {
+	tilerange_t* data;			// The tile as it is in the file; allocated the first time the slot's used
+	int tile;					// -1 when free
+} slot_t;
+
+typedef struct {
+	int tile;
+	int slot;
+	int ok;
+	double milliseconds;
+} tileload_t;
+
+typedef struct {
+	int tile;
+	GLfloat distance;
+} wantedtile_t;
+
+struct terrainpager_s {
+	tileheader_t header;
+	unsigned short* overview;
+	size_t tileBytes;
+	unsigned long long tilesOffset;	// Where the first tile starts in the file
+	tile_t* tiles;
+	slot_t* slots;
+	int slotCount;
+	wantedtile_t* wanted;		// Scratch for terrainPagerUpdate()
+	unsigned int updates;
+	unsigned int generation;
+	terrainpagerstats_t stats;
+
+	// Shared with the loader thread, under the mutex.
+	FILE* file;					// Only read by the loader thread
+	platformthread_t* thread;
+	platformmutex_t* mutex;
+	platformcondition_t* wake;
+	tileload_t queued[TERRAIN_PAGER_MAX_LOADS];
+	int queuedHead;
+	int queuedCount;
+	tileload_t completed[TERRAIN_PAGER_MAX_LOADS];
+	int completedCount;
+	int stopping;
+};
+
+static int clampInt(int value, int low, int high)
+{
+	return value < low ? low : value > high ? high : value;
+}
+
+// Tiles of cells cells, and overview heights step vertices apart, covering size vertices.
+static int tilesAlong(int size, int cells)
+{
+	return (size - 2) / cells + 1;
+}
+
+static int overviewAlong(int size, int step)
+{
+	return (size - 2) / step + 2;
+}
+
+/******************************************************************************
+ * Writing
+ ******************************************************************************/
+
+int terrainTilesWrite(const char* path, int sizeX, int sizeZ, GLfloat originX, GLfloat originZ, GLfloat spacing,
+	terrainheightfunc_t height, void* context)
+{
+	tileheader_t header = { 0 };
+	int cells = TERRAIN_TILE_CELLS, step = TERRAIN_OVERVIEW_STEP;
+
+	if (sizeX < 2 || sizeZ < 2) {
+		return 0;
+	}
+	memcpy(header.magic, TILE_FILE_MAGIC, sizeof(header.magic));
+	header.sizeX = sizeX;
+	header.sizeZ = sizeZ;
+	header.tileCells = cells;
+	header.overviewStep = step;
+	header.originX = originX;
+	header.originZ = originZ;
+	header.spacing = spacing;
+	header.tilesX = tilesAlong(sizeX, cells);
+	header.tilesZ = tilesAlong(sizeZ, cells);
+	header.overviewX = overviewAlong(sizeX, step);
+	header.overviewZ = overviewAlong(sizeZ, step);
+
+	FILE* file = platformOpenFile(path, "wb");
+	if (file == NULL) {
+		return 0;
+	}
+
+	// The overview's range takes a pass of its own; it's a small fraction of the heights.
+	heightfield_t range = { 0 };
+	GLfloat low = height(context, 0, 0), high = low;
+	for (int i = 0; i < header.overviewX; i++) {
+		for (int j = 0; j < header.overviewZ; j++) {
+			GLfloat value = height(context, clampInt(i * step, 0, sizeX - 1), clampInt(j * step, 0, sizeZ - 1));
+			low = value < low ? value : low;
+			high = value > high ? value : high;
+		}
+	}
+	heightfieldSetRange(&range, low, high);
+	header.overviewScale = range.scale;
+	header.overviewOffset = range.offset;
+
+	// One row of the overview, then one tile, at a time.
+	size_t tileHeights = (size_t)(cells + 1) * (cells + 1);
+	size_t rowFloats = (size_t)header.overviewZ > tileHeights ? (size_t)header.overviewZ : tileHeights;
+	GLfloat* buffer = malloc(sizeof(GLfloat) * rowFloats);
+	unsigned short* quantized = malloc(sizeof(unsigned short) * rowFloats);
+	int ok = buffer != NULL && quantized != NULL && fwrite(&header, sizeof(header), 1, file) == 1;
+
+	for (int i = 0; ok && i < header.overviewX; i++) {
+		for (int j = 0; j < header.overviewZ; j++) {
+			quantized[j] = heightfieldQuantize(&range,
+				height(context, clampInt(i * step, 0, sizeX - 1), clampInt(j * step, 0, sizeZ - 1)));
+		}
+		ok = fwrite(quantized, sizeof(unsigned short), header.overviewZ, file) == (size_t)header.overviewZ;
+	}
+	for (int tx = 0; ok && tx < header.tilesX; tx++) {
+		for (int tz = 0; ok && tz < header.tilesZ; tz++) {
+			for (int a = 0; a <= cells; a++) {
+				for (int b = 0; b <= cells; b++) {
+					buffer[a * (cells + 1) + b] = height(context, clampInt(tx * cells + a, 0, sizeX - 1),
+						clampInt(tz * cells + b, 0, sizeZ - 1));
+				}
+			}
+
+			// Each tile over its own range, which is usually far narrower than the world's.
+			low = high = buffer[0];
+			for (size_t i = 1; i < tileHeights; i++) {
+				low = buffer[i] < low ? buffer[i] : low;
+				high = buffer[i] > high ? buffer[i] : high;
+			}
+			heightfieldSetRange(&range, low, high);
+			for (size_t i = 0; i < tileHeights; i++) {
+				quantized[i] = heightfieldQuantize(&range, buffer[i]);
+			}
+			tilerange_t tileRange = { range.scale, range.offset };
+			ok = fwrite(&tileRange, sizeof(tileRange), 1, file) == 1 &&
+				fwrite(quantized, sizeof(unsigned short), tileHeights, file) == tileHeights;
+		}
+	}
+
+	free(buffer);
+	free(quantized);
+	if (fclose(file) != 0) {
+		ok = 0;
+	}
+	return ok;
+}
+
+GLfloat terrainSyntheticHeight(void* context, int x, int z)
+{
+	unsigned int hash = (unsigned int)x * 73856093u ^ (unsigned int)z * 19349663u;
+	hash = (hash ^ (hash >> 13)) * 1274126177u;
+	(void)context;
+	return 20.0f + 12.0f * sinf(x * 0.013f) * cosf(z * 0.011f) + 5.0f * sinf(x * 0.071f + z * 0.053f) +
+		1.5f * sinf((x - z) * 0.29f) + 0.2f * (hash >> 24) / 255.0f;
+}
+
+/******************************************************************************
+ * Loader Thread
+ ******************************************************************************/
+
+static void loaderMain(void* argument)
+{
+	terrainpager_t* pager = argument;
+	traceSetThreadName("terrain pager");
+
+	platformMutexLock(pager->mutex);
+	for (;;) {
+		while (pager->queuedCount == 0 && !pager->stopping) {
+			platformConditionWait(pager->wake, pager->mutex);
+		}
+		if (pager->stopping) {
+			break;
+		}
+		tileload_t load = pager->queued[pager->queuedHead];
+		pager->queuedHead = (pager->queuedHead + 1) % TERRAIN_PAGER_MAX_LOADS;
+		pager->queuedCount--;
+		platformMutexUnlock(pager->mutex);
+
+		tracezone_t traceZone = traceBegin("loadTerrainTile");
+		double start = platformTimeSeconds();
+		load.ok = platformReadFileAt(pager->file, pager->tilesOffset + (unsigned long long)load.tile * pager->tileBytes,
+			pager->slots[load.slot].data, pager->tileBytes);
+		load.milliseconds = (platformTimeSeconds() - start) * 1000.0;
+		traceEnd(traceZone);
+
+		platformMutexLock(pager->mutex);
+		pager->completed[pager->completedCount++] = load;
+	}
+	platformMutexUnlock(pager->mutex);
+}
+
+/******************************************************************************
+ * Opening and Closing
+ ******************************************************************************/
+
+// Whether a header read from a file of fileSize bytes describes the file
+// terrainTilesWrite() would have written: everything the pager sizes its
+// allocations and reads from has to agree with the world's size.
+static int headerValid(const tileheader_t* header, unsigned long long fileSize)
+{
+	if (memcmp(header->magic, TILE_FILE_MAGIC, sizeof(header->magic)) != 0 || header->sizeX < 2 || header->sizeZ < 2 ||
+		header->tileCells < 1 || header->tileCells > TILE_MAX_CELLS || header->overviewStep < 1 ||
+		!(header->spacing > 0.0f) || header->tilesX != tilesAlong(header->sizeX, header->tileCells) ||
+		header->tilesZ != tilesAlong(header->sizeZ, header->tileCells) ||
+		header->overviewX != overviewAlong(header->sizeX, header->overviewStep) ||
+		header->overviewZ != overviewAlong(header->sizeZ, header->overviewStep) ||
+		(long long)header->tilesX * header->tilesZ > INT_MAX) {
+		return 0;
+	}
+
+	unsigned long long tileBytes = sizeof(tilerange_t) +
+		sizeof(unsigned short) * (unsigned long long)(header->tileCells + 1) * (header->tileCells + 1);
+	unsigned long long expected = sizeof(tileheader_t) +
+		sizeof(unsigned short) * (unsigned long long)header->overviewX * header->overviewZ +
+		tileBytes * header->tilesX * header->tilesZ;
+	return fileSize == expected;
+}
+
+terrainpager_t* terrainPagerOpen(const char* path, size_t budgetBytes)
+{
+	terrainpager_t* pager = calloc(1, sizeof(terrainpager_t));
+	if (pager == NULL) {
+		return NULL;
+	}
+
+	unsigned long long fileSize = 0;
+	long long modified;
+	pager->file = platformOpenFile(path, "rb");
+	if (pager->file == NULL || !platformFileStamp(path, &fileSize, &modified) ||
+		fread(&pager->header, sizeof(tileheader_t), 1, pager->file) != 1 || !headerValid(&pager->header, fileSize)) {
+		printf("%s isn't a terrain tile file\n", path);
+		terrainPagerClose(pager);
+		return NULL;
+	}
+
+	const tileheader_t* header = &pager->header;
+	size_t overviewCount = (size_t)header->overviewX * header->overviewZ;
+	int tileCount = header->tilesX * header->tilesZ;
+	pager->tileBytes = sizeof(tilerange_t) + sizeof(unsigned short) * (header->tileCells + 1) * (header->tileCells + 1);
+	pager->tilesOffset = sizeof(tileheader_t) + sizeof(unsigned short) * overviewCount;
+
+	// The overview always stays; the rest of the budget is tiles.
+	size_t overviewBytes = sizeof(unsigned short) * overviewCount;
+	pager->slotCount = budgetBytes > overviewBytes ? (int)((budgetBytes - overviewBytes) / pager->tileBytes) : 0;
+	pager->slotCount = clampInt(pager->slotCount, 1, tileCount);
+	pager->stats.budgetBytes = budgetBytes;
+	pager->stats.budgetTiles = pager->slotCount;
+
+	pager->overview = malloc(overviewBytes);
+	pager->tiles = calloc(tileCount, sizeof(tile_t));
+	pager->slots = calloc(pager->slotCount, sizeof(slot_t));
+	pager->wanted = malloc(sizeof(wantedtile_t) * tileCount);
+	if (pager->overview == NULL || pager->tiles == NULL || pager->slots == NULL || pager->wanted == NULL) {
+		printf("Out of memory opening %s\n", path);
+		terrainPagerClose(pager);
+		return NULL;
+	}
+	if (fread(pager->overview, sizeof(unsigned short), overviewCount, pager->file) != overviewCount) {
+		printf("%s is truncated\n", path);
+		terrainPagerClose(pager);
+		return NULL;
+	}
+	for (int i = 0; i < pager->slotCount; i++) {
+		pager->slots[i].tile = -1;
+	}
+
+	pager->mutex = platformMutexCreate();
+	pager->wake = platformConditionCreate();
+	pager->thread = platformThreadCreate(loaderMain, pager);
+	if (pager->thread == NULL) {
+		printf("Couldn't start the terrain pager's thread\n");
+		terrainPagerClose(pager);
+		return NULL;
+	}
+	return pager;
+}
+
+void terrainPagerClose(terrainpager_t* pager)
+{
+	if (pager == NULL) {
+		return;
+	}
+
+	if (pager->thread != NULL) {
+		platformMutexLock(pager->mutex);
+		pager->stopping = 1;
+		platformConditionBroadcast(pager->wake);
+		platformMutexUnlock(pager->mutex);
+		platformThreadJoin(pager->thread);
+	}
+	if (pager->wake != NULL) {
+		platformConditionDestroy(pager->wake);
+	}
+	if (pager->mutex != NULL) {
+		platformMutexDestroy(pager->mutex);
+	}
+	if (pager->file != NULL) {
+		fclose(pager->file);
+	}
+	for (int i = 0; pager->slots != NULL && i < pager->slotCount; i++) {
+		free(pager->slots[i].data);
+	}
+	free(pager->slots);
+	free(pager->tiles);
+	free(pager->wanted);
+	free(pager->overview);
+	free(pager);
+}
+
+void terrainPagerGetExtent(const terrainpager_t* pager, int* sizeX, int* sizeZ, GLfloat* originX, GLfloat* originZ,
+	GLfloat* spacing)
+{
+	*sizeX = pager->header.sizeX;
+	*sizeZ = pager->header.sizeZ;
+	*originX = pager->header.originX;
+	*originZ = pager->header.originZ;
+	*spacing = pager->header.spacing;
+}
+
+/******************************************************************************
+ * Paging
+ ******************************************************************************/
+
+// Take in the loads the loader thread has finished.
+static void takeCompleted(terrainpager_t* pager)
+{
+	tileload_t completed[TERRAIN_PAGER_MAX_LOADS];
+
+	platformMutexLock(pager->mutex);
+	int count = pager->completedCount;
+	memcpy(completed, pager->completed, sizeof(tileload_t) * count);
+	pager->completedCount = 0;
+	platformMutexUnlock(pager->mutex);
+
+	for (int i = 0; i < count; i++) {
+		tile_t* tile = &pager->tiles[completed[i].tile];
+		pager->stats.pendingLoads--;
+		pager->stats.loadMilliseconds += completed[i].milliseconds;
+		if (completed[i].ok) {
+			tile->state = TILE_RESIDENT;
+			pager->stats.loads++;
+			pager->generation++;
+		}
+		else {
+			tile->state = TILE_ABSENT;
+			pager->slots[completed[i].slot].tile = -1;
+			pager->stats.failedLoads++;
+		}
+	}
+}
+
+// Distance from (x, z) to the nearest point of a tile.
+static GLfloat tileDistance(const terrainpager_t* pager, int index, GLfloat x, GLfloat z)
+{
+	const tileheader_t* header = &pager->header;
+	GLfloat size = header->tileCells * header->spacing;
+	GLfloat left = header->originX + (index / header->tilesZ) * size;
+	GLfloat top = header->originZ + (index % header->tilesZ) * size;
+	GLfloat dx = x < left ? left - x : x > left + size ? x - left - size : 0.0f;
+	GLfloat dz = z < top ? top - z : z > top + size ? z - top - size : 0.0f;
+	return sqrtf(dx * dx + dz * dz);
+}
+
+static int compareWanted(const void* a, const void* b)
+{
+	GLfloat first = ((const wantedtile_t*)a)->distance, second = ((const wantedtile_t*)b)->distance;
+	return first < second ? -1 : first > second ? 1 : 0;
+}
+
+// A slot for a new tile: a free one, or the one holding the tile furthest
+// from (x, z) that this update doesn't want. Returns -1 if there's none.
+static int claimSlot(terrainpager_t* pager, GLfloat x, GLfloat z)
+{
+	int furthest = -1;
+	GLfloat furthestDistance = -1.0f;
+
+	for (int i = 0; i < pager->slotCount; i++) {
+		int tile = pager->slots[i].tile;
+		if (tile < 0) {
+			return i;
+		}
+		if (pager->tiles[tile].state == TILE_RESIDENT && pager->tiles[tile].wanted != pager->updates) {
+			GLfloat distance = tileDistance(pager, tile, x, z);
+			if (distance > furthestDistance) {
+				furthest = i;
+				furthestDistance = distance;
+			}
+		}
+	}
+	if (furthest >= 0) {
+		tile_t* evicted = &pager->tiles[pager->slots[furthest].tile];
+		evicted->state = TILE_ABSENT;
+		pager->slots[furthest].tile = -1;
+		pager->stats.evictions++;
+		pager->generation++;
+	}
+	return furthest;
+}
+
+void terrainPagerUpdate(terrainpager_t* pager, GLfloat x, GLfloat z, GLfloat radius)
+{
+	tracezone_t traceZone = traceBegin("terrainPagerUpdate");
+	const tileheader_t* header = &pager->header;
+	GLfloat size = header->tileCells * header->spacing;
+
+	takeCompleted(pager);
+	pager->updates++;
+
+	// The tiles within the radius, nearest first, as many as fit.
+	int firstX = clampInt((int)floorf((x - radius - header->originX) / size), 0, header->tilesX - 1);
+	int lastX = clampInt((int)floorf((x + radius - header->originX) / size), 0, header->tilesX - 1);
+	int firstZ = clampInt((int)floorf((z - radius - header->originZ) / size), 0, header->tilesZ - 1);
+	int lastZ = clampInt((int)floorf((z + radius - header->originZ) / size), 0, header->tilesZ - 1);
+	int wantedCount = 0;
+	for (int tx = firstX; tx <= lastX; tx++) {
+		for (int tz = firstZ; tz <= lastZ; tz++) {
+			int index = tx * header->tilesZ + tz;
+			GLfloat distance = tileDistance(pager, index, x, z);
+			if (distance <= radius) {
+				pager->wanted[wantedCount++] = (wantedtile_t){ index, distance };
+			}
+		}
+	}
+	qsort(pager->wanted, wantedCount, sizeof(wantedtile_t), compareWanted);
+	if (wantedCount > pager->slotCount) {
+		wantedCount = pager->slotCount;
+	}
+	for (int i = 0; i < wantedCount; i++) {
+		pager->tiles[pager->wanted[i].tile].wanted = pager->updates;
+	}
+
+	for (int i = 0; i < wantedCount && pager->stats.pendingLoads < TERRAIN_PAGER_MAX_LOADS; i++) {
+		int index = pager->wanted[i].tile;
+		if (pager->tiles[index].state != TILE_ABSENT) {
+			continue;
+		}
+
+		int slot = claimSlot(pager, x, z);
+		if (slot < 0) {
+			break;
+		}
+		if (pager->slots[slot].data == NULL) {
+			pager->slots[slot].data = malloc(pager->tileBytes);
+			if (pager->slots[slot].data == NULL) {
+				break;
+			}
+		}
+		pager->slots[slot].tile = index;
+		pager->tiles[index].state = TILE_LOADING;
+		pager->tiles[index].slot = slot;
+		pager->stats.pendingLoads++;
+
+		platformMutexLock(pager->mutex);
+		pager->queued[(pager->queuedHead + pager->queuedCount) % TERRAIN_PAGER_MAX_LOADS] =
+			(tileload_t){ index, slot, 0, 0.0 };
+		pager->queuedCount++;
+		platformConditionSignal(pager->wake);
+		platformMutexUnlock(pager->mutex);
+	}
+	traceEnd(traceZone);
+}
+
+unsigned int terrainPagerGeneration(const terrainpager_t* pager)
+{
+	return pager->generation;
+}
+
+/******************************************************************************
+ * Queries and Stats
+ ******************************************************************************/
+
+// Interpolate between the four quantized heights around (fx, fz) in a grid
+// whose rows are stride heights apart, in quantized steps as heightfield.c
+// does, scaling once at the end.
+static GLfloat bilinear(const unsigned short* grid, GLfloat scale, GLfloat offset, int stride, int x, int z, GLfloat fx,
+	GLfloat fz)
+{
+	const unsigned short* row = grid + (size_t)x * stride + z;
+	GLfloat near = row[0] + (row[1] - row[0]) * fz;
+	GLfloat far = row[stride] + (row[stride + 1] - row[stride]) * fz;
+	return (near + (far - near) * fx) * scale + offset;
+}
+
+GLfloat terrainPagerHeight(terrainpager_t* pager, GLfloat x, GLfloat z)
+{
+	const tileheader_t* header = &pager->header;
+	GLfloat gx = (x - header->originX) / header->spacing;
+	GLfloat gz = (z - header->originZ) / header->spacing;
+	gx = gx < 0.0f ? 0.0f : gx > header->sizeX - 1 ? (GLfloat)(header->sizeX - 1) : gx;
+	gz = gz < 0.0f ? 0.0f : gz > header->sizeZ - 1 ? (GLfloat)(header->sizeZ - 1) : gz;
+
+	int cellX = clampInt((int)gx, 0, header->sizeX - 2);
+	int cellZ = clampInt((int)gz, 0, header->sizeZ - 2);
+	int tileX = clampInt(cellX / header->tileCells, 0, header->tilesX - 1);
+	int tileZ = clampInt(cellZ / header->tileCells, 0, header->tilesZ - 1);
+	const tile_t* tile = &pager->tiles[tileX * header->tilesZ + tileZ];
+
+	pager->stats.queries++;
+	if (tile->state == TILE_RESIDENT) {
+		const tilerange_t* range = pager->slots[tile->slot].data;
+		return bilinear((const unsigned short*)(range + 1), range->scale, range->offset, header->tileCells + 1,
+			cellX - tileX * header->tileCells, cellZ - tileZ * header->tileCells, gx - cellX, gz - cellZ);
+	}
+
+	// The overview's last interval can be short, where the world's size isn't a multiple of its step.
+	pager->stats.misses++;
+	int step = header->overviewStep;
+	int overviewX = clampInt((int)(gx / step), 0, header->overviewX - 2);
+	int overviewZ = clampInt((int)(gz / step), 0, header->overviewZ - 2);
+	int nextX = clampInt((overviewX + 1) * step, 0, header->sizeX - 1);
+	int nextZ = clampInt((overviewZ + 1) * step, 0, header->sizeZ - 1);
+	GLfloat fx = (gx - overviewX * step) / (nextX - overviewX * step);
+	GLfloat fz = (gz - overviewZ * step) / (nextZ - overviewZ * step);
+	return bilinear(pager->overview, header->overviewScale, header->overviewOffset, header->overviewZ, overviewX,
+		overviewZ, fx, fz);
+}
+
+void terrainPagerGetStats(const terrainpager_t* pager, terrainpagerstats_t* stats)
+{
+	*stats = pager->stats;
+	stats->residentTiles = 0;
+	for (int i = 0; i < pager->slotCount; i++) {
+		int tile = pager->slots[i].tile;
+		if (tile >= 0 && pager->tiles[tile].state == TILE_RESIDENT) {
+			stats->residentTiles++;
+		}
+	}
+	stats->residentBytes = sizeof(unsigned short) * pager->header.overviewX * pager->header.overviewZ +
+		stats->residentTiles * pager->tileBytes;
+}
+
+void terrainPagerPrintStats(const terrainpager_t* pager)
+{
+	terrainpagerstats_t stats;
+	terrainPagerGetStats(pager, &stats);
+
+	printf("Terrain pager: %d of %d tiles resident (%.1f of %.1f MB), %d loading; %lu loads (%lu failed, %.2f ms mean), "
+		"%lu evictions; %lu of %lu height queries fell back to the overview\n",
+		stats.residentTiles, stats.budgetTiles, stats.residentBytes / 1048576.0, stats.budgetBytes / 1048576.0,
+		stats.pendingLoads, stats.loads, stats.failedLoads,
+		stats.loads + stats.failedLoads > 0 ? stats.loadMilliseconds / (stats.loads + stats.failedLoads) : 0.0,
+		stats.evictions, stats.misses, stats.queries);
+}
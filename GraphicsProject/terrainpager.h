@@ -0,0 +1,92 @@
+/******************************************************************************
+ *
+ * Terrain Paging
+ *
+ * Worlds too big to keep in memory are stored as a tile file, written by
+ * terrainTilesWrite(): a header, a coarse overview of the whole world (every
+ * overviewStep-th height) and then the full resolution heights cut into
+ * square tiles. The overview and each tile are quantized to 16 bits a height
+ * over their own range, as heightfield.h describes. A pager keeps the
+ * overview resident and streams the tiles around a point of interest in on a
+ * thread of its own, nearest first, into a fixed memory budget, evicting the
+ * tiles furthest away when it needs room.
+ *
+ * Height queries never wait for a tile: where the one they need isn't in
+ * memory they're answered from the overview, and counted as misses in the
+ * stats. The pager is driven (terrainPagerUpdate()) and queried from one
+ * thread; only the file reads happen on its own.
+ *
+ ******************************************************************************/
+
+#ifndef TERRAINPAGER_H
+#define TERRAINPAGER_H
+
+#include <freeglut.h>
+#include <stddef.h>
+
+// Cells along the side of a tile, and how far apart overview heights are, by default.
+#define TERRAIN_TILE_CELLS		128
+#define TERRAIN_OVERVIEW_STEP	16
+
+// Most tile reads waiting for the loader thread at once.
+#define TERRAIN_PAGER_MAX_LOADS	8
+
+// Supplies height (x, z) of a sizeX by sizeZ grid to terrainTilesWrite().
+typedef GLfloat (*terrainheightfunc_t)(void* context, int x, int z);
+
+typedef struct {
+	int residentTiles;			// Tiles in memory...
+	int budgetTiles;			// ...and the most that fit in the budget
+	size_t residentBytes;		// Tiles plus the overview
+	size_t budgetBytes;
+	int pendingLoads;			// Reads queued or in progress
+	unsigned long loads;		// Tiles read since the pager was opened
+	unsigned long failedLoads;
+	unsigned long evictions;
+	unsigned long queries;		// Height queries...
+	unsigned long misses;		// ...answered from the overview because their tile wasn't in memory
+	double loadMilliseconds;	// Total time spent reading tiles (on the loader thread)
+} terrainpagerstats_t;
+
+typedef struct terrainpager_s terrainpager_t;
+
+// Write a sizeX by sizeZ grid of heights, spacing apart with vertex (0, 0)
+// at (originX, originZ), as a tile file. Heights are asked for a tile at a
+// time, so the grid never has to be in memory. Returns 0 on failure.
+int terrainTilesWrite(const char* path, int sizeX, int sizeZ, GLfloat originX, GLfloat originZ, GLfloat spacing,
+	terrainheightfunc_t height, void* context);
+
+// Open a tile file and start paging it within budgetBytes (which always
+// holds the overview and at least one tile). Returns NULL, with a message on
+// stdout, if the file can't be used.
+terrainpager_t* terrainPagerOpen(const char* path, size_t budgetBytes);
+
+// Stop the loader thread and free everything.
+void terrainPagerClose(terrainpager_t* pager);
+
+// The world's extent: vertices, the position of vertex (0, 0) and the distance between vertices.
+void terrainPagerGetExtent(const terrainpager_t* pager, int* sizeX, int* sizeZ, GLfloat* originX, GLfloat* originZ,
+	GLfloat* spacing);
+
+// Take in the tiles that have finished loading, then queue loads (nearest
+// first) for the tiles within radius of (x, z) that aren't in memory,
+// evicting the ones furthest away if the budget is full. Never blocks on I/O.
+void terrainPagerUpdate(terrainpager_t* pager, GLfloat x, GLfloat z, GLfloat radius);
+
+// Counts up whenever tiles come into or leave memory, so anything built from
+// the heights knows to rebuild.
+unsigned int terrainPagerGeneration(const terrainpager_t* pager);
+
+// Height of the world at (x, z), interpolated between the nearest heights
+// (full resolution if their tile is in memory, otherwise the overview's) and
+// clamped to the edges.
+GLfloat terrainPagerHeight(terrainpager_t* pager, GLfloat x, GLfloat z);
+
+void terrainPagerGetStats(const terrainpager_t* pager, terrainpagerstats_t* stats);
+void terrainPagerPrintStats(const terrainpager_t* pager);
+
+// Rolling hills with some detail on top, about the height range of
+// terrain.ppm, for test worlds of any size.
+GLfloat terrainSyntheticHeight(void* context, int x, int z);
+
+#endif
@@ -0,0 +1,125 @@
+/******************************************************************************
+ *
+ * Texture Manager (see textures.h)
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "glfuncs.h"
+#include "platform.h"
+#include "glstats.h"
+#include "glstate.h"
+#include "textures.h"
+
+typedef struct {
+	GLuint name;					// GL texture object (0 if the slot is free)
+	char label[32];					// For stats output
+	int width;
+	int height;
+	unsigned long long bytes;
+} texture_t;
+
+static texture_t textures[TEXTURE_MAX];
+static unsigned long uploads = 0;
+
+static texture_t* lookup(texturehandle_t handle)
+{
+	if (handle <= 0 || handle > TEXTURE_MAX || textures[handle - 1].name == 0) {
+		return NULL;
+	}
+	return &textures[handle - 1];
+}
+
+texturehandle_t textureUpload(texturehandle_t handle, const char* name, int width, int height, const unsigned char* rgb)
+{
+	texture_t* texture = lookup(handle);
+
+	if (texture == NULL) {
+		for (handle = 1; handle <= TEXTURE_MAX && textures[handle - 1].name != 0; handle++) {
+		}
+		if (handle > TEXTURE_MAX) {
+			printf("Too many textures loading %s!\n", name);
+			return 0;
+		}
+		texture = &textures[handle - 1];
+		glGenTextures(1, &texture->name);
+	}
+
+	snprintf(texture->label, sizeof(texture->label), "%s", name);
+	texture->width = width;
+	texture->height = height;
+	texture->bytes = (unsigned long long)width * height * 3;
+
+	glBindTexture(GL_TEXTURE_2D, texture->name);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	// Rows of RGB bytes aren't padded to four bytes.
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, rgb);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	uploads++;
+
+	return handle;
+}
+
+void textureBind(texturehandle_t handle)
+{
+	texture_t* texture = lookup(handle);
+	glBindTexture(GL_TEXTURE_2D, texture != NULL ? texture->name : 0);
+}
+
+void textureRelease(texturehandle_t handle)
+{
+	texture_t* texture = lookup(handle);
+
+	if (texture != NULL) {
+		glDeleteTextures(1, &texture->name);
+		glStateInvalidate();	// In case it was bound: deleting it unbinds it behind the cache's back.
+		memset(texture, 0, sizeof(texture_t));
+	}
+}
+
+void texturesGetStats(texturestats_t* stats)
+{
+	memset(stats, 0, sizeof(texturestats_t));
+	stats->uploads = uploads;
+
+	// Core profiles dropped glAreTexturesResident() along with the rest of the fixed pipeline.
+	if (glFuncs.coreProfile) {
+		stats->resident = -1;
+	}
+
+	for (int i = 0; i < TEXTURE_MAX; i++) {
+		if (textures[i].name != 0) {
+			GLboolean resident = GL_FALSE;
+
+			stats->textures++;
+			stats->bytes += textures[i].bytes;
+			// Residency only means something on older drivers; modern ones report GL_TRUE.
+			if (!glFuncs.coreProfile && (glAreTexturesResident(1, &textures[i].name, &resident) || resident)) {
+				stats->resident++;
+			}
+		}
+	}
+}
+
+void texturesPrintStats(void)
+{
+	texturestats_t stats;
+	texturesGetStats(&stats);
+
+	char resident[32] = "residency unknown";
+	if (stats.resident >= 0) {
+		snprintf(resident, sizeof(resident), "%d resident", stats.resident);
+	}
+	printf("Textures: %d live (%s), %.1f KB, %lu uploads since startup\n",
+		stats.textures, resident, stats.bytes / 1024.0, stats.uploads);
+	for (int i = 0; i < TEXTURE_MAX; i++) {
+		if (textures[i].name != 0) {
+			printf("  %2d %-22s %4dx%-4d %8.1f KB\n", i + 1, textures[i].label,
+				textures[i].width, textures[i].height, textures[i].bytes / 1024.0);
+		}
+	}
+}
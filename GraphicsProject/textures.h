@@ -0,0 +1,45 @@
+/******************************************************************************
+ *
+ * Texture Manager
+ *
+ * Owns the scene's GL texture objects. Images are uploaded once, when they're
+ * loaded, and drawing code refers to them through stable handles, so a frame
+ * only ever binds textures (re-uploading an image keeps its handle). The
+ * manager also keeps track of how much texture memory is in use.
+ *
+ ******************************************************************************/
+
+#ifndef TEXTURES_H
+#define TEXTURES_H
+
+#include <freeglut.h>
+
+// Most textures that can exist at once.
+#define TEXTURE_MAX 64
+
+// Refers to a texture; 0 means "no texture".
+typedef int texturehandle_t;
+
+// Totals across every live texture.
+typedef struct {
+	int textures;					// Live textures
+	int resident;					// ...of which the driver reports as resident in video memory (-1 if it can't say)
+	unsigned long long bytes;		// Texel data held by the driver (as uploaded, without mipmaps)
+	unsigned long uploads;			// glTexImage2D calls since startup
+} texturestats_t;
+
+// Upload an RGB image (width * height triples, top row first) with linear filtering.
+// Pass handle 0 to create a new texture, or an existing handle to replace its
+// image in place. Returns the texture's handle, or 0 if no more can be created.
+texturehandle_t textureUpload(texturehandle_t handle, const char* name, int width, int height, const unsigned char* rgb);
+
+// Bind a texture to GL_TEXTURE_2D (handle 0 unbinds).
+void textureBind(texturehandle_t handle);
+
+// Delete a texture; its handle may be reused by a later textureUpload(..., 0, ...).
+void textureRelease(texturehandle_t handle);
+
+void texturesGetStats(texturestats_t* stats);
+void texturesPrintStats(void);
+
+#endif
@@ -0,0 +1,187 @@
+/******************************************************************************
+ *
+ * Hot-Path Tracing (see trace.h)
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "platform.h"
+#include "trace.h"
+
+// A finished zone (or an instant marker, when duration is negative).
+typedef struct {
+	const char* name;
+	double start;
+	double duration;
+} traceevent_t;
+
+// One thread's ring buffer. Only the owning thread writes events; it publishes
+// each one by advancing writeCount. Event n is written while writeCount is n,
+// so a reader that copies events out and then finds writeCount at most n has
+// a whole copy of every event from n - TRACE_RING_SIZE + 1 on.
+typedef struct tracebuffer {
+	traceevent_t events[TRACE_RING_SIZE];
+	volatile int writeCount;
+	int threadId;
+	char threadName[32];		// Empty until traceSetThreadName()
+	struct tracebuffer* next;
+} tracebuffer_t;
+
+static volatile int enabled = 0;
+
+// All thread buffers ever created (a lock-free push-only list).
+static tracebuffer_t* volatile bufferList = NULL;
+static volatile int nextThreadId = 0;
+
+// Time the trace's timestamps are measured from.
+static double traceEpoch = 0.0;
+
+static PLATFORM_THREAD_LOCAL tracebuffer_t* threadBuffer = NULL;
+
+// Find (or create and register) the calling thread's buffer.
+static tracebuffer_t* getThreadBuffer(void)
+{
+	if (threadBuffer != NULL) {
+		return threadBuffer;
+	}
+
+	tracebuffer_t* buffer = calloc(1, sizeof(tracebuffer_t));
+	if (buffer == NULL) {
+		return NULL;
+	}
+	buffer->threadId = platformAtomicAddInt(&nextThreadId, 1);
+
+	tracebuffer_t* head;
+	do {
+		head = platformAtomicLoadPointer((void* volatile*)&bufferList);
+		buffer->next = head;
+	} while (platformAtomicCompareExchangePointer((void* volatile*)&bufferList, head, buffer) != head);
+
+	threadBuffer = buffer;
+	return buffer;
+}
+
+static void recordEvent(const char* name, double start, double duration)
+{
+	tracebuffer_t* buffer = getThreadBuffer();
+	if (buffer == NULL) {
+		return;
+	}
+
+	// Only this thread writes writeCount, so a plain read is enough here. The
+	// fence keeps the event's stores after the last one's publication.
+	unsigned int count = (unsigned int)buffer->writeCount;
+	traceevent_t* event = &buffer->events[count & (TRACE_RING_SIZE - 1)];
+	platformAtomicFenceRelease();
+	event->name = name;
+	event->start = start;
+	event->duration = duration;
+	platformAtomicStoreInt(&buffer->writeCount, (int)(count + 1));
+}
+
+void traceEnable(int enable)
+{
+	if (enable && traceEpoch == 0.0) {
+		traceEpoch = platformTimeSeconds();
+	}
+	platformAtomicStoreInt(&enabled, enable);
+}
+
+int traceIsEnabled(void)
+{
+	return platformAtomicLoadInt(&enabled);
+}
+
+void traceSetThreadName(const char* name)
+{
+	tracebuffer_t* buffer = getThreadBuffer();
+	if (buffer != NULL) {
+		snprintf(buffer->threadName, sizeof(buffer->threadName), "%s", name);
+	}
+}
+
+tracezone_t traceBegin(const char* name)
+{
+	tracezone_t zone = { NULL, 0.0 };
+
+	if (enabled) {
+		zone.name = name;
+		zone.start = platformTimeSeconds();
+	}
+	return zone;
+}
+
+void traceEnd(tracezone_t zone)
+{
+	if (zone.name != NULL) {
+		recordEvent(zone.name, zone.start, platformTimeSeconds() - zone.start);
+	}
+}
+
+void traceInstant(const char* name)
+{
+	if (enabled) {
+		recordEvent(name, platformTimeSeconds(), -1.0);
+	}
+}
+
+/******************************************************************************
+ * Export
+ ******************************************************************************/
+
+int traceWrite(const char* path)
+{
+	// Each ring is copied out before it's written, as its thread may still be recording.
+	traceevent_t* events = malloc(sizeof(traceevent_t) * TRACE_RING_SIZE);
+	FILE* file = events != NULL ? platformOpenFile(path, "w") : NULL;
+	if (file == NULL) {
+		free(events);
+		return 0;
+	}
+
+	int first = 1;
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+	tracebuffer_t* buffer = platformAtomicLoadPointer((void* volatile*)&bufferList);
+	for (; buffer != NULL; buffer = buffer->next) {
+		unsigned int count = (unsigned int)platformAtomicLoadInt(&buffer->writeCount);
+		unsigned int oldest = count > TRACE_RING_SIZE ? count - TRACE_RING_SIZE : 0;
+		for (unsigned int i = oldest; i != count; i++) {
+			events[i & (TRACE_RING_SIZE - 1)] = buffer->events[i & (TRACE_RING_SIZE - 1)];
+		}
+
+		// Leave out the events the thread has overwritten (or is overwriting) since.
+		platformAtomicFenceAcquire();
+		unsigned int now = (unsigned int)platformAtomicLoadInt(&buffer->writeCount);
+		if (now - oldest >= TRACE_RING_SIZE) {
+			oldest = now - oldest - TRACE_RING_SIZE < count - oldest ? now - TRACE_RING_SIZE + 1 : count;
+		}
+
+		if (buffer->threadName[0] != '\0') {
+			fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+				first ? "" : ",\n", buffer->threadId, buffer->threadName);
+			first = 0;
+		}
+
+		for (unsigned int i = oldest; i != count; i++) {
+			const traceevent_t* event = &events[i & (TRACE_RING_SIZE - 1)];
+			double startUs = (event->start - traceEpoch) * 1e6;
+
+			if (event->duration < 0.0) {
+				fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+					first ? "" : ",\n", event->name, startUs, buffer->threadId);
+			}
+			else {
+				fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+					first ? "" : ",\n", event->name, startUs, event->duration * 1e6, buffer->threadId);
+			}
+			first = 0;
+		}
+	}
+
+	fprintf(file, "\n]}\n");
+	fclose(file);
+	free(events);
+	return 1;
+}
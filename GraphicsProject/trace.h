@@ -0,0 +1,53 @@
+/******************************************************************************
+ *
+ * Hot-Path Tracing
+ *
+ * Lightweight timed zones for the render loop. Each thread records finished
+ * zones into its own fixed-size ring buffer (the oldest zones are overwritten
+ * once it's full), and the buffers can be written out as Chrome trace JSON,
+ * which chrome://tracing and the Perfetto UI (ui.perfetto.dev) both open.
+ *
+ * Usage: wrap the code to be measured in a begin/end pair,
+ *
+ *     tracezone_t zone = traceBegin("drawTerrain");
+ *     ...
+ *     traceEnd(zone);
+ *
+ * Zone names must be string literals (or otherwise outlive the trace). While
+ * tracing is disabled both calls return almost immediately.
+ *
+ ******************************************************************************/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+// Number of zones each thread's ring buffer holds (must be a power of two).
+#define TRACE_RING_SIZE 65536
+
+// An open zone, returned by traceBegin() and handed back to traceEnd().
+typedef struct {
+	const char* name;	// NULL if tracing was disabled when the zone began.
+	double start;		// Start time in seconds (platformTimeSeconds).
+} tracezone_t;
+
+// Turn recording on or off (off by default).
+void traceEnable(int enabled);
+int traceIsEnabled(void);
+
+// Name the calling thread in the exported trace (the name is copied, and cut
+// short at 31 characters).
+void traceSetThreadName(const char* name);
+
+// Open and close a zone on the calling thread.
+tracezone_t traceBegin(const char* name);
+void traceEnd(tracezone_t zone);
+
+// Record a zero-length marker (e.g. "frame over budget") on the calling thread.
+void traceInstant(const char* name);
+
+// Write every buffered zone from every thread to a Chrome trace JSON file.
+// Other threads can keep recording meanwhile: zones they overwrite while
+// their ring is being copied out are left out. Returns 0 on failure.
+int traceWrite(const char* path);
+
+#endif
@@ -0,0 +1,56 @@
+/******************************************************************************
+ *
+ * Triple Buffer (see triplebuffer.h)
+ *
+ ******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "triplebuffer.h"
+
+// Set in shared while its slot holds a value the reader hasn't taken.
+#define TRIPLE_BUFFER_FRESH 4
+
+int tripleBufferInit(triplebuffer_t* buffer, size_t size, const void* initial)
+{
+	buffer->slots = malloc(size * 3);
+	if (buffer->slots == NULL) {
+		return 0;
+	}
+	for (int i = 0; i < 3; i++) {
+		memcpy(buffer->slots + size * i, initial, size);
+	}
+	buffer->size = size;
+	buffer->writing = 0;
+	buffer->shared = 1;
+	buffer->reading = 2;
+	return 1;
+}
+
+void* tripleBufferWriteSlot(triplebuffer_t* buffer)
+{
+	return buffer->slots + buffer->size * buffer->writing;
+}
+
+void tripleBufferPublish(triplebuffer_t* buffer)
+{
+	buffer->writing = platformAtomicExchangeInt(&buffer->shared, buffer->writing | TRIPLE_BUFFER_FRESH)
+		& ~TRIPLE_BUFFER_FRESH;
+}
+
+const void* tripleBufferRead(triplebuffer_t* buffer)
+{
+	// Only the writer can make the slot in between fresh, so once it is it
+	// stays fresh (if not the same slot) until it's swapped here.
+	if (platformAtomicLoadInt(&buffer->shared) & TRIPLE_BUFFER_FRESH) {
+		buffer->reading = platformAtomicExchangeInt(&buffer->shared, buffer->reading) & ~TRIPLE_BUFFER_FRESH;
+	}
+	return buffer->slots + buffer->size * buffer->reading;
+}
+
+void tripleBufferFree(triplebuffer_t* buffer)
+{
+	free(buffer->slots);
+	memset(buffer, 0, sizeof(*buffer));
+}
@@ -0,0 +1,46 @@
+/******************************************************************************
+ *
+ * Triple Buffer
+ *
+ * Hands the latest of a stream of values from one thread to another without
+ * either ever waiting: three slots, one being written, one being read and one
+ * in between. The writer fills its slot and swaps it with the one in between
+ * (marking it fresh); the reader, when there's a fresh one, swaps its slot
+ * for it. The swaps are a single atomic exchange of the in-between slot's
+ * index, so neither side takes a lock and the reader always has a whole
+ * value, the newest written. Values the reader is too slow to see are
+ * skipped.
+ *
+ * There must be only one writing thread and one reading thread.
+ *
+ ******************************************************************************/
+
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <stddef.h>
+
+typedef struct {
+	unsigned char* slots;	// Three of size bytes each
+	size_t size;
+	volatile int shared;	// The slot in between, plus TRIPLE_BUFFER_FRESH until the reader takes it
+	int writing;			// The writer's slot...
+	int reading;			// ...and the reader's
+} triplebuffer_t;
+
+// Make room for values of size bytes, each slot starting as a copy of
+// initial. Returns 0 if out of memory.
+int tripleBufferInit(triplebuffer_t* buffer, size_t size, const void* initial);
+
+// The writer's slot, to fill with the next value...
+void* tripleBufferWriteSlot(triplebuffer_t* buffer);
+
+// ...then hand it to the reader (the slot's contents aren't kept).
+void tripleBufferPublish(triplebuffer_t* buffer);
+
+// The newest value published, which stays put until the next call.
+const void* tripleBufferRead(triplebuffer_t* buffer);
+
+void tripleBufferFree(triplebuffer_t* buffer);
+
+#endif